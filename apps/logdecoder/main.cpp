@@ -0,0 +1,220 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2026                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+// Converts log files that were written by the ghoul::logging::BinaryLog back into text
+// or into an HTML table. Usage:
+//
+//   ghoul-logdecoder [--html] [--output <file>] <log file>...
+//
+// Multiple files are decoded in the order in which they are provided, so that rotated
+// files can be combined by passing the oldest file first. Without an output file, the
+// result is written to the standard output
+
+#include <ghoul/logging/binarylog.h>
+#include <ghoul/format.h>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace ghoul::logging;
+
+namespace {
+    constexpr std::string_view Usage =
+        "Usage: ghoul-logdecoder [--html] [--output <file>] <log file>...\n"
+        "  --html           Write an HTML table instead of text\n"
+        "  --output <file>  Write into the file instead of the standard output\n"
+        "All times are in UTC\n";
+
+    struct Options {
+        bool html = false;
+        std::filesystem::path output;
+        std::vector<std::filesystem::path> inputs;
+    };
+
+    std::string_view colorForLevel(LogLevel level) {
+        switch (level) {
+            case LogLevel::Trace:   return "#999999";
+            case LogLevel::Debug:   return "#00CC00";
+            case LogLevel::Warning: return "#FFFF00";
+            case LogLevel::Error:   return "#FF0000";
+            case LogLevel::Fatal:   return "#00FFFF";
+            default:                return "#FFFFFF";
+        }
+    }
+
+    void appendEscaped(std::string& output, std::string_view text) {
+        for (const char c : text) {
+            switch (c) {
+                case '<':
+                    output += "&lt;";
+                    break;
+                case '>':
+                    output += "&gt;";
+                    break;
+                case '&':
+                    output += "&amp;";
+                    break;
+                case '\n':
+                    output += "<br>";
+                    break;
+                default:
+                    output += c;
+                    break;
+            }
+        }
+    }
+
+    void writeEntry(std::ostream& out, const BinaryLogReader::Entry& entry, bool html) {
+        using namespace std::chrono;
+        const sys_days day = floor<days>(entry.time);
+        const year_month_day date = year_month_day(day);
+        const hh_mm_ss time = hh_mm_ss(floor<milliseconds>(entry.time - day));
+        const std::string dateString = std::format(
+            "{}-{:0>2}-{:0>2}",
+            static_cast<int>(date.year()),
+            static_cast<unsigned int>(date.month()),
+            static_cast<unsigned int>(date.day())
+        );
+        const std::string timeString = std::format(
+            "{:0>2}:{:0>2}:{:0>2}.{:0>3}",
+            time.hours().count(),
+            time.minutes().count(),
+            time.seconds().count(),
+            time.subseconds().count()
+        );
+
+        std::string output;
+        if (html) {
+            output = std::format(
+                "\t\t\t<tr bgcolor=\"{}\">\n"
+                "\t\t\t\t<td class=\"log-date\">{}</td>\n"
+                "\t\t\t\t<td class=\"log-time\">{}</td>\n"
+                "\t\t\t\t<td class=\"log-category\">",
+                colorForLevel(entry.level), dateString, timeString
+            );
+            appendEscaped(output, entry.category);
+            output += std::format(
+                "</td>\n\t\t\t\t<td class=\"log-level\">{}</td>\n"
+                "\t\t\t\t<td class=\"log-message\">",
+                ghoul::to_string(entry.level)
+            );
+            appendEscaped(output, entry.message);
+            output += "</td>\n\t\t\t</tr>\n";
+        }
+        else {
+            output = std::format("[{} | {}] ", dateString, timeString);
+            if (!entry.category.empty()) {
+                output += entry.category;
+                output += ' ';
+            }
+            output += std::format("({})\t", ghoul::to_string(entry.level));
+            output += entry.message;
+            output += '\n';
+        }
+        out << output;
+    }
+
+    int decode(const Options& options, std::ostream& out) {
+        if (options.html) {
+            out << "<html>\n\t<head>\n\t\t<title>Log File</title>\n\t</head>\n\t<body>\n"
+                << "\t<table>\n\t\t<thead>\n\t\t\t<tr>\n"
+                << "\t\t\t\t<th class=\"log-date\">Date</th>\n"
+                << "\t\t\t\t<th class=\"log-time\">Time</th>\n"
+                << "\t\t\t\t<th class=\"log-category\">Category</th>\n"
+                << "\t\t\t\t<th class=\"log-level\">Level</th>\n"
+                << "\t\t\t\t<th class=\"log-message\">Message</th>\n"
+                << "\t\t\t</tr>\n\t\t</thead>\n\t\t<tbody>\n";
+        }
+
+        int result = 0;
+        for (const std::filesystem::path& input : options.inputs) {
+            try {
+                BinaryLogReader reader = BinaryLogReader(input);
+                while (std::optional<BinaryLogReader::Entry> entry = reader.next()) {
+                    writeEntry(out, *entry, options.html);
+                }
+            }
+            catch (const ghoul::RuntimeError& e) {
+                // Continue with the remaining files so that a single corrupted file
+                // does not hide the others
+                std::cerr << std::format("{}: {}\n", input, e.message);
+                result = 1;
+            }
+        }
+
+        if (options.html) {
+            out << "\t\t</tbody>\n\t</table>\n\t</body>\n</html>\n";
+        }
+        return result;
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        const std::string_view arg = argv[i];
+        if (arg == "--html") {
+            options.html = true;
+        }
+        else if (arg == "--output" || arg == "-o") {
+            if (i + 1 >= argc) {
+                std::cerr << Usage;
+                return 1;
+            }
+            i++;
+            options.output = argv[i];
+        }
+        else if (arg == "--help" || arg == "-h") {
+            std::cout << Usage;
+            return 0;
+        }
+        else {
+            options.inputs.emplace_back(arg);
+        }
+    }
+
+    if (options.inputs.empty()) {
+        std::cerr << Usage;
+        return 1;
+    }
+
+    if (options.output.empty()) {
+        return decode(options, std::cout);
+    }
+    else {
+        std::ofstream out = std::ofstream(options.output);
+        if (!out.good()) {
+            std::cerr << std::format("Error opening output file '{}'\n", options.output);
+            return 1;
+        }
+        return decode(options, out);
+    }
+}
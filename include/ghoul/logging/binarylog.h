@@ -0,0 +1,234 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2026                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __GHOUL___BINARYLOG___H__
+#define __GHOUL___BINARYLOG___H__
+
+#include <ghoul/logging/log.h>
+
+#include <ghoul/misc/exception.h>
+#include <ghoul/misc/map.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ghoul::logging {
+
+/**
+ * A concrete subclass of Log that writes the messages in a compact binary format into a
+ * memory-mapped file. Each message is stored with the difference of its timestamp to the
+ * previous message as a variable-length integer, the LogLevel, and an identifier for its
+ * category that refers to a category name which is only written once per file. Messages
+ * that were created from a DeferredMessage whose arguments can be formatted without
+ * knowing their C++ type are stored as an identifier of the format string and the raw
+ * encoded arguments instead of the formatted message. The files can be converted back
+ * into text with the BinaryLogReader or the `ghoul-logdecoder` tool.
+ *
+ * While running, the log is rotated once the current file has reached its maximum size
+ * or, optionally, its maximum age. The rotation follows the same naming scheme as the
+ * TextLog, so the previous files are called `filename-1.ext`, `filename-2.ext`, etc.
+ * Since the file is memory-mapped, messages that have been written are not lost if the
+ * application crashes, as long as the operating system keeps running.
+ *
+ * The stamping settings of the Log are not used, as the timestamp, category, and
+ * LogLevel are always stored.
+ */
+class BinaryLog : public Log {
+public:
+    /**
+     * Creates the BinaryLog and the first log file. If the file already exists, it is
+     * overwritten or rotated, depending on the \p nLogRotation.
+     *
+     * \param filename The path and filename of the file that will receive the log
+     *        messages
+     * \param maxFileSize The size in bytes at which the log is rotated. A single message
+     *        that is larger than this will be written into a file of its own
+     * \param maxFileAge The time after which the log is rotated even if the current file
+     *        has not reached its maximum size. If this is 0, the log is only rotated
+     *        based on the \p maxFileSize
+     * \param nLogRotation The number of previous log files that should be kept. If this
+     *        is 0, the file is overwritten when the log is rotated
+     * \param minimumLogLevel The minimum log level that this logger will accept
+     *
+     * \throw RuntimeError If the file could not be created or mapped
+     * \pre \p filename must not be empty
+     * \pre \p maxFileSize must be at least 4096 bytes
+     * \pre \p nLogRotation must be >= 0
+     */
+    BinaryLog(std::filesystem::path filename, size_t maxFileSize = 64 * 1024 * 1024,
+        std::chrono::seconds maxFileAge = std::chrono::seconds(0), int nLogRotation = 0,
+        LogLevel minimumLogLevel = LogLevel::AllLogging);
+
+    /**
+     * Destructor that unmaps the file and truncates it to the size that was written.
+     */
+    ~BinaryLog() override;
+
+    /**
+     * Writes the \p message with the \p level and \p category to the file. If the file
+     * has to be rotated and the new file cannot be created, the exception is passed on
+     * and this and all further messages are discarded.
+     *
+     * \param level The log level with which the message shall be logged
+     * \param category The category of this message
+     * \param message The message body of the log message
+     */
+    void log(LogLevel level, std::string_view category,
+        std::string_view message) override;
+
+    /**
+     * Writes the format string and the encoded arguments of the \p deferred message to
+     * the file. If the arguments cannot be formatted without knowing their C++ type, the
+     * formatted \p message is written instead. Errors are handled the same way as in
+     * #log.
+     *
+     * \param level The log level with which the message shall be logged
+     * \param category The category of this message
+     * \param message The formatted message body of the log message
+     * \param deferred The format string and the encoded arguments of the \p message
+     */
+    void logDeferred(LogLevel level, std::string_view category,
+        std::string_view message, const DeferredMessage& deferred) override;
+
+    /**
+     * Asks the operating system to write the mapped file to disk.
+     */
+    void flush() override;
+
+private:
+    struct MappedFile;
+
+    /// Encodes the record into the #_record buffer, including the definitions of the
+    /// category and the format string if they have not been written to the current file
+    void encodeRecord(LogLevel level, std::string_view category,
+        std::string_view message, const DeferredMessage* deferred, int64_t timestamp);
+
+    /// Writes a record with the time of the message, rotating the file first if the
+    /// record doesn't fit or the file has reached its maximum age
+    void writeRecord(LogLevel level, std::string_view category,
+        std::string_view message, const DeferredMessage* deferred);
+
+    /// Closes the current file, moves the previous files one position up, and opens a
+    /// new file that can hold at least \p minimumSize bytes. If opening the new file
+    /// throws, #_file remains `nullptr` and all further messages are discarded
+    void rotate(size_t minimumSize);
+
+    const std::filesystem::path _filename;
+    const size_t _maxFileSize;
+    const std::chrono::seconds _maxFileAge;
+    const int _nLogRotation;
+
+    std::mutex _mutex;
+    std::unique_ptr<MappedFile> _file;
+
+    /// The timestamp of the previous record in microseconds since the epoch
+    int64_t _previousTimestamp = 0;
+
+    /// The identifiers of the categories and format strings of the current file
+    using IdMap = std::unordered_map<
+        std::string, uint32_t, transparent_string_hash, std::equal_to<>
+    >;
+    IdMap _categories;
+    IdMap _formats;
+
+    /// The buffer into which a record is encoded before it is copied into the file
+    std::string _record;
+};
+
+/**
+ * The exception that is thrown by the BinaryLogReader if a file is not a valid binary log
+ * file.
+ */
+struct BinaryLogError final : public RuntimeError {
+    explicit BinaryLogError(std::string msg);
+};
+
+/**
+ * Reads files that were written by a BinaryLog and returns the messages in the order in
+ * which they were written. Files of logs that are still being written to or whose
+ * application has crashed can be read as well and contain all messages that were
+ * completely written.
+ */
+class BinaryLogReader {
+public:
+    /// A single message in a binary log file
+    struct Entry {
+        /// The time at which the message was logged
+        std::chrono::system_clock::time_point time;
+
+        /// The LogLevel of the message
+        LogLevel level;
+
+        /// The category of the message
+        std::string category;
+
+        /// The message. For messages that were stored as a format string and arguments,
+        /// this is the formatted message
+        std::string message;
+    };
+
+    /**
+     * Reads the binary log file at \p path.
+     *
+     * \param path The path to the binary log file
+     *
+     * \throw RuntimeError If the file could not be read
+     * \throw BinaryLogError If the file is not a valid binary log file
+     */
+    explicit BinaryLogReader(const std::filesystem::path& path);
+
+    /**
+     * Returns the next message in the file or `std::nullopt` if all messages have been
+     * read. If the arguments of a message cannot be formatted with its format string, the
+     * message consists of the format string instead.
+     *
+     * \return The next message in the file
+     *
+     * \throw BinaryLogError If the file is corrupted
+     */
+    std::optional<Entry> next();
+
+private:
+    uint64_t readVarint();
+    std::string_view readBytes(size_t size);
+
+    std::string _content;
+    size_t _offset = 0;
+    int64_t _timestamp = 0;
+    std::vector<std::string_view> _categories;
+    std::vector<std::string_view> _formats;
+};
+
+} // namespace ghoul::logging
+
+#endif // __GHOUL___BINARYLOG___H__
@@ -27,110 +27,90 @@
 #define __GHOUL___BUFFERLOG___H__
 
 #include <ghoul/misc/exception.h>
-
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <optional>
 #include <string>
+#include <string_view>
+
+namespace ghoul { class SharedMemory; }
 
 namespace ghoul::logging {
 
 /**
- * The BufferLog stores timestamped messages into a provided custom buffer of memory. It
- * automatically reserves a part of the block for use as a header in which the version,
- * possible attributes and the amount of stored data is located. The version is always
- * located in the first byte of the buffer and determines the size and the structure of
- * the rest of the header. Each log entry stores an 8 byte timestamp followed by a `\0`
- * terminated ASCII char array containing the message. Each logging will test if there is
- * enough memory left in the buffer. For memory exhaustion management, a custom callback
- * can be specified (#setCallback) that will have to reset the buffer (#resetBuffer) or a
- * warning will be logged. The buffer can be written to disk (#writeToDisk), or access
- * directly (#buffer). Most of the methods are thread-safe and are marked as such.
+ * The BufferLog stores timestamped messages into a provided custom buffer of memory that
+ * is used as a ring buffer of fixed-size records. When the ring buffer is full, the
+ * oldest records are overwritten. The beginning of the buffer is reserved for a header
+ * that contains the version, the layout of the records, and the sequence number of the
+ * next record. The version is always located in the first byte of the header, which is
+ * placed at the first 64-byte aligned address of the buffer and determines the structure
+ * of the rest of the header. Each record stores its sequence number, an 8 byte timestamp,
+ * and the length of the message, followed by the `\0` terminated message. Messages that
+ * are longer than the record allows are truncated.
+ *
+ * All state is stored inside the buffer and only atomic operations are used to
+ * coordinate between writers and readers. This means that the buffer can be placed in a
+ * SharedMemory block and be read by a BufferLogReader in a different process while this
+ * process is writing to it. Any number of threads can call #log concurrently and a
+ * producer never waits for another one. If the buffer wraps around completely while
+ * another producer is still writing into the same record, the newer message is dropped.
  */
 class BufferLog {
 public:
-    /**
-     * This exception is thrown if a call to #log exhausted the available memory and there
-     * is either no registered MemoryExhaustedCallback or the registered callback failed
-     * to free enough memory.
-     */
-    struct MemoryExhaustionException final : public RuntimeError {
-        explicit MemoryExhaustionException(int sizeTotal, int sizeRequested);
-
-        const int totalSize;
-        const int requestedSize;
-    };
-
-    /**
-     * A callback of this time will be called when the logging of a message would exhaust
-     * the available memory of the buffer. It is the callbacks responsibility to either
-     * reset the buffer (#resetBuffer) or supply a new buffer that will be used instead
-     * (#setBuffer). The passed parameters are the BufferLog that is exhausted and the
-     * timestamp that will be used in the message after the callback has been resolved.
-     */
-    using MemoryExhaustedCallback =
-        std::function<void(BufferLog&, unsigned long long int&)>;
-
-    /**
-     * Constructor that registers a MemoryExhausedCallback that will be used. The
-     * constructor will take a small piece of the provided buffer to store a necessary
-     * header. The size of the header is version-dependent.
-     *
-     * \param address The address to the buffer that will be used by this log. The
-     *        ownership of the memory is **not** passed to the BufferLog by this
-     * \param bufferSize The total size of the buffer. It is the callers responsibility to
-     *        assure that the provided buffer is at least as big as \p totalSize
-     * \param callback The MemoryExhaustedCallback that will be used when a potential log
-     *        entry would exhaust the available memory in the buffer. It is the callback's
-     *        responsibility to either clear the buffer (#resetBuffer) or provide a new
-     *        buffer that is used instead (#setBuffer)
-     *
-     * \pre \p address must not be `nullptr`
-     * \pre \p bufferSize must be positive
-     */
-    BufferLog(void* address, size_t bufferSize, MemoryExhaustedCallback callback);
+    /// The default size of a single record in the ring buffer, including the record
+    /// header
+    static constexpr size_t DefaultRecordSize = 256;
 
     /**
      * The constructor will take a small piece of the provided buffer to store a necessary
-     * header. The size of the header is version-dependent. If no MemoryExhaustedCallback
-     * is registered and a subsequent call to #log would exceed the remainder of the
-     * buffer, an exception will be thrown.
+     * header and divides the rest into records of \p recordSize bytes. The number of
+     * records is determined by the size of the buffer. Any previous content of the
+     * buffer is discarded.
      *
      * \param address The address to the buffer that will be used by this log. The
      *        ownership of the memory is **not** passed to the BufferLog by this
      * \param bufferSize The total size of the buffer. It is the callers responsibility to
      *        assure that the provided buffer is at least as big as \p bufferSize
+     * \param recordSize The size of each record in bytes. The maximum length of a message
+     *        is \p recordSize minus 25 bytes
      *
      * \pre \p address must not be `nullptr`
-     * \pre \p bufferSize must be positive
+     * \pre \p recordSize must be a multiple of 8 and at least 32
+     * \pre \p bufferSize must be big enough for the header and at least two records
      */
-    BufferLog(void* address, size_t bufferSize);
+    BufferLog(void* address, size_t bufferSize, size_t recordSize = DefaultRecordSize);
 
     /**
-     * Sets the callback that will be used to handle out-of-memory situations. The
-     * callback will be called when the memory requirement of the next log message would
-     * exhaust the available memory in the buffer. It is the callback's responsibility to
-     * either clear the used memory (#resetBuffer) or provide a replacement buffer
-     * (#setBuffer) that is used instead.
+     * Creates a BufferLog that uses the memory of the provided SharedMemory block, which
+     * makes the log accessible to other processes that attach to the same block. The
+     * \p memory has to outlive the BufferLog.
      *
-     * \param callback The callback that will be used to handle out-of-memory situations
+     * \param memory The SharedMemory block whose memory is used for the ring buffer
+     * \param recordSize The size of each record in bytes. The maximum length of a message
+     *        is \p recordSize minus 25 bytes
+     *
+     * \pre \p recordSize must be a multiple of 8 and at least 32
+     * \pre The \p memory must be big enough for the header and at least two records
      */
-    void setCallback(MemoryExhaustedCallback callback);
+    BufferLog(const SharedMemory& memory, size_t recordSize = DefaultRecordSize);
 
     /**
      * Logs a \p message with a particular \p timestamp. The unit of the timestamp is
      * undefined and depends on the specific use case. The \p timestamp and the \p message
-     * will be copied into the buffer. This method will acquire a lock before calling the
-     * callback function (if provided). Calling this function from the callback results in
-     * undefined behavior. This method is thread-safe.
+     * will be copied into the next record of the buffer, overwriting the oldest record
+     * if the buffer is full. If the \p message is longer than a record allows, it is
+     * truncated. This method is thread-safe and wait-free. If the buffer wrapped around
+     * completely and an older message is still being written into the same record, the
+     * \p message is discarded and counted in #droppedRecords.
      *
      * \param timestamp The timestamp of the message
      * \param message The message to store in the buffer
+     * \return The sequence number of the record that contains the message
      *
-     * \throw MemoryExhaustionException If there was not enough memory left in the buffer
-     *        and there either was no MemoryExhaustCallback or the callback failed to
-     *        provide new memory
      * \pre \p message must not be empty
      */
-    void log(unsigned long long timestamp, const std::string& message);
+    uint64_t log(unsigned long long timestamp, std::string_view message);
 
     /**
      * Returns the buffer that is used by the BufferLog. If this buffer is modified by the
@@ -142,7 +122,7 @@ public:
 
     /**
      * Returns the total size of the buffer that was specified by the user when the
-     * BufferLog was constructed or a new buffer was supplied (#setBuffer).
+     * BufferLog was constructed.
      *
      * \return The total size of the buffer
      */
@@ -151,72 +131,172 @@ public:
     /**
      * Returns the number of bytes that have been used by this BufferLog, including the
      * information for the header fields. This value is guaranteed to be always less than
-     * the value returned by #totalSize.
+     * or equal to the value returned by #totalSize.
      *
      * \return The number of bytes that have been used by this BufferLog
      */
     size_t usedSize() const;
 
     /**
-     * Provides a new buffer that will be used by this BufferLog. This method can be used
-     * by the MemoryExhaustCallback to provide a new buffer while taking take of the old
-     * buffer (#buffer) separately. The caller is responsible to ensure that the \p buffer
-     * contains at least as many bytes as \p bufferSize. As the BufferLog does not take
-     * ownership of the provided buffer, the old buffer might become unavailable after
-     * this function call. This has to be taken care of by the caller or a memory leak
-     * will occur. This method is thread-safe.
+     * Returns the number of records that fit into the ring buffer before the oldest
+     * records are overwritten.
      *
-     * \param buffer The buffer that will be used by the BufferLog from now on
-     * \param bufferSize The size of the buffer that will be used by the BufferLog to
-     *        store messages
+     * \return The number of records in the ring buffer
+     */
+    size_t nRecords() const;
+
+    /**
+     * Returns the sequence number that will be assigned to the next message. This is
+     * equal to the total number of messages that have been logged.
      *
-     * \pre \p buffer must not be `nullptr`
-     * \pre \p bufferSize must be positive
+     * \return The sequence number of the next message
      */
-    void setBuffer(void* buffer, size_t bufferSize);
+    uint64_t nextSequence() const;
 
     /**
-     * Resets the used buffer so that it can hold as many bytes as it did when the
-     * BufferLog was first initialized. This method does not actually overwrite anything
-     * in the buffer, but marks the buffer as available again. This method is thread-safe.
+     * Returns the number of messages that were discarded because their record was
+     * still being written by an older message or was already taken by a newer message by
+     * the time the writing started. This can only happen if the buffer wraps around
+     * completely while a message is being logged.
+     *
+     * \return The number of messages that were discarded
      */
-    void resetBuffer();
+    uint64_t droppedRecords() const;
 
     /**
      * This method writes the contents of the buffer to disk as a binary file. The full
      * buffer, including the header, will be written out. Only the parts of the buffer
      * that have been used will be written to disk, as opposed to the whole buffer. This
-     * means that the file may contain less bytes than #totalSize. This method is
-     * thread-safe.
+     * means that the file may contain less bytes than #totalSize. Records that are
+     * written concurrently to this call might be partially written in the file.
      *
      * \param filename The path to the file which will hold the contents of the buffer.
      *        Any existing file at that location will be overwritten in the process
      */
     void writeToDisk(const std::string& filename);
 
-protected:
-    /**
-     * This method will initialize the individual members of the header fields and make
-     * the buffer usable.
-     */
-    void initializeBuffer();
-
+private:
     /// This block of memory will store all log messages that are added to this BufferLog
     /// it has to be as big as the value provided in `_totalSize`
     void* _buffer;
+
     /// The total size of the buffer used by this BufferLog
     size_t _totalSize;
 
-    /// This callback will be called when an incoming log message would exhaust the
-    /// available memory of the buffer. The callback has to either provide a new buffer
-    /// which will be used henceforth (#setBuffer) or mark the current buffer as
-    /// reusable (#resetBuffer)
-    MemoryExhaustedCallback _callback;
+    /// The aligned location of the header inside the `_buffer`
+    std::byte* _header;
+};
+
+/**
+ * This exception is thrown if a BufferLogReader is created for a buffer that does not
+ * contain a BufferLog with a supported version.
+ */
+struct BufferLogError final : public RuntimeError {
+    explicit BufferLogError(std::string msg);
+};
+
+/**
+ * The BufferLogReader reads the records of a BufferLog in the order of their sequence
+ * numbers while the BufferLog is being written to. The reader can be located in a
+ * different thread or in a different process that has attached the same SharedMemory
+ * block. Each reader keeps its own position, so any number of readers can read the same
+ * BufferLog independently. If the BufferLog overwrites records before they have been
+ * read, those records are skipped and counted in #lostRecords.
+ *
+ * Records can be accessed either without any copies using #next, in which case the
+ * content has to be verified after it has been used with #isValid, or using #drain,
+ * which only passes on records whose content was verified.
+ */
+class BufferLogReader {
+public:
+    /// A single record of the BufferLog
+    struct Record {
+        /// The sequence number of the record
+        uint64_t sequence;
+
+        /// The timestamp that was passed to the BufferLog::log method
+        unsigned long long timestamp;
+
+        /// The message of the record
+        std::string_view message;
+    };
+
+    /**
+     * Creates a reader for the BufferLog that is located in the \p address. The reader
+     * starts at the oldest record that is still available in the buffer.
+     *
+     * \param address The address of the buffer that was passed to the BufferLog
+     * \param bufferSize The size of the buffer in bytes
+     *
+     * \throw BufferLogError If the \p address does not contain a valid BufferLog or if
+     *        the records described by its header do not fit into the \p bufferSize
+     * \pre \p address must not be `nullptr`
+     */
+    BufferLogReader(const void* address, size_t bufferSize);
+
+    /**
+     * Creates a reader for the BufferLog that is located in the \p memory. The reader
+     * starts at the oldest record that is still available in the buffer. The \p memory
+     * has to outlive the BufferLogReader.
+     *
+     * \param memory The SharedMemory block that contains the BufferLog
+     *
+     * \throw BufferLogError If the \p memory does not contain a valid BufferLog or if
+     *        the records described by its header do not fit into the \p memory
+     */
+    explicit BufferLogReader(const SharedMemory& memory);
+
+    /**
+     * Returns the next record that has been completely written and advances the reader.
+     * The message of the returned Record points directly into the buffer and can be
+     * overwritten by the BufferLog at any point. After the Record has been used, #isValid
+     * has to be called to determine whether the content was still intact while it was
+     * used.
+     *
+     * \return The next record or `std::nullopt` if there is no new record yet
+     */
+    std::optional<Record> next();
+
+    /**
+     * Returns whether the \p record, which was returned by #next, has not been
+     * overwritten by the BufferLog since it was returned.
+     *
+     * \param record The record that is checked
+     * \return `true` if the \p record is still intact, `false` otherwise
+     */
+    bool isValid(const Record& record) const;
+
+    /**
+     * Calls the \p callback for all records that are available and advances the reader
+     * past them. The message of each record is copied before it is verified, so the
+     * \p callback only receives intact records. The message is only valid for the
+     * duration of the \p callback.
+     *
+     * \param callback The function that is called for each available record
+     * \return The number of records that were passed to the \p callback
+     */
+    size_t drain(const std::function<void(const Record&)>& callback);
+
+    /**
+     * Returns the number of records that were overwritten before this reader was able to
+     * read them.
+     *
+     * \return The number of lost records
+     */
+    uint64_t lostRecords() const;
+
+private:
+    /// The aligned location of the header of the BufferLog
+    const std::byte* _header;
+
+    /// The sequence number of the next record that this reader returns
+    uint64_t _next = 0;
+
+    /// The number of records that were overwritten before they were read
+    uint64_t _nLost = 0;
 
-    /// This variable is `true` if this BufferLog has had its callback trigged in the
-    /// current callstack. It forces some methods to ignore the `atomic_lock` to ensure
-    /// that no deadlock can happen
-    bool _inCallbackStack = false;
+    /// The storage for the messages that are passed to the callback in #drain
+    std::string _message;
 };
 
 } // namespace ghoul::logging
@@ -101,7 +101,10 @@ public:
 
 protected:
     CallbackFunction _callbackFunction;
-    TracyLockable(std::mutex, _mutex);
+
+    /// Serializes the calls of the callback. It is recursive as the callback might log
+    /// another message, which is passed to the callback again
+    TracyLockable(std::recursive_mutex, _mutex);
 };
 
 } // namespace ghoul::logging
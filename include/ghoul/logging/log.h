@@ -27,7 +27,9 @@
 #define __GHOUL___LOG___H__
 
 #include <ghoul/logging/loglevel.h>
+#include <ghoul/logging/logrecord.h>
 #include <ghoul/misc/boolean.h>
+#include <chrono>
 #include <string>
 #include <string_view>
 
@@ -68,6 +70,40 @@ public:
     virtual void log(LogLevel level, std::string_view category,
         std::string_view message) = 0;
 
+    /**
+     * Method that logs a message that was created from a DeferredMessage. The default
+     * implementation passes the formatted \p message to #log, but subclasses can use the
+     * format string and the encoded arguments of the \p deferred message instead.
+     *
+     * \param level The log level with which the message shall be logged
+     * \param category The category of this message. Can be used by each subclass
+     *        individually
+     * \param message The formatted message body of the log message
+     * \param deferred The format string and the encoded arguments of the \p message
+     */
+    virtual void logDeferred(LogLevel level, std::string_view category,
+        std::string_view message, const DeferredMessage& deferred);
+
+    /**
+     * Logs the \p message through #log or, if a \p deferred message is provided, through
+     * #logDeferred while using the \p timestamp as the time at which the message was
+     * created. While the message is logged, #createFullMessageString, #timeString,
+     * #dateString, and #messageTime use the \p timestamp instead of the current time.
+     * This is used by the LogManager to keep the time of messages that are only written
+     * some time after they were logged.
+     *
+     * \param timestamp The time at which the message was created
+     * \param level The log level with which the message shall be logged
+     * \param category The category of this message. Can be used by each subclass
+     *        individually
+     * \param message The message body of the log message
+     * \param deferred The format string and the encoded arguments of the \p message or
+     *        `nullptr` if the message was not created from a DeferredMessage
+     */
+    void logAt(std::chrono::system_clock::time_point timestamp, LogLevel level,
+        std::string_view category, std::string_view message,
+        const DeferredMessage* deferred = nullptr);
+
     /**
      * Returns the minimum LogLevel that this Log accepts.
      */
@@ -141,17 +177,26 @@ protected:
     void setLogLevelStamping(LogLevelStamping logLevelStamping);
 
     /**
-     * Returns the current time as a string. The format for the time is "HH:MM:SS" and the
-     * clock is 24h.
+     * Returns the time at which the message that is currently being logged was created.
+     * This is the timestamp that was passed to #logAt or the current time if the message
+     * was passed to #log directly.
+     *
+     * \return The time at which the current message was created
+     */
+    static std::chrono::system_clock::time_point messageTime();
+
+    /**
+     * Returns the #messageTime as a string. The format for the time is "HH:MM:SS" and
+     * the clock is 24h.
      *
-     * \return The current time as a string
+     * \return The time of the current message as a string
      */
     static std::string timeString();
 
     /**
-     * Returns the current date as a string. The date format is "YYYY-MM-DD".
+     * Returns the date of the #messageTime as a string. The date format is "YYYY-MM-DD".
      *
-     * \return The current date as a string
+     * \return The date of the current message as a string
      */
     static std::string dateString();
 
@@ -0,0 +1,101 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2026                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __GHOUL___LOGCATEGORY___H__
+#define __GHOUL___LOGCATEGORY___H__
+
+#include <optional>
+#include <string_view>
+
+namespace ghoul::logging {
+
+/**
+ * A category name that has been interned in a process-wide registry and has been assigned
+ * a unique, dense identifier. Creating two LogCategory objects with the same name results
+ * in the same identifier. The identifier is used by the LogManager to look up the
+ * LogLevel of the category in constant time, whereas a category that is passed as a
+ * string has to be looked up by its name first. A LogCategory can therefore be used as
+ * the `_loggerCat` variable of a file that logs in a hot path:
+ * ```
+ * const ghoul::logging::LogCategory _loggerCat("Renderer");
+ * ```
+ * The registry is thread-safe and categories are never removed from it.
+ */
+class LogCategory {
+public:
+    /// The maximum number of different categories that can be interned
+    static constexpr int MaxCategories = 65536;
+
+    /**
+     * Interns the \p name, if it has not been interned before, and creates a LogCategory
+     * that refers to it.
+     *
+     * \param name The name of the category
+     *
+     * \throw RuntimeError If more than #MaxCategories categories would be interned
+     */
+    explicit LogCategory(std::string_view name);
+
+    /**
+     * Returns the name of this category. The returned view is valid for the lifetime of
+     * the application.
+     *
+     * \return The name of this category
+     */
+    std::string_view name() const;
+
+    /**
+     * Returns the identifier of this category, which is in `[0, MaxCategories)`.
+     *
+     * \return The identifier of this category
+     */
+    int id() const;
+
+    /**
+     * Converts the category into its name so that it can be passed to all functions that
+     * expect the category as a string.
+     */
+    operator std::string_view() const;
+
+    /**
+     * Returns the identifier of the category with the provided \p name if it has been
+     * interned before. This function does not intern the \p name. The result is cached
+     * for each thread by the address of the \p name, so that repeated lookups of the same
+     * name, such as a `_loggerCat` string, neither hash the name nor take a lock.
+     *
+     * \param name The name of the category that is looked up
+     * \return The identifier of the category or `std::nullopt` if no category with the
+     *         \p name has been interned
+     */
+    static std::optional<int> find(std::string_view name);
+
+private:
+    std::string_view _name;
+    int _id;
+};
+
+} // namespace ghoul::logging
+
+#endif // __GHOUL___LOGCATEGORY___H__
@@ -26,10 +26,18 @@
 #ifndef __GHOUL___LOGMANAGER___H__
 #define __GHOUL___LOGMANAGER___H__
 
+#include <ghoul/format.h>
+#include <ghoul/logging/logcategory.h>
 #include <ghoul/logging/loglevel.h>
+#include <ghoul/logging/logrecord.h>
 #include <ghoul/misc/boolean.h>
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <string_view>
 #include <vector>
 
@@ -37,6 +45,36 @@ namespace ghoul::logging {
 
 class Log;
 
+/**
+ * Determines what happens to a message that is logged while the LogManager is in the
+ * asynchronous mode and the queue of messages that are waiting to be written is full.
+ */
+enum class OverflowPolicy {
+    /// The logging thread waits until the sink thread has made room in the queue
+    Block,
+    /// The message is discarded and counted in LogManager::droppedMessages
+    Drop,
+    /// Messages with a LogLevel below AsyncOptions::dropBelowLevel are discarded, for all
+    /// other messages the logging thread waits until there is room in the queue
+    DropBelowLevel
+};
+
+/**
+ * The options that control the asynchronous mode of the LogManager.
+ */
+struct AsyncOptions {
+    /// The number of messages that can be waiting to be written at the same time. This
+    /// value is rounded up to the next power of two
+    size_t queueSize = 4096;
+
+    /// What happens to a message that is logged while the queue is full
+    OverflowPolicy overflowPolicy = OverflowPolicy::Block;
+
+    /// The LogLevel below which messages are discarded if the #overflowPolicy is
+    /// OverflowPolicy::DropBelowLevel
+    LogLevel dropBelowLevel = LogLevel::Warning;
+};
+
 /**
  * The central singleton class that is responsible for handling Log%s and logging methods.
  * This singleton class provides methods to add new Log%s, remove Log%s, and relay
@@ -58,7 +96,27 @@ class Log;
  * #LDEBUGC, #LINFO, #LINFOC, #LWARNING, #LWARNINGC, #LERROR, #LERRORC, #LFATAL, #LFATALC.
  * The *C versions of the macros requires the category and the message as a parameter. The
  * versions without the C require an `std::string` variable named `_loggerCat` to be
- * defined in the scope of the macro "call".
+ * defined in the scope of the macro "call". The `_loggerCat` can also be a LogCategory,
+ * which makes the check of a category-specific LogLevel faster.
+ *
+ * Messages below the `GHOUL_LOGGING_MINIMUM_LEVEL`, which is the integer value of a
+ * LogLevel and is set through the CMake option of the same name, are removed from the
+ * application at compile time by all macros. At runtime, #setCategoryLevel can be used
+ * to set a LogLevel for individual categories that replaces the LogLevel of the
+ * LogManager for messages of that category. All macros check the LogLevel before their
+ * message is created, so silenced messages are neither formatted nor passed to any Log.
+ *
+ * For messages that are created with `std::format`, the macros #LTRACEF, #LDEBUGF,
+ * #LINFOF, #LWARNINGF, #LERRORF, #LFATALF and their *FC versions take the format string
+ * and its arguments instead. These macros check the LogLevel before the arguments are
+ * evaluated and, in the asynchronous mode, only copy the arguments into the queue so that
+ * the message is formatted on the sink thread.
+ *
+ * By default, each message is written to all Log%s on the thread that logs it. Calling
+ * #startAsync switches the LogManager into an asynchronous mode in which the logging
+ * thread only places the message into a lock-free queue and a dedicated sink thread
+ * writes the messages to the Log%s, which removes the cost of formatting and writing
+ * the messages from the logging threads.
  */
 class LogManager {
 public:
@@ -83,6 +141,12 @@ public:
     LogManager(LogLevel level = LogLevel::Info,
         ImmediateFlush immediateFlush = ImmediateFlush::No);
 
+    /**
+     * Destroys the LogManager. If the LogManager is in the asynchronous mode, all queued
+     * messages are written before the sink thread is stopped.
+     */
+    ~LogManager();
+
     /**
      * The main method to log messages. If the `level` is >= the level this LogManager was
      * created with, the `message` will be passed to the stored Log%s. The `category` will
@@ -108,6 +172,78 @@ public:
      */
     void logMessage(LogLevel level, std::string_view message);
 
+    /**
+     * The function that creates the message of a deferred log record from the format
+     * string and the captured arguments. It appends the message to the \p result.
+     */
+    using FormatFunction = logging::FormatFunction;
+
+    /**
+     * Logs the message that results from formatting the \p args with the \p format
+     * string. Apart from that, this function behaves the same as #logMessage. If all
+     * arguments are strings, arithmetic types, enums, or pointers, they are encoded into
+     * a DeferredMessage, which is passed to the Log%s together with the formatted
+     * message. In the asynchronous mode, only the encoded arguments are copied into the
+     * queue and the message is formatted on the sink thread. Otherwise, the message is
+     * formatted right away.
+     *
+     * \param level The level of the message that should be passed to the Log%s
+     * \param category The category of the message, which will be used depending on the
+     *        Log%s
+     * \param format The `std::format` format string of the message
+     * \param args The arguments that are formatted into the message
+     */
+    template <typename... Args>
+    void logFormatted(LogLevel level, std::string_view category,
+        std::format_string<Args...> format, Args&&... args);
+
+    /**
+     * Passes the \p message to the Log%s like #logMessage, but without checking whether
+     * messages with the \p level and \p category are enabled. This is used by the logging
+     * macros, which have to check this before the message is evaluated anyway, so that
+     * the category does not have to be looked up twice for each message.
+     *
+     * \param level The level of the message that should be passed to the Log%s
+     * \param category The category of the message, which will be used depending on the
+     *        Log%s
+     * \param message The message that will be passed to the Log%s. May contain control
+     *        sequences
+     *
+     * \pre \p level must not be LogLevel::NoLogging
+     * \pre #isEnabled must return `true` for the \p level and \p category
+     */
+    void logEnabledMessage(LogLevel level, std::string_view category,
+        std::string_view message);
+
+    /**
+     * Logs the message that results from formatting the \p args with the \p format
+     * string like #logFormatted, but without checking whether messages with the \p level
+     * and \p category are enabled.
+     *
+     * \param level The level of the message that should be passed to the Log%s
+     * \param category The category of the message, which will be used depending on the
+     *        Log%s
+     * \param format The `std::format` format string of the message
+     * \param args The arguments that are formatted into the message
+     *
+     * \pre \p level must not be LogLevel::NoLogging
+     * \pre #isEnabled must return `true` for the \p level and \p category
+     */
+    template <typename... Args>
+    void logEnabledFormatted(LogLevel level, std::string_view category,
+        std::format_string<Args...> format, Args&&... args);
+
+    /**
+     * Writes the \p message to the console. This is used for messages that are logged
+     * before the LogManager has been initialized.
+     *
+     * \param level The level of the message
+     * \param category The category of the message
+     * \param message The message that is written to the console
+     */
+    static void logUninitialized(LogLevel level, std::string_view category,
+        std::string_view message);
+
     /**
      * Returns the LogLevel that this LogManager has been initialized with. This method is
      * inlined as it is used in the LOGC macro and it might lead the compiler to do some
@@ -117,6 +253,51 @@ public:
      */
     LogLevel logLevel() const;
 
+    /**
+     * Sets the LogLevel for all messages of the \p category, which replaces the LogLevel
+     * of this LogManager for these messages. The LogLevel can be both higher, which
+     * silences a noisy category, or lower, which shows more messages of a category.
+     *
+     * \param category The category for which the LogLevel is set. The category is
+     *        interned as a LogCategory
+     * \param level The LogLevel for the messages of the \p category
+     */
+    void setCategoryLevel(std::string_view category, LogLevel level);
+
+    /**
+     * Removes the LogLevel that was set for the \p category with #setCategoryLevel, so
+     * that messages of the \p category use the LogLevel of this LogManager again.
+     * Resetting a category for which no LogLevel was set has no effect and is permitted.
+     *
+     * \param category The category whose LogLevel is removed
+     */
+    void resetCategoryLevel(std::string_view category);
+
+    /**
+     * Returns whether a message with the \p level and the \p category would be passed
+     * to the Log%s, which depends on the LogLevel of this LogManager and the LogLevel
+     * that might have been set for the \p category. As long as no category-specific
+     * LogLevel was set, this only compares the \p level with the LogLevel of this
+     * LogManager. Otherwise, the \p category has to be looked up by its name, which is
+     * cached for each thread and does not take a lock after the first lookup.
+     *
+     * \param level The LogLevel of the message
+     * \param category The category of the message
+     * \return `true` if the message would be passed to the Log%s
+     */
+    bool isEnabled(LogLevel level, std::string_view category) const;
+
+    /**
+     * Returns whether a message with the \p level and the \p category would be passed
+     * to the Log%s. As the \p category is already interned, this is a constant-time
+     * lookup.
+     *
+     * \param level The LogLevel of the message
+     * \param category The category of the message
+     * \return `true` if the message would be passed to the Log%s
+     */
+    bool isEnabled(LogLevel level, const LogCategory& category) const;
+
     /**
      * Returns the message counter status for the passed LogLevel \p level.
      *
@@ -142,6 +323,9 @@ public:
      * Removes the passed log from the list of managed Log%s. This transfers the ownership
      * of the Log back to the caller and he is responsible for deleting the Log. Trying to
      * remove a Log that is not part of this LogManager has no effect and is permitted.
+     * If a Log is removed while a message is written to it, for example from within
+     * Log::log, it receives no further messages but is only destroyed after the message
+     * has been written to all Logs.
      *
      * \param log The Log that should be removed from this LogManager
      */
@@ -154,7 +338,81 @@ public:
      */
     void flushLogs();
 
+    /**
+     * Switches this LogManager into the asynchronous mode. In this mode, #logMessage only
+     * copies the message into a lock-free queue and returns, and a dedicated sink thread
+     * writes the queued messages to the Log%s in the order in which they were queued.
+     * The Log%s are therefore called from the sink thread only. Messages with the
+     * LogLevel::Fatal are always written before #logMessage returns, as they are likely
+     * to be followed by a termination of the application. Messages that a Log logs
+     * while the sink thread is writing to it are written right away, as the sink thread
+     * can't wait for the queue that only it is emptying. Each message keeps the time at
+     * which it was logged, which is passed to the Log%s through Log::logAt.
+     *
+     * \param options The options that determine the size of the queue and the behavior
+     *        if the queue is full
+     *
+     * \pre The LogManager must not be in the asynchronous mode already
+     * \pre `options.queueSize` must be bigger than 0
+     * \pre No message must be logged concurrently with this function
+     */
+    void startAsync(AsyncOptions options = AsyncOptions());
+
+    /**
+     * Writes all messages that are still queued to the Log%s, stops the sink thread, and
+     * switches this LogManager back into the synchronous mode. Calling this function if
+     * the LogManager is not in the asynchronous mode has no effect.
+     *
+     * \pre No message must be logged concurrently with this function
+     */
+    void stopAsync();
+
+    /**
+     * Returns whether this LogManager is currently in the asynchronous mode.
+     *
+     * \return `true` if this LogManager is in the asynchronous mode
+     */
+    bool isAsync() const;
+
+    /**
+     * Returns the number of messages that were discarded because the queue of the
+     * asynchronous mode was full. See OverflowPolicy for the cases in which messages are
+     * discarded.
+     *
+     * \return The number of discarded messages since the creation of the LogManager or
+     *         the last call to #resetMessageCounters
+     */
+    int droppedMessages() const;
+
 private:
+    struct AsyncState;
+    struct CategoryLevels;
+
+    /// Returns the LogLevel that applies to the category with the \p id
+    LogLevel thresholdForCategory(int id) const;
+
+    /// Writes the message that was created at the \p timestamp to the console log and all
+    /// registered Log%s. If the message was created from a DeferredMessage, it is passed
+    /// to the Log%s as well
+    void writeMessage(std::chrono::system_clock::time_point timestamp, LogLevel level,
+        std::string_view category, std::string_view message,
+        const DeferredMessage* deferred = nullptr);
+
+    /// Places the message into the queue of the asynchronous mode. If a \p formatter is
+    /// provided, the \p message is the format string and the \p arguments are passed to
+    /// the \p formatter on the sink thread. Returns `false` if the message was discarded
+    /// because the queue was full
+    bool queueMessage(LogLevel level, std::string_view category,
+        std::string_view message, FormatFunction formatter = nullptr,
+        std::string_view arguments = std::string_view());
+
+    /// Queues or writes a deferred log record and updates the message counters
+    void logRecord(LogLevel level, std::string_view category, std::string_view format,
+        FormatFunction formatter, std::string_view arguments);
+
+    /// Blocks until all messages that were queued before this call have been written
+    void waitForQueue();
+
     static LogManager* _instance;
 
     /// The LogLevel
@@ -166,34 +424,134 @@ private:
     /// Stores the Logs which are managed by this LogManager
     std::vector<std::unique_ptr<Log>> _logs;
 
+    /// Protects the #_logs against concurrent modification while a message is written to
+    /// them. It is recursive as a Log might add or remove a Log while it is written to
+    std::recursive_mutex _logsMutex;
+
+    /// The number of messages that are currently being written to the #_logs by the
+    /// thread that holds the #_logsMutex. Used to detect Logs that are removed while a
+    /// message is written
+    int _nDispatching = 0;
+
+    /// The Logs that were removed while a message was written. Their entries in #_logs
+    /// are `nullptr` until the message has been written to all Logs
+    std::vector<std::unique_ptr<Log>> _removedLogs;
+
+    /// The queue and sink thread of the asynchronous mode, or `nullptr` if the
+    /// LogManager is in the synchronous mode
+    std::unique_ptr<AsyncState> _async;
+
     /// Stores the number of messages for each log level (7)
-    std::array<int, 7> _logCounters = { 0, 0, 0, 0, 0, 0, 0 };
+    std::array<std::atomic<int>, 7> _logCounters = {};
+
+    /// The number of messages that were discarded in the asynchronous mode
+    std::atomic<int> _nDroppedMessages = 0;
+
+    /// The LogLevels that were set for individual categories, indexed by the identifier
+    /// of the interned LogCategory
+    std::unique_ptr<CategoryLevels> _categoryLevels;
+
+    /// The number of categories that currently have a LogLevel set. As long as this is 0,
+    /// the categories of messages don't have to be looked up
+    std::atomic<int> _nCategoryLevels = 0;
 };
 
 } // namespace ghoul::logging
 
 #define LogMgr (ghoul::logging::LogManager::ref())
 
+// The integer value of the lowest LogLevel for which the logging macros are compiled
+#ifndef GHOUL_LOGGING_MINIMUM_LEVEL
+#ifdef GHOUL_LOGGING_ENABLE_TRACE
+#define GHOUL_LOGGING_MINIMUM_LEVEL 1
+#else // ^^^^ GHOUL_LOGGING_ENABLE_TRACE // !GHOUL_LOGGING_ENABLE_TRACE vvvv
+#define GHOUL_LOGGING_MINIMUM_LEVEL 2
+#endif // GHOUL_LOGGING_ENABLE_TRACE
+#endif // GHOUL_LOGGING_MINIMUM_LEVEL
+
 inline void log(ghoul::logging::LogLevel level, std::string_view category,
     std::string_view message);
 
+// The category is bound to a local so that it is only evaluated once. Whether the message
+// is enabled is only checked here, as the message must not be evaluated otherwise. Before
+// the LogManager is initialized, all messages are written to the console
+#define GHOUL_LOG(__level__, __category__, ...)                                          \
+    do {                                                                                 \
+        if constexpr (static_cast<int>(__level__) >= GHOUL_LOGGING_MINIMUM_LEVEL) {      \
+            const auto& ghoulLogCategory = (__category__);                               \
+            if (!ghoul::logging::LogManager::isInitialized()) {                          \
+                ghoul::logging::LogManager::logUninitialized(                            \
+                    (__level__), ghoulLogCategory, __VA_ARGS__                           \
+                );                                                                       \
+            }                                                                            \
+            else if (LogMgr.isEnabled((__level__), ghoulLogCategory)) {                  \
+                LogMgr.logEnabledMessage((__level__), ghoulLogCategory, __VA_ARGS__);    \
+            }                                                                            \
+        }                                                                                \
+    } while (false)
+
+#define GHOUL_LOG_FORMATTED(__level__, __category__, ...)                                \
+    do {                                                                                 \
+        if constexpr (static_cast<int>(__level__) >= GHOUL_LOGGING_MINIMUM_LEVEL) {      \
+            const auto& ghoulLogCategory = (__category__);                               \
+            if (!ghoul::logging::LogManager::isInitialized()) {                          \
+                ghoul::logging::LogManager::logUninitialized(                            \
+                    (__level__), ghoulLogCategory, std::format(__VA_ARGS__)              \
+                );                                                                       \
+            }                                                                            \
+            else if (LogMgr.isEnabled((__level__), ghoulLogCategory)) {                  \
+                LogMgr.logEnabledFormatted((__level__), ghoulLogCategory, __VA_ARGS__);  \
+            }                                                                            \
+        }                                                                                \
+    } while (false)
+
 #define LTRACE(__msg__) LTRACEC(_loggerCat, __msg__)
-inline void LTRACEC(std::string_view category, std::string_view message);
+#define LTRACEC(__category__, ...)                                                       \
+    GHOUL_LOG(ghoul::logging::LogLevel::Trace, __category__, __VA_ARGS__)
 
 #define LDEBUG(__msg__) LDEBUGC(_loggerCat, __msg__)
-inline void LDEBUGC(std::string_view category, std::string_view message);
+#define LDEBUGC(__category__, ...)                                                       \
+    GHOUL_LOG(ghoul::logging::LogLevel::Debug, __category__, __VA_ARGS__)
 
 #define LINFO(__msg__) LINFOC(_loggerCat, __msg__)
-inline void LINFOC(std::string_view category, std::string_view message);
+#define LINFOC(__category__, ...)                                                        \
+    GHOUL_LOG(ghoul::logging::LogLevel::Info, __category__, __VA_ARGS__)
 
 #define LWARNING(__msg__) LWARNINGC(_loggerCat, __msg__)
-inline void LWARNINGC(std::string_view category, std::string_view message);
+#define LWARNINGC(__category__, ...)                                                     \
+    GHOUL_LOG(ghoul::logging::LogLevel::Warning, __category__, __VA_ARGS__)
 
 #define LERROR(__msg__) LERRORC(_loggerCat, __msg__)
-inline void LERRORC(std::string_view category, std::string_view message);
+#define LERRORC(__category__, ...)                                                       \
+    GHOUL_LOG(ghoul::logging::LogLevel::Error, __category__, __VA_ARGS__)
 
 #define LFATAL(__msg__) LFATALC(_loggerCat, __msg__)
-inline void LFATALC(std::string_view category, std::string_view message);
+#define LFATALC(__category__, ...)                                                       \
+    GHOUL_LOG(ghoul::logging::LogLevel::Fatal, __category__, __VA_ARGS__)
+
+#define LTRACEF(...) LTRACEFC(_loggerCat, __VA_ARGS__)
+#define LTRACEFC(__category__, ...)                                                      \
+    GHOUL_LOG_FORMATTED(ghoul::logging::LogLevel::Trace, __category__, __VA_ARGS__)
+
+#define LDEBUGF(...) LDEBUGFC(_loggerCat, __VA_ARGS__)
+#define LDEBUGFC(__category__, ...)                                                      \
+    GHOUL_LOG_FORMATTED(ghoul::logging::LogLevel::Debug, __category__, __VA_ARGS__)
+
+#define LINFOF(...) LINFOFC(_loggerCat, __VA_ARGS__)
+#define LINFOFC(__category__, ...)                                                       \
+    GHOUL_LOG_FORMATTED(ghoul::logging::LogLevel::Info, __category__, __VA_ARGS__)
+
+#define LWARNINGF(...) LWARNINGFC(_loggerCat, __VA_ARGS__)
+#define LWARNINGFC(__category__, ...)                                                    \
+    GHOUL_LOG_FORMATTED(ghoul::logging::LogLevel::Warning, __category__, __VA_ARGS__)
+
+#define LERRORF(...) LERRORFC(_loggerCat, __VA_ARGS__)
+#define LERRORFC(__category__, ...)                                                      \
+    GHOUL_LOG_FORMATTED(ghoul::logging::LogLevel::Error, __category__, __VA_ARGS__)
+
+#define LFATALF(...) LFATALFC(_loggerCat, __VA_ARGS__)
+#define LFATALFC(__category__, ...)                                                      \
+    GHOUL_LOG_FORMATTED(ghoul::logging::LogLevel::Fatal, __category__, __VA_ARGS__)
 
 #include "logmanager.inl"
 
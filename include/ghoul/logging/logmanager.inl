@@ -23,32 +23,66 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
-inline void log(ghoul::logging::LogLevel level, std::string_view category,
-                std::string_view message)
-{
-    LogMgr.logMessage(level, category, message);
-}
+#include <ghoul/misc/defer.h>
+#include <type_traits>
 
-inline void LTRACEC(std::string_view category, std::string_view message) {
-    log(ghoul::logging::LogLevel::Trace, category, message);
-}
+namespace ghoul::logging {
 
-inline void LDEBUGC(std::string_view category, std::string_view message) {
-    log(ghoul::logging::LogLevel::Debug, category, message);
-}
+namespace detail {
 
-inline void LINFOC(std::string_view category, std::string_view message) {
-    log(ghoul::logging::LogLevel::Info, category, message);
-}
+    // The buffer into which the arguments of a deferred message are encoded before they
+    // are passed on. It keeps its capacity between messages
+    inline std::string& argumentBuffer() {
+        thread_local std::string buffer;
+        return buffer;
+    }
+
+} // namespace detail
 
-inline void LWARNINGC(std::string_view category, std::string_view message) {
-    log(ghoul::logging::LogLevel::Warning, category, message);
+template <typename... Args>
+void LogManager::logFormatted(LogLevel level, std::string_view category,
+                              std::format_string<Args...> format, Args&&... args)
+{
+    if (level == LogLevel::NoLogging || !isEnabled(level, category)) {
+        return;
+    }
+
+    logEnabledFormatted(level, category, format, std::forward<Args>(args)...);
 }
 
-inline void LERRORC(std::string_view category, std::string_view message) {
-    log(ghoul::logging::LogLevel::Error, category, message);
+template <typename... Args>
+void LogManager::logEnabledFormatted(LogLevel level, std::string_view category,
+                                     std::format_string<Args...> format, Args&&... args)
+{
+    if constexpr ((detail::IsDeferrable<std::remove_cvref_t<Args>> && ...)) {
+        // If a Log logs another message while this one is written, the nested message
+        // must not overwrite the arguments that are still passed to the other Log%s
+        std::string& buffer = detail::argumentBuffer();
+        std::string nested;
+        std::string& arguments = buffer.empty() ? buffer : nested;
+        defer { arguments.clear(); };
+        (detail::encodeArgument(arguments, args), ...);
+        logRecord(
+            level,
+            category,
+            format.get(),
+            &detail::formatArguments<std::remove_cvref_t<Args>...>,
+            arguments
+        );
+    }
+    else {
+        logEnabledMessage(
+            level,
+            category,
+            std::format(format, std::forward<Args>(args)...)
+        );
+    }
 }
 
-inline void LFATALC(std::string_view category, std::string_view message) {
-    log(ghoul::logging::LogLevel::Fatal, category, message);
+} // namespace ghoul::logging
+
+inline void log(ghoul::logging::LogLevel level, std::string_view category,
+                std::string_view message)
+{
+    LogMgr.logMessage(level, category, message);
 }
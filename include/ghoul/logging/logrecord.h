@@ -0,0 +1,251 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2026                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __GHOUL___LOGRECORD___H__
+#define __GHOUL___LOGRECORD___H__
+
+#include <ghoul/format.h>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+namespace ghoul::logging {
+
+/**
+ * The function that creates the message of a deferred log message from the format string
+ * and the encoded arguments. It appends the message to the \p result.
+ */
+using FormatFunction = void(*)(std::string& result, std::string_view format,
+    std::string_view arguments);
+
+/**
+ * A message whose arguments have been captured instead of being formatted. The
+ * `arguments` are encoded as a sequence of arguments, each of which starts with its
+ * ArgumentType followed by the value of the argument.
+ */
+struct DeferredMessage {
+    /// The `std::format` format string of the message
+    std::string_view format;
+
+    /// The encoded arguments of the message
+    std::string_view arguments;
+};
+
+/**
+ * The type of an encoded argument of a DeferredMessage. All types except `Raw` can be
+ * decoded and formatted without knowing the C++ type of the original argument. The
+ * values are part of the binary log format, so new types must only be added before
+ * `Raw` and existing types must not be reordered.
+ */
+enum class ArgumentType : uint8_t {
+    Bool = 0,
+    Char,
+    Int8,
+    Int16,
+    Int32,
+    Int64,
+    UInt8,
+    UInt16,
+    UInt32,
+    UInt64,
+    Float,
+    Double,
+    /// A `uint64_t` length followed by the characters
+    String,
+    /// The address as a `uint64_t`
+    Pointer,
+    /// A `uint32_t` size followed by the object representation of a trivially copyable
+    /// type that can only be formatted by the process that encoded it
+    Raw
+};
+
+/**
+ * Returns whether all arguments in the encoded \p arguments are of a type other than
+ * ArgumentType::Raw and can therefore be formatted by #formatArguments.
+ *
+ * \param arguments The encoded arguments of a DeferredMessage
+ * \return `true` if all arguments can be formatted without knowing their C++ type
+ */
+bool hasPortableArguments(std::string_view arguments);
+
+/**
+ * Formats the encoded \p arguments with the \p format string. In contrast to the
+ * FormatFunction that was created when the arguments were encoded, this function only
+ * relies on the ArgumentType of each argument and can therefore be used on arguments
+ * that were encoded by another process. Format specifications that take their width or
+ * precision from another argument are not supported.
+ *
+ * \param format The `std::format` format string
+ * \param arguments The encoded arguments
+ * \return The formatted message
+ *
+ * \throw std::format_error If the \p format string is not valid for the \p arguments or
+ *        if the \p arguments contain an ArgumentType::Raw argument
+ */
+std::string formatArguments(std::string_view format, std::string_view arguments);
+
+namespace detail {
+
+    // Arguments that can be viewed as a string are stored as their length followed by
+    // the characters, as the pointer might not be valid anymore when the message is
+    // formatted. All other arguments are stored with their object representation
+    template <typename T>
+    constexpr bool IsStringArgument = std::is_convertible_v<const T&, std::string_view>;
+
+    // Only arguments whose value is self-contained can be deferred. A trivially copyable
+    // type such as `std::span` can refer to memory that no longer exists when the
+    // message is formatted, so these arguments are formatted eagerly instead. Pointers
+    // are only formatted as their address and are never dereferenced
+    template <typename T>
+    constexpr bool IsDeferrable = IsStringArgument<T> || std::is_arithmetic_v<T> ||
+        std::is_enum_v<T> || std::is_pointer_v<T> || std::is_null_pointer_v<T>;
+
+    template <typename T>
+    constexpr ArgumentType argumentType() {
+        if constexpr (IsStringArgument<T>) {
+            return ArgumentType::String;
+        }
+        else if constexpr (std::is_same_v<T, bool>) {
+            return ArgumentType::Bool;
+        }
+        else if constexpr (std::is_same_v<T, char>) {
+            return ArgumentType::Char;
+        }
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            if constexpr (sizeof(T) == 1) { return ArgumentType::Int8; }
+            else if constexpr (sizeof(T) == 2) { return ArgumentType::Int16; }
+            else if constexpr (sizeof(T) == 4) { return ArgumentType::Int32; }
+            else if constexpr (sizeof(T) == 8) { return ArgumentType::Int64; }
+            else { return ArgumentType::Raw; }
+        }
+        else if constexpr (std::is_integral_v<T> && std::is_unsigned_v<T>) {
+            if constexpr (sizeof(T) == 1) { return ArgumentType::UInt8; }
+            else if constexpr (sizeof(T) == 2) { return ArgumentType::UInt16; }
+            else if constexpr (sizeof(T) == 4) { return ArgumentType::UInt32; }
+            else if constexpr (sizeof(T) == 8) { return ArgumentType::UInt64; }
+            else { return ArgumentType::Raw; }
+        }
+        else if constexpr (std::is_same_v<T, float>) {
+            return ArgumentType::Float;
+        }
+        else if constexpr (std::is_same_v<T, double>) {
+            return ArgumentType::Double;
+        }
+        else if constexpr ((std::is_pointer_v<T> || std::is_null_pointer_v<T>) &&
+                           sizeof(T) <= sizeof(uint64_t))
+        {
+            return ArgumentType::Pointer;
+        }
+        else {
+            return ArgumentType::Raw;
+        }
+    }
+
+    template <typename T>
+    void encodeArgument(std::string& buffer, const T& value) {
+        constexpr ArgumentType Type = argumentType<T>();
+        buffer += static_cast<char>(Type);
+
+        if constexpr (Type == ArgumentType::String) {
+            const std::string_view v = value;
+            const uint64_t size = v.size();
+            buffer.append(reinterpret_cast<const char*>(&size), sizeof(uint64_t));
+            buffer.append(v);
+        }
+        else if constexpr (Type == ArgumentType::Pointer) {
+            // Pointers are widened so that the size does not depend on the platform
+            const uint64_t address = reinterpret_cast<uintptr_t>(
+                static_cast<const void*>(value)
+            );
+            buffer.append(reinterpret_cast<const char*>(&address), sizeof(uint64_t));
+        }
+        else {
+            if constexpr (Type == ArgumentType::Raw) {
+                const uint32_t size = sizeof(T);
+                buffer.append(reinterpret_cast<const char*>(&size), sizeof(uint32_t));
+            }
+            buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+    }
+
+    template <typename T>
+    auto decodeArgument(const char*& cursor) {
+        constexpr ArgumentType Type = argumentType<T>();
+        // The type was only needed for decoding without knowing the C++ type
+        cursor += sizeof(ArgumentType);
+
+        if constexpr (Type == ArgumentType::String) {
+            uint64_t size = 0;
+            std::memcpy(&size, cursor, sizeof(uint64_t));
+            cursor += sizeof(uint64_t);
+            const std::string_view v = std::string_view(cursor, size);
+            cursor += size;
+            return v;
+        }
+        else if constexpr (Type == ArgumentType::Pointer) {
+            uint64_t address = 0;
+            std::memcpy(&address, cursor, sizeof(uint64_t));
+            cursor += sizeof(uint64_t);
+            return reinterpret_cast<const void*>(static_cast<uintptr_t>(address));
+        }
+        else {
+            if constexpr (Type == ArgumentType::Raw) {
+                cursor += sizeof(uint32_t);
+            }
+            T value;
+            std::memcpy(&value, cursor, sizeof(T));
+            cursor += sizeof(T);
+            return value;
+        }
+    }
+
+    template <typename... Args>
+    void formatArguments(std::string& result, std::string_view format,
+                         std::string_view arguments)
+    {
+        [[maybe_unused]] const char* cursor = arguments.data();
+        // The braced initialization guarantees that the arguments are decoded in order
+        const std::tuple values = { decodeArgument<Args>(cursor)... };
+        std::apply(
+            [&result, format](const auto&... v) {
+                std::vformat_to(
+                    std::back_inserter(result),
+                    format,
+                    std::make_format_args(v...)
+                );
+            },
+            values
+        );
+    }
+
+} // namespace detail
+
+} // namespace ghoul::logging
+
+#endif // __GHOUL___LOGRECORD___H__
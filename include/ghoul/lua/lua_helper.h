@@ -198,6 +198,34 @@ void loadDictionaryFromFile(const std::filesystem::path& filename, Dictionary& d
 Dictionary loadDictionaryFromFile(const std::filesystem::path& filename,
     lua_State* state = nullptr);
 
+/**
+ * Loads a Lua script and returns it as a #ghoul::Dictionary in the same way as
+ * loadDictionaryFromFile, but stores the result in the binary Dictionary format in the
+ * CacheManager. Subsequent calls for the same file load the cached result instead of
+ * executing the script, until the file is modified. Note that only the modification of
+ * the file itself is detected, not of other files that are loaded by the script. If no
+ * CacheManager has been created, this function behaves like loadDictionaryFromFile.
+ *
+ * \param filename The filename pointing to the script that is executed
+ * \param state If this is set to a valid lua_State, this state is used instead of
+ *        creating a new state if the script has to be executed. It is the callers
+ *        responsibility to ensure that the passed state is valid if this parameter is
+ *        not `nullptr`. After calling this method, the stack of the passed state will be
+ *        empty after this function returns
+ * \return The ghoul::Dictionary described by the Lua script
+ *
+ * \throw FormattingException If the #ghoul::Dictionary contains mixed keys of both type
+ *        `string` and type `number`
+ * \throw FormattingException If the script did not return anything else but a table
+ * \throw LuaRuntimeException If there was an error initializing a new Lua state if it was
+ *        necessary
+ * \pre \p filename must not be empty
+ * \pre \p filename must be a path to an existing file
+ * \post The \p state%'s stack is empty
+ */
+Dictionary loadDictionaryFromFileCached(const std::filesystem::path& filename,
+    lua_State* state = nullptr);
+
 /**
  * Loads a Lua configuration into the given #ghoul::Dictionary, extending the passed in
  * dictionary. This method will overwrite values with the same keys, but will not remove
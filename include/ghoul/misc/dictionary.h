@@ -30,9 +30,11 @@
 #include <concepts>
 #include <filesystem>
 #include <functional>
-#include <map>
+#include <memory>
+#include <span>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -56,8 +58,8 @@ concept SupportedByDictionary = IsAnyOf<
 /**
  * The Dictionary is a class that represents a mapping from a string to a fixed selection
  * of types. It has the ability to store and retrieve these items by unique string keys.
- * The only automatic conversion that is currently performed is to convert glm vector or
- * matrix types into std::vector types and reconstructing them on access such that:
+ * The only automatic conversion that is currently performed is between glm vector or
+ * matrix types and std::vector types with the same number of values such that:
  * ```
  * Dictionary d;
  * d.setValue("a", glm::dvec4(1.0, 2.0, 3.0, 4.0);
@@ -71,6 +73,16 @@ concept SupportedByDictionary = IsAnyOf<
  * // vv.x == 5.0 && vv.y == 6.0 && vv.z == 7.0 && vv.w == 8.0
  * ```
  * are legal
+ *
+ * The values are stored in a single vector that is sorted by the keys, so that a lookup
+ * is a binary search over contiguous memory and a Dictionary with n values requires a
+ * single allocation for its entries instead of n separate nodes. Keys that are short
+ * enough to fit into the small string buffer of std::string are stored inline.
+ *
+ * Copies of a Dictionary share their values until one of them is modified, so copying a
+ * Dictionary takes constant time regardless of its size. Modifying a Dictionary only
+ * copies the values of that Dictionary but not of the Dictionaries nested in it, which
+ * remain shared until they are modified themselves.
  */
 class Dictionary {
 public:
@@ -133,6 +145,65 @@ public:
     template <SupportedByDictionary T>
     bool hasValue(std::string_view key) const;
 
+    /**
+     * Returns a reference to the Dictionary stored at the provided \p key without copying
+     * it. The reference is invalidated when this Dictionary is modified or destroyed.
+     *
+     * \param key The key of the Dictionary that should be returned
+     * \return A reference to the Dictionary stored at the \p key
+     *
+     * \throw KeyError If the provided \p key does not exist
+     * \throw ValueError If the value stored at \p key is not a Dictionary
+     * \pre \p key must not be the empty string
+     */
+    const Dictionary& ref(std::string_view key) const;
+
+    /**
+     * Returns a view of the string stored at the provided \p key without copying it. The
+     * view is invalidated when this Dictionary is modified or destroyed.
+     *
+     * \param key The key of the string that should be returned
+     * \return A view of the string stored at the \p key
+     *
+     * \throw KeyError If the provided \p key does not exist
+     * \throw ValueError If the value stored at \p key is not a string
+     * \pre \p key must not be the empty string
+     */
+    std::string_view stringView(std::string_view key) const;
+
+    /**
+     * Returns a view of the numbers stored at the provided \p key without copying them.
+     * The value can either be a std::vector of T or any vector or matrix type whose
+     * components are of type T. The span is invalidated when this Dictionary is modified
+     * or destroyed.
+     *
+     * \tparam T The type of the numbers, which has to be `int` or `double`
+     * \param key The key of the numbers that should be returned
+     * \return A view of the numbers stored at the \p key
+     *
+     * \throw KeyError If the provided \p key does not exist
+     * \throw ValueError If the value stored at \p key does not consist of Ts
+     * \pre \p key must not be the empty string
+     */
+    template <typename T>
+        requires IsAnyOf<T, int, double>
+    std::span<const T> valueSpan(std::string_view key) const;
+
+    /**
+     * Follows a \p path of keys separated by `.` through the nested Dictionaries without
+     * copying any of them. For the path `a.b.c`, the Dictionary stored at `b` inside the
+     * Dictionary stored at `a` is returned together with the remaining key `c`, which can
+     * then be passed to the other access functions. The returned pointer is invalidated
+     * when this Dictionary is modified or destroyed.
+     *
+     * \param path The keys separated by `.`
+     * \return The Dictionary that contains the last key of the \p path and that key. If
+     *         one of the keys before the last one does not exist or is not a Dictionary,
+     *         the returned pointer is `nullptr`
+     */
+    std::pair<const Dictionary*, std::string_view> resolvePath(
+        std::string_view path) const;
+
     /**
      * Checks whether the Dictionary stores any value under the provided key, regardless
      * of its type.
@@ -152,6 +223,31 @@ public:
      */
     std::vector<std::string_view> keys() const;
 
+    /**
+     * Calls the \p function for every value in the Dictionary in the order of their keys.
+     * The \p function is called with the key as an `std::string_view` and a const
+     * reference to the value in the type in which it is stored. This is one of the types
+     * of the Types variant, except that `std::filesystem::path` values are stored as
+     * `std::string` and `std::vector<std::filesystem::path>` values are stored as
+     * `std::vector<std::string>`.
+     *
+     * \param function The function that is called for every value
+     */
+    template <typename Function>
+    void forEach(Function&& function) const;
+
+    /**
+     * Calls the \p function for the value that is stored at \p key. The \p function is
+     * called with the same arguments as for #forEach. If the \p key does not exist, the
+     * \p function is not called.
+     *
+     * \param key The key of the value for which the \p function is called
+     * \param function The function that is called for the value
+     * \return `true` if the \p key exists, `false` otherwise
+     */
+    template <typename Function>
+    bool visit(std::string_view key, Function&& function) const;
+
     /**
      * Removes the provided \p key from the dictionary. If the key does not exist, this
      * operation does not do anything.
@@ -185,13 +281,61 @@ public:
     bool isSubset(const Dictionary& dict) const;
 
 private:
+    /// The vector and matrix types are stored inline so that they don't require an
+    /// allocation, but they are still accessible as std::vector of their values
     using StorageTypes = std::variant<
         bool, int, double, std::string, Dictionary, void*, std::vector<int>,
-        std::vector<double>, std::vector<std::string>
+        std::vector<double>, std::vector<std::string>, glm::ivec2, glm::ivec3,
+        glm::ivec4, glm::dvec2, glm::dvec3, glm::dvec4, glm::dmat2x2, glm::dmat2x3,
+        glm::dmat2x4, glm::dmat3x2, glm::dmat3x3, glm::dmat3x4, glm::dmat4x2,
+        glm::dmat4x3, glm::dmat4x4
     >;
-    std::map<std::string, StorageTypes, std::less<>> _storage;
+    using Entry = std::pair<std::string, StorageTypes>;
+
+    /// Returns the value stored at \p key or `nullptr` if the key does not exist
+    const StorageTypes* find(std::string_view key) const;
+
+    /// Stores the \p value at \p key, overwriting any existing value
+    void insertOrAssign(std::string key, StorageTypes value);
+
+    /// Returns all values of this Dictionary sorted by their keys
+    const std::vector<Entry>& entries() const;
+
+    /// Returns the values of this Dictionary for modification, copying them first if
+    /// they are shared with other Dictionaries
+    std::vector<Entry>& mutableEntries();
+
+    /// All values of this Dictionary sorted by their keys. The values are shared between
+    /// copies of the Dictionary until one of the copies is modified. `nullptr` if the
+    /// Dictionary has never contained any values
+    std::shared_ptr<std::vector<Entry>> _storage;
 };
 
+template <typename Function>
+void Dictionary::forEach(Function&& function) const {
+    for (const Entry& entry : entries()) {
+        std::visit(
+            [&function, &entry](const auto& value) {
+                function(std::string_view(entry.first), value);
+            },
+            entry.second
+        );
+    }
+}
+
+template <typename Function>
+bool Dictionary::visit(std::string_view key, Function&& function) const {
+    const StorageTypes* v = find(key);
+    if (!v) {
+        return false;
+    }
+    std::visit(
+        [&function, key](const auto& value) { function(key, value); },
+        *v
+    );
+    return true;
+}
+
 extern template void Dictionary::setValue(std::string, Dictionary value);
 extern template void Dictionary::setValue(std::string, bool value);
 extern template void Dictionary::setValue(std::string, double);
@@ -248,6 +392,9 @@ extern template glm::dmat4x2 Dictionary::value(std::string_view) const;
 extern template glm::dmat4x3 Dictionary::value(std::string_view) const;
 extern template glm::dmat4x4 Dictionary::value(std::string_view) const;
 
+extern template std::span<const int> Dictionary::valueSpan(std::string_view) const;
+extern template std::span<const double> Dictionary::valueSpan(std::string_view) const;
+
 extern template bool Dictionary::hasValue<Dictionary>(std::string_view) const;
 extern template bool Dictionary::hasValue<bool>(std::string_view) const;
 extern template bool Dictionary::hasValue<double>(std::string_view) const;
@@ -0,0 +1,296 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2026                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __GHOUL___DICTIONARYBINARYFORMAT___H__
+#define __GHOUL___DICTIONARYBINARYFORMAT___H__
+
+#include <ghoul/misc/dictionary.h>
+#include <ghoul/misc/exception.h>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace ghoul {
+
+/**
+ * This exception is thrown if a Dictionary cannot be converted into the binary format or
+ * if a buffer does not contain a valid binary Dictionary.
+ */
+struct BinaryFormatError final : public RuntimeError {
+    explicit BinaryFormatError(std::string msg);
+};
+
+/**
+ * A read-only view into a Dictionary that is stored in the binary format. Only the parts
+ * of the buffer that are accessed are decoded, so individual values and nested
+ * Dictionaries can be retrieved without decoding the rest of the buffer. The view does
+ * not own the buffer, which has to outlive the view and all views that are created from
+ * it.
+ */
+class BinaryDictionaryView {
+public:
+    /**
+     * Creates a view of the top-level Dictionary stored in the \p buffer.
+     *
+     * \param buffer The buffer that contains the Dictionary in the binary format
+     *
+     * \throw BinaryFormatError If the \p buffer does not contain a binary Dictionary or
+     *        it was written by an incompatible version or on a machine with a different
+     *        byte order
+     * \pre The \p buffer must be aligned to 8 bytes
+     */
+    explicit BinaryDictionaryView(std::span<const std::byte> buffer);
+
+    /**
+     * Returns the value stored at the provided \p key. Only this value is decoded, which
+     * for a nested Dictionary includes all of its values.
+     *
+     * \param key The key for which to retrieve the value
+     * \return The value stored at the \p key
+     *
+     * \throw RuntimeError If the \p key does not exist or is not of type T, using the
+     *        same rules as Dictionary::value
+     * \throw BinaryFormatError If the buffer is corrupted
+     * \pre \p key must not be the empty string
+     */
+    template <SupportedByDictionary T>
+    T value(std::string_view key) const;
+
+    /**
+     * Checks whether the value stored at the provided \p key is of type T using the same
+     * rules as Dictionary::hasValue.
+     *
+     * \param key The key for which to check the type
+     * \return `true` if the \p key exists and is of type T
+     *
+     * \throw BinaryFormatError If the buffer is corrupted
+     * \pre \p key must not be the empty string
+     */
+    template <SupportedByDictionary T>
+    bool hasValue(std::string_view key) const;
+
+    /**
+     * Returns a view of the Dictionary stored at the provided \p key without decoding it.
+     *
+     * \param key The key of the Dictionary
+     * \return A view of the Dictionary at the \p key
+     *
+     * \throw BinaryFormatError If the \p key does not exist or is not a Dictionary
+     * \pre \p key must not be the empty string
+     */
+    BinaryDictionaryView view(std::string_view key) const;
+
+    /**
+     * Returns a view of the string stored at the provided \p key without copying it. The
+     * returned view points into the buffer.
+     *
+     * \param key The key of the string
+     * \return The string stored at the \p key
+     *
+     * \throw BinaryFormatError If the \p key does not exist or is not a string
+     * \pre \p key must not be the empty string
+     */
+    std::string_view stringView(std::string_view key) const;
+
+    /**
+     * Returns the values of the list, vector, or matrix stored at the provided \p key
+     * without copying them. The returned span points into the buffer.
+     *
+     * \param key The key of the list, vector, or matrix
+     * \return The values stored at the \p key
+     *
+     * \throw BinaryFormatError If the \p key does not exist or does not contain values of
+     *        type T
+     * \pre \p key must not be the empty string
+     */
+    template <typename T>
+        requires IsAnyOf<T, int, double>
+    std::span<const T> valueSpan(std::string_view key) const;
+
+    /**
+     * Checks whether the Dictionary stores any value under the provided \p key.
+     *
+     * \param key The key for which to check the existence
+     * \return `true` if the Dictionary contains the \p key
+     *
+     * \throw BinaryFormatError If the buffer is corrupted
+     * \pre \p key must not be the empty string
+     */
+    bool hasKey(std::string_view key) const;
+
+    /**
+     * Returns a list of all keys stored in the Dictionary in sorted order. The returned
+     * views point into the buffer.
+     *
+     * \return A list of all keys stored in the Dictionary
+     *
+     * \throw BinaryFormatError If the buffer is corrupted
+     */
+    std::vector<std::string_view> keys() const;
+
+    /**
+     * Returns the number of values stored in the Dictionary.
+     *
+     * \return The number of values stored in the Dictionary
+     *
+     * \throw BinaryFormatError If the buffer is corrupted
+     */
+    size_t size() const;
+
+    /**
+     * Decodes the entire Dictionary that is represented by this view, including all of
+     * its nested Dictionaries.
+     *
+     * \return The decoded Dictionary
+     *
+     * \throw BinaryFormatError If the buffer is corrupted
+     */
+    Dictionary dictionary() const;
+
+private:
+    BinaryDictionaryView(std::span<const std::byte> buffer, uint64_t keyTable,
+        uint32_t nKeys, uint64_t node);
+
+    /// Returns a Dictionary that only contains the decoded value stored at \p key or an
+    /// empty Dictionary if the key does not exist
+    Dictionary decode(std::string_view key) const;
+
+    std::span<const std::byte> _buffer;
+    uint64_t _keyTable = 0;
+    uint32_t _nKeys = 0;
+    uint64_t _node = 0;
+};
+
+/**
+ * A Dictionary in the binary format that is stored in a file. The file is memory-mapped
+ * and the pages are only read from disk when the values in them are accessed.
+ */
+class BinaryDictionaryFile {
+public:
+    /**
+     * Maps the file at \p path into memory.
+     *
+     * \param path The path to the file containing a Dictionary in the binary format
+     *
+     * \throw RuntimeError If the file cannot be opened or mapped
+     * \throw BinaryFormatError If the file does not contain a valid binary Dictionary
+     */
+    explicit BinaryDictionaryFile(const std::filesystem::path& path);
+    ~BinaryDictionaryFile();
+
+    BinaryDictionaryFile(const BinaryDictionaryFile&) = delete;
+    BinaryDictionaryFile& operator=(const BinaryDictionaryFile&) = delete;
+
+    /**
+     * Returns a view of the top-level Dictionary stored in the file. The view and all
+     * views created from it must not outlive this BinaryDictionaryFile.
+     *
+     * \return A view of the top-level Dictionary stored in the file
+     */
+    BinaryDictionaryView root() const;
+
+private:
+    const std::byte* _data = nullptr;
+    size_t _size = 0;
+};
+
+/**
+ * Converts the passed \p dictionary into the binary format. The format stores the
+ * Dictionary in a single buffer that can be used in-place after it has been
+ * memory-mapped from a file:
+ *   - Each Dictionary is stored as the number of its values followed by one fixed-size
+ *     record per value (key index, type, payload) in the sorted order of the keys, so
+ *     that a value can be found with a binary search. Booleans and numbers are stored in
+ *     the payload, all other types store the offset of their data
+ *   - All keys are interned into a single table, so that keys that are repeated, for
+ *     example in lists of Dictionaries, are only stored once
+ *   - Lists, vectors, and matrices are 8-byte aligned and can be accessed in-place
+ *
+ * The buffer uses the byte order of the machine that created it and is intended for
+ * caching data on the same machine rather than as an exchange format.
+ *
+ * \param dictionary The Dictionary that should be converted
+ * \return The buffer containing the \p dictionary in the binary format
+ *
+ * \throw BinaryFormatError If the \p dictionary contains a pointer value, which cannot be
+ *        stored
+ */
+std::vector<std::byte> formatBinary(const Dictionary& dictionary);
+
+/**
+ * Decodes the Dictionary stored in the \p buffer in the binary format.
+ *
+ * \param buffer The buffer containing the Dictionary in the binary format
+ * \return The decoded Dictionary
+ *
+ * \throw BinaryFormatError If the \p buffer does not contain a valid binary Dictionary
+ * \pre The \p buffer must be aligned to 8 bytes
+ */
+Dictionary parseBinary(std::span<const std::byte> buffer);
+
+/**
+ * Converts the passed \p dictionary into the binary format and writes it to the file at
+ * \p path, overwriting the file if it exists.
+ *
+ * \param dictionary The Dictionary that should be stored
+ * \param path The path of the file that is written
+ *
+ * \throw BinaryFormatError If the \p dictionary contains a pointer value
+ * \throw RuntimeError If the file could not be written
+ */
+void saveBinaryFile(const Dictionary& dictionary, const std::filesystem::path& path);
+
+/**
+ * Memory-maps the file at \p path and decodes the Dictionary stored in it.
+ *
+ * \param path The path to the file containing a Dictionary in the binary format
+ * \return The decoded Dictionary
+ *
+ * \throw RuntimeError If the file cannot be opened or mapped
+ * \throw BinaryFormatError If the file does not contain a valid binary Dictionary
+ */
+Dictionary loadBinaryFile(const std::filesystem::path& path);
+
+template <SupportedByDictionary T>
+T BinaryDictionaryView::value(std::string_view key) const {
+    return decode(key).value<T>(key);
+}
+
+template <SupportedByDictionary T>
+bool BinaryDictionaryView::hasValue(std::string_view key) const {
+    return decode(key).hasValue<T>(key);
+}
+
+extern template std::span<const int> BinaryDictionaryView::valueSpan(
+    std::string_view) const;
+extern template std::span<const double> BinaryDictionaryView::valueSpan(
+    std::string_view) const;
+
+} // namespace ghoul
+
+#endif // __GHOUL___DICTIONARYBINARYFORMAT___H__
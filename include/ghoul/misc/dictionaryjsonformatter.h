@@ -27,6 +27,7 @@
 #define __GHOUL___DICTIONARYJSONFORMATTER___H__
 
 #include <ghoul/misc/exception.h>
+#include <iosfwd>
 #include <string>
 
 namespace ghoul {
@@ -46,10 +47,37 @@ struct JsonFormattingError final : public RuntimeError {
  * \param dictionary The Dictionary that should be converted
  * \return A JSON string representing the Dictionary
  *
- * \throw JsonFormattingError If the \p key points to a type that cannot be converted
+ * \throw JsonFormattingError If the \p dictionary contains a value of a type that
+ *        cannot be converted
  */
 std::string formatJson(const Dictionary& dictionary);
 
+/**
+ * Converts the passed \p dictionary into a JSON string representation and appends it to
+ * the \p buffer. Reusing the same buffer for repeated conversions avoids allocating new
+ * memory for every conversion.
+ *
+ * \param dictionary The Dictionary that should be converted
+ * \param buffer The string to which the JSON representation is appended
+ *
+ * \throw JsonFormattingError If the \p dictionary contains a value of a type that
+ *        cannot be converted
+ */
+void formatJson(const Dictionary& dictionary, std::string& buffer);
+
+/**
+ * Converts the passed \p dictionary into a JSON string representation and writes it to
+ * the \p stream. The representation is written in chunks instead of being assembled in
+ * memory completely first.
+ *
+ * \param dictionary The Dictionary that should be converted
+ * \param stream The stream to which the JSON representation is written
+ *
+ * \throw JsonFormattingError If the \p dictionary contains a value of a type that
+ *        cannot be converted
+ */
+void formatJson(const Dictionary& dictionary, std::ostream& stream);
+
 } // namespace ghoul
 
 #endif // __GHOUL___DICTIONARYJSONFORMATTER___H__
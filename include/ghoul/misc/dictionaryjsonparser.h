@@ -0,0 +1,88 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2026                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __GHOUL___DICTIONARYJSONPARSER___H__
+#define __GHOUL___DICTIONARYJSONPARSER___H__
+
+#include <ghoul/misc/exception.h>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace ghoul {
+
+class Dictionary;
+
+/**
+ * This exception is thrown if the JSON text that is parsed is malformed. The line and
+ * column of the offending character are part of the message.
+ */
+struct JsonParsingError final : public RuntimeError {
+    explicit JsonParsingError(std::string msg);
+};
+
+/**
+ * Parses the JSON text in \p json and builds a #ghoul::Dictionary from it directly
+ * without going through an intermediate representation. The top-level value must be a
+ * JSON object. The values are converted as follows:
+ *   - Objects are converted into nested Dictionary objects
+ *   - Numbers are stored as `double`
+ *   - Arrays that only contain numbers are stored as `std::vector<double>`, and arrays
+ *     that only contain strings are stored as `std::vector<std::string>`
+ *   - All other arrays are stored as a Dictionary with the keys `1` to `n`
+ *   - Object members and array elements that are `null` are omitted
+ *
+ * Note that this differs from ghoul::lua::loadDictionaryFromString, which stores every
+ * Lua array as a Dictionary with the keys `1` to `n`. A number or string array that is
+ * loaded from JSON therefore does not satisfy `hasValue<Dictionary>` and can not be
+ * accessed with `value<Dictionary>`, whereas the same array loaded from Lua can not be
+ * accessed as a `std::vector`. Only the glm vector and matrix accessors accept both
+ * representations.
+ *
+ * \param json The JSON text that should be parsed
+ * \return The Dictionary described by the JSON text
+ *
+ * \throw JsonParsingError If \p json is not a valid JSON text, the top-level value is
+ *        not an object, or an object contains an empty key
+ */
+Dictionary parseJson(std::string_view json);
+
+/**
+ * Loads the file at \p path and parses its contents with #parseJson. The file is not
+ * streamed; its entire contents are read into memory first, so the peak memory usage is
+ * the size of the file in addition to the resulting Dictionary.
+ *
+ * \param path The path to the file that contains the JSON text
+ * \return The Dictionary described by the contents of the file
+ *
+ * \throw JsonParsingError If the contents of the file are not a valid JSON text
+ * \throw RuntimeError If the file could not be read
+ * \pre \p path must point to an existing file
+ */
+Dictionary parseJsonFile(const std::filesystem::path& path);
+
+} // namespace ghoul
+
+#endif // __GHOUL___DICTIONARYJSONPARSER___H__
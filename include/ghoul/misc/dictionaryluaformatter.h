@@ -54,7 +54,8 @@ BooleanType(PrettyPrint);
     *        that is used
     * \return A Lua string representing the Dictionary
     *
-    * \throw LuaFormattingError If the \p key points to a type that cannot be converted
+    * \throw LuaFormattingError If the \p dictionary contains a value of a type that
+    *        cannot be converted
     */
 std::string formatLua(const Dictionary& dictionary,
     PrettyPrint prettyPrint = PrettyPrint::No, const std::string& indentation = "    ");
@@ -0,0 +1,195 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2026                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __GHOUL___FRAMEARENA___H__
+#define __GHOUL___FRAMEARENA___H__
+
+#include <cstddef>
+#include <memory>
+
+#if (defined(__linux__) && defined(__clang__))
+#include <experimental/memory_resource>
+#include <experimental/string>
+#include <experimental/vector>
+namespace pmr = std::experimental::pmr;
+#else // ^^^^ __linux__ && __clang__ // !(__linux__ && __clang__) vvvv
+#include <memory_resource>
+namespace pmr = std::pmr;
+#endif // __linux__ && __clang__
+
+#include <string>
+#include <vector>
+
+namespace ghoul {
+
+/**
+ * The FrameArena is a memory resource for temporary data whose lifetime is bound to a
+ * specific scope, for example a single frame or a single function call. Memory is
+ * handed out by incrementing a pointer into a list of large chunks, which makes
+ * allocations very cheap. Individual deallocations are ignored; instead, the current
+ * position can be stored with #mark and all memory that was allocated since then is
+ * released at once by passing the Marker to #rewind. The Scope class does this
+ * automatically at the end of a C++ scope. The chunks are kept after rewinding, so a
+ * FrameArena that is used repeatedly stops allocating memory from the system after the
+ * first few uses.
+ *
+ * A FrameArena is not thread-safe. Instead, each thread has its own instance that is
+ * returned by #threadLocal, so the Worker%s of a ThreadPool can use their scratch memory
+ * without any synchronization. The frame_vector and frame_string aliases are the `pmr`
+ * containers that are used together with a FrameArena:
+ * ```
+ * ghoul::FrameArena& arena = ghoul::FrameArena::threadLocal();
+ * ghoul::FrameArena::Scope scope(arena);
+ * ghoul::frame_vector<float> vertices(&arena);
+ * vertices.reserve(1024);
+ * ```
+ *
+ * All objects that were allocated from the FrameArena must have been destroyed before
+ * the memory is rewound, as their destructors are not called by the FrameArena.
+ */
+class FrameArena final : public pmr::memory_resource {
+public:
+    /**
+     * A position in the FrameArena that is returned by #mark and can be passed to
+     * #rewind.
+     */
+    struct Marker {
+        /// The index of the chunk
+        size_t chunk = 0;
+        /// The number of bytes that were used in the chunk
+        size_t offset = 0;
+    };
+
+    /**
+     * Marks the position of a FrameArena on construction and rewinds the FrameArena to
+     * that position on destruction.
+     */
+    class Scope {
+    public:
+        /**
+         * Stores the current position of the \p arena.
+         *
+         * \param arena The FrameArena that is rewound when this Scope is destroyed
+         */
+        explicit Scope(FrameArena& arena);
+
+        /**
+         * Rewinds the FrameArena to the position it had when this Scope was created.
+         */
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        FrameArena& _arena;
+        const Marker _marker;
+    };
+
+    /**
+     * Creates an empty FrameArena. Memory is requested from the system in chunks of
+     * \p chunkSize bytes, or bigger if a single allocation does not fit into a chunk.
+     *
+     * \param chunkSize The size of each chunk of memory in bytes
+     *
+     * \pre \p chunkSize must be positive
+     */
+    explicit FrameArena(size_t chunkSize = 64 * 1024);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    /**
+     * Returns the current position of this FrameArena, which can later be passed to
+     * #rewind to release all memory that is allocated in between.
+     *
+     * \return The current position of this FrameArena
+     */
+    Marker mark() const;
+
+    /**
+     * Releases all memory that has been allocated since the \p marker was created. The
+     * released memory is reused by the following allocations.
+     *
+     * \param marker The position to which this FrameArena is rewound
+     *
+     * \pre \p marker must have been returned by #mark of this FrameArena and must not
+     *      have been invalidated by rewinding to an earlier position
+     */
+    void rewind(Marker marker);
+
+    /**
+     * Releases all memory that has been allocated from this FrameArena. The chunks are
+     * kept so that they can be reused.
+     */
+    void reset();
+
+    /**
+     * Returns the number of bytes that are currently allocated from this FrameArena,
+     * including the bytes needed for alignment and the unused ends of earlier chunks.
+     */
+    size_t usage() const;
+
+    /**
+     * Returns the total size of all chunks that have been requested from the system.
+     */
+    size_t capacity() const;
+
+    /**
+     * Returns the FrameArena of the calling thread. Each thread has its own instance,
+     * which is created when this function is called for the first time on that thread.
+     *
+     * \return The FrameArena of the calling thread
+     */
+    static FrameArena& threadLocal();
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) final;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) final;
+    bool do_is_equal(const pmr::memory_resource& other) const noexcept final;
+
+    struct Chunk {
+        std::unique_ptr<std::byte[]> data;
+        size_t size = 0;
+    };
+
+    /// All chunks that have been requested from the system
+    std::vector<Chunk> _chunks;
+    /// The position of the next allocation
+    Marker _position;
+    /// The size of newly created chunks
+    const size_t _chunkSize;
+};
+
+/// A `std::vector` that is meant to be used with a FrameArena
+template <typename T>
+using frame_vector = pmr::vector<T>;
+
+/// A `std::string` that is meant to be used with a FrameArena
+using frame_string = pmr::string;
+
+} // namespace ghoul
+
+#endif // __GHOUL___FRAMEARENA___H__
@@ -0,0 +1,475 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2026                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __GHOUL___FUTURE___H__
+#define __GHOUL___FUTURE___H__
+
+#include <ghoul/misc/threadpool.h>
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace ghoul {
+
+template <typename T> class Future;
+template <typename T> class Promise;
+template <typename T> struct WhenAnyResult;
+
+namespace detail {
+
+/// A type-erased function that is called once the shared state of a Future is ready
+struct FutureCallback {
+    virtual ~FutureCallback() = default;
+    virtual void operator()() = 0;
+};
+
+/// The state that is shared between a Promise and the Future that was created from it
+template <typename T>
+struct FutureState {
+    /// The type in which the value is stored; `void` values are stored as monostate
+    using Value = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+    /**
+     * Calls the \p callback once this state is ready. If the state is already ready,
+     * the \p callback is called immediately on the calling thread, otherwise it is
+     * called on the thread that completes the state.
+     */
+    template <typename Callback>
+    void addCallback(Callback&& callback);
+
+    /// Stores the \p value and calls all callbacks that have been added so far
+    template <typename... V>
+    void setValue(V&&... value);
+
+    /// Stores the \p e and calls all callbacks that have been added so far
+    void setException(std::exception_ptr e);
+
+    /// Calls all registered callbacks after the value or exception has been set
+    void complete(std::unique_lock<std::mutex> lock);
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::atomic_bool isReady = false;
+    std::optional<Value> value;
+    std::exception_ptr exception;
+    std::vector<std::unique_ptr<FutureCallback>> callbacks;
+
+    /// The ThreadPool onto which continuations are scheduled if none is specified
+    ThreadPool* pool = nullptr;
+};
+
+/// Removes one level of Future from \p T, so that continuations returning a Future can
+/// be flattened
+template <typename T> struct UnwrapFuture { using type = T; };
+template <typename T> struct UnwrapFuture<Future<T>> { using type = T; };
+
+/// The type returned by a continuation \p F that is called with the value of a
+/// `Future<T>`
+template <typename T, typename F>
+struct ContinuationResult { using type = std::invoke_result_t<F, T>; };
+template <typename F>
+struct ContinuationResult<void, F> { using type = std::invoke_result_t<F>; };
+
+/// The value type of the Future that is returned by `Future<T>::then(F)`
+template <typename T, typename F>
+using ThenResult = typename UnwrapFuture<typename ContinuationResult<T, F>::type>::type;
+
+/// The value type of the Future that is returned by whenAll
+template <typename T> struct WhenAllResult { using type = std::vector<T>; };
+template <> struct WhenAllResult<void> { using type = void; };
+
+/// The promise type that is used if a Future is the return type of a coroutine
+template <typename T> struct CoroutinePromise;
+
+/// The awaitable returned by resumeOn
+struct ResumeOnAwaiter {
+    bool await_ready() const noexcept;
+    void await_suspend(std::coroutine_handle<> handle);
+    void await_resume() const noexcept;
+
+    ThreadPool& pool;
+};
+
+} // namespace detail
+
+/**
+ * A Promise is the producing side of a Future. The value or the exception that is
+ * passed to the Promise becomes available through the Future that is returned from
+ * #future. If a Promise is destroyed before a value or an exception was set, the Future
+ * will throw an `std::future_error` with the `std::future_errc::broken_promise` error
+ * code. In most cases, it is not necessary to use a Promise directly, as the runAsync
+ * function creates one for a task that is executed on a ThreadPool.
+ *
+ * \tparam T The type of the value that is produced, which can be `void`
+ */
+template <typename T>
+class Promise {
+public:
+    /**
+     * Creates a Promise whose Future does not have an associated ThreadPool, which means
+     * that ThreadPool has to be passed explicitly when calling Future::then.
+     */
+    Promise();
+
+    /**
+     * Creates a Promise whose Future schedules its continuations onto the \p pool if no
+     * other ThreadPool is passed to Future::then.
+     *
+     * \param pool The ThreadPool that is used for the continuations of the Future
+     */
+    explicit Promise(ThreadPool& pool);
+
+    Promise(Promise&&) noexcept = default;
+    Promise& operator=(Promise&& rhs) noexcept;
+    Promise(const Promise&) = delete;
+    Promise& operator=(const Promise&) = delete;
+
+    /**
+     * Destroys the Promise. If no value or exception was set, the Future is completed
+     * with an `std::future_error` with the `std::future_errc::broken_promise` code.
+     */
+    ~Promise();
+
+    /**
+     * Returns the Future that receives the value of this Promise. This function must
+     * only be called once.
+     *
+     * \return The Future that receives the value of this Promise
+     */
+    Future<T> future();
+
+    /**
+     * Completes the Future with the passed \p value.
+     *
+     * \param value The value with which the Future is completed
+     *
+     * \pre No value or exception must have been set before
+     */
+    template <typename V>
+        requires (std::is_constructible_v<T, V>)
+    void setValue(V&& value);
+
+    /**
+     * Completes the Future of a Promise without a value.
+     *
+     * \pre No value or exception must have been set before
+     */
+    void setValue() requires (std::is_void_v<T>);
+
+    /**
+     * Completes the Future with the exception \p e, which is rethrown by Future::get.
+     *
+     * \param e The exception with which the Future is completed
+     *
+     * \pre No value or exception must have been set before
+     */
+    void setException(std::exception_ptr e);
+
+private:
+    std::shared_ptr<detail::FutureState<T>> _state;
+    bool _futureRetrieved = false;
+};
+
+namespace detail {
+
+template <typename T>
+struct CoroutinePromiseBase {
+    Future<T> get_return_object();
+    std::suspend_never initial_suspend() noexcept;
+    std::suspend_never final_suspend() noexcept;
+    void unhandled_exception();
+
+    Promise<T> promise;
+};
+
+template <typename T>
+struct CoroutinePromise : CoroutinePromiseBase<T> {
+    template <typename V>
+    void return_value(V&& value);
+};
+
+template <>
+struct CoroutinePromise<void> : CoroutinePromiseBase<void> {
+    void return_void();
+};
+
+} // namespace detail
+
+/**
+ * A Future holds a value that will be produced at a later point in time, usually by a
+ * task that is executed on a ThreadPool through the runAsync function. In contrast to
+ * `std::future`, it is possible to attach a continuation to a Future through the #then
+ * function. The continuation is executed on a ThreadPool as soon as the value is
+ * available, so that multiple steps that depend on each other can be chained without
+ * any thread blocking while waiting for the previous step. Multiple Future%s can be
+ * combined using the whenAll and whenAny functions.
+ *
+ * Example use-case:
+ * ```
+ * ghoul::Future<Geometry> geometry = ghoul::runAsync(pool, [path]() {
+ *         return readFile(path);
+ *     })
+ *     .then([](std::vector<std::byte> data) { return decodeImage(std::move(data)); })
+ *     .then([](Image image) { return uploadAsync(std::move(image)); })
+ *     .then([](Texture texture) { return assembleGeometry(std::move(texture)); });
+ * ```
+ *
+ * If a continuation returns a Future itself, as `uploadAsync` in the example above, the
+ * Future returned from #then is only completed once that inner Future is completed. If
+ * a step throws an exception, all following continuations are skipped and the
+ * exception is rethrown when calling #get on the last Future.
+ *
+ * Future%s can also be used with C++20 coroutines. A Future can be `co_await`ed, which
+ * suspends the coroutine until the value is available, and a coroutine can return a
+ * Future, which is completed with the result of `co_return`. The resumeOn function
+ * returns an awaitable that continues the coroutine on a Worker of a ThreadPool:
+ * ```
+ * ghoul::Future<Geometry> loadGeometry(ghoul::ThreadPool& pool, std::string path) {
+ *     co_await ghoul::resumeOn(pool);
+ *     Image image = co_await loadImageAsync(pool, std::move(path));
+ *     Texture texture = co_await uploadAsync(std::move(image));
+ *     co_return assembleGeometry(std::move(texture));
+ * }
+ * ```
+ *
+ * A Future is a move-only type and its value can only be retrieved once, either through
+ * #get, #then, or `co_await`. The ThreadPool that is used to execute the continuations
+ * must outlive the Future and all of its continuations.
+ *
+ * \tparam T The type of the value that is produced, which can be `void`
+ */
+template <typename T>
+class Future {
+public:
+    using promise_type = detail::CoroutinePromise<T>;
+
+    /**
+     * Creates an invalid Future that does not refer to any value.
+     */
+    Future() = default;
+
+    Future(Future&&) noexcept = default;
+    Future& operator=(Future&&) noexcept = default;
+    Future(const Future&) = delete;
+    Future& operator=(const Future&) = delete;
+
+    /**
+     * Returns whether this Future refers to a value. A Future is invalid if it was
+     * default constructed, moved from, or if its value was consumed by #get, #then, or
+     * `co_await`.
+     *
+     * \return `true` if this Future refers to a value
+     */
+    bool isValid() const;
+
+    /**
+     * Returns whether the value or exception of this Future is available, meaning that
+     * #get will not block.
+     *
+     * \return `true` if the value of this Future is available
+     *
+     * \pre This Future must be valid
+     */
+    bool isReady() const;
+
+    /**
+     * Blocks the calling thread until the value or exception of this Future is
+     * available.
+     *
+     * \pre This Future must be valid
+     */
+    void wait() const;
+
+    /**
+     * Waits until the value of this Future is available and returns it. If the Future
+     * was completed with an exception, that exception is rethrown instead. Afterwards,
+     * this Future is no longer valid.
+     *
+     * \return The value of this Future
+     *
+     * \pre This Future must be valid
+     */
+    T get();
+
+    /**
+     * Attaches the \p continuation to this Future, which is queued on the ThreadPool
+     * that is associated with this Future once the value is available. The continuation
+     * is called with the value of this Future, or without any argument if this is a
+     * `Future<void>`. If this Future is completed with an exception, the continuation is
+     * not called and the returned Future is completed with the same exception.
+     * Afterwards, this Future is no longer valid.
+     *
+     * \tparam F A callable object that accepts the value of this Future
+     * \param continuation The function that is called with the value of this Future
+     * \return A Future containing the result of the \p continuation. If the
+     *         \p continuation returns a `Future<U>`, the result is a `Future<U>` as well
+     *
+     * \pre This Future must be valid
+     * \pre This Future must have an associated ThreadPool, which is the case for all
+     *      Future%s that are returned by runAsync and #then
+     */
+    template <typename F>
+    auto then(F&& continuation) -> Future<detail::ThenResult<T, F>>;
+
+    /**
+     * Attaches the \p continuation to this Future, which is queued on the \p pool once
+     * the value is available. Apart from the ThreadPool, this function behaves the same
+     * as the #then function above. The returned Future is associated with the \p pool.
+     *
+     * \tparam F A callable object that accepts the value of this Future
+     * \param pool The ThreadPool on which the \p continuation is executed
+     * \param continuation The function that is called with the value of this Future
+     * \return A Future containing the result of the \p continuation
+     *
+     * \pre This Future must be valid
+     */
+    template <typename F>
+    auto then(ThreadPool& pool, F&& continuation) -> Future<detail::ThenResult<T, F>>;
+
+    /// The awaitable that is used when `co_await`ing a Future
+    struct Awaiter {
+        bool await_ready() const;
+        void await_suspend(std::coroutine_handle<> handle);
+        T await_resume();
+
+        std::shared_ptr<detail::FutureState<T>> state;
+    };
+
+    /**
+     * Suspends the calling coroutine until the value of this Future is available. The
+     * coroutine is resumed on the ThreadPool associated with this Future, or on the
+     * thread that completes this Future if there is no associated ThreadPool.
+     * Afterwards, this Future is no longer valid.
+     *
+     * \return The awaitable whose result is the value of this Future
+     *
+     * \pre This Future must be valid
+     */
+    Awaiter operator co_await();
+
+private:
+    template <typename U> friend class Promise;
+    template <typename U> friend class Future;
+    template <typename U>
+    friend auto whenAll(std::vector<Future<U>> futures)
+        -> Future<typename detail::WhenAllResult<U>::type>;
+    template <typename U>
+    friend auto whenAny(std::vector<Future<U>> futures) -> Future<WhenAnyResult<U>>;
+
+    explicit Future(std::shared_ptr<detail::FutureState<T>> state);
+
+    /// Calls the \p continuation with the value of the completed \p state and passes
+    /// its result on to the \p promise
+    template <typename U, typename F>
+    static void runContinuation(detail::FutureState<T>& state, Promise<U>& promise,
+                                F& continuation);
+
+    std::shared_ptr<detail::FutureState<T>> _state;
+};
+
+/**
+ * The result of the whenAny function. The \p index is the index of the Future that was
+ * completed first and \p futures contains all of the Future%s that were passed to
+ * whenAny in their original order.
+ */
+template <typename T>
+struct WhenAnyResult {
+    size_t index = 0;
+    std::vector<Future<T>> futures;
+};
+
+/**
+ * Executes the \p function with the passed \p arguments on the \p pool and returns a
+ * Future containing the result. The returned Future is associated with the \p pool, so
+ * continuations that are attached to it are executed on the same ThreadPool. Exceptions
+ * thrown by the \p function are rethrown by Future::get.
+ *
+ * \tparam F The description of the \p function%'s signature that will be called
+ * \tparam Args A variable list of arguments that can be passed to the \p function
+ * \param pool The ThreadPool on which the \p function is executed
+ * \param function The function that will be called
+ * \param arguments The potential list of arguments passed to the \p function
+ * \return A Future containing the result of the \p function
+ */
+template <typename F, typename... Args>
+auto runAsync(ThreadPool& pool, F&& function, Args&&... arguments)
+    -> Future<std::invoke_result_t<F, Args...>>;
+
+/**
+ * Returns a Future that is completed once all of the \p futures are completed. For
+ * `Future<void>`, the returned Future is a `Future<void>`; otherwise, it contains the
+ * values of all \p futures in the same order. If any of the \p futures was completed
+ * with an exception, the returned Future is completed with the exception of the first
+ * such Future in the list. The returned Future is associated with the ThreadPool of the
+ * first of the \p futures.
+ *
+ * \tparam T The value type of the \p futures
+ * \param futures The Future%s that are combined
+ * \return A Future that is completed once all \p futures are completed
+ *
+ * \pre All \p futures must be valid
+ */
+template <typename T>
+auto whenAll(std::vector<Future<T>> futures)
+    -> Future<typename detail::WhenAllResult<T>::type>;
+
+/**
+ * Returns a Future that is completed as soon as one of the \p futures is completed. The
+ * result contains the index of that Future together with all \p futures, so that the
+ * value of the completed one can be retrieved and the others can still be used. The
+ * returned Future is associated with the ThreadPool of the first of the \p futures.
+ *
+ * \tparam T The value type of the \p futures
+ * \param futures The Future%s of which the first completed one is determined
+ * \return A Future that is completed once any of the \p futures is completed
+ *
+ * \pre \p futures must not be empty
+ * \pre All \p futures must be valid
+ */
+template <typename T>
+auto whenAny(std::vector<Future<T>> futures) -> Future<WhenAnyResult<T>>;
+
+/**
+ * Returns an awaitable that, when `co_await`ed in a coroutine, suspends the coroutine
+ * and resumes it on one of the Worker%s of the \p pool.
+ *
+ * \param pool The ThreadPool on which the coroutine is resumed
+ * \return The awaitable that moves a coroutine onto the \p pool
+ */
+detail::ResumeOnAwaiter resumeOn(ThreadPool& pool);
+
+} // namespace ghoul
+
+#include "future.inl"
+
+#endif // __GHOUL___FUTURE___H__
@@ -0,0 +1,468 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2026                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <ghoul/misc/assert.h>
+#include <functional>
+#include <future>
+#include <utility>
+
+namespace ghoul {
+
+namespace detail {
+
+template <typename T>
+template <typename Callback>
+void FutureState<T>::addCallback(Callback&& callback) {
+    struct Impl final : FutureCallback {
+        explicit Impl(Callback&& c) : function(std::forward<Callback>(c)) {}
+        void operator()() override { function(); }
+
+        std::decay_t<Callback> function;
+    };
+
+    {
+        const std::lock_guard lock(mutex);
+        if (!isReady) {
+            callbacks.push_back(std::make_unique<Impl>(std::forward<Callback>(callback)));
+            return;
+        }
+    }
+    callback();
+}
+
+template <typename T>
+template <typename... V>
+void FutureState<T>::setValue(V&&... v) {
+    std::unique_lock lock(mutex);
+    ghoul_assert(!isReady, "Promise must not be completed twice");
+    value.emplace(std::forward<V>(v)...);
+    complete(std::move(lock));
+}
+
+template <typename T>
+void FutureState<T>::setException(std::exception_ptr e) {
+    std::unique_lock lock(mutex);
+    ghoul_assert(!isReady, "Promise must not be completed twice");
+    exception = std::move(e);
+    complete(std::move(lock));
+}
+
+template <typename T>
+void FutureState<T>::complete(std::unique_lock<std::mutex> lock) {
+    isReady = true;
+    std::vector<std::unique_ptr<FutureCallback>> cbs = std::move(callbacks);
+    lock.unlock();
+
+    cv.notify_all();
+    for (const std::unique_ptr<FutureCallback>& callback : cbs) {
+        (*callback)();
+    }
+}
+
+template <typename T>
+Future<T> CoroutinePromiseBase<T>::get_return_object() {
+    return promise.future();
+}
+
+template <typename T>
+std::suspend_never CoroutinePromiseBase<T>::initial_suspend() noexcept {
+    return {};
+}
+
+template <typename T>
+std::suspend_never CoroutinePromiseBase<T>::final_suspend() noexcept {
+    return {};
+}
+
+template <typename T>
+void CoroutinePromiseBase<T>::unhandled_exception() {
+    promise.setException(std::current_exception());
+}
+
+template <typename T>
+template <typename V>
+void CoroutinePromise<T>::return_value(V&& value) {
+    this->promise.setValue(std::forward<V>(value));
+}
+
+inline void CoroutinePromise<void>::return_void() {
+    promise.setValue();
+}
+
+} // namespace detail
+
+template <typename T>
+Promise<T>::Promise()
+    : _state(std::make_shared<detail::FutureState<T>>())
+{}
+
+template <typename T>
+Promise<T>::Promise(ThreadPool& pool)
+    : Promise()
+{
+    _state->pool = &pool;
+}
+
+template <typename T>
+Promise<T>& Promise<T>::operator=(Promise&& rhs) noexcept {
+    if (this != &rhs) {
+        Promise<T> old = std::move(*this);
+        _state = std::move(rhs._state);
+        _futureRetrieved = rhs._futureRetrieved;
+    }
+    return *this;
+}
+
+template <typename T>
+Promise<T>::~Promise() {
+    // Only this Promise can complete the state, so there is no race on 'isReady'
+    if (_state && !_state->isReady) {
+        _state->setException(
+            std::make_exception_ptr(std::future_error(std::future_errc::broken_promise))
+        );
+    }
+}
+
+template <typename T>
+Future<T> Promise<T>::future() {
+    ghoul_assert(_state, "Promise must be valid");
+    ghoul_assert(!_futureRetrieved, "Future must only be retrieved once");
+    _futureRetrieved = true;
+    return Future<T>(_state);
+}
+
+template <typename T>
+template <typename V>
+    requires (std::is_constructible_v<T, V>)
+void Promise<T>::setValue(V&& value) {
+    ghoul_assert(_state, "Promise must be valid");
+    _state->setValue(std::forward<V>(value));
+}
+
+template <typename T>
+void Promise<T>::setValue() requires (std::is_void_v<T>) {
+    ghoul_assert(_state, "Promise must be valid");
+    _state->setValue(std::monostate());
+}
+
+template <typename T>
+void Promise<T>::setException(std::exception_ptr e) {
+    ghoul_assert(_state, "Promise must be valid");
+    _state->setException(std::move(e));
+}
+
+template <typename T>
+Future<T>::Future(std::shared_ptr<detail::FutureState<T>> state)
+    : _state(std::move(state))
+{}
+
+template <typename T>
+bool Future<T>::isValid() const {
+    return _state != nullptr;
+}
+
+template <typename T>
+bool Future<T>::isReady() const {
+    ghoul_assert(isValid(), "Future must be valid");
+    return _state->isReady;
+}
+
+template <typename T>
+void Future<T>::wait() const {
+    ghoul_assert(isValid(), "Future must be valid");
+    std::unique_lock lock(_state->mutex);
+    _state->cv.wait(lock, [s = _state.get()]() { return s->isReady.load(); });
+}
+
+template <typename T>
+T Future<T>::get() {
+    wait();
+    std::shared_ptr<detail::FutureState<T>> state = std::move(_state);
+    if (state->exception) {
+        std::rethrow_exception(state->exception);
+    }
+    if constexpr (!std::is_void_v<T>) {
+        return std::move(*state->value);
+    }
+}
+
+template <typename T>
+template <typename F>
+auto Future<T>::then(F&& continuation) -> Future<detail::ThenResult<T, F>> {
+    ghoul_assert(isValid(), "Future must be valid");
+    ghoul_assert(_state->pool, "Future must have an associated ThreadPool");
+    return then(*_state->pool, std::forward<F>(continuation));
+}
+
+template <typename T>
+template <typename F>
+auto Future<T>::then(ThreadPool& pool, F&& continuation)
+    -> Future<detail::ThenResult<T, F>>
+{
+    ghoul_assert(isValid(), "Future must be valid");
+
+    using U = detail::ThenResult<T, F>;
+    Promise<U> promise(pool);
+    Future<U> result = promise.future();
+
+    // The callback only queues the continuation, so that the thread that completes this
+    // Future does not have to execute it. Capturing the state in its own callback is not
+    // a cycle that leaks as the callbacks are released once the state is completed
+    std::shared_ptr<detail::FutureState<T>> state = std::move(_state);
+    detail::FutureState<T>* s = state.get();
+    s->addCallback(
+        [&pool, state = std::move(state), promise = std::move(promise),
+         f = std::forward<F>(continuation)]() mutable
+        {
+            pool.submit(
+                [state = std::move(state), promise = std::move(promise),
+                 f = std::move(f)]() mutable
+                {
+                    runContinuation(*state, promise, f);
+                }
+            );
+        }
+    );
+    return result;
+}
+
+template <typename T>
+template <typename U, typename F>
+void Future<T>::runContinuation(detail::FutureState<T>& state, Promise<U>& promise,
+                                F& continuation)
+{
+    if (state.exception) {
+        promise.setException(state.exception);
+        return;
+    }
+
+    using R = typename detail::ContinuationResult<T, F>::type;
+    try {
+        auto call = [&]() -> R {
+            if constexpr (std::is_void_v<T>) {
+                return std::invoke(continuation);
+            }
+            else {
+                return std::invoke(continuation, std::move(*state.value));
+            }
+        };
+
+        if constexpr (!std::is_same_v<R, U>) {
+            // The continuation returned a Future, whose result becomes the result of
+            // the Future that was returned from 'then'
+            std::shared_ptr<detail::FutureState<U>> inner = call()._state;
+            ghoul_assert(inner, "Continuation must return a valid Future");
+            detail::FutureState<U>* i = inner.get();
+            i->addCallback(
+                [inner = std::move(inner), promise = std::move(promise)]() mutable {
+                    if (inner->exception) {
+                        promise.setException(inner->exception);
+                    }
+                    else if constexpr (std::is_void_v<U>) {
+                        promise.setValue();
+                    }
+                    else {
+                        promise.setValue(std::move(*inner->value));
+                    }
+                }
+            );
+        }
+        else if constexpr (std::is_void_v<R>) {
+            call();
+            promise.setValue();
+        }
+        else {
+            promise.setValue(call());
+        }
+    }
+    catch (...) {
+        promise.setException(std::current_exception());
+    }
+}
+
+template <typename T>
+bool Future<T>::Awaiter::await_ready() const {
+    return state->isReady;
+}
+
+template <typename T>
+void Future<T>::Awaiter::await_suspend(std::coroutine_handle<> handle) {
+    ThreadPool* pool = state->pool;
+    state->addCallback([pool, handle]() {
+        if (pool) {
+            pool->submit([handle]() { handle.resume(); });
+        }
+        else {
+            handle.resume();
+        }
+    });
+}
+
+template <typename T>
+T Future<T>::Awaiter::await_resume() {
+    return Future<T>(std::move(state)).get();
+}
+
+template <typename T>
+typename Future<T>::Awaiter Future<T>::operator co_await() {
+    ghoul_assert(isValid(), "Future must be valid");
+    return Awaiter{ .state = std::move(_state) };
+}
+
+template <typename F, typename... Args>
+auto runAsync(ThreadPool& pool, F&& function, Args&&... arguments)
+    -> Future<std::invoke_result_t<F, Args...>>
+{
+    using R = std::invoke_result_t<F, Args...>;
+
+    Promise<R> promise(pool);
+    Future<R> future = promise.future();
+    pool.submit(
+        [promise = std::move(promise), f = std::forward<F>(function),
+         ...args = std::forward<Args>(arguments)]() mutable
+        {
+            try {
+                if constexpr (std::is_void_v<R>) {
+                    std::invoke(f, args...);
+                    promise.setValue();
+                }
+                else {
+                    promise.setValue(std::invoke(f, args...));
+                }
+            }
+            catch (...) {
+                promise.setException(std::current_exception());
+            }
+        }
+    );
+    return future;
+}
+
+template <typename T>
+auto whenAll(std::vector<Future<T>> futures)
+    -> Future<typename detail::WhenAllResult<T>::type>
+{
+    using R = typename detail::WhenAllResult<T>::type;
+
+    struct Shared {
+        std::vector<Future<T>> futures;
+        std::atomic_size_t nRemaining;
+        Promise<R> promise;
+    };
+
+    ThreadPool* pool = futures.empty() ? nullptr : futures.front()._state->pool;
+    auto shared = std::make_shared<Shared>();
+    shared->promise = pool ? Promise<R>(*pool) : Promise<R>();
+    Future<R> result = shared->promise.future();
+    if (futures.empty()) {
+        if constexpr (std::is_void_v<R>) {
+            shared->promise.setValue();
+        }
+        else {
+            shared->promise.setValue(R());
+        }
+        return result;
+    }
+
+    // The callbacks might be called immediately, so we have to collect the states
+    // before passing the futures on to the shared state
+    std::vector<detail::FutureState<T>*> states;
+    states.reserve(futures.size());
+    for (const Future<T>& f : futures) {
+        ghoul_assert(f.isValid(), "All futures must be valid");
+        states.push_back(f._state.get());
+    }
+    shared->nRemaining = futures.size();
+    shared->futures = std::move(futures);
+
+    for (detail::FutureState<T>* state : states) {
+        state->addCallback([shared]() {
+            if (--shared->nRemaining > 0) {
+                return;
+            }
+
+            // All futures are completed, so we are the only ones accessing them now
+            for (Future<T>& f : shared->futures) {
+                if (f._state->exception) {
+                    shared->promise.setException(f._state->exception);
+                    return;
+                }
+            }
+            if constexpr (std::is_void_v<R>) {
+                shared->promise.setValue();
+            }
+            else {
+                R values;
+                values.reserve(shared->futures.size());
+                for (Future<T>& f : shared->futures) {
+                    values.push_back(std::move(*f._state->value));
+                }
+                shared->promise.setValue(std::move(values));
+            }
+            shared->futures.clear();
+        });
+    }
+    return result;
+}
+
+template <typename T>
+auto whenAny(std::vector<Future<T>> futures) -> Future<WhenAnyResult<T>> {
+    ghoul_assert(!futures.empty(), "There must be at least one future");
+
+    struct Shared {
+        std::vector<Future<T>> futures;
+        std::atomic_bool isDone = false;
+        Promise<WhenAnyResult<T>> promise;
+    };
+
+    ThreadPool* pool = futures.front()._state->pool;
+    auto shared = std::make_shared<Shared>();
+    using R = WhenAnyResult<T>;
+    shared->promise = pool ? Promise<R>(*pool) : Promise<R>();
+    Future<R> result = shared->promise.future();
+
+    // The first callback moves the futures out of the shared state, which might happen
+    // while we are still adding the callbacks, so we have to collect the states first
+    std::vector<std::shared_ptr<detail::FutureState<T>>> states;
+    states.reserve(futures.size());
+    for (const Future<T>& f : futures) {
+        ghoul_assert(f.isValid(), "All futures must be valid");
+        states.push_back(f._state);
+    }
+    shared->futures = std::move(futures);
+
+    for (size_t i = 0; i < states.size(); i++) {
+        states[i]->addCallback([shared, i]() {
+            if (!shared->isDone.exchange(true)) {
+                shared->promise.setValue(
+                    WhenAnyResult<T>{ .index = i, .futures = std::move(shared->futures) }
+                );
+            }
+        });
+    }
+    return result;
+}
+
+} // namespace ghoul
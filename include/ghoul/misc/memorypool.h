@@ -27,8 +27,14 @@
 #define __GHOUL___MEMORYPOOL___H__
 
 #include <array>
+#include <atomic>
+#include <bit>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
 
 #if (defined(__linux__) && defined(__clang__))
 #include <experimental/memory_resource>
@@ -42,29 +48,105 @@ namespace pmr = std::pmr;
 
 namespace ghoul {
 
+/**
+ * Determines from where the memory for the buckets of a MemoryPool is requested.
+ */
+enum class BucketBacking {
+    /// The buckets are allocated on the heap using the global `operator new`
+    Heap,
+    /// Each bucket is mapped directly from the operating system using normal pages
+    Pages,
+    /// Each bucket is mapped directly from the operating system using huge pages, which
+    /// reduces the number of TLB misses when accessing large buckets randomly. If no
+    /// explicit huge pages are available, transparent huge pages are requested instead
+    /// and if those are not supported either, normal pages are used
+    HugePages
+};
+
+namespace detail {
+
+/**
+ * The memory of a single bucket, which is allocated according to a BucketBacking and
+ * returned to the operating system when this object is destroyed.
+ */
+struct BucketMemory {
+    /**
+     * Allocates a block of memory of at least \p size bytes using the \p backing.
+     *
+     * \param size The minimum number of bytes of the block
+     * \param backing The requested way in which the memory should be allocated
+     *
+     * \throw std::bad_alloc If the memory could not be allocated
+     * \pre \p size must be positive
+     */
+    BucketMemory(size_t size, BucketBacking backing);
+    ~BucketMemory();
+
+    BucketMemory(const BucketMemory&) = delete;
+    BucketMemory& operator=(const BucketMemory&) = delete;
+
+    /// The beginning of the memory block
+    std::byte* data = nullptr;
+    /// The number of bytes that were reserved, which might be larger than requested
+    size_t size = 0;
+    /// The way in which the memory was actually allocated after all fallbacks
+    BucketBacking backing = BucketBacking::Heap;
+};
+
+} // namespace detail
+
 /**
  * This class represents a MemoryPool with a specific size from which individual memory
  * blocks can be requested. The MemoryPool is organized into multiple separate buckets
  * with a specific size. The number of buckets in the MemoryPool will increase until the
  * MemoryPool is destroyed or the reset method is called.
  *
+ * Memory that is deallocated is kept in segregated free lists, one for each power-of-two
+ * size class, and a bitmap records which of the lists are not empty. Allocating a block
+ * from and returning a block to the free lists therefore takes constant time regardless
+ * of how many blocks have been deallocated. A deallocated block is immediately merged
+ * with free blocks of the same bucket that directly precede or follow it, so that larger
+ * blocks become available again without having to call #housekeeping. Each free block
+ * stores its index at its beginning and its end, which are used to find the neighbors
+ * without any additional allocations. All blocks are therefore a multiple of
+ * #Granularity bytes long.
+ *
+ * If no free block fits, the new block is taken from the end of the current bucket. Once
+ * a block does not fit into the current bucket anymore, its remaining space is returned
+ * to the free lists and the next bucket becomes the current one. The bucket of a block
+ * that is deallocated is found through a hash table of the address ranges that the
+ * buckets cover, so neither allocating nor deallocating depends on the number of buckets.
+ *
+ * The size of the buckets defaults to the \p BucketSize template parameter, but can be
+ * changed at runtime when constructing the MemoryPool. For pools with large buckets, the
+ * buckets can be mapped directly from the operating system instead of being allocated
+ * on the heap, optionally using huge pages (see BucketBacking).
+ *
  * OBS: If the MemoryPool is destroyed, all memory that was returned from the alloc method
  *      is freed, but if the memory was used to create objects, their destructors are not
  *      called
  *
- * \tparam BucketSize The size of each bucket in bytes
+ * \tparam BucketSize The default size of each bucket in bytes
  */
 template <int BucketSize = 4096, bool InjectDebugMemory = false, bool NoDealloc = false>
 class MemoryPool final : public pmr::memory_resource {
 public:
     const static int _bucketSize = BucketSize;
 
+    /// All requested sizes are rounded up to a multiple of this number of bytes
+    static constexpr size_t Granularity = 8;
+
     /**
      * Creates the MemoryBool with the specified number of buckets already created.
      *
      * \param nBuckets The number of buckets that should be created at creation time
+     * \param bucketSize The size of each bucket in bytes
+     * \param backing Determines from where the memory of the buckets is requested
+     *
+     * \pre \p bucketSize must be positive
      */
-    explicit MemoryPool(int nBuckets = 1);
+    explicit MemoryPool(int nBuckets = 1, size_t bucketSize = BucketSize,
+        BucketBacking backing = BucketBacking::Heap);
 
     /**
      * Frees the memory that was allocated during the existence of this MemoryPool.
@@ -72,9 +154,9 @@ public:
     void reset();
 
     /**
-     * Function that will make sure the list of returned pointers is nice and clean.
-     * Should be called regularly (once per frame, for example) to make sure that the list
-     * doesn't degenerate.
+     * Adjacent free blocks are merged as soon as they are deallocated, so calling this
+     * function is no longer necessary. It only remains for backwards compatibility and
+     * does nothing.
      */
     void housekeeping();
 
@@ -97,6 +179,24 @@ public:
      */
     int nBuckets() const;
 
+    /**
+     * Returns the size of each bucket in bytes as passed to the constructor.
+     */
+    size_t bucketSize() const;
+
+    /**
+     * Returns the way in which the memory of the buckets was requested. The buckets
+     * might have been allocated with a different backing if the requested one was not
+     * available, which can be checked through #nHugePageBuckets.
+     */
+    BucketBacking backing() const;
+
+    /**
+     * Returns the number of buckets whose memory is backed by huge pages, either
+     * explicitly or through transparent huge pages.
+     */
+    int nHugePageBuckets() const;
+
     /**
      * Returns the usages for each of the buckets. The number of values returned is the
      * same as returned by the \see nBuckets function.
@@ -108,24 +208,250 @@ public:
      */
     int totalOccupancy() const;
 
+    /**
+     * Statistics about the memory that has been deallocated and is available for reuse.
+     */
+    struct FragmentationStatistics {
+        /// The number of separate free blocks
+        int nFreeBlocks = 0;
+        /// The total number of bytes in all free blocks
+        int freeBytes = 0;
+        /// The size of the largest free block in bytes
+        int largestFreeBlock = 0;
+        /// The fraction of the free memory that is not part of the largest free block.
+        /// 0 means that all free memory is available in a single block
+        double fragmentation = 0.0;
+    };
+
+    /**
+     * Returns statistics about the deallocated memory that is waiting to be reused. The
+     * deallocated memory is still included in the #occupancies.
+     */
+    FragmentationStatistics fragmentationStatistics() const;
+
 private:
     struct Bucket {
+        Bucket(size_t size, BucketBacking backing);
+
         /// The number of bytes that have been used in this Bucket
         size_t usage = 0;
         /// The bucket's data storage
-        std::array<std::byte, BucketSize> payload;
+        detail::BucketMemory payload;
     };
 
-    struct EmptyPair {
-        void* ptr = nullptr;
+    /// Creates a new bucket and registers its payload
+    Bucket& createBucket();
+
+    /// Registers the payload of the \p bucket in #_bucketRanges
+    void registerBucket(const Bucket& bucket);
+
+    /// Returns the bucket whose payload contains \p p or `nullptr` if there is none
+    const Bucket* findBucket(const std::byte* p) const;
+
+    /// A block of memory that has been deallocated
+    struct FreeBlock {
+        /// The beginning of the block or `nullptr` if this entry is currently unused
+        std::byte* ptr = nullptr;
         size_t size = 0;
+        /// The index of the previous FreeBlock in the same free list or -1
+        int previous = -1;
+        /// The index of the next FreeBlock in the same free list or -1
+        int next = -1;
     };
-    std::vector<EmptyPair> _emptyList;
+
+    /// The number of size classes; size class i contains blocks of [2^i, 2^(i+1)) bytes
+    static constexpr int NSizeClasses = 64;
+
+    /// Returns the size class that contains blocks of \p bytes bytes
+    static int sizeClass(size_t bytes);
+
+    /// Adds a free block at \p ptr with \p size bytes to the free lists
+    void addFreeBlock(std::byte* ptr, size_t size);
+
+    /// Removes the FreeBlock with the index \p i from the free lists
+    void removeFreeBlock(int i);
+
+    /// Returns the index of the FreeBlock that ends at \p p in the \p bucket or -1
+    int freeBlockEndingAt(const Bucket& bucket, const std::byte* p) const;
+
+    /// Returns the index of the FreeBlock that starts at \p p in the \p bucket or -1
+    int freeBlockStartingAt(const Bucket& bucket, const std::byte* p) const;
+
+    /// Adds the block at \p p with \p size bytes of the \p bucket to the free lists
+    /// after merging it with the free blocks directly before and after it
+    void releaseBlock(const Bucket& bucket, std::byte* p, size_t size);
+
+    /// Storage for all FreeBlocks, which are linked through their indices
+    std::vector<FreeBlock> _freeBlocks;
+    /// The indices of entries in _freeBlocks that are currently not used
+    std::vector<int> _unusedFreeBlocks;
+    /// The first FreeBlock of each size class or -1 if the size class is empty
+    std::array<int, NSizeClasses> _freeLists;
+    /// Bit i is set if the free list of size class i is not empty
+    uint64_t _freeListBitmap = 0;
+    /// The buckets whose payloads overlap an address range of 2^#_rangeShift bytes,
+    /// indexed by the address of the range shifted by #_rangeShift. As no payload is
+    /// larger than a range, at most three payloads can overlap the same range
+    std::unordered_map<uintptr_t, std::array<const Bucket*, 3>> _bucketRanges;
 
     /// The number of allocated buckets
     std::vector<std::unique_ptr<Bucket>> _buckets;
+    /// The index of the bucket from which new blocks are taken if the free lists don't
+    /// contain a fitting block. All buckets before it are full
+    size_t _currentBucket = 0;
     /// The original desired number of buckets
     const int _originalBucketSize;
+    /// The size of each bucket in bytes
+    const size_t _payloadSize;
+    /// The requested backing of the buckets
+    const BucketBacking _backing;
+    /// The binary logarithm of the size of the address ranges in #_bucketRanges, which
+    /// is the smallest power of two that is at least the size of a bucket
+    const int _rangeShift;
+};
+
+/**
+ * This class is a thread-safe variant of the MemoryPool that can be shared between
+ * multiple threads, for example the Worker%s of a ThreadPool. Each thread that
+ * allocates memory from the ConcurrentMemoryPool receives its own cache, so that
+ * allocating and deallocating memory on the same thread does not need any locks or
+ * atomic read-modify-write operations. Only when a thread's cache has run out of memory,
+ * it refills from a shared list of buckets, which is protected by a mutex.
+ *
+ * Memory is handed out in blocks whose size is the next power of two of the requested
+ * size, starting at 16 bytes. Each bucket only contains blocks of a single size and
+ * belongs to the cache of the thread that first requested it. Memory can be deallocated
+ * from any thread; if the deallocating thread is not the owner of the bucket, the block
+ * is pushed onto a lock-free list of the owning cache, from which the owner takes all
+ * blocks at once once its own free list is empty. Requests that are larger than
+ * #MaxBlockSize bytes are passed directly to the global `operator new`.
+ *
+ * If a thread terminates, its cache is kept alive by the ConcurrentMemoryPool and is
+ * adopted by the next thread that requests a new cache, so that the memory in it is not
+ * lost if threads are created and destroyed repeatedly.
+ *
+ * OBS: If the ConcurrentMemoryPool is destroyed, all memory that was returned from the
+ *      allocate method is freed, but if the memory was used to create objects, their
+ *      destructors are not called
+ *
+ * \tparam BucketSize The size of each bucket in bytes, which must be a power of two
+ */
+template <int BucketSize = 65536>
+class ConcurrentMemoryPool final : public pmr::memory_resource {
+public:
+    static_assert(
+        BucketSize >= 1024 && (BucketSize & (BucketSize - 1)) == 0,
+        "BucketSize must be a power of two and at least 1024"
+    );
+
+    /// The largest block size that is served from the buckets
+    static constexpr size_t MaxBlockSize = BucketSize / 8;
+
+    /**
+     * Creates the ConcurrentMemoryPool with the specified number of buckets already
+     * created. These buckets are handed out to the threads' caches on demand.
+     *
+     * \param nBuckets The number of buckets that should be created at creation time
+     */
+    explicit ConcurrentMemoryPool(int nBuckets = 0);
+
+    /**
+     * Returns a pointer to an allocated object of type T. The parameters to this function
+     * are passed on to the contructor of T.
+     *
+     * \tparam T The type of the object that is to be constructed
+     * \param args The arguments to the constructor of T
+     */
+    template <typename T, class... Types>
+    T* alloc(Types&&... args);
+
+    void* do_allocate(size_t bytes, size_t alignment) final;
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) final;
+    bool do_is_equal(const pmr::memory_resource& other) const noexcept final;
+
+    /**
+     * Returns the number of buckets that have been allocated.
+     */
+    int nBuckets() const;
+
+    /**
+     * Returns the number of thread caches that have been created, which is the largest
+     * number of threads that have used this ConcurrentMemoryPool at the same time.
+     */
+    int nThreadCaches() const;
+
+private:
+    /// The number of different block sizes; from 16 bytes to MaxBlockSize
+    static constexpr int NSizeClasses = std::bit_width(MaxBlockSize) - 4;
+
+    /// A free block of memory, which stores the pointer to the next free block
+    struct Block {
+        Block* next = nullptr;
+    };
+
+    struct ThreadCache {
+        /// The free blocks of each size class that can only be used by the owner
+        std::array<Block*, NSizeClasses> freeList = {};
+        /// The blocks that were deallocated by other threads. These are pushed by other
+        /// threads and only ever removed as a whole by the owner of this cache
+        std::array<std::atomic<Block*>, NSizeClasses> remoteFreeList = {};
+        /// Whether this cache currently belongs to a thread
+        std::atomic_bool isOwned = true;
+    };
+
+    /// The header at the beginning of each bucket
+    struct BucketHeader {
+        /// The cache to which all blocks in this bucket belong
+        ThreadCache* owner = nullptr;
+        /// The size class of all blocks in this bucket
+        int sizeClass = 0;
+    };
+
+    /// The state that is shared between all threads using this ConcurrentMemoryPool
+    struct State {
+        ~State();
+
+        std::mutex mutex;
+        /// All buckets that have been allocated
+        std::vector<std::byte*> buckets;
+        /// The buckets that have not been handed to a thread cache yet
+        std::vector<std::byte*> spareBuckets;
+        /// All thread caches that have been created
+        std::vector<std::unique_ptr<ThreadCache>> caches;
+    };
+
+    /// The thread caches of the current thread for all ConcurrentMemoryPools
+    struct LocalCaches {
+        struct Entry {
+            uint64_t poolId = 0;
+            ThreadCache* cache = nullptr;
+            std::weak_ptr<State> state;
+        };
+
+        /// Returns the caches of terminated threads to their ConcurrentMemoryPools
+        ~LocalCaches();
+
+        std::vector<Entry> entries;
+    };
+
+    /// Returns the size class that is used for the allocation of \p bytes
+    static int sizeClass(size_t bytes, size_t alignment);
+
+    /// Returns the cache of the calling thread or `nullptr` if it does not have one
+    ThreadCache* findLocalCache() const;
+
+    /// Returns the cache of the calling thread, creating or adopting one if necessary
+    ThreadCache& localCache();
+
+    /// Refills the free list of the \p cache for the \p sizeClass
+    void refill(ThreadCache& cache, int sizeClass);
+
+    std::shared_ptr<State> _state;
+    /// A unique identifier of this pool that is never reused by other pools
+    const uint64_t _id;
+
+    static inline std::atomic_uint64_t _nextId = 1;
+    static inline thread_local LocalCaches _localCaches;
 };
 
 /**
@@ -133,12 +459,42 @@ private:
  * the returned pointers can be returned to make them available again for future calls of
  * the allocate method.
  *
+ * Objects can either be created and destroyed directly through the #create and #destroy
+ * functions, which call the constructor and destructor of T, or the raw memory can be
+ * requested through #allocate and returned through #free, in which case the caller is
+ * responsible for the lifetime of the objects. Returned memory is kept in an intrusive
+ * free list, so neither creating nor destroying an object allocates any memory unless a
+ * new bucket is required.
+ *
+ * Each slot carries a generation counter that is incremented whenever the slot is
+ * returned to the pool. A Handle stores the generation at the time the object was
+ * created, which makes it possible to detect accesses to objects that have already been
+ * destroyed; in debug builds, these accesses trigger an assertion. A Handle additionally
+ * stores the number of times the pool had been reset, so that all Handles become invalid
+ * when the pool is reset.
+ *
+ * OBS: Objects that have not been destroyed when the pool is reset or destroyed do not
+ *      have their destructors called
+ *
  * \tparam T The type for which the MemoryPool should operate
  * \tparam BucketSizeItems The number of Ts that should be stored in a single Bucket
  */
 template <typename T, int BucketSizeItems = 128, bool InjectDebugMemory = false>
 class ReusableTypedMemoryPool {
 public:
+    /**
+     * A reference to an object that was created through #createHandle, which can detect
+     * if the object has been destroyed in the meantime.
+     */
+    struct Handle {
+        /// The object that is referenced by this Handle
+        T* ptr = nullptr;
+        /// The generation of the slot at the time the object was created
+        uint32_t generation = 0;
+        /// The number of times the pool had been reset when the object was created
+        uint32_t epoch = 0;
+    };
+
     /**
      * Creates the MemoryBool with the specified number of buckets already created.
      *
@@ -155,7 +511,8 @@ public:
     /**
      * Frees the memory that was allocated during the existence of this MemoryPool or the
      * last call of reset and returns the number of buckets to the initial number of
-     * buckets as requested in the constructor.
+     * buckets as requested in the constructor. All Handles that were created before are
+     * invalid afterwards.
      */
     void reset();
 
@@ -170,9 +527,18 @@ public:
      */
     std::vector<void*> allocate(int n);
 
+    /**
+     * Reserves one memory location for each entry in \p slots that is big enough to fit
+     * a single instance of T. No object is constructed in these locations.
+     *
+     * \param slots The span that receives the pointers to the memory locations
+     */
+    void allocate(std::span<T*> slots);
+
     /**
      * Returns ownership of the pointer \p ptr back to the ReusableTypedMemoryPool. This
-     * pointer will be returned in a future allocate call.
+     * pointer will be returned in a future allocate call. The destructor of the object at
+     * this location is not called.
      *
      * \param ptr The pointer that should be returned and marked for reuse. This pointer
      *            must be a pointer that has previously been returned by the allocate
@@ -180,20 +546,134 @@ public:
      */
     void free(T* ptr);
 
+    /**
+     * Returns ownership of all pointers in \p ptrs back to the ReusableTypedMemoryPool.
+     * The destructors of the objects at these locations are not called.
+     *
+     * \param ptrs The pointers that should be returned and marked for reuse
+     */
+    void free(std::span<T* const> ptrs);
+
+    /**
+     * Creates a new instance of T in the memory of this pool. The parameters to this
+     * function are passed on to the constructor of T.
+     *
+     * \param args The arguments to the constructor of T
+     * \return The newly created object, which has to be destroyed through #destroy
+     */
+    template <typename... Args>
+    T* create(Args&&... args);
+
+    /**
+     * Creates one new instance of T for each entry in \p objects, all of which are
+     * constructed from the same \p args. If one of the constructors throws, the objects
+     * that have already been created are destroyed again.
+     *
+     * \param objects The span that receives the pointers to the created objects
+     * \param args The arguments to the constructor of T
+     */
+    template <typename... Args>
+    void createN(std::span<T*> objects, const Args&... args);
+
+    /**
+     * Creates a new instance of T like #create, but returns a Handle that can be used to
+     * detect whether the object has been destroyed.
+     *
+     * \param args The arguments to the constructor of T
+     * \return The Handle to the newly created object
+     */
+    template <typename... Args>
+    Handle createHandle(Args&&... args);
+
+    /**
+     * Calls the destructor of the object \p ptr and returns its memory to the pool.
+     *
+     * \param ptr The object that should be destroyed. If it is `nullptr`, nothing happens
+     *
+     * \pre \p ptr must have been created by this pool and not been destroyed before
+     */
+    void destroy(T* ptr);
+
+    /**
+     * Destroys all objects in \p objects.
+     *
+     * \param objects The objects that should be destroyed
+     *
+     * \pre All entries in \p objects must have been created by this pool and not been
+     *      destroyed before
+     */
+    void destroyN(std::span<T* const> objects);
+
+    /**
+     * Destroys the object referenced by the \p handle.
+     *
+     * \param handle The Handle to the object that should be destroyed
+     *
+     * \pre \p handle must be valid
+     */
+    void destroy(Handle handle);
+
+    /**
+     * Returns whether the object referenced by \p handle has not been destroyed yet.
+     *
+     * \param handle The Handle that should be tested
+     * \return `true` if the object referenced by \p handle still exists
+     */
+    bool isValid(Handle handle) const;
+
+    /**
+     * Returns the object referenced by \p handle.
+     *
+     * \param handle The Handle whose object should be returned
+     * \return The object referenced by the \p handle
+     *
+     * \pre \p handle must be valid
+     */
+    T* get(Handle handle) const;
+
 private:
+    /// A single entry in a bucket, which either holds an object or is part of the free
+    /// list. The object is placed at the beginning so that the address of the object and
+    /// of the slot are the same
+    struct Slot {
+        union {
+            alignas(T) std::byte object[sizeof(T)];
+            Slot* next;
+        };
+        /// Incremented every time the slot is returned to the pool
+        uint32_t generation;
+    };
+
     struct Bucket {
-        /// The data storage of this bucket
-        std::array<std::byte, BucketSizeItems * sizeof(T)> payload;
-        /// The number of bytes that have been used in this Bucket
+        /// The data storage of this bucket, which is left uninitialized
+        std::array<Slot, BucketSizeItems> slots;
+        /// The number of slots that have been used in this Bucket
         int usage = 0;
     };
 
-    /// The list of pointers that have been returned
-    std::vector<T*> _freeList;
+    /// Creates a new bucket whose slots all start with generation 0
+    void createBucket();
+
+    /// Returns a slot from the free list or from the first bucket that has space left
+    Slot* takeSlot();
+
+    /// Returns the \p slot to the free list and invalidates all Handles to it
+    void returnSlot(Slot* slot);
+
+    /// Returns the slot in which the object \p ptr is located
+    static Slot* slot(T* ptr);
+
+    /// The slots that have been returned, linked through their next pointers
+    Slot* _freeList = nullptr;
     /// The number of allocated buckets
     std::vector<std::unique_ptr<Bucket>> _buckets;
+    /// The index of the first bucket that might have space left
+    size_t _currentBucket = 0;
     /// The original desired number of buckets
     int _originalNBuckets;
+    /// The number of times the pool has been reset. Handles from an earlier epoch are
+    /// invalid without looking at their slot, which might have been freed by the reset
+    uint32_t _epoch = 0;
 };
 
 } // namespace ghoul
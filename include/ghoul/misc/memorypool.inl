@@ -27,31 +27,98 @@
 #include <ghoul/misc/profiling.h>
 #include <algorithm>
 #include <cstring>
+#include <new>
 #include <numeric>
 #include <stdexcept>
 
 namespace {
     constexpr int DebugByte = 0x0F;
-    constexpr int AlignmentByte = 0x1F;
     constexpr int ClearByte = 0xF0;
+
+    // The type of the index that every free block stores at its beginning and its end
+    using BoundaryTag = int32_t;
+
+    constexpr size_t roundToMultiple(size_t bytes, size_t multiple) {
+        return (bytes + multiple - 1) & ~(multiple - 1);
+    }
+
+    template <typename T>
+    T* alignUp(T* p, size_t alignment) {
+        const uintptr_t address = reinterpret_cast<uintptr_t>(p);
+        const uintptr_t aligned = (address + alignment - 1) & ~(alignment - 1);
+        return p + (aligned - address);
+    }
 } // namespace
 
 namespace ghoul {
 
 template <int BucketSize, bool InjectDebugMemory, bool NoDealloc>
-MemoryPool<BucketSize, InjectDebugMemory, NoDealloc>::MemoryPool(int nBuckets)
+MemoryPool<BucketSize, InjectDebugMemory, NoDealloc>::Bucket::Bucket(size_t size,
+                                                                  BucketBacking backing)
+    : payload(size, backing)
+{}
+
+template <int BucketSize, bool InjectDebugMemory, bool NoDealloc>
+MemoryPool<BucketSize, InjectDebugMemory, NoDealloc>::MemoryPool(int nBuckets,
+                                                                 size_t bucketSize,
+                                                                 BucketBacking backing)
     : _originalBucketSize(nBuckets)
+    , _payloadSize(bucketSize)
+    , _backing(backing)
+    , _rangeShift(static_cast<int>(std::bit_width(std::max(bucketSize, size_t(2)) - 1)))
 {
+    ghoul_assert(bucketSize > 0, "bucketSize must be positive");
+
+    _freeLists.fill(-1);
+
     _buckets.reserve(nBuckets);
     for (int i = 0; i < nBuckets; i++) {
-        auto b = std::make_unique<Bucket>();
-        if (InjectDebugMemory) {
-            std::memset(b->payload.data(), DebugByte, BucketSize);
-        }
-        _buckets.push_back(std::move(b));
+        createBucket();
     }
+}
 
-    _emptyList.reserve(10);
+template <int BucketSize, bool InjectDebugMemory, bool NoDealloc>
+typename MemoryPool<BucketSize, InjectDebugMemory, NoDealloc>::Bucket&
+MemoryPool<BucketSize, InjectDebugMemory, NoDealloc>::createBucket()
+{
+    auto b = std::make_unique<Bucket>(_payloadSize, _backing);
+    if (InjectDebugMemory) {
+        std::memset(b->payload.data, DebugByte, _payloadSize);
+    }
+    registerBucket(*b);
+    _buckets.push_back(std::move(b));
+    return *_buckets.back();
+}
+
+template <int BucketSize, bool InjectDebugMemory, bool NoDealloc>
+void MemoryPool<BucketSize, InjectDebugMemory, NoDealloc>::registerBucket(
+                                                                     const Bucket& bucket)
+{
+    // As the payload is not larger than a range, it overlaps at most two ranges
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(bucket.payload.data);
+    const uintptr_t end = begin + _payloadSize - 1;
+    for (uintptr_t r = begin >> _rangeShift; r <= end >> _rangeShift; r++) {
+        std::array<const Bucket*, 3>& buckets = _bucketRanges[r];
+        auto it = std::find(buckets.begin(), buckets.end(), nullptr);
+        ghoul_assert(it != buckets.end(), "Too many buckets in the same range");
+        *it = &bucket;
+    }
+}
+
+template <int BucketSize, bool InjectDebugMemory, bool NoDealloc>
+const typename MemoryPool<BucketSize, InjectDebugMemory, NoDealloc>::Bucket*
+MemoryPool<BucketSize, InjectDebugMemory, NoDealloc>::findBucket(const std::byte* p) const
+{
+    const auto it = _bucketRanges.find(reinterpret_cast<uintptr_t>(p) >> _rangeShift);
+    if (it == _bucketRanges.end()) {
+        return nullptr;
+    }
+    for (const Bucket* b : it->second) {
+        if (b && p >= b->payload.data && p < b->payload.data + _payloadSize) {
+            return b;
+        }
+    }
+    return nullptr;
 }
 
 template <int BucketSize, bool InjectDebugMemory, bool NoDealloc>
@@ -60,47 +127,145 @@ void MemoryPool<BucketSize, InjectDebugMemory, NoDealloc>::reset() {
         b->usage = 0;
 
         if (InjectDebugMemory) {
-            std::memset(b->payload.data(), DebugByte, BucketSize);
+            std::memset(b->payload.data, DebugByte, _payloadSize);
         }
     }
     _buckets.resize(_originalBucketSize);
+    _currentBucket = 0;
+
+    _bucketRanges.clear();
+    for (const std::unique_ptr<Bucket>& b : _buckets) {
+        registerBucket(*b);
+    }
 
-    _emptyList.clear();
+    _freeBlocks.clear();
+    _unusedFreeBlocks.clear();
+    _freeLists.fill(-1);
+    _freeListBitmap = 0;
 }
 
 template <int BucketSize, bool InjectDebugMemory, bool NoDealloc>
-void MemoryPool<BucketSize, InjectDebugMemory, NoDealloc>::housekeeping() {
-    ZoneScoped;
+void MemoryPool<BucketSize, InjectDebugMemory, NoDealloc>::housekeeping() {}
 
-    if (_emptyList.empty()) {
-        return;
+template <int BucketSize, bool InjectDebugMemory, bool NoDealloc>
+int MemoryPool<BucketSize, InjectDebugMemory, NoDealloc>::sizeClass(size_t bytes) {
+    ghoul_assert(bytes > 0, "bytes must be positive");
+    return static_cast<int>(std::bit_width(bytes)) - 1;
+}
+
+template <int BucketSize, bool InjectDebugMemory, bool NoDealloc>
+void MemoryPool<BucketSize, InjectDebugMemory, NoDealloc>::addFreeBlock(std::byte* ptr,
+                                                                        size_t size)
+{
+    int i = -1;
+    if (_unusedFreeBlocks.empty()) {
+        i = static_cast<int>(_freeBlocks.size());
+        _freeBlocks.emplace_back();
+    }
+    else {
+        i = _unusedFreeBlocks.back();
+        _unusedFreeBlocks.pop_back();
     }
 
-    // Remove all 0-sized empty pairs that have already been reused
-    _emptyList.erase(
-        std::remove_if(
-            _emptyList.begin(),
-            _emptyList.end(),
-            [](const EmptyPair& ep) { return ep.size == 0; }
-        ),
-        _emptyList.end()
-    );
+    const int sc = sizeClass(size);
+    FreeBlock& block = _freeBlocks[i];
+    block.ptr = ptr;
+    block.size = size;
+    block.previous = -1;
+    block.next = _freeLists[sc];
+    if (block.next != -1) {
+        _freeBlocks[block.next].previous = i;
+    }
+    _freeLists[sc] = i;
+    _freeListBitmap |= uint64_t(1) << sc;
+
+    // The boundary tags make it possible to find this block from its neighbors. As the
+    // size is a multiple of the Granularity, the two tags never overlap
+    static_assert(2 * sizeof(BoundaryTag) <= Granularity);
+    const BoundaryTag tag = i;
+    std::memcpy(ptr, &tag, sizeof(BoundaryTag));
+    std::memcpy(ptr + size - sizeof(BoundaryTag), &tag, sizeof(BoundaryTag));
+}
 
-    std::sort(
-        _emptyList.begin(),
-        _emptyList.end(),
-        [](const EmptyPair& lhs, const EmptyPair& rhs) { return lhs.size < rhs.size; }
-    );
-    for (size_t i = 0; i < _emptyList.size() - 1; i++) {
-        EmptyPair& current = _emptyList[i];
-        EmptyPair& next = _emptyList[i + 1];
-
-        if (static_cast<char*>(current.ptr) + current.size == next.ptr) {
-            // We found a subsequent pair
-            current.size += next.size;
-            next.size = 0;
+template <int BucketSize, bool InjectDebugMemory, bool NoDealloc>
+void MemoryPool<BucketSize, InjectDebugMemory, NoDealloc>::removeFreeBlock(int i) {
+    const FreeBlock& block = _freeBlocks[i];
+    const int sc = sizeClass(block.size);
+    if (block.previous != -1) {
+        _freeBlocks[block.previous].next = block.next;
+    }
+    else {
+        _freeLists[sc] = block.next;
+        if (block.next == -1) {
+            _freeListBitmap &= ~(uint64_t(1) << sc);
         }
     }
+    if (block.next != -1) {
+        _freeBlocks[block.next].previous = block.previous;
+    }
+
+    _freeBlocks[i].ptr = nullptr;
+    _freeBlocks[i].size = 0;
+    _unusedFreeBlocks.push_back(i);
+}
+
+template <int BucketSize, bool InjectDebugMemory, bool NoDealloc>
+int MemoryPool<BucketSize, InjectDebugMemory, NoDealloc>::freeBlockEndingAt(
+                                                             const Bucket& bucket,
+                                                             const std::byte* p) const
+{
+    if (p < bucket.payload.data + sizeof(BoundaryTag)) {
+        return -1;
+    }
+
+    // The bytes before p are either the end tag of a free block or belong to a block that
+    // is in use. In the latter case the value is arbitrary, so it is only accepted if it
+    // refers to a free block that actually ends at p
+    BoundaryTag tag = -1;
+    std::memcpy(&tag, p - sizeof(BoundaryTag), sizeof(BoundaryTag));
+    if (tag < 0 || tag >= static_cast<BoundaryTag>(_freeBlocks.size())) {
+        return -1;
+    }
+    const FreeBlock& block = _freeBlocks[tag];
+    return (block.ptr && block.ptr + block.size == p) ? tag : -1;
+}
+
+template <int BucketSize, bool InjectDebugMemory, bool NoDealloc>
+int MemoryPool<BucketSize, InjectDebugMemory, NoDealloc>::freeBlockStartingAt(
+                                                             const Bucket& bucket,
+                                                             const std::byte* p) const
+{
+    // Only the used part of the bucket can contain free blocks
+    if (p + sizeof(BoundaryTag) > bucket.payload.data + bucket.usage) {
+        return -1;
+    }
+
+    BoundaryTag tag = -1;
+    std::memcpy(&tag, p, sizeof(BoundaryTag));
+    if (tag < 0 || tag >= static_cast<BoundaryTag>(_freeBlocks.size())) {
+        return -1;
+    }
+    return _freeBlocks[tag].ptr == p ? tag : -1;
+}
+
+template <int BucketSize, bool InjectDebugMemory, bool NoDealloc>
+void MemoryPool<BucketSize, InjectDebugMemory, NoDealloc>::releaseBlock(
+                                                                   const Bucket& bucket,
+                                                                   std::byte* p,
+                                                                   size_t size)
+{
+    // Merge the block with the free blocks directly before and after it. Only blocks of
+    // the same bucket are considered, as the payloads of two buckets might be adjacent
+    if (const int before = freeBlockEndingAt(bucket, p); before != -1) {
+        p = _freeBlocks[before].ptr;
+        size += _freeBlocks[before].size;
+        removeFreeBlock(before);
+    }
+    if (const int after = freeBlockStartingAt(bucket, p + size); after != -1) {
+        size += _freeBlocks[after].size;
+        removeFreeBlock(after);
+    }
+    addFreeBlock(p, size);
 }
 
 template <int BucketSize, bool InjectDebugMemory, bool NoDealloc>
@@ -110,52 +275,88 @@ void* MemoryPool<BucketSize, InjectDebugMemory, NoDealloc>::do_allocate(size_t b
     ZoneScoped;
 
     ghoul_assert(
-        bytes <= BucketSize,
+        bytes <= _payloadSize,
         "Cannot allocate larger memory blocks than available in a bucket"
     );
-
-    for (EmptyPair& ep : _emptyList) {
-        if (bytes <= ep.size) {
-            // We found an empty pair that works
-            ep.size -= bytes;
-            void* p = ep.ptr;
-            ep.ptr = static_cast<std::byte*>(ep.ptr) + bytes;
-            return p;
+    ghoul_assert(std::has_single_bit(alignment), "alignment must be a power of two");
+    bytes = roundToMultiple(std::max(bytes, size_t(1)), Granularity);
+
+    // Every block in the size classes above the one of 'bytes' is big enough, so the
+    // first non-empty one of them can be found directly through the bitmap. If 'bytes'
+    // is a power of two, all blocks in its own size class are big enough as well. The
+    // alignment might require some padding at the beginning of the block, so the first
+    // block of each candidate size class is checked until a fitting one is found
+    int sc = sizeClass(bytes);
+    if (!std::has_single_bit(bytes)) {
+        sc++;
+    }
+    uint64_t candidates = sc < NSizeClasses ? _freeListBitmap >> sc : 0;
+    while (candidates != 0) {
+        const int candidate = std::countr_zero(candidates);
+        const int i = _freeLists[sc + candidate];
+        std::byte* p = _freeBlocks[i].ptr;
+        const size_t size = _freeBlocks[i].size;
+        std::byte* aligned = alignUp(p, alignment);
+        const size_t padding = static_cast<size_t>(aligned - p);
+        if (padding + bytes <= size) {
+            removeFreeBlock(i);
+            // Neither remainder can have a free neighbor other than the allocated block,
+            // as those would have been merged with the block when it was deallocated
+            if (padding > 0) {
+                addFreeBlock(p, padding);
+            }
+            if (padding + bytes < size) {
+                addFreeBlock(aligned + bytes, size - padding - bytes);
+            }
+            return aligned;
         }
+        candidates &= candidates - 1;
     }
 
-    // Find the first bucket that has enough space left for the number of items
-    auto it = std::find_if(
-        _buckets.begin(),
-        _buckets.end(),
-        [bytes](const std::unique_ptr<Bucket>& i) {
-            return i->usage + bytes <= BucketSize;
+    // Take the block from the current bucket if it has enough space left. Otherwise the
+    // rest of the current bucket is returned to the free lists, so that smaller blocks
+    // can still use it, and we move on to the next bucket
+    auto padding = [alignment](const Bucket& b) {
+        const std::byte* end = b.payload.data + b.usage;
+        return static_cast<size_t>(alignUp(end, alignment) - end);
+    };
+    auto current = [this]() -> Bucket* {
+        if (_currentBucket < _buckets.size()) {
+            return _buckets[_currentBucket].get();
         }
-    );
-
-    // No bucket had enough space, so we have to create a new one
-    if (it == _buckets.end()) {
-        _buckets.push_back(std::make_unique<Bucket>());
-        it = _buckets.end() - 1;
+        return nullptr;
+    };
+    Bucket* b = current();
+    if (b && b->usage + padding(*b) + bytes > _payloadSize) {
+        // The rest might be smaller than a block if the bucket size is not a multiple of
+        // the Granularity
+        const size_t rest = (_payloadSize - b->usage) & ~(Granularity - 1);
+        if (rest > 0) {
+            std::byte* end = b->payload.data + b->usage;
+            b->usage += rest;
+            releaseBlock(*b, end, rest);
+        }
+        _currentBucket++;
+        b = current();
     }
-
-
-    Bucket* b = it->get();
-    std::array<std::byte, BucketSize>& payload = b->payload;
-    std::byte* ptr = payload.data() + b->usage;
+    if (!b) {
+        // No bucket had enough space, so we have to create a new one
+        b = &createBucket();
+    }
+    const size_t pad = padding(*b);
+    if (pad > 0) {
+        // The padding in front of the block is returned right away so that it can be
+        // reused and merged with its neighbors once they are deallocated
+        std::byte* end = b->payload.data + b->usage;
+        b->usage += pad;
+        releaseBlock(*b, end, pad);
+    }
+    std::byte* ptr = b->payload.data + b->usage;
     b->usage += bytes;
 
     if (InjectDebugMemory) {
         std::memset(ptr, DebugByte, bytes);
     }
-    // Handle unaligned memory by padding to the next alignment boundary
-    const size_t align = alignment - (bytes % alignment);
-    if (align != alignment) {
-        // Mark the extra bytes as "used"
-        b->usage += align;
-        std::memset(ptr + bytes, AlignmentByte, align);
-    }
-
     return ptr;
 }
 
@@ -178,19 +379,17 @@ void MemoryPool<BucketSize, InjectDebugMemory, NoDealloc>::do_deallocate(void* p
         return;
     }
 
-    for (const std::unique_ptr<Bucket>& b : _buckets) {
-        const std::array<std::byte, BucketSize>& bp = b->payload;
-        if (ptr >= bp.data() && ptr < (bp.data() + BucketSize)) {
-            // We found our bucket to which this pointer belongs
-            if (InjectDebugMemory) {
-                std::memset(ptr, ClearByte, bytes);
-            }
-            _emptyList.push_back({ ptr, bytes });
-            return;
-        }
+    std::byte* p = static_cast<std::byte*>(ptr);
+    const Bucket* bucket = findBucket(p);
+    if (!bucket) {
+        throw std::runtime_error("Returned pointer must have been from this MemoryPool");
     }
 
-    throw std::runtime_error("Returned pointer must have been from this MemoryPool");
+    if (InjectDebugMemory) {
+        std::memset(ptr, ClearByte, bytes);
+    }
+    const size_t size = roundToMultiple(std::max(bytes, size_t(1)), Granularity);
+    releaseBlock(*bucket, p, size);
 }
 
 template <int BucketSize, bool InjectDebugMemory, bool NoDealloc>
@@ -205,6 +404,27 @@ int MemoryPool<BucketSize, InjectDebugMemory, NoDealloc>::nBuckets() const {
     return static_cast<int>(_buckets.size());
 }
 
+template <int BucketSize, bool InjectDebugMemory, bool NoDealloc>
+size_t MemoryPool<BucketSize, InjectDebugMemory, NoDealloc>::bucketSize() const {
+    return _payloadSize;
+}
+
+template <int BucketSize, bool InjectDebugMemory, bool NoDealloc>
+BucketBacking MemoryPool<BucketSize, InjectDebugMemory, NoDealloc>::backing() const {
+    return _backing;
+}
+
+template <int BucketSize, bool InjectDebugMemory, bool NoDealloc>
+int MemoryPool<BucketSize, InjectDebugMemory, NoDealloc>::nHugePageBuckets() const {
+    return static_cast<int>(std::count_if(
+        _buckets.begin(),
+        _buckets.end(),
+        [](const std::unique_ptr<Bucket>& b) {
+            return b->payload.backing == BucketBacking::HugePages;
+        }
+    ));
+}
+
 template <int BucketSize, bool InjectDebugMemory, bool NoDealloc>
 std::vector<int> MemoryPool<BucketSize, InjectDebugMemory, NoDealloc>::occupancies() const
 {
@@ -227,6 +447,228 @@ int MemoryPool<BucketSize, InjectDebugMemory, NoDealloc>::totalOccupancy() const
     );
 }
 
+template <int BucketSize, bool InjectDebugMemory, bool NoDealloc>
+typename MemoryPool<BucketSize, InjectDebugMemory, NoDealloc>::FragmentationStatistics
+MemoryPool<BucketSize, InjectDebugMemory, NoDealloc>::fragmentationStatistics() const {
+    FragmentationStatistics res;
+    size_t largest = 0;
+    for (int i : _freeLists) {
+        for (; i != -1; i = _freeBlocks[i].next) {
+            res.nFreeBlocks++;
+            res.freeBytes += static_cast<int>(_freeBlocks[i].size);
+            largest = std::max(largest, _freeBlocks[i].size);
+        }
+    }
+    res.largestFreeBlock = static_cast<int>(largest);
+    if (res.freeBytes > 0) {
+        res.fragmentation = 1.0 - static_cast<double>(largest) / res.freeBytes;
+    }
+    return res;
+}
+
+template <int BucketSize>
+ConcurrentMemoryPool<BucketSize>::State::~State() {
+    for (std::byte* b : buckets) {
+        ::operator delete(b, std::align_val_t(BucketSize));
+    }
+}
+
+template <int BucketSize>
+ConcurrentMemoryPool<BucketSize>::LocalCaches::~LocalCaches() {
+    for (const Entry& e : entries) {
+        // Only return the cache if its ConcurrentMemoryPool still exists
+        if (std::shared_ptr<State> state = e.state.lock()) {
+            e.cache->isOwned.store(false, std::memory_order_release);
+        }
+    }
+}
+
+template <int BucketSize>
+ConcurrentMemoryPool<BucketSize>::ConcurrentMemoryPool(int nBuckets)
+    : _state(std::make_shared<State>())
+    , _id(_nextId++)
+{
+    ghoul_assert(nBuckets >= 0, "nBuckets must be non-negative");
+
+    _state->buckets.reserve(nBuckets);
+    _state->spareBuckets.reserve(nBuckets);
+    for (int i = 0; i < nBuckets; i++) {
+        std::byte* b = static_cast<std::byte*>(
+            ::operator new(BucketSize, std::align_val_t(BucketSize))
+        );
+        _state->buckets.push_back(b);
+        _state->spareBuckets.push_back(b);
+    }
+}
+
+template <int BucketSize>
+int ConcurrentMemoryPool<BucketSize>::sizeClass(size_t bytes, size_t alignment) {
+    const size_t size = std::max({ bytes, alignment, size_t(16) });
+    return std::bit_width(size - 1) - 4;
+}
+
+template <int BucketSize>
+typename ConcurrentMemoryPool<BucketSize>::ThreadCache*
+ConcurrentMemoryPool<BucketSize>::findLocalCache() const
+{
+    for (const typename LocalCaches::Entry& e : _localCaches.entries) {
+        if (e.poolId == _id) {
+            return e.cache;
+        }
+    }
+    return nullptr;
+}
+
+template <int BucketSize>
+typename ConcurrentMemoryPool<BucketSize>::ThreadCache&
+ConcurrentMemoryPool<BucketSize>::localCache()
+{
+    if (ThreadCache* c = findLocalCache()) {
+        return *c;
+    }
+
+    // This is the first time the current thread uses this pool, so we either adopt the
+    // cache of a thread that has terminated or create a new one
+    ThreadCache* cache = nullptr;
+    {
+        const std::lock_guard lock(_state->mutex);
+        for (const std::unique_ptr<ThreadCache>& c : _state->caches) {
+            bool isOwned = false;
+            if (c->isOwned.compare_exchange_strong(isOwned, true)) {
+                cache = c.get();
+                break;
+            }
+        }
+        if (!cache) {
+            _state->caches.push_back(std::make_unique<ThreadCache>());
+            cache = _state->caches.back().get();
+        }
+    }
+
+    // Remove the entries of pools that no longer exist while we are at it
+    std::erase_if(
+        _localCaches.entries,
+        [](const typename LocalCaches::Entry& e) { return e.state.expired(); }
+    );
+    _localCaches.entries.push_back({ .poolId = _id, .cache = cache, .state = _state });
+    return *cache;
+}
+
+template <int BucketSize>
+void ConcurrentMemoryPool<BucketSize>::refill(ThreadCache& cache, int sc) {
+    ZoneScoped;
+
+    // Blocks that were returned by other threads are taken all at once, so that there is
+    // no ABA problem with other threads pushing to the list at the same time
+    Block* remote = cache.remoteFreeList[sc].exchange(nullptr, std::memory_order_acquire);
+    if (remote) {
+        cache.freeList[sc] = remote;
+        return;
+    }
+
+    std::byte* bucket = nullptr;
+    {
+        const std::lock_guard lock(_state->mutex);
+        if (!_state->spareBuckets.empty()) {
+            bucket = _state->spareBuckets.back();
+            _state->spareBuckets.pop_back();
+        }
+        else {
+            bucket = static_cast<std::byte*>(
+                ::operator new(BucketSize, std::align_val_t(BucketSize))
+            );
+            _state->buckets.push_back(bucket);
+        }
+    }
+
+    new (bucket) BucketHeader{ .owner = &cache, .sizeClass = sc };
+
+    // As the bucket is aligned to its size, placing the first block at a multiple of the
+    // block size after the header aligns all blocks to their size
+    const size_t blockSize = size_t(16) << sc;
+    size_t offset = std::max(blockSize, sizeof(BucketHeader));
+    offset = (offset + blockSize - 1) / blockSize * blockSize;
+    Block* head = cache.freeList[sc];
+    for (size_t o = BucketSize - blockSize; o >= offset; o -= blockSize) {
+        head = new (bucket + o) Block{ head };
+    }
+    cache.freeList[sc] = head;
+}
+
+template <int BucketSize>
+void* ConcurrentMemoryPool<BucketSize>::do_allocate(size_t bytes, size_t alignment) {
+    if (bytes > MaxBlockSize || alignment > MaxBlockSize) {
+        return ::operator new(bytes, std::align_val_t(alignment));
+    }
+
+    const int sc = sizeClass(bytes, alignment);
+    ThreadCache& cache = localCache();
+    if (!cache.freeList[sc]) {
+        refill(cache, sc);
+    }
+
+    Block* b = cache.freeList[sc];
+    cache.freeList[sc] = b->next;
+    return b;
+}
+
+template <int BucketSize>
+template <typename T, class... Types>
+T* ConcurrentMemoryPool<BucketSize>::alloc(Types&&... args) {
+    void* ptr = do_allocate(sizeof(T), alignof(T));
+    T* obj = new (ptr) T(std::forward<Types>(args)...);
+    return obj;
+}
+
+template <int BucketSize>
+void ConcurrentMemoryPool<BucketSize>::do_deallocate(void* ptr, size_t bytes,
+                                                     size_t alignment)
+{
+    if (bytes > MaxBlockSize || alignment > MaxBlockSize) {
+        ::operator delete(ptr, std::align_val_t(alignment));
+        return;
+    }
+
+    const uintptr_t bucketAddress =
+        reinterpret_cast<uintptr_t>(ptr) & ~static_cast<uintptr_t>(BucketSize - 1);
+    const BucketHeader* header = reinterpret_cast<const BucketHeader*>(bucketAddress);
+    ThreadCache* owner = header->owner;
+    const int sc = header->sizeClass;
+    ghoul_assert(sc == sizeClass(bytes, alignment), "Wrong size passed to deallocate");
+
+    Block* b = new (ptr) Block;
+    // A thread that has never allocated from this pool cannot be the owner, so there is
+    // no need to create a cache for it
+    if (owner == findLocalCache()) {
+        b->next = owner->freeList[sc];
+        owner->freeList[sc] = b;
+    }
+    else {
+        std::atomic<Block*>& list = owner->remoteFreeList[sc];
+        b->next = list.load(std::memory_order_relaxed);
+        while (!list.compare_exchange_weak(b->next, b, std::memory_order_release)) {}
+    }
+}
+
+template <int BucketSize>
+bool ConcurrentMemoryPool<BucketSize>::do_is_equal(
+                                    const pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+template <int BucketSize>
+int ConcurrentMemoryPool<BucketSize>::nBuckets() const {
+    const std::lock_guard lock(_state->mutex);
+    return static_cast<int>(_state->buckets.size());
+}
+
+template <int BucketSize>
+int ConcurrentMemoryPool<BucketSize>::nThreadCaches() const {
+    const std::lock_guard lock(_state->mutex);
+    return static_cast<int>(_state->caches.size());
+}
+
 template <typename T, int BucketSizeItems, bool InjectDebugMemory>
 ReusableTypedMemoryPool<T, BucketSizeItems, InjectDebugMemory>::ReusableTypedMemoryPool(
                                                                              int nBuckets)
@@ -234,88 +676,201 @@ ReusableTypedMemoryPool<T, BucketSizeItems, InjectDebugMemory>::ReusableTypedMem
 {
     _buckets.reserve(nBuckets);
     for (int i = 0; i < nBuckets; i++) {
-        _buckets.push_back(std::make_unique<Bucket>());
+        createBucket();
     }
 }
 
 template <typename T, int BucketSizeItems, bool InjectDebugMemory>
-void ReusableTypedMemoryPool<T, BucketSizeItems, InjectDebugMemory>::reset() {
-    for (Bucket* b : _buckets) {
-        delete b;
+void ReusableTypedMemoryPool<T, BucketSizeItems, InjectDebugMemory>::createBucket() {
+    // The objects in the slots are intentionally left uninitialized
+    _buckets.push_back(std::make_unique_for_overwrite<Bucket>());
+    for (Slot& s : _buckets.back()->slots) {
+        s.generation = 0;
     }
+}
+
+template <typename T, int BucketSizeItems, bool InjectDebugMemory>
+void ReusableTypedMemoryPool<T, BucketSizeItems, InjectDebugMemory>::reset() {
     _buckets.resize(_originalNBuckets);
+    for (const std::unique_ptr<Bucket>& b : _buckets) {
+        b->usage = 0;
+    }
+    _currentBucket = 0;
+    _freeList = nullptr;
+    // Invalidates all Handles that were handed out before the reset, including those to
+    // slots in buckets that were just freed
+    _epoch++;
 }
 
 template <typename T, int BucketSizeItems, bool InjectDebugMemory>
-std::vector<void*>
-ReusableTypedMemoryPool<T, BucketSizeItems, InjectDebugMemory>::allocate(int n)
+typename ReusableTypedMemoryPool<T, BucketSizeItems, InjectDebugMemory>::Slot*
+ReusableTypedMemoryPool<T, BucketSizeItems, InjectDebugMemory>::takeSlot()
 {
-    ghoul_assert(n >= 0, "Need to allocate positive size");
-    // Hackish implementation to support larger allocations than number of items in a
-    // bucket; probably not likely to happen
-    if (n > BucketSizeItems) {
-        std::vector<void*> res;
-        res.reserve(n);
-        while (n > BucketSizeItems) {
-            std::vector<void*> r = allocate(BucketSizeItems);
-            res.insert(res.end(), r.begin(), r.end());
-            n -= BucketSizeItems;
-        }
-        std::vector<void*> r = allocate(n);
-        res.insert(res.end(), r.begin(), r.end());
-        return res;
+    if (_freeList) {
+        Slot* s = _freeList;
+        _freeList = s->next;
+        return s;
     }
 
-    // First check if there are items in the free list, if so, return those
-    if (_freeList.size() >= static_cast<size_t>(n)) {
-        std::vector<void*> res(n);
-        size_t startIndex = _freeList.size() - n;
-        for (int i = 0; i < n; i++) {
-            res[i] = _freeList[startIndex + i];
-        }
-        _freeList.erase(_freeList.begin() + startIndex, _freeList.end());
-        return res;
+    // All buckets before the current one are full, and as slots are never given back to
+    // a bucket, they will stay full until the next reset
+    while (_currentBucket < _buckets.size() &&
+           _buckets[_currentBucket]->usage == BucketSizeItems)
+    {
+        _currentBucket++;
+    }
+    if (_currentBucket == _buckets.size()) {
+        createBucket();
     }
 
-    // Find the first bucket that has enough space left for the number of items
-    auto it = std::find_if(
-        _buckets.begin(),
-        _buckets.end(),
-        [n](const std::unique_ptr<Bucket>& i) {
-            return i->usage + n * sizeof(T) <= BucketSizeItems * sizeof(T);
-        }
-    );
+    Bucket& b = *_buckets[_currentBucket];
+    Slot* s = &b.slots[b.usage];
+    b.usage++;
+    if (InjectDebugMemory) {
+        std::memset(s->object, DebugByte, sizeof(T));
+    }
+    return s;
+}
 
-    // No bucket had enough space, so we have to create a new one
-    if (it == _buckets.end()) {
-        _buckets.push_back(std::make_unique<Bucket>());
-        it = _buckets.end() - 1;
+template <typename T, int BucketSizeItems, bool InjectDebugMemory>
+void ReusableTypedMemoryPool<T, BucketSizeItems, InjectDebugMemory>::returnSlot(Slot* s) {
+    if (InjectDebugMemory) {
+        std::memset(s->object, ClearByte, sizeof(T));
     }
+    s->generation++;
+    s->next = _freeList;
+    _freeList = s;
+}
 
+template <typename T, int BucketSizeItems, bool InjectDebugMemory>
+typename ReusableTypedMemoryPool<T, BucketSizeItems, InjectDebugMemory>::Slot*
+ReusableTypedMemoryPool<T, BucketSizeItems, InjectDebugMemory>::slot(T* ptr)
+{
+    return reinterpret_cast<Slot*>(ptr);
+}
 
-    Bucket* b = it->get();
-    void* ptr = reinterpret_cast<std::byte*>(b->payload.data()) + b->usage;
-    b->usage += n * sizeof(T);
+template <typename T, int BucketSizeItems, bool InjectDebugMemory>
+std::vector<void*>
+ReusableTypedMemoryPool<T, BucketSizeItems, InjectDebugMemory>::allocate(int n)
+{
+    ghoul_assert(n >= 0, "Need to allocate positive size");
 
+    // The slots are filled in reverse so that the pointers that were freed last are
+    // returned in the order in which they were freed
     std::vector<void*> res(n);
-    for (int i = 0; i < n; i++) {
-        res[i] = reinterpret_cast<std::byte*>(ptr) + (i * sizeof(T));
-
-        if (InjectDebugMemory) {
-            for (int ii = 0; ii < sizeof(T) / sizeof(std::byte); ii++) {
-                std::byte* bptr = reinterpret_cast<std::byte*>(res[i]);
-                std::memset(bptr + ii, DebugByte, 1);
-            }
-        }
+    for (int i = n - 1; i >= 0; i--) {
+        res[i] = takeSlot()->object;
     }
     return res;
 }
 
+template <typename T, int BucketSizeItems, bool InjectDebugMemory>
+void ReusableTypedMemoryPool<T, BucketSizeItems, InjectDebugMemory>::allocate(
+                                                                      std::span<T*> slots)
+{
+    for (size_t i = slots.size(); i > 0; i--) {
+        slots[i - 1] = reinterpret_cast<T*>(takeSlot()->object);
+    }
+}
+
 template <typename T, int BucketSizeItems, bool InjectDebugMemory>
 void ReusableTypedMemoryPool<T, BucketSizeItems, InjectDebugMemory>::free(T* ptr) {
     if (ptr) {
-        _freeList.push_back(ptr);
+        returnSlot(slot(ptr));
+    }
+}
+
+template <typename T, int BucketSizeItems, bool InjectDebugMemory>
+void ReusableTypedMemoryPool<T, BucketSizeItems, InjectDebugMemory>::free(
+                                                                 std::span<T* const> ptrs)
+{
+    for (T* ptr : ptrs) {
+        free(ptr);
+    }
+}
+
+template <typename T, int BucketSizeItems, bool InjectDebugMemory>
+template <typename... Args>
+T* ReusableTypedMemoryPool<T, BucketSizeItems, InjectDebugMemory>::create(
+                                                                           Args&&... args)
+{
+    Slot* s = takeSlot();
+    try {
+        return new (s->object) T(std::forward<Args>(args)...);
+    }
+    catch (...) {
+        returnSlot(s);
+        throw;
+    }
+}
+
+template <typename T, int BucketSizeItems, bool InjectDebugMemory>
+template <typename... Args>
+void ReusableTypedMemoryPool<T, BucketSizeItems, InjectDebugMemory>::createN(
+                                               std::span<T*> objects, const Args&... args)
+{
+    for (size_t i = 0; i < objects.size(); i++) {
+        try {
+            objects[i] = create(args...);
+        }
+        catch (...) {
+            destroyN(objects.first(i));
+            throw;
+        }
+    }
+}
+
+template <typename T, int BucketSizeItems, bool InjectDebugMemory>
+template <typename... Args>
+typename ReusableTypedMemoryPool<T, BucketSizeItems, InjectDebugMemory>::Handle
+ReusableTypedMemoryPool<T, BucketSizeItems, InjectDebugMemory>::createHandle(
+                                                                           Args&&... args)
+{
+    T* ptr = create(std::forward<Args>(args)...);
+    return { .ptr = ptr, .generation = slot(ptr)->generation, .epoch = _epoch };
+}
+
+template <typename T, int BucketSizeItems, bool InjectDebugMemory>
+void ReusableTypedMemoryPool<T, BucketSizeItems, InjectDebugMemory>::destroy(T* ptr) {
+    if (ptr) {
+        ptr->~T();
+        returnSlot(slot(ptr));
     }
 }
 
+template <typename T, int BucketSizeItems, bool InjectDebugMemory>
+void ReusableTypedMemoryPool<T, BucketSizeItems, InjectDebugMemory>::destroyN(
+                                                              std::span<T* const> objects)
+{
+    for (T* ptr : objects) {
+        destroy(ptr);
+    }
+}
+
+template <typename T, int BucketSizeItems, bool InjectDebugMemory>
+void ReusableTypedMemoryPool<T, BucketSizeItems, InjectDebugMemory>::destroy(
+                                                                            Handle handle)
+{
+    ghoul_assert(isValid(handle), "Handle refers to an object that was destroyed");
+    destroy(handle.ptr);
+}
+
+template <typename T, int BucketSizeItems, bool InjectDebugMemory>
+bool ReusableTypedMemoryPool<T, BucketSizeItems, InjectDebugMemory>::isValid(
+                                                                      Handle handle) const
+{
+    // The epoch has to be checked first, as the slot of a Handle from before a reset
+    // might no longer exist
+    return handle.ptr && handle.epoch == _epoch &&
+           slot(handle.ptr)->generation == handle.generation;
+}
+
+template <typename T, int BucketSizeItems, bool InjectDebugMemory>
+T* ReusableTypedMemoryPool<T, BucketSizeItems, InjectDebugMemory>::get(
+                                                                      Handle handle) const
+{
+    ghoul_assert(isValid(handle), "Handle refers to an object that was destroyed");
+    return handle.ptr;
+}
+
 } // namespace ghoul
@@ -28,6 +28,7 @@
 
 #include <ghoul/misc/boolean.h>
 #include <thread>
+#include <vector>
 
 namespace ghoul::thread {
 
@@ -58,6 +59,47 @@ enum class ThreadPriorityLevel {
 };
 
 BooleanType(Background);
+BooleanType(NumaLocalMemory);
+
+/**
+ * A single NUMA node of the system's CPU topology, consisting of the node's index and the
+ * indices of the logical processors that belong to the node. The topology of the current
+ * system is reported by the `GeneralCapabilitiesComponent::numaNodes` function.
+ */
+struct NumaNode {
+    /// The index of the NUMA node as it is used by the operating system
+    int id = 0;
+    /// The indices of the logical processors that belong to this NUMA node
+    std::vector<int> cpus;
+};
+
+/**
+ * Determines to which logical processors threads are pinned.
+ */
+enum class Affinity {
+    None = 0,  ///< Threads are not pinned and can be migrated by the operating system
+    Core,      ///< Each thread is pinned to a single logical processor
+    NumaNode   ///< Each thread is pinned to all logical processors of a single NUMA node
+};
+
+/**
+ * Describes how a group of threads is distributed across the processors of the system.
+ * The threads are distributed round-robin across the NUMA nodes of the \p topology and,
+ * within each node, across the node's logical processors.
+ */
+struct Placement {
+    /// The processors to which each thread is pinned
+    Affinity affinity = Affinity::None;
+
+    /// The CPU topology of the system. If this is empty, the system is treated as a
+    /// single NUMA node containing all logical processors
+    std::vector<NumaNode> topology;
+
+    /// If this is `NumaLocalMemory::Yes`, memory that is allocated by a pinned thread is
+    /// preferably taken from the NUMA node that the thread is pinned to. This value is
+    /// ignored if the \p affinity is `Affinity::None`
+    NumaLocalMemory numaLocalMemory = NumaLocalMemory::No;
+};
 
 /**
  * This method sets the priorty of the thread \p t to the ThreadPriorityClass
@@ -86,6 +128,36 @@ void setPriority(std::thread& t, ThreadPriorityClass priorityClass,
  */
 void setThreadBackground(std::thread& t, Background background);
 
+/**
+ * This method restricts the thread \p t to only run on the logical processors whose
+ * indices are contained in \p cpus. This function might not be supported on all
+ * platforms and reverts to a no-op on platforms that are not supported. On Windows, only
+ * the processors of the first processor group (indices 0-63) are supported.
+ *
+ * \param t The thread whose affinity is changed
+ * \param cpus The indices of the logical processors that \p t is allowed to run on
+ *
+ * \throw ghoul::RuntimeError If the affinity could not be set, for example because none
+ *        of the \p cpus is available to the process
+ * \pre \p cpus must not be empty
+ */
+void setAffinity(std::thread& t, const std::vector<int>& cpus);
+
+/**
+ * This method causes all future memory allocations of the calling thread to be taken
+ * from the NUMA node \p node if possible. If the node does not have enough free memory,
+ * the memory is taken from a different node instead. This function might not be
+ * supported on all platforms and reverts to a no-op on platforms that are not supported.
+ * On Windows, memory is already allocated on the node of the processor the thread is
+ * running on, so it is sufficient to pin the thread using #setAffinity.
+ *
+ * \param node The index of the NUMA node from which memory should be allocated
+ *
+ * \throw ghoul::RuntimeError If the memory policy could not be set
+ * \pre \p node must not be negative
+ */
+void setPreferredMemoryNode(int node);
+
 } // namespace ghoul::thread
 
 #endif // __GHOUL___THREAD___H__
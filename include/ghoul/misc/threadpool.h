@@ -45,15 +45,23 @@
 
 #include <ghoul/misc/boolean.h>
 #include <ghoul/misc/thread.h>
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
 #include <functional>
 #include <future>
+#include <latch>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <queue>
 #include <thread>
 #include <tuple>
+#include <type_traits>
 #include <vector>
 
 namespace ghoul {
@@ -90,7 +98,43 @@ namespace ghoul {
  *  }
  * ```
  *
- * Tasks passed to the ThreadPool as started in order a strict FIFO ordering.
+ * Tasks passed to the ThreadPool as started in order a strict FIFO ordering within each
+ * TaskPriority. Tasks with a higher TaskPriority are always started before tasks with a
+ * lower TaskPriority, so that, for example, background prefetching does not delay urgent
+ * work. Tasks can additionally be tied to a CancellationToken; once the token has been
+ * cancelled, all of its tasks that have not started yet are discarded instead of being
+ * executed.
+ *
+ * Alternatively, a ThreadPool can be created with `WorkStealing::Yes`, in which case each
+ * Worker owns a separate double-ended queue of tasks. Tasks that are queued from within a
+ * Worker are pushed to that Worker's own queue without taking a lock, and idle Workers
+ * steal tasks from randomly chosen other Workers. Tasks that are queued from outside the
+ * ThreadPool are still collected in a shared queue from which the Workers pull batches.
+ * In this mode, the ordering of tasks is not strictly FIFO anymore.
+ *
+ * The Worker%s can be pinned to individual processors or NUMA nodes by passing a
+ * ghoul::thread::Placement to the constructor. The topology of the system that is needed
+ * for this is reported by the `GeneralCapabilitiesComponent::numaNodes` function, for
+ * example:
+ * ```
+ * ghoul::ThreadPool pool(
+ *     16, [](){}, [](){},
+ *     thread::ThreadPriorityClass::Normal, thread::ThreadPriorityLevel::Normal,
+ *     thread::Background::No, ThreadPool::WorkStealing::Yes,
+ *     {
+ *         .affinity = thread::Affinity::NumaNode,
+ *         .topology = CpuCap.numaNodes(),
+ *         .numaLocalMemory = thread::NumaLocalMemory::Yes
+ *     }
+ * );
+ * ```
+ *
+ * The ThreadPool continuously collects metrics about the time tasks spend waiting in the
+ * queue, the time they take to execute, and the utilization of each Worker. These can be
+ * retrieved at any time through the #metrics function. The counters are kept separately
+ * for each Worker and are only combined when a snapshot is requested, so collecting them
+ * is cheap enough to be always enabled. If Ghoul is compiled with Tracy support, each
+ * executed task is additionally shown as a zone in the profiler.
  *
  * Workers can be initialized with custom functions that are passed to the ThreadPool
  * during construction. These functions are called once for each Worker at the beginning
@@ -105,6 +149,145 @@ class ThreadPool {
 public:
     BooleanType(RunRemainingTasks);
     BooleanType(DetachThreads);
+    BooleanType(WorkStealing);
+
+    /**
+     * The priority lanes into which tasks can be queued. Pending tasks with a higher
+     * priority are always started before pending tasks with a lower priority.
+     */
+    enum class TaskPriority {
+        High = 0,   ///< Urgent tasks, for example for data that is needed right now
+        Normal,     ///< The default priority for tasks
+        Background  ///< Tasks that are only started when no other task is pending
+    };
+
+    /// The number of different TaskPriority values
+    static constexpr int NTaskPriorities = 3;
+
+    /**
+     * A token that one or more tasks can be tied to in order to cancel them as a group.
+     * Copies of a CancellationToken share the same state, so cancelling one copy cancels
+     * all of them. Tasks whose token has been cancelled are discarded when a Worker would
+     * otherwise start them; tasks that are already running are not interrupted.
+     */
+    class CancellationToken {
+    public:
+        /**
+         * Creates a new token that is not cancelled.
+         */
+        CancellationToken();
+
+        /**
+         * Cancels this token and all of its copies. All tasks that are tied to this token
+         * and that have not been started yet will be discarded.
+         */
+        void cancel();
+
+        /**
+         * Returns whether this token or one of its copies has been cancelled.
+         *
+         * \return `true` if this token has been cancelled, `false` otherwise
+         */
+        bool isCancelled() const;
+
+    private:
+        friend class ThreadPool;
+
+        /// The state that is shared between all copies of the token and the tasks that
+        /// are tied to it
+        std::shared_ptr<std::atomic_bool> _isCancelled;
+    };
+
+    /**
+     * A histogram of durations whose buckets grow exponentially. Bucket `i` counts the
+     * durations `d` with 2^i ns <= `d` < 2^(i+1) ns. Durations shorter than 1 ns are
+     * counted in the first bucket and durations that are too long for the last bucket
+     * are counted in the last bucket.
+     */
+    struct Histogram {
+        /// The number of buckets of the histogram. The last bucket starts at ~9 minutes
+        static constexpr int NBuckets = 40;
+
+        /**
+         * Returns the index of the bucket into which the \p duration falls.
+         *
+         * \param duration The duration whose bucket is returned
+         * \return The index of the bucket into which the \p duration falls
+         */
+        static int bucket(std::chrono::nanoseconds duration);
+
+        /**
+         * Returns the total number of durations in this histogram.
+         *
+         * \return The total number of durations in this histogram
+         */
+        uint64_t count() const;
+
+        /**
+         * Returns an upper bound of the \p p-th percentile of the durations in this
+         * histogram, that is the upper limit of the bucket in which the percentile lies.
+         *
+         * \param p The percentile in the range [0, 1]
+         * \return The upper bound of the percentile or 0 if the histogram is empty
+         *
+         * \pre \p p must be in the range [0, 1]
+         */
+        std::chrono::nanoseconds percentile(double p) const;
+
+        /// The number of durations in each bucket
+        std::array<uint64_t, NBuckets> buckets = {};
+    };
+
+    /**
+     * The metrics of a single Worker of a ThreadPool.
+     */
+    struct WorkerMetrics {
+        /// The number of tasks that were executed by this Worker
+        uint64_t nTasks = 0;
+        /// The total time this Worker spent executing tasks
+        std::chrono::nanoseconds busyTime = std::chrono::nanoseconds(0);
+        /// The time since this Worker was started
+        std::chrono::nanoseconds lifetime = std::chrono::nanoseconds(0);
+        /// The fraction of the lifetime this Worker spent executing tasks
+        double utilization = 0.0;
+    };
+
+    /**
+     * A snapshot of the metrics of a ThreadPool, as returned by ThreadPool::metrics. The
+     * values are accumulated over the whole lifetime of the ThreadPool, so the metrics
+     * of a specific time interval can be computed from two snapshots.
+     */
+    struct Metrics {
+        /// The point in time at which this snapshot was taken
+        std::chrono::steady_clock::time_point time;
+        /// The number of tasks that have been executed
+        uint64_t nTasksExecuted = 0;
+        /// The number of tasks that have been discarded because they were cancelled
+        uint64_t nTasksCancelled = 0;
+        /// The sum of the times all executed tasks spent in the queue
+        std::chrono::nanoseconds totalQueueWaitTime = std::chrono::nanoseconds(0);
+        /// The sum of the execution times of all executed tasks
+        std::chrono::nanoseconds totalExecutionTime = std::chrono::nanoseconds(0);
+        /// The distribution of the time tasks spent in the queue before being started
+        Histogram queueWaitTime;
+        /// The distribution of the execution times of the tasks
+        Histogram executionTime;
+        /// The metrics of all currently active Worker%s. Tasks that were executed by
+        /// threads that are waiting in one of the fork-join functions or by Worker%s that
+        /// have been removed are only included in the totals
+        std::vector<WorkerMetrics> workers;
+    };
+
+    /**
+     * Additional options that control how a task is scheduled.
+     */
+    struct TaskOptions {
+        /// The priority lane into which the task is queued
+        TaskPriority priority = TaskPriority::Normal;
+        /// If this is set, the task is discarded without being executed if the token was
+        /// cancelled before the task is started
+        std::optional<CancellationToken> cancellationToken;
+    };
 
     /**
      * Constructor that initializes and starts \p nThreads Worker objects.
@@ -121,6 +304,12 @@ public:
      *        the ThreadPool
      * \param bg Whether the worker threads managed by this thread pool are run in a
      *        background mode (depending on the support of the operating system)
+     * \param workStealing If `WorkStealing::Yes`, each Worker maintains its own queue
+     *        of tasks and idle Workers steal tasks from other Workers. If
+     *        `WorkStealing::No`, all Workers share a single queue of tasks
+     * \param placement Determines whether and how the Worker%s are pinned to the
+     *        processors of the system. The \p nThreads Workers are distributed
+     *        round-robin across the NUMA nodes of the topology
      *
      * \pre \p nThreads must be bigger than 0
      * \pre \p workerInit must not be empty
@@ -131,7 +320,9 @@ public:
         std::function<void()> workerDeinit = [](){},
         thread::ThreadPriorityClass tpc = thread::ThreadPriorityClass::Normal,
         thread::ThreadPriorityLevel tpl = thread::ThreadPriorityLevel::Normal,
-        thread::Background bg = thread::Background::No);
+        thread::Background bg = thread::Background::No,
+        WorkStealing workStealing = WorkStealing::No,
+        thread::Placement placement = thread::Placement());
 
     /**
      * Destructor that will block and wait for all remaining Tasks to be finished if the
@@ -212,6 +403,35 @@ public:
      */
     int remainingTasks() const;
 
+    /**
+     * Returns the number of remaining tasks with the \p priority that are waiting to be
+     * processed by this ThreadPool. Tasks that are tied to a cancelled CancellationToken
+     * are included in this number until a Worker has discarded them.
+     *
+     * \param priority The priority lane whose tasks are counted
+     * \return The number of remaining tasks with the \p priority
+     */
+    int remainingTasks(TaskPriority priority) const;
+
+    /**
+     * Returns a snapshot of the metrics that this ThreadPool has collected since it was
+     * created. The counters of all Worker%s are combined when this function is called.
+     *
+     * \return A snapshot of the metrics of this ThreadPool
+     */
+    Metrics metrics() const;
+
+    /**
+     * Returns the average number of tasks per second that were executed between the two
+     * snapshots \p before and \p after.
+     *
+     * \param before The earlier snapshot
+     * \param after The later snapshot
+     * \return The number of tasks per second that were executed between the snapshots or
+     *         0 if both snapshots were taken at the same time
+     */
+    static double throughput(const Metrics& before, const Metrics& after);
+
     /**
      * Removes the remaining tasks from the waiting list, discarding them.
      *
@@ -266,6 +486,41 @@ public:
     auto queue(Function&& function, Args&&... arguments)
         -> std::future<decltype(function(arguments...))>;
 
+    /**
+     * This function queues a task with the provided \p options and returns an
+     * `std::future` object that holds a potential return value of the function. Apart
+     * from the \p options, this function behaves the same as the #queue function above.
+     * If the task is discarded because its CancellationToken was cancelled, the
+     * `std::future` will throw an `std::future_error` with the
+     * `std::future_errc::broken_promise` error code.
+     *
+     * Example use-case:
+     * ```
+     * ghoul::ThreadPool::CancellationToken token;
+     * std::future<Tile> tile = pool.queue(
+     *     {
+     *         .priority = ThreadPool::TaskPriority::Background,
+     *         .cancellationToken = token
+     *     },
+     *     [](){ return loadTile(); }
+     * );
+     * // The tile is no longer needed
+     * token.cancel();
+     * ```
+     *
+     * \tparam Function The description of the \p function%'s signature that will be
+     *         called
+     * \tparam Args A variable list of arguments that can be passed to the \p function
+     * \param options The options that determine how the task is scheduled
+     * \param function The function that will be called
+     * \param arguments The potential list of arguments passed to the \p function
+     * \return A future containing the result of the evaluation of \p function with the
+     *         passed \p arguments
+     */
+    template <typename Function, typename... Args>
+    auto queue(const TaskOptions& options, Function&& function, Args&&... arguments)
+        -> std::future<decltype(function(arguments...))>;
+
     /**
      * This function queues a `std::packaged_task` and returns its `std::future` object
      * that holds a potential return value. All tasks passed to this functions are
@@ -284,16 +539,228 @@ public:
     auto queue(std::packaged_task<T>&& task, Args&&... arguments)
         -> decltype(task.get_future());
 
+    /**
+     * This function queues a task without creating a `std::future` for it. This is the
+     * cheapest way to pass work to the ThreadPool, as queueing a function whose captures
+     * and arguments fit into a small inline buffer does not allocate any memory. As
+     * there is no way to retrieve the result of the function, the return value of the
+     * \p function is ignored and exceptions that are thrown by the \p function are
+     * caught and logged.
+     *
+     * \tparam Function The description of the \p function%'s signature that will be
+     *         called
+     * \tparam Args A variable list of arguments that can be passed to the \p function
+     * \param function The function that will be called
+     * \param arguments The potential list of arguments passed to the \p function
+     */
+    template <typename Function, typename... Args>
+        requires (!std::is_same_v<std::decay_t<Function>, TaskOptions>)
+    void submit(Function&& function, Args&&... arguments);
+
+    /**
+     * This function queues a task with the provided \p options without creating a
+     * `std::future` for it. Apart from the \p options, this function behaves the same as
+     * the #submit function above.
+     *
+     * \tparam Function The description of the \p function%'s signature that will be
+     *         called
+     * \tparam Args A variable list of arguments that can be passed to the \p function
+     * \param options The options that determine how the task is scheduled
+     * \param function The function that will be called
+     * \param arguments The potential list of arguments passed to the \p function
+     */
+    template <typename Function, typename... Args>
+    void submit(const TaskOptions& options, Function&& function, Args&&... arguments);
+
+    /**
+     * Calls the \p function once for each index in the half-open range [\p begin,
+     * \p end) and returns after all calls have finished. The range is split recursively
+     * into subranges that are processed in parallel by the Worker%s. Initially, the range
+     * is split into roughly as many pieces as there are Worker%s; afterwards, a subrange
+     * is only split further while there are idle Worker%s that could work on the other
+     * half. Subranges never become smaller than \p grain indices. While waiting, the
+     * calling thread executes pending tasks of this ThreadPool itself and only blocks
+     * once there are none left. If any invocation of \p function throws an exception,
+     * the first such exception is rethrown from this function after all other tasks
+     * have finished.
+     *
+     * Example use-case:
+     * ```
+     * std::vector<glm::vec3> vertices = ...;
+     * pool.parallelFor(size_t(0), vertices.size(), size_t(1024), [&](size_t i) {
+     *     vertices[i] = transform(vertices[i]);
+     * });
+     * ```
+     *
+     * \tparam Index An integral type that is used for the indices
+     * \tparam Function A callable object that accepts a single `Index`
+     * \param begin The first index of the range
+     * \param end The index one past the last index of the range
+     * \param grain The minimum number of indices that are processed in one task
+     * \param function The function that is called for each index
+     *
+     * \throw RuntimeError If a part of the range was discarded by #clearRemainingTasks
+     *        or #stop before it was processed
+     * \pre \p grain must be bigger than 0
+     */
+    template <typename Index, typename Function>
+    void parallelFor(Index begin, Index end, Index grain, Function&& function);
+
+    /**
+     * Computes the reduction of the values that are returned by \p map for each index in
+     * the half-open range [\p begin, \p end). The range is split in the same way as in
+     * #parallelFor and each subrange is reduced separately, starting with \p identity.
+     * The partial results are then combined using the \p reduce function. As the order
+     * in which partial results are combined is not defined, \p reduce must be
+     * associative and commutative and \p identity must be the identity element of
+     * \p reduce. The calling thread executes pending tasks while waiting.
+     *
+     * Example use-case:
+     * ```
+     * double sum = pool.parallelReduce(0, nRows, 256, 0.0,
+     *     [&](int i) { return rows[i].value; },
+     *     [](double a, double b) { return a + b; }
+     * );
+     * ```
+     *
+     * \tparam Index An integral type that is used for the indices
+     * \tparam T The type of the result
+     * \tparam Map A callable object that accepts a single `Index` and returns a `T`
+     * \tparam Reduce A callable object that accepts two `T`s and returns a `T`
+     * \param begin The first index of the range
+     * \param end The index one past the last index of the range
+     * \param grain The minimum number of indices that are processed in one task
+     * \param identity The identity element of the \p reduce function
+     * \param map The function that is called for each index
+     * \param reduce The function that combines two values
+     * \return The combined value of all indices or \p identity if the range is empty
+     *
+     * \throw RuntimeError If a part of the range was discarded by #clearRemainingTasks
+     *        or #stop before it was processed
+     * \pre \p grain must be bigger than 0
+     */
+    template <typename Index, typename T, typename Map, typename Reduce>
+    T parallelReduce(Index begin, Index end, Index grain, T identity, Map&& map,
+        Reduce&& reduce);
+
+    /**
+     * Invokes all of the passed \p functions in parallel and returns after all of them
+     * have finished. The first function is executed directly on the calling thread, all
+     * others are queued in this ThreadPool. While waiting, the calling thread executes
+     * pending tasks itself. If any of the functions throws an exception, the first such
+     * exception is rethrown after all functions have finished.
+     *
+     * \tparam Function The type of a callable object that does not take any arguments
+     * \tparam Functions The types of callable objects that do not take any arguments
+     * \param function The function that is executed on the calling thread
+     * \param functions The functions that are queued in this ThreadPool
+     *
+     * \throw RuntimeError If one of the \p functions was discarded by
+     *        #clearRemainingTasks or #stop before it was executed
+     */
+    template <typename Function, typename... Functions>
+    void parallelInvoke(Function&& function, Functions&&... functions);
+
 private:
     ThreadPool(const ThreadPool&) = delete;
     ThreadPool(ThreadPool&&) = delete;
     ThreadPool& operator=(const ThreadPool&) = delete;
     ThreadPool& operator=(ThreadPool&&) = delete;
 
-    /// A single task that is executed. This is a functional wrapper around the function +
-    /// arguments that are passed in the queue method so that we can store all tasks in a
-    /// single list
-    using Task = std::function<void()>;
+    /**
+     * A single task that is executed. This is a type-erased, move-only wrapper around the
+     * function + arguments that are passed in the queue method so that we can store all
+     * tasks in a single list. Tasks are never created directly, but are taken from a pool
+     * of reusable slots through #allocateTask and returned through #freeTask. Functions
+     * that fit into the inline storage are stored there, bigger functions are stored on
+     * the heap instead, so that queueing a small function does not allocate memory.
+     */
+    struct Task {
+        /// The size of the inline storage. Chosen such that a Task is exactly 128 bytes
+        static constexpr size_t StorageSize =
+            128 - 2 * sizeof(void(*)()) -
+            sizeof(std::shared_ptr<const std::atomic_bool>) -
+            sizeof(std::chrono::steady_clock::time_point);
+
+        /// The storage for the function object or a pointer to it if it is too big
+        alignas(std::max_align_t) std::byte storage[StorageSize];
+        /// Executes the stored function and destroys it afterwards
+        void (*run)(Task& task) = nullptr;
+        /// Destroys the stored function without executing it
+        void (*discard)(Task& task) = nullptr;
+        /// The state of the CancellationToken the task is tied to, or `nullptr` if the
+        /// task cannot be cancelled
+        std::shared_ptr<const std::atomic_bool> isCancelled;
+        /// The point in time at which the task was queued
+        std::chrono::steady_clock::time_point queueTime;
+    };
+
+    class WorkStealingQueue;
+    struct MetricsRegistry;
+
+    /**
+     * The metrics counters of a single thread that executes tasks. The counters are only
+     * modified by the owning thread, except for the counters of threads that are not
+     * Worker%s, which are shared between all of those threads. All counters are accessed
+     * with relaxed memory ordering.
+     */
+    struct WorkerCounters {
+        /**
+         * Creates the counters for a thread that belongs to the \p owner.
+         *
+         * \param owner The MetricsRegistry that the counters belong to
+         */
+        explicit WorkerCounters(const MetricsRegistry* owner);
+
+        /**
+         * Records the execution of a single task.
+         *
+         * \param queueWait The time the task spent in the queue
+         * \param execution The time it took to execute the task
+         */
+        void record(std::chrono::nanoseconds queueWait,
+            std::chrono::nanoseconds execution);
+
+        /**
+         * Adds the counters of this object to the \p metrics.
+         *
+         * \param metrics The metrics to which the counters are added
+         */
+        void addTo(Metrics& metrics) const;
+
+        /// The MetricsRegistry that these counters belong to
+        const MetricsRegistry* owner;
+        /// The point in time at which the thread was started
+        std::chrono::steady_clock::time_point startTime;
+        /// The number of executed tasks
+        std::atomic_uint64_t nTasks = 0;
+        /// The number of tasks that were discarded because they were cancelled
+        std::atomic_uint64_t nCancelled = 0;
+        /// The total time in nanoseconds the executed tasks spent in the queue
+        std::atomic_uint64_t queueWait = 0;
+        /// The total time in nanoseconds spent executing tasks
+        std::atomic_uint64_t execution = 0;
+        /// The histogram of the time tasks spent in the queue
+        std::array<std::atomic_uint64_t, Histogram::NBuckets> queueWaitHistogram = {};
+        /// The histogram of the execution times of tasks
+        std::array<std::atomic_uint64_t, Histogram::NBuckets> executionHistogram = {};
+    };
+
+    /**
+     * The list of the metrics counters of all Worker%s of a ThreadPool.
+     */
+    struct MetricsRegistry {
+        MetricsRegistry();
+
+        /// The mutex protecting the list of counters
+        std::mutex mutex;
+        /// The counters of all active Worker%s
+        std::vector<std::shared_ptr<WorkerCounters>> workers;
+        /// The counters of all threads that execute tasks but are not Worker%s
+        WorkerCounters external;
+        /// The accumulated counters of all Worker%s that have been terminated
+        Metrics retired;
+    };
 
     /**
      * A worker object that consists of a thread and a boolean flag that determines
@@ -308,32 +775,55 @@ private:
         /// a new task. This is stored as a shared_pointer as this value is used in the
         /// ThreadPool as well as the lambda expression that drives the thread
         std::shared_ptr<std::atomic<bool>> shouldTerminate;
+        /// The Worker's own queue of tasks if work stealing is enabled, `nullptr`
+        /// otherwise
+        std::shared_ptr<WorkStealingQueue> localQueue;
     };
 
     /**
-     * This class represents a thin wrapper around `std::queue` that provides `std::mutex`
-     * protection for the available methods, thus making them thread-safe to use. As soon
-     * as there is a better adapter pattern for the STL classes that works in a concurrent
-     * environment, this class is not needed anymore.
+     * This class represents a thin wrapper around one `std::queue` per TaskPriority that
+     * provides `std::mutex` protection for the available methods, thus making them
+     * thread-safe to use. As soon as there is a better adapter pattern for the STL
+     * classes that works in a concurrent environment, this class is not needed anymore.
      */
     class TaskQueue {
     public:
         /**
-         * Returns the top element of the queue and whether this item existed. If the
-         * queue was empty, `{ Task(), false }` is returned, otherwise the second argument
-         * to the `tuple` is `true`.
+         * Discards all of the tasks that are still remaining in the queue.
+         */
+        ~TaskQueue();
+
+        /**
+         * Removes and returns the top element of the highest priority lane that is not
+         * empty. Lanes with a lower priority than \p lowest are not considered. If all
+         * considered lanes were empty, `nullptr` is returned.
+         *
+         * \param lowest The lowest priority lane from which a task is taken
+         * \return The top element of the queue or `nullptr` if the queue was empty. The
+         *         caller takes ownership of the task
+         */
+        Task* pop(TaskPriority lowest = TaskPriority::Background);
+
+        /**
+         * Pushes the \p task to the bottom of the lane for the \p priority.
          *
-         * \return A tuple containing either the top element of the queue and `true`, or a
-         *         default constructed Task and `false`
+         * \param task The task to be pushed onto the queue. The queue takes ownership of
+         *        the task
+         * \param priority The priority lane into which the task is pushed
          */
-        std::tuple<Task, bool> pop();
+        void push(Task* task, TaskPriority priority);
 
         /**
-         * Pushes the \p task to the bottom of the `std::queue`.
+         * Moves a batch of tasks from the top of the TaskPriority::Normal lane to the
+         * bottom of the \p target queue while only acquiring the lock once. The size of
+         * the batch is the share of the remaining tasks that falls on one of \p nShares
+         * consumers, but at least one task.
          *
-         * \param task The task to be pushed onto the queue
+         * \param target The queue that receives the tasks
+         * \param nShares The number of consumers between which the tasks are split
+         * \return The number of tasks that were moved
          */
-        void push(const Task& task);
+        int popInto(WorkStealingQueue& target, int nShares);
 
         /**
          * Returns whether the queue is empty.
@@ -349,23 +839,318 @@ private:
          */
         int size() const;
 
+        /**
+         * Returns the number of tasks in the lane for the \p priority. This function does
+         * not acquire the lock, so the value is only a snapshot.
+         *
+         * \param priority The priority lane whose size is returned
+         * \return The number of tasks in the lane for the \p priority
+         */
+        int size(TaskPriority priority) const;
+
     private:
-        /// The queue of tasks
-        std::queue<ThreadPool::Task> _queue;
+        /// The queues of tasks, one for each TaskPriority
+        std::array<std::queue<ThreadPool::Task*>, NTaskPriorities> _queues;
+
+        /// The number of tasks in each of the queues, which can be read without locking
+        std::array<std::atomic_int, NTaskPriorities> _sizes = {};
 
         /// The mutex protecting the queue. As the mutex is also required by const
         /// functions, it is declared 'mutable'
         mutable std::mutex _queueMutex;
     };
 
+    /**
+     * This class is a lock-free double-ended queue of tasks that is owned by a single
+     * Worker, based on the algorithm described in "Correct and Efficient Work-Stealing
+     * for Weak Memory Models" by Lê et al. (2013). The owning Worker pushes and pops
+     * tasks at the bottom of the queue without taking a lock, while any other thread can
+     * steal tasks from the top of the queue. The queue grows automatically if more tasks
+     * are pushed than it can hold.
+     */
+    class WorkStealingQueue {
+    public:
+        /**
+         * Creates an empty queue that can initially hold \p capacity tasks.
+         *
+         * \param capacity The initial capacity of the queue
+         *
+         * \pre \p capacity must be a power of two
+         */
+        explicit WorkStealingQueue(int64_t capacity = 256);
+
+        /**
+         * Destroys the queue and all of the tasks that were still remaining in it.
+         */
+        ~WorkStealingQueue();
+
+        /**
+         * Pushes the \p task to the bottom of the queue. This function must only be
+         * called by the thread that owns this queue.
+         *
+         * \param task The task to be pushed onto the queue. The queue takes ownership of
+         *        the task
+         */
+        void push(Task* task);
+
+        /**
+         * Removes and returns the task at the bottom of the queue, which is the task that
+         * was pushed last. This function must only be called by the thread that owns
+         * this queue.
+         *
+         * \return The task that was removed or `nullptr` if the queue was empty. The
+         *         caller takes ownership of the task
+         */
+        Task* pop();
+
+        /**
+         * Removes and returns the task at the top of the queue, which is the oldest task.
+         * This function can be called from any thread.
+         *
+         * \return The task that was removed or `nullptr` if the queue was empty or the
+         *         task was taken by a different thread at the same time. The caller takes
+         *         ownership of the task
+         */
+        Task* steal();
+
+        /**
+         * Returns the approximate number of tasks in the queue. As the queue might be
+         * modified concurrently, the value is only a snapshot.
+         *
+         * \return The approximate number of tasks in the queue
+         */
+        int size() const;
+
+    private:
+        /// The circular storage of the tasks. The capacity is always a power of two
+        struct Storage {
+            explicit Storage(int64_t cap);
+
+            Task* get(int64_t i) const;
+            void put(int64_t i, Task* task);
+
+            const int64_t capacity;
+            std::unique_ptr<std::atomic<Task*>[]> data;
+        };
+
+        /// The index of the oldest task; only ever incremented by successful steals or
+        /// by the owner popping the last remaining task
+        alignas(64) std::atomic<int64_t> _top = 0;
+        /// The index one past the newest task; only ever modified by the owner
+        alignas(64) std::atomic<int64_t> _bottom = 0;
+        /// The currently active storage
+        std::atomic<Storage*> _storage;
+        /// The number of thieves that are currently inside #steal
+        std::atomic<int> _nThieves = 0;
+        /// The active storage followed by all storages that have been replaced. Replaced
+        /// storages have to stay alive as concurrent thieves might still be reading from
+        /// them and are only released by the owner once no thief is active
+        std::vector<std::unique_ptr<Storage>> _storages;
+    };
+
+    /**
+     * The list of all WorkStealingQueue%s of the Worker%s that are currently active. This
+     * is used by idle Worker%s to find victims to steal from.
+     */
+    struct WorkerQueues {
+        /// The mutex protecting the list of queues
+        std::mutex mutex;
+        /// The queues of all active Worker%s
+        std::vector<std::shared_ptr<WorkStealingQueue>> queues;
+        /// Incremented each time the list of queues changes, which lets the Worker%s
+        /// refresh their cached copy of the list only when necessary
+        std::atomic<uint64_t> generation = 0;
+    };
+
+    /**
+     * A group of tasks that are spawned by one of the fork-join functions and whose
+     * completion the spawning thread waits for. The TaskGroup lives on the stack of the
+     * spawning thread, which is safe as that thread does not return before all of the
+     * tasks of the group have finished.
+     */
+    struct TaskGroup {
+        /// The number of tasks of this group that have not finished or been discarded
+        /// yet. The waiting thread is notified when this reaches 0
+        std::atomic_int nRemaining = 0;
+        /// Is set to `true` by the first task that throws an exception or is discarded
+        std::atomic_bool hasException = false;
+        /// The exception that was thrown by the first failing task
+        std::exception_ptr exception;
+    };
+
+    /**
+     * The function object of a task that belongs to a TaskGroup. Once the task has been
+     * executed or discarded without being executed, for example by #clearRemainingTasks,
+     * the destructor removes the task from its TaskGroup. A discarded task stores a
+     * RuntimeError in the TaskGroup, so that the waiting thread does not wait forever.
+     */
+    template <typename Function>
+    struct GroupTask {
+        GroupTask(TaskGroup& group_, Function function_);
+        GroupTask(GroupTask&& other) noexcept;
+        ~GroupTask();
+
+        /// Executes the #function and records a potential exception in the #group
+        void operator()();
+
+        /// The group to which the task belongs or `nullptr` if it has been moved from
+        TaskGroup* group = nullptr;
+        /// Whether the task has been executed
+        bool hasRun = false;
+        /// The function that is executed by the task
+        std::optional<Function> function;
+    };
+
+    /**
+     * Queues the \p function as a task that is part of the \p group. Contrary to the
+     * #queue function, no `std::packaged_task` or `std::future` is created.
+     *
+     * \param group The TaskGroup to which the new task belongs
+     * \param function The function that is executed by the task
+     */
+    template <typename Function>
+    void spawn(TaskGroup& group, Function&& function);
+
+    /**
+     * Processes the half-open range [\p begin, \p end) by calling \p body for
+     * consecutive chunks of at most \p grain indices. Before each chunk, the upper half
+     * of the remaining range is split off into a new task of the \p group as long as the
+     * range is bigger than \p grain and either \p eagerSplits is bigger than 0 or there
+     * are idle Worker%s.
+     *
+     * \param group The TaskGroup to which newly created tasks belong
+     * \param begin The first index of the range
+     * \param end The index one past the last index of the range
+     * \param grain The minimum number of indices that are processed in one task
+     * \param eagerSplits The number of times the range is split regardless of whether
+     *        there are idle Worker%s or not
+     * \param body The function that is called with the beginning and the end of each
+     *        chunk
+     */
+    template <typename Index, typename Body>
+    void processRange(TaskGroup& group, Index begin, Index end, Index grain,
+        int eagerSplits, Body& body);
+
+    /**
+     * Executes the \p function and stores a potential exception in the \p group if it
+     * is the first exception of the group.
+     *
+     * \param group The TaskGroup to which the \p function belongs
+     * \param function The function that is executed
+     */
+    template <typename Function>
+    static void runInGroup(TaskGroup& group, Function& function);
+
+    /**
+     * Blocks until all tasks of the \p group have finished. While waiting, the calling
+     * thread executes pending tasks of this ThreadPool and only goes to sleep once there
+     * are no pending tasks left. If one of the tasks of the \p group has thrown an
+     * exception or has been discarded, the exception is rethrown from this function.
+     *
+     * \param group The TaskGroup whose tasks are waited for
+     */
+    void wait(TaskGroup& group);
+
+    /**
+     * Removes a single pending task from the queues of this ThreadPool and executes it on
+     * the calling thread.
+     *
+     * \return `true` if a task was executed, `false` if no task was available
+     */
+    bool runPendingTask();
+
+    /**
+     * Creates a new Task that executes the \p function. The Task is taken from the pool
+     * of reusable slots and the \p function is stored inline if it is small enough.
+     *
+     * \param function The function that is executed by the Task
+     * \return The newly created Task. The caller takes ownership of the Task
+     */
+    template <typename Function>
+    static Task* createTask(Function&& function);
+
+    /**
+     * Executes the \p task and returns its slot to the pool. Exceptions that are thrown
+     * by the task are caught and logged. If the CancellationToken of the \p task has
+     * been cancelled, the \p task is discarded instead. The execution is recorded in the
+     * \p counters.
+     *
+     * \param task The task that is executed
+     * \param counters The metrics counters of the calling thread
+     */
+    static void runTask(Task* task, WorkerCounters& counters);
+
+    /**
+     * Destroys the \p task without executing it and returns its slot to the pool.
+     *
+     * \param task The task that is discarded
+     */
+    static void discardTask(Task* task);
+
+    /// The thread-local cache of free Task slots that sits in front of the shared pool
+    struct TaskCache;
+
+    /**
+     * Returns an uninitialized Task slot from the cache of the calling thread. Only if
+     * the cache is empty, a batch of slots is taken from the shared pool.
+     *
+     * \return An uninitialized Task slot
+     */
+    static Task* allocateTask();
+
+    /**
+     * Returns the Task slot \p task to the cache of the calling thread. Only if the
+     * cache grows too big, a batch of slots is handed back to the shared pool.
+     *
+     * \param task The Task slot that is no longer used
+     */
+    static void freeTask(Task* task);
+
+    /**
+     * Pushes the \p task into the appropriate queue and wakes up an idle Worker. If the
+     * calling thread is a Worker of this ThreadPool, work stealing is enabled, and the
+     * task has TaskPriority::Normal, the task is pushed onto the Worker's local
+     * WorkStealingQueue, otherwise it is pushed onto the shared TaskQueue.
+     *
+     * \param task The task that is to be executed. The ThreadPool takes ownership of the
+     *        task
+     * \param options The options that determine the priority and cancellation of the
+     *        \p task
+     */
+    void enqueue(Task* task, const TaskOptions& options);
+
+    BooleanType(WakeAll);
+
+    /**
+     * Wakes up one or all of the Worker%s that are waiting for tasks. This function has
+     * to be called after a new task has been made available or after the state of the
+     * ThreadPool has changed in a way that sleeping Worker%s need to know about. If
+     * \p all is `WakeAll::No` and no Worker is waiting, this function does not acquire
+     * any lock.
+     *
+     * \param all Whether all Worker%s or a single Worker should be woken up
+     */
+    void wakeWorkers(WakeAll all);
+
+    /**
+     * Activates the Worker%s in the half-open range [\p begin, \p end) of #_workers and
+     * blocks until all of them have finished their initialization.
+     *
+     * \param begin The index of the first Worker that is activated
+     * \param end The index one past the last Worker that is activated
+     */
+    void activateWorkers(int begin, int end);
+
     /**
      * Activate the \p worker by creating a `std::thread` with the lambda expression that
      * will do all of the work inside the Worker. This function will overwrite the values
-     * of the passed \p worker.
+     * of the passed \p worker. This function does not wait for the Worker to start, but
+     * the Worker counts down the \p initialized latch once it has been initialized.
      *
      * \param worker The worker to be set by this function
+     * \param initialized The latch that is counted down once the Worker is initialized
      */
-    void activateWorker(Worker& worker);
+    void activateWorker(Worker& worker, std::shared_ptr<std::latch> initialized);
 
     /// The list of all workers managed by this ThreadPool
     std::vector<Worker> _workers;
@@ -373,6 +1158,12 @@ private:
     /// The list of remaining tasks that might be addressed by the available Worker%s
     std::shared_ptr<TaskQueue> _taskQueue;
 
+    /// The queues of all Worker%s if work stealing is enabled, `nullptr` otherwise
+    std::shared_ptr<WorkerQueues> _workerQueues;
+
+    /// The metrics counters of all Worker%s
+    std::shared_ptr<MetricsRegistry> _metrics;
+
     /// `true` if the ThreadPool is currently running, false otherwise
     std::shared_ptr<std::atomic_bool> _isRunning;
 
@@ -405,6 +1196,19 @@ private:
     /// Whether all Worker%s of this ThreadPool are started in the background mode (if
     /// supported by the operating system)
     thread::Background _threadBackground;
+    /// The placement of the Worker%s on the processors of the system. The topology
+    /// always contains at least one node with at least one processor
+    thread::Placement _placement;
+
+    /// The WorkStealingQueue of the current thread if it is a Worker of a ThreadPool that
+    /// uses work stealing, `nullptr` otherwise
+    static thread_local WorkStealingQueue* _localQueue;
+    /// The WorkerQueues of the ThreadPool that owns the current thread. Used to check
+    /// whether the _localQueue belongs to a specific ThreadPool
+    static thread_local const WorkerQueues* _localQueueOwner;
+    /// The metrics counters of the current thread if it is a Worker of a ThreadPool,
+    /// `nullptr` otherwise
+    static thread_local WorkerCounters* _localCounters;
 };
 
 } // namespace ghoul
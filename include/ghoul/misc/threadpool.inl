@@ -23,29 +23,44 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/defer.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <bit>
+#include <new>
+#include <type_traits>
+#include <utility>
+
 namespace ghoul {
 
 template <typename F, typename... Arg>
 auto ThreadPool::queue(F&& f, Arg&&... arg) -> std::future<decltype(f(arg...))> {
+    return queue(TaskOptions(), std::forward<F>(f), std::forward<Arg>(arg)...);
+}
+
+template <typename F, typename... Arg>
+auto ThreadPool::queue(const TaskOptions& options, F&& f, Arg&&... arg)
+    -> std::future<decltype(f(arg...))>
+{
     using ReturnType = decltype(f(arg...));
 
-    const std::unique_lock lock(_queueMutex);
-    // We wrap the packaged_task into a shared pointer so that we can store it in the
-    // lambda expression below. The capture of the lambda expression will keep this
-    // packaged_task alive
-    auto pck = std::make_shared<std::packaged_task<ReturnType ()>>(
-        std::bind(std::forward<F>(f), std::forward<Arg>(arg)...)
+    // The packaged_task stores the function and arguments together with the shared state
+    // of the future, which is the only memory allocation required here. The
+    // packaged_task itself is moved into the inline storage of the Task
+    std::packaged_task<ReturnType ()> pck(
+        [f = std::forward<F>(f), ...arg = std::forward<Arg>(arg)]() mutable {
+            return std::invoke(f, arg...);
+        }
     );
 
-    // Push the packaged packaged_task onto the queue of work items
-    _taskQueue->push([pck]() { (*pck)(); });
-
     // Get the future of the result (which might be std::future<void>, but that is not a
     // problem
-    std::future<ReturnType> future = pck->get_future();
+    std::future<ReturnType> future = pck.get_future();
 
-    // Notify a potentially waiting thread that a new task is available
-    _cv->notify_one();
+    // Push the packaged packaged_task onto the queue of work items. This will also
+    // notify a potentially waiting thread that a new task is available
+    enqueue(createTask([pck = std::move(pck)]() mutable { pck(); }), options);
 
     // And return the future back to the caller
     return future;
@@ -57,16 +72,244 @@ template <typename T, typename... Args>
 auto ThreadPool::queue(std::packaged_task<T>&& task, Args&&...)
     -> decltype(task.get_future())
 {
-    const std::unique_lock lock(_queueMutex);
+    auto future = task.get_future();
+    enqueue(createTask([pck = std::move(task)]() mutable { pck(); }), TaskOptions());
+    return future;
+}
 
-    auto pck = std::make_shared<std::packaged_task<T>>(std::move(task));
-    _taskQueue->push([pck]() { (*pck)(); });
+template <typename Function, typename... Args>
+    requires (!std::is_same_v<std::decay_t<Function>, ThreadPool::TaskOptions>)
+void ThreadPool::submit(Function&& function, Args&&... arguments) {
+    submit(
+        TaskOptions(),
+        std::forward<Function>(function),
+        std::forward<Args>(arguments)...
+    );
+}
 
-    std::future<T> future = pck->get_future();
+template <typename Function, typename... Args>
+void ThreadPool::submit(const TaskOptions& options, Function&& function,
+                        Args&&... arguments)
+{
+    if constexpr (sizeof...(Args) == 0) {
+        enqueue(createTask(std::forward<Function>(function)), options);
+    }
+    else {
+        enqueue(
+            createTask(
+                [f = std::forward<Function>(function),
+                 ...args = std::forward<Args>(arguments)]() mutable
+                {
+                    std::invoke(f, args...);
+                }
+            ),
+            options
+        );
+    }
+}
 
-    _cv->notify_one();
+template <typename Index, typename Function>
+void ThreadPool::parallelFor(Index begin, Index end, Index grain, Function&& function) {
+    static_assert(std::is_integral_v<Index>, "Index must be an integral type");
+    ghoul_assert(grain > 0, "grain must be bigger than 0");
 
-    return future;
+    if (begin >= end) {
+        return;
+    }
+
+    auto body = [&function](Index b, Index e) {
+        for (Index i = b; i < e; i++) {
+            function(i);
+        }
+    };
+
+    TaskGroup group;
+    const int eagerSplits = std::bit_width(static_cast<unsigned int>(size()));
+    auto root = [&]() { processRange(group, begin, end, grain, eagerSplits, body); };
+    runInGroup(group, root);
+    wait(group);
+}
+
+template <typename Index, typename T, typename Map, typename Reduce>
+T ThreadPool::parallelReduce(Index begin, Index end, Index grain, T identity, Map&& map,
+                             Reduce&& reduce)
+{
+    static_assert(std::is_integral_v<Index>, "Index must be an integral type");
+    ghoul_assert(grain > 0, "grain must be bigger than 0");
+
+    if (begin >= end) {
+        return identity;
+    }
+
+    // Each chunk is reduced locally first and only the partial result of the chunk is
+    // combined with the global result, so the lock is only taken once per chunk
+    std::mutex resultMutex;
+    T result = identity;
+    auto body = [&](Index b, Index e) {
+        T partial = identity;
+        for (Index i = b; i < e; i++) {
+            partial = reduce(std::move(partial), map(i));
+        }
+        const std::lock_guard lock(resultMutex);
+        result = reduce(std::move(result), std::move(partial));
+    };
+
+    TaskGroup group;
+    const int eagerSplits = std::bit_width(static_cast<unsigned int>(size()));
+    auto root = [&]() { processRange(group, begin, end, grain, eagerSplits, body); };
+    runInGroup(group, root);
+    wait(group);
+    return result;
+}
+
+template <typename Function, typename... Functions>
+void ThreadPool::parallelInvoke(Function&& function, Functions&&... functions) {
+    TaskGroup group;
+    (spawn(group, [&f = functions]() { f(); }), ...);
+    runInGroup(group, function);
+    wait(group);
+}
+
+template <typename Index, typename Body>
+void ThreadPool::processRange(TaskGroup& group, Index begin, Index end, Index grain,
+                              int eagerSplits, Body& body)
+{
+    while (begin < end) {
+        // Split off the upper half of the range into a new task as long as the range is
+        // big enough and there is someone that could work on it. The first splits always
+        // happen so that each Worker receives a part of the range right away
+        while (end - begin > grain && (eagerSplits > 0 || idleThreads() > 0)) {
+            const Index mid = begin + (end - begin) / 2;
+            eagerSplits = std::max(eagerSplits - 1, 0);
+            spawn(group, [this, &group, mid, end, grain, eagerSplits, &body]() {
+                processRange(group, mid, end, grain, eagerSplits, body);
+            });
+            end = mid;
+        }
+
+        const Index chunkEnd = (end - begin > grain) ? begin + grain : end;
+        body(begin, chunkEnd);
+        begin = chunkEnd;
+    }
+}
+
+template <typename Function>
+ThreadPool::GroupTask<Function>::GroupTask(TaskGroup& group_, Function function_)
+    : group(&group_)
+    , function(std::move(function_))
+{}
+
+template <typename Function>
+ThreadPool::GroupTask<Function>::GroupTask(GroupTask&& other) noexcept
+    : group(std::exchange(other.group, nullptr))
+    , hasRun(other.hasRun)
+    , function(std::move(other.function))
+{}
+
+template <typename Function>
+ThreadPool::GroupTask<Function>::~GroupTask() {
+    if (!group) {
+        // We have been moved from
+        return;
+    }
+
+    // The function might reference objects that only live as long as the group, so it
+    // has to be destroyed before the group is notified
+    function.reset();
+
+    if (!hasRun && !group->hasException.exchange(true)) {
+        group->exception = std::make_exception_ptr(RuntimeError(
+            "A task of a parallel operation was discarded before it was executed",
+            "ThreadPool"
+        ));
+    }
+
+    // The group might be destroyed immediately after this decrement, so it must be the
+    // last access to it. Same as for `std::latch`, the notification only uses the
+    // address of the counter and does not access the counter itself anymore
+    std::atomic_int* nRemaining = &group->nRemaining;
+    if (nRemaining->fetch_sub(1) == 1) {
+        nRemaining->notify_all();
+    }
+}
+
+template <typename Function>
+void ThreadPool::GroupTask<Function>::operator()() {
+    hasRun = true;
+    runInGroup(*group, *function);
+}
+
+template <typename Function>
+void ThreadPool::spawn(TaskGroup& group, Function&& function) {
+    group.nRemaining++;
+    // If the task is discarded instead of executed, for example by clearRemainingTasks,
+    // the destructor of the GroupTask still removes it from the group
+    Task* task = createTask(
+        GroupTask<std::decay_t<Function>>(group, std::forward<Function>(function))
+    );
+    enqueue(task, TaskOptions());
+}
+
+template <typename Function>
+void ThreadPool::runInGroup(TaskGroup& group, Function& function) {
+    try {
+        function();
+    }
+    catch (...) {
+        if (!group.hasException.exchange(true)) {
+            group.exception = std::current_exception();
+        }
+    }
+}
+
+template <typename Function>
+ThreadPool::Task* ThreadPool::createTask(Function&& function) {
+    using F = std::decay_t<Function>;
+
+    Task* task = allocateTask();
+    if constexpr (sizeof(F) <= Task::StorageSize &&
+                  alignof(F) <= alignof(std::max_align_t))
+    {
+        try {
+            new (task->storage) F(std::forward<Function>(function));
+        }
+        catch (...) {
+            freeTask(task);
+            throw;
+        }
+
+        task->run = [](Task& t) {
+            F* f = std::launder(reinterpret_cast<F*>(t.storage));
+            defer { f->~F(); };
+            (*f)();
+        };
+        task->discard = [](Task& t) {
+            std::launder(reinterpret_cast<F*>(t.storage))->~F();
+        };
+    }
+    else {
+        // The function does not fit into the inline storage, so we have to store it on
+        // the heap and only keep the pointer in the Task
+        F* ptr = nullptr;
+        try {
+            ptr = new F(std::forward<Function>(function));
+        }
+        catch (...) {
+            freeTask(task);
+            throw;
+        }
+        new (task->storage) F*(ptr);
+
+        task->run = [](Task& t) {
+            F* f = *std::launder(reinterpret_cast<F**>(t.storage));
+            defer { delete f; };
+            (*f)();
+        };
+        task->discard = [](Task& t) {
+            delete *std::launder(reinterpret_cast<F**>(t.storage));
+        };
+    }
+    return task;
 }
 
 } // namespace ghoul
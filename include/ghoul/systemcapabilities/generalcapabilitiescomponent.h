@@ -28,7 +28,9 @@
 
 #include <ghoul/systemcapabilities/systemcapabilitiescomponent.h>
 
+#include <ghoul/misc/thread.h>
 #include <ghoul/systemcapabilities/systemcapabilities.h>
+#include <vector>
 
 namespace ghoul::systemcapabilities {
 
@@ -168,6 +170,16 @@ public:
      */
     unsigned int cacheSize() const;
 
+    /**
+     * Returns the NUMA nodes of this computer together with the logical processors that
+     * belong to each node. On systems without multiple NUMA nodes or where the topology
+     * cannot be detected, a single node containing all logical processors is returned.
+     * The result can be used to place the Worker%s of a ThreadPool.
+     *
+     * \return The NUMA nodes of this computer
+     */
+    const std::vector<thread::NumaNode>& numaNodes() const;
+
     /**
      * Returns all supported exteions as comma separated string.
      *
@@ -212,6 +224,11 @@ protected:
      */
     void detectCPU();
 
+    /**
+     * Detects the NUMA nodes and the logical processors that belong to each of them.
+     */
+    void detectNumaTopology();
+
     /// Information about the operating system
     OperatingSystem _operatingSystem = OperatingSystem::Unknown;
     std::string _operatingSystemExtra;
@@ -237,6 +254,9 @@ protected:
 
     /// Available CPU extensions
     std::string _extensions;
+
+    /// The NUMA nodes and their logical processors
+    std::vector<thread::NumaNode> _numaNodes;
 };
 
 } // namespace ghoul::systemcapabilities
@@ -30,6 +30,7 @@
 #include <ghoul/format.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/assert.h>
+#include <ghoul/misc/framearena.h>
 #include <ghoul/misc/profiling.h>
 #include <ghoul/misc/stringhelper.h>
 #include <ghoul/opengl/programobject.h>
@@ -465,9 +466,13 @@ FontRenderer::BoundingBoxInformation FontRenderer::render(Font& font,
 
     _program->activate();
 
-    std::vector<float> vertexBuffer;
+    // The buffers are only needed until they are uploaded, so they are placed in the
+    // scratch memory of the current thread
+    FrameArena& arena = FrameArena::threadLocal();
+    const FrameArena::Scope scope(arena);
+    frame_vector<float> vertexBuffer(&arena);
     vertexBuffer.reserve(128 * 10);
-    std::vector<GLushort> indexBuffer;
+    frame_vector<GLushort> indexBuffer(&arena);
     indexBuffer.reserve(128 * 10);
 
     GLushort vertexIndex = 0;
@@ -583,9 +588,13 @@ FontRenderer::BoundingBoxInformation FontRenderer::render(Font& font,
 {
     const float h = font.height();
 
-    std::vector<float> vertexBuffer;
+    // The buffers are only needed until they are uploaded, so they are placed in the
+    // scratch memory of the current thread
+    FrameArena& arena = FrameArena::threadLocal();
+    const FrameArena::Scope scope(arena);
+    frame_vector<float> vertexBuffer(&arena);
     vertexBuffer.reserve(128 * 10);
-    std::vector<GLushort> indexBuffer;
+    frame_vector<GLushort> indexBuffer(&arena);
     indexBuffer.reserve(128 * 10);
 
     const size_t lines = std::count(text.begin(), text.end(), '\n') + 1;
@@ -0,0 +1,535 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2026                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <ghoul/logging/binarylog.h>
+
+#include <ghoul/format.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+#ifdef WIN32
+#include <Windows.h>
+#else // ^^^^ WIN32 // !WIN32 vvvv
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif // WIN32
+
+namespace {
+    using namespace ghoul::logging;
+
+    constexpr std::array<char, 4> Magic = { 'G', 'L', 'O', 'G' };
+    constexpr uint32_t Version = 1;
+    constexpr uint32_t ByteOrderMark = 0x01020304;
+
+    struct Header {
+        std::array<char, 4> magic;
+        uint32_t version;
+        uint32_t byteOrder;
+        uint32_t reserved;
+        /// The creation time of the file in microseconds since the epoch
+        int64_t startTime;
+        /// The number of bytes in the file that contain valid records, including the
+        /// header. This is updated after every record so that the file can be read
+        /// while it is still being written
+        uint64_t size;
+    };
+    static_assert(sizeof(Header) == 32);
+
+    // The record types are part of the file format, so new types must only be added to
+    // the end and existing types must not be reordered
+    enum class RecordType : uint8_t {
+        // Defines the name of the next category identifier
+        Category = 0,
+        // Defines the next format string identifier
+        Format,
+        // A message that is stored as text
+        Message,
+        // A message that is stored as a format string identifier and encoded arguments
+        FormattedMessage
+    };
+
+    // The longest possible encoding of a 64-bit varint
+    constexpr size_t MaxVarintSize = 10;
+
+    void appendVarint(std::string& buffer, uint64_t value) {
+        while (value >= 0x80) {
+            buffer += static_cast<char>((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        buffer += static_cast<char>(value);
+    }
+
+    // Maps signed values to unsigned ones so that small negative values, which happen if
+    // the system clock is adjusted, also result in a short varint
+    uint64_t zigzag(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    int64_t unzigzag(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    int64_t microsecondsSinceEpoch(std::chrono::system_clock::time_point time) {
+        using namespace std::chrono;
+        return duration_cast<microseconds>(time.time_since_epoch()).count();
+    }
+
+    // Moves all existing log files one position up, the same way the TextLog does
+    void moveLogFiles(const std::filesystem::path& filename, int nLogRotation) {
+        const std::filesystem::path fname = filename.stem();
+        const std::filesystem::path ext = filename.extension();
+
+        for (int i = nLogRotation; i > 0; i--) {
+            std::filesystem::path newCandidate = filename;
+            newCandidate.replace_filename(std::format("{}-{}{}", fname, i, ext));
+
+            std::filesystem::path oldCandidate = filename;
+            if (i > 1) {
+                // We don't actually have a -0 version, it is just the base name
+                oldCandidate.replace_filename(std::format("{}-{}{}", fname, i - 1, ext));
+            }
+
+            std::error_code ec;
+            std::filesystem::remove(newCandidate, ec);
+            std::filesystem::rename(oldCandidate, newCandidate, ec);
+        }
+    }
+} // namespace
+
+namespace ghoul::logging {
+
+struct BinaryLog::MappedFile {
+    MappedFile(const std::filesystem::path& path, size_t capacity_);
+    ~MappedFile();
+
+    void write(std::string_view record);
+    void flush() const;
+
+    std::byte* data = nullptr;
+    size_t capacity = 0;
+    size_t size = sizeof(Header);
+    std::chrono::system_clock::time_point created;
+
+#ifdef WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else // ^^^^ WIN32 // !WIN32 vvvv
+    int file = -1;
+#endif // WIN32
+};
+
+BinaryLog::MappedFile::MappedFile(const std::filesystem::path& path, size_t capacity_)
+    : capacity(capacity_)
+    , created(std::chrono::system_clock::now())
+{
+    ZoneScoped;
+
+#ifdef WIN32
+    file = CreateFileW(
+        path.c_str(),
+        GENERIC_READ | GENERIC_WRITE,
+        FILE_SHARE_READ,
+        nullptr,
+        CREATE_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE) {
+        throw RuntimeError(std::format("Error creating file '{}'", path), "BinaryLog");
+    }
+    const uint64_t c = capacity;
+    mapping = CreateFileMappingW(
+        file,
+        nullptr,
+        PAGE_READWRITE,
+        static_cast<DWORD>(c >> 32),
+        static_cast<DWORD>(c & 0xFFFFFFFF),
+        nullptr
+    );
+    if (!mapping) {
+        CloseHandle(file);
+        throw RuntimeError(std::format("Error mapping file '{}'", path), "BinaryLog");
+    }
+    void* d = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, capacity);
+    if (!d) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        throw RuntimeError(std::format("Error mapping file '{}'", path), "BinaryLog");
+    }
+#else // ^^^^ WIN32 // !WIN32 vvvv
+    file = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (file == -1) {
+        throw RuntimeError(std::format("Error creating file '{}'", path), "BinaryLog");
+    }
+    if (ftruncate(file, static_cast<off_t>(capacity)) != 0) {
+        close(file);
+        throw RuntimeError(std::format("Error resizing file '{}'", path), "BinaryLog");
+    }
+    void* d = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    if (d == MAP_FAILED) {
+        close(file);
+        throw RuntimeError(std::format("Error mapping file '{}'", path), "BinaryLog");
+    }
+#endif // WIN32
+    data = static_cast<std::byte*>(d);
+
+    const Header header = {
+        .magic = Magic,
+        .version = Version,
+        .byteOrder = ByteOrderMark,
+        .reserved = 0,
+        .startTime = microsecondsSinceEpoch(created),
+        .size = size
+    };
+    std::memcpy(data, &header, sizeof(Header));
+}
+
+BinaryLog::MappedFile::~MappedFile() {
+    // The file was created with its full capacity, so we cut off the unused part
+#ifdef WIN32
+    UnmapViewOfFile(data);
+    CloseHandle(mapping);
+    LARGE_INTEGER s;
+    s.QuadPart = static_cast<LONGLONG>(size);
+    SetFilePointerEx(file, s, nullptr, FILE_BEGIN);
+    SetEndOfFile(file);
+    CloseHandle(file);
+#else // ^^^^ WIN32 // !WIN32 vvvv
+    munmap(data, capacity);
+    [[maybe_unused]] const int res = ftruncate(file, static_cast<off_t>(size));
+    close(file);
+#endif // WIN32
+}
+
+void BinaryLog::MappedFile::write(std::string_view record) {
+    ghoul_assert(size + record.size() <= capacity, "Record does not fit into the file");
+
+    std::memcpy(data + size, record.data(), record.size());
+    size += record.size();
+
+    // A reader of the file that is still being written must not see the new size before
+    // the record that it covers
+    uint64_t& s = *reinterpret_cast<uint64_t*>(data + offsetof(Header, size));
+    std::atomic_ref<uint64_t>(s).store(size, std::memory_order_release);
+}
+
+void BinaryLog::MappedFile::flush() const {
+#ifdef WIN32
+    FlushViewOfFile(data, size);
+#else // ^^^^ WIN32 // !WIN32 vvvv
+    msync(data, size, MS_ASYNC);
+#endif // WIN32
+}
+
+BinaryLog::BinaryLog(std::filesystem::path filename, size_t maxFileSize,
+                     std::chrono::seconds maxFileAge, int nLogRotation,
+                     LogLevel minimumLogLevel)
+    : Log(
+        TimeStamping::Yes,
+        DateStamping::Yes,
+        CategoryStamping::Yes,
+        LogLevelStamping::Yes,
+        minimumLogLevel
+    )
+    , _filename(std::move(filename))
+    , _maxFileSize(maxFileSize)
+    , _maxFileAge(maxFileAge)
+    , _nLogRotation(nLogRotation)
+{
+    ghoul_assert(!_filename.empty(), "Filename must not be empty");
+    ghoul_assert(_maxFileSize >= 4096, "Maximum file size must be at least 4096 bytes");
+    ghoul_assert(_nLogRotation >= 0, "Log rotation must not be negative");
+
+    rotate(0);
+}
+
+BinaryLog::~BinaryLog() = default;
+
+void BinaryLog::log(LogLevel level, std::string_view category, std::string_view message)
+{
+    ZoneScoped;
+
+    writeRecord(level, category, message, nullptr);
+}
+
+void BinaryLog::logDeferred(LogLevel level, std::string_view category,
+                            std::string_view message, const DeferredMessage& deferred)
+{
+    ZoneScoped;
+
+    if (hasPortableArguments(deferred.arguments)) {
+        writeRecord(level, category, message, &deferred);
+    }
+    else {
+        writeRecord(level, category, message, nullptr);
+    }
+}
+
+void BinaryLog::flush() {
+    const std::lock_guard lock(_mutex);
+    if (_file) {
+        _file->flush();
+    }
+}
+
+void BinaryLog::encodeRecord(LogLevel level, std::string_view category,
+                             std::string_view message, const DeferredMessage* deferred,
+                             int64_t timestamp)
+{
+    _record.clear();
+
+    // Returns the identifier for the `value`, writing its definition first if it is new
+    auto intern = [this](IdMap& map, RecordType type, std::string_view value) {
+        const auto it = map.find(value);
+        if (it != map.end()) {
+            return it->second;
+        }
+        const uint32_t id = static_cast<uint32_t>(map.size());
+        _record += static_cast<char>(type);
+        appendVarint(_record, id);
+        appendVarint(_record, value.size());
+        _record += value;
+        map.emplace(value, id);
+        return id;
+    };
+
+    const uint32_t categoryId = intern(_categories, RecordType::Category, category);
+    if (deferred) {
+        const uint32_t formatId = intern(_formats, RecordType::Format, deferred->format);
+        _record += static_cast<char>(RecordType::FormattedMessage);
+        appendVarint(_record, zigzag(timestamp - _previousTimestamp));
+        _record += static_cast<char>(level);
+        appendVarint(_record, categoryId);
+        appendVarint(_record, formatId);
+        appendVarint(_record, deferred->arguments.size());
+        _record += deferred->arguments;
+    }
+    else {
+        _record += static_cast<char>(RecordType::Message);
+        appendVarint(_record, zigzag(timestamp - _previousTimestamp));
+        _record += static_cast<char>(level);
+        appendVarint(_record, categoryId);
+        appendVarint(_record, message.size());
+        _record += message;
+    }
+}
+
+void BinaryLog::writeRecord(LogLevel level, std::string_view category,
+                            std::string_view message, const DeferredMessage* deferred)
+{
+    // In the asynchronous mode of the LogManager, messages are written some time after
+    // they were logged, so the time of the message is used instead of the current time
+    const std::chrono::system_clock::time_point now = messageTime();
+    const int64_t timestamp = microsecondsSinceEpoch(now);
+
+    const std::lock_guard lock(_mutex);
+    if (!_file) {
+        // A previous rotation failed to create the new file
+        return;
+    }
+    if (_maxFileAge.count() > 0 && now - _file->created >= _maxFileAge) {
+        rotate(0);
+    }
+
+    encodeRecord(level, category, message, deferred, timestamp);
+    if (_file->size + _record.size() > _file->capacity) {
+        // In the new file, the category and format string have to be defined again, so
+        // the record can become larger by at most these definitions
+        size_t maxRecordSize = _record.size() + category.size() + 2 * MaxVarintSize + 1;
+        if (deferred) {
+            maxRecordSize += deferred->format.size() + 2 * MaxVarintSize + 1;
+        }
+        rotate(sizeof(Header) + maxRecordSize);
+        encodeRecord(level, category, message, deferred, timestamp);
+    }
+
+    _file->write(_record);
+    _previousTimestamp = timestamp;
+}
+
+void BinaryLog::rotate(size_t minimumSize) {
+    ZoneScoped;
+
+    // Close the current file first so that it has its final size when it is moved. If
+    // the new file can't be created, #_file stays empty and all further messages are
+    // discarded, as we can't write them anywhere
+    _file = nullptr;
+    moveLogFiles(_filename, _nLogRotation);
+
+    _file = std::make_unique<MappedFile>(_filename, std::max(_maxFileSize, minimumSize));
+    _previousTimestamp = microsecondsSinceEpoch(_file->created);
+    _categories.clear();
+    _formats.clear();
+}
+
+BinaryLogError::BinaryLogError(std::string msg)
+    : RuntimeError(std::move(msg), "BinaryLog")
+{}
+
+BinaryLogReader::BinaryLogReader(const std::filesystem::path& path) {
+    ZoneScoped;
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.good()) {
+        throw RuntimeError(std::format("Error opening file '{}'", path), "BinaryLog");
+    }
+    _content = std::string(
+        std::istreambuf_iterator<char>(file),
+        std::istreambuf_iterator<char>()
+    );
+
+    if (_content.size() < sizeof(Header)) {
+        throw BinaryLogError(std::format("File '{}' is too small", path));
+    }
+    Header header;
+    std::memcpy(&header, _content.data(), sizeof(Header));
+    if (header.magic != Magic) {
+        throw BinaryLogError(std::format("File '{}' is not a binary log", path));
+    }
+    if (header.byteOrder != ByteOrderMark) {
+        throw BinaryLogError(std::format("File '{}' has a different byte order", path));
+    }
+    if (header.version != Version) {
+        throw BinaryLogError(std::format(
+            "File '{}' has unsupported version {}", path, header.version
+        ));
+    }
+    if (header.size < sizeof(Header) || header.size > _content.size()) {
+        throw BinaryLogError(std::format("File '{}' has an invalid size", path));
+    }
+
+    // Anything after the size in the header was not completely written
+    _content.resize(header.size);
+    _offset = sizeof(Header);
+    _timestamp = header.startTime;
+}
+
+std::optional<BinaryLogReader::Entry> BinaryLogReader::next() {
+    while (_offset < _content.size()) {
+        const RecordType type = static_cast<RecordType>(_content[_offset]);
+        _offset++;
+
+        switch (type) {
+            case RecordType::Category:
+            case RecordType::Format:
+            {
+                std::vector<std::string_view>& list =
+                    type == RecordType::Category ? _categories : _formats;
+                const uint64_t id = readVarint();
+                if (id != list.size()) {
+                    throw BinaryLogError("Identifiers are not consecutive");
+                }
+                const uint64_t length = readVarint();
+                list.push_back(readBytes(length));
+                break;
+            }
+            case RecordType::Message:
+            case RecordType::FormattedMessage:
+            {
+                _timestamp += unzigzag(readVarint());
+                const uint8_t level = static_cast<uint8_t>(readBytes(1)[0]);
+                if (level > static_cast<uint8_t>(LogLevel::NoLogging)) {
+                    throw BinaryLogError(std::format("Invalid log level {}", level));
+                }
+                const uint64_t categoryId = readVarint();
+                if (categoryId >= _categories.size()) {
+                    throw BinaryLogError("Undefined category");
+                }
+
+                Entry entry = {
+                    .time = std::chrono::system_clock::time_point(
+                        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                            std::chrono::microseconds(_timestamp)
+                        )
+                    ),
+                    .level = static_cast<LogLevel>(level),
+                    .category = std::string(_categories[categoryId]),
+                    .message = std::string()
+                };
+
+                if (type == RecordType::Message) {
+                    const uint64_t length = readVarint();
+                    entry.message = std::string(readBytes(length));
+                }
+                else {
+                    const uint64_t formatId = readVarint();
+                    if (formatId >= _formats.size()) {
+                        throw BinaryLogError("Undefined format string");
+                    }
+                    const uint64_t length = readVarint();
+                    const std::string_view arguments = readBytes(length);
+                    try {
+                        entry.message = formatArguments(_formats[formatId], arguments);
+                    }
+                    catch (const std::format_error&) {
+                        entry.message = std::string(_formats[formatId]);
+                    }
+                }
+                return entry;
+            }
+            default:
+                throw BinaryLogError(
+                    std::format("Unknown record type {}", static_cast<int>(type))
+                );
+        }
+    }
+    return std::nullopt;
+}
+
+uint64_t BinaryLogReader::readVarint() {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (_offset >= _content.size()) {
+            throw BinaryLogError("Unexpected end of file");
+        }
+        const uint8_t byte = static_cast<uint8_t>(_content[_offset]);
+        _offset++;
+        result |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return result;
+        }
+    }
+    throw BinaryLogError("Invalid variable-length integer");
+}
+
+std::string_view BinaryLogReader::readBytes(size_t size) {
+    if (size > _content.size() - _offset) {
+        throw BinaryLogError("Unexpected end of file");
+    }
+    const std::string_view result = std::string_view(_content).substr(_offset, size);
+    _offset += size;
+    return result;
+}
+
+} // namespace ghoul::logging
@@ -27,11 +27,22 @@
 
 #include <ghoul/format.h>
 #include <ghoul/misc/assert.h>
+#include <ghoul/misc/profiling.h>
+#include <ghoul/misc/sharedmemory.h>
+#include <algorithm>
 #include <atomic>
+#include <cstring>
 #include <fstream>
+#include <new>
 
 namespace {
-    constexpr uint8_t CurrentVersion = 1;
+    constexpr uint8_t CurrentVersion = 2;
+    constexpr size_t CacheLineSize = 64;
+
+    static_assert(
+        std::atomic<uint64_t>::is_always_lock_free,
+        "The BufferLog requires lock-free atomics to be usable across processes"
+    );
 
     struct Header {
         /**
@@ -41,170 +52,175 @@ namespace {
          */
         uint8_t version;
 
-        /**
-         * This atomic is set to `true` if some process is currently writing to the log,
-         * otherwise it is `false`. It is not guaranteed that this value is usable when
-         * the buffer is written to disk in its entirety.
-         */
-        std::atomic_flag mutex;
-
         /**
          * The attributes are used for user-defined behavior. Information that is
          * necessary to interpret the buffer may be put in here.
          */
         uint8_t attributes;
 
+        /// The size of each record in bytes, including the RecordHeader
+        uint32_t recordSize;
+
+        /// The number of records in the ring buffer
+        uint64_t nRecords;
+
+        /// The sequence number that will be handed out to the next message. The record
+        /// for a sequence number is located at position `sequence % nRecords`
+        alignas(CacheLineSize) std::atomic<uint64_t> head;
+
+        /// The number of messages that were discarded as a newer message already took
+        /// their record
+        alignas(CacheLineSize) std::atomic<uint64_t> nDropped;
+    };
+
+    struct RecordHeader {
         /**
-         * This value provides an offset to find the first byte in the buffer that has not
-         * been used already. The values between `_buffer + sizeof(Header)` and
-         * `_buffer + sizeof(Header) + firstEmptyByte` are the logs that have been stored
-         * before.
+         * The state of the record, which is `0` if the record has never been written.
+         * While the message with the sequence number `s` is being written, the state is
+         * `2 * s + 1`, afterwards it is `2 * s + 2`. As the state only ever increases, a
+         * reader can detect whether a record was overwritten while it was being read.
          */
-        uint32_t firstEmptyByte;
+        std::atomic<uint64_t> state;
+
+        /// The timestamp of the message
+        std::atomic<uint64_t> timestamp;
+
+        /// The length of the message, not including the `\0` terminator
+        std::atomic<uint32_t> length;
     };
 
+    constexpr size_t RecordHeaderSize = 24;
+    static_assert(sizeof(RecordHeader) <= RecordHeaderSize);
+
+    constexpr uint64_t writingState(uint64_t sequence) {
+        return 2 * sequence + 1;
+    }
+
+    constexpr uint64_t writtenState(uint64_t sequence) {
+        return 2 * sequence + 2;
+    }
+
     /**
-     * This method returns the beginning part of the buffer that contains the header
-     * information.
+     * Returns the first address inside the \p buffer at which the header can be placed.
+     * As the alignment only depends on the address itself, a reader in a different
+     * process will find the same location as long as the buffer is mapped at the same
+     * offset to a page boundary, which is the case for SharedMemory.
      */
-    Header& header(void* buffer) {
-        return *reinterpret_cast<Header*>(buffer);
+    template <typename T>
+    T* alignedHeader(T* buffer) {
+        const uintptr_t address = reinterpret_cast<uintptr_t>(buffer);
+        const uintptr_t offset =
+            (CacheLineSize - address % CacheLineSize) % CacheLineSize;
+        return buffer + offset;
     }
 
-    /**
-     * This method returns the buffer block that begins at the first empty byte. This
-     * offset is guaranteed to be in valid memory if the values provided in the
-     * constructor or the \see setBuffer function were correct.
-    */
-    void* firstEmptyMemory(void* buffer) {
-        const Header& h = header(buffer);
-
-        return reinterpret_cast<void*>(
-            reinterpret_cast<char*>(buffer) + sizeof(Header) + h.firstEmptyByte
-        );
+    Header& header(std::byte* h) {
+        return *reinterpret_cast<Header*>(h);
     }
-} // namespace
 
-namespace ghoul::logging {
+    const Header& header(const std::byte* h) {
+        return *reinterpret_cast<const Header*>(h);
+    }
 
-BufferLog::MemoryExhaustionException::MemoryExhaustionException(int sizeTotal,
-                                                                int sizeRequested)
-    : RuntimeError(
-        std::format("Exhausted BufferLog ({} of {} byte)", sizeRequested, sizeTotal),
-        "BufferLog"
-    )
-    , totalSize(sizeTotal)
-    , requestedSize(sizeRequested)
-{}
+    template <typename T>
+    T* record(T* h, uint64_t sequence) {
+        const Header& head = header(h);
+        const size_t index = static_cast<size_t>(sequence % head.nRecords);
+        return h + sizeof(Header) + index * head.recordSize;
+    }
 
-BufferLog::BufferLog(void* address, size_t bufferSize)
-    : _buffer(address)
-    , _totalSize(bufferSize)
-{
-    ghoul_assert(address, "Address must not be nullptr");
-    ghoul_assert(bufferSize > 0, "Total size must be positive");
+    RecordHeader& recordHeader(std::byte* rec) {
+        return *reinterpret_cast<RecordHeader*>(rec);
+    }
 
-    initializeBuffer();
-    Header& h = header(_buffer);
-    h.mutex.clear();
-}
+    const RecordHeader& recordHeader(const std::byte* rec) {
+        return *reinterpret_cast<const RecordHeader*>(rec);
+    }
+} // namespace
+
+namespace ghoul::logging {
 
-BufferLog::BufferLog(void* address, size_t bufferSize, MemoryExhaustedCallback callback)
+BufferLog::BufferLog(void* address, size_t bufferSize, size_t recordSize)
     : _buffer(address)
     , _totalSize(bufferSize)
-    , _callback(std::move(callback))
+    , _header(alignedHeader(reinterpret_cast<std::byte*>(address)))
 {
     ghoul_assert(address, "Address must not be nullptr");
-    ghoul_assert(bufferSize > 0, "Total size must be positive");
+    ghoul_assert(recordSize % 8 == 0, "Record size must be a multiple of 8");
+    ghoul_assert(recordSize >= 32, "Record size must be at least 32");
 
-    initializeBuffer();
-    Header& h = header(_buffer);
-    h.mutex.clear();
-}
-
-void BufferLog::initializeBuffer() {
-    Header& h = header(_buffer);
-    h.version = CurrentVersion;
-    h.attributes = 0;
-    h.firstEmptyByte = 0;
-}
-
-void BufferLog::setCallback(MemoryExhaustedCallback callback) {
-    _callback = std::move(callback);
-}
+    const size_t offset = static_cast<size_t>(_header - static_cast<std::byte*>(_buffer));
+    ghoul_assert(
+        bufferSize >= offset + sizeof(Header) + 2 * recordSize,
+        "Buffer must fit the header and at least two records"
+    );
 
-void BufferLog::resetBuffer() {
-    // Resetting the buffer does not overwrite any of the data but resets the
-    // `firstEmptyByte` pointer so that following log will overwrite the buffer
-    Header& h = header(_buffer);
-
-    // If test_and_set returns 'true', someone else is in the critical section unless we
-    // are currently in a callstack containing the callback function. In which case we are
-    // already safe
-    while (h.mutex.test_and_set() && !_inCallbackStack) {}
-    // The moment we return, we own the mutex
-    h.firstEmptyByte = 0;
-    if (!_inCallbackStack) {
-        // Only release the mutex if we are not in the callback stack
-        h.mutex.clear();
+    Header* h = new (_header) Header;
+    h->version = CurrentVersion;
+    h->attributes = 0;
+    h->recordSize = static_cast<uint32_t>(recordSize);
+    h->nRecords = (bufferSize - offset - sizeof(Header)) / recordSize;
+    h->head = 0;
+    h->nDropped = 0;
+
+    for (uint64_t i = 0; i < h->nRecords; i++) {
+        RecordHeader* rec = new (record(_header, i)) RecordHeader;
+        rec->state = 0;
+        rec->timestamp = 0;
+        rec->length = 0;
     }
 }
 
-void BufferLog::log(unsigned long long timestamp, const std::string& message) {
+BufferLog::BufferLog(const SharedMemory& memory, size_t recordSize)
+    : BufferLog(memory.memory(), memory.size(), recordSize)
+{}
+
+uint64_t BufferLog::log(unsigned long long timestamp, std::string_view message) {
+    ZoneScoped;
     ghoul_assert(!message.empty(), "Message must not be empty");
 
-    Header& h = header(_buffer);
-    // This is the full size of the incoming message. +1 for the terminating \0 character
-    const size_t fullSize = sizeof(unsigned long long) + message.length() + 1;
-
-    // If test_and_set returns 'true', someone else is in the critical section
-    while (h.mutex.test_and_set()) {}
-    // The moment we return, we own the mutex
-
-    const size_t requestedSize = h.firstEmptyByte + sizeof(Header) + fullSize;
-
-    // If this message would exceed the available memory...
-    if (requestedSize > _totalSize) {
-        // ...and we have a valid callback function
-        if (_callback) {
-            // Delegate the cleaning up to the callback
-            _inCallbackStack = true;
-            _callback(*this, timestamp);
-            _inCallbackStack = false;
-            if (h.firstEmptyByte + fullSize > _totalSize) {
-                // The callback failed to clear the memory
-                h.mutex.clear();
-                throw MemoryExhaustionException(
-                    static_cast<int>(_totalSize),
-                    static_cast<int>(requestedSize)
-                );
-            }
+    Header& h = header(_header);
+    const uint64_t sequence = h.head.fetch_add(1, std::memory_order_relaxed);
+    std::byte* rec = record(_header, sequence);
+    RecordHeader& r = recordHeader(rec);
+
+    // Claim the record. If a newer message has already claimed it, this message would
+    // have been overwritten anyway and is discarded. If an older message is still being
+    // written, this message is discarded as well instead of waiting for the other
+    // producer, which might have been preempted for an arbitrary amount of time
+    uint64_t state = r.state.load(std::memory_order_relaxed);
+    while (true) {
+        if (state >= writingState(sequence) || state % 2 == 1) {
+            h.nDropped.fetch_add(1, std::memory_order_relaxed);
+            return sequence;
         }
-        else {
-            // We have to fail if there is no callback
-            h.mutex.clear();
-            throw MemoryExhaustionException(
-                static_cast<int>(_totalSize),
-                static_cast<int>(requestedSize)
-            );
+
+        const bool success = r.state.compare_exchange_weak(
+            state,
+            writingState(sequence),
+            std::memory_order_acquire,
+            std::memory_order_relaxed
+        );
+        if (success) {
+            break;
         }
     }
-    // Copy the values of the timestamp
-    std::memcpy(
-        firstEmptyMemory(_buffer),
-        reinterpret_cast<void*>(&timestamp),
-        sizeof(unsigned long long)
-    );
-    // Advance the empty pointer
-    h.firstEmptyByte += sizeof(unsigned long long);
-
-    // Copy the message into the buffer, strcpy will copy the \0 terminator character, too
-    char* destination = reinterpret_cast<char*>(firstEmptyMemory(_buffer));
-    std::memcpy(destination, message.data(), message.length() + 1);
-    // Advance the empty pointer; +1 for the \0 terminator
-    h.firstEmptyByte += uint32_t(message.length() + 1);
-
-    h.mutex.clear();
+    // Order the store of the writing state before the writes of the content, so that a
+    // reader that sees any part of the new content also sees the changed state
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // Readers might copy the message while it is being written. They detect this by
+    // checking the state of the record afterwards and discard the torn copy
+    const size_t capacity = h.recordSize - RecordHeaderSize - 1;
+    const size_t length = std::min(message.size(), capacity);
+    char* destination = reinterpret_cast<char*>(rec + RecordHeaderSize);
+    std::memcpy(destination, message.data(), length);
+    destination[length] = '\0';
+    r.timestamp.store(timestamp, std::memory_order_relaxed);
+    r.length.store(static_cast<uint32_t>(length), std::memory_order_relaxed);
+
+    r.state.store(writtenState(sequence), std::memory_order_release);
+    return sequence;
 }
 
 void* BufferLog::buffer() {
@@ -216,46 +232,164 @@ size_t BufferLog::totalSize() const {
 }
 
 size_t BufferLog::usedSize() const {
-    const Header& h = header(_buffer);
-    return h.firstEmptyByte + sizeof(Header);
+    const Header& h = header(_header);
+    const uint64_t nUsed = std::min<uint64_t>(nextSequence(), h.nRecords);
+    const size_t offset = static_cast<size_t>(_header - static_cast<std::byte*>(_buffer));
+    return offset + sizeof(Header) + static_cast<size_t>(nUsed) * h.recordSize;
 }
 
-void BufferLog::setBuffer(void* buffer, size_t bufferSize) {
-    ghoul_assert(buffer, "Buffer must not be nullptr");
-    ghoul_assert(bufferSize > 0, "Total size must be positive");
-
-    Header& h = header(_buffer);
-    // If test_and_set returns 'true', someone else is in the critical section unless we
-    // are currently in a callstack containing the callback function. In which case we are
-    // already safe
-    while (h.mutex.test_and_set() && !_inCallbackStack) {}
-    // The moment we return, we own the mutex
+size_t BufferLog::nRecords() const {
+    return static_cast<size_t>(header(_header).nRecords);
+}
 
-    _buffer = buffer;
-    _totalSize = bufferSize;
-    initializeBuffer();
+uint64_t BufferLog::nextSequence() const {
+    return header(_header).head.load(std::memory_order_relaxed);
+}
 
-    if (!_inCallbackStack) {
-        // Only release the mutex if we are not in the callback stack
-        h.mutex.clear();
-    }
+uint64_t BufferLog::droppedRecords() const {
+    return header(_header).nDropped.load(std::memory_order_relaxed);
 }
 
 void BufferLog::writeToDisk(const std::string& filename) {
     std::ofstream file;
     file.exceptions(std::ofstream::failbit | std::ofstream::badbit);
-    file.open(filename);
-    Header& h = header(_buffer);
-    // If test_and_set returns 'true', someone else is in the critical section unless we
-    // are currently in a callstack containing the callback function. In which case we are
-    // already safe
-    while (h.mutex.test_and_set() && !_inCallbackStack) {}
-    // The moment we return, we own the mutex
-    file.write(reinterpret_cast<char*>(_buffer), usedSize());
-    if (!_inCallbackStack) {
-        // Only release the mutex if we are not in the callback stack
-        h.mutex.clear();
+    file.open(filename, std::ofstream::binary);
+    file.write(
+        reinterpret_cast<const char*>(_buffer),
+        static_cast<std::streamsize>(usedSize())
+    );
+}
+
+BufferLogError::BufferLogError(std::string msg)
+    : RuntimeError(std::move(msg), "BufferLog")
+{}
+
+BufferLogReader::BufferLogReader(const void* address, size_t bufferSize)
+    : _header(alignedHeader(reinterpret_cast<const std::byte*>(address)))
+{
+    ghoul_assert(address, "Address must not be nullptr");
+
+    const size_t offset = static_cast<size_t>(
+        _header - reinterpret_cast<const std::byte*>(address)
+    );
+    if (bufferSize < offset + sizeof(Header)) {
+        throw BufferLogError(std::format(
+            "Buffer of {} bytes is too small for a BufferLog", bufferSize
+        ));
+    }
+
+    const Header& h = header(_header);
+    if (h.version != CurrentVersion) {
+        throw BufferLogError(std::format(
+            "Unsupported BufferLog version {}, expected {}", h.version, CurrentVersion
+        ));
+    }
+    if (h.recordSize < 32 || h.recordSize % 8 != 0 || h.nRecords == 0) {
+        throw BufferLogError("Invalid BufferLog header");
     }
+
+    // The header comes from a potentially different process, so we can't trust it to
+    // describe records that stay inside the buffer
+    const size_t available = bufferSize - offset - sizeof(Header);
+    if (h.nRecords > available / h.recordSize) {
+        throw BufferLogError(std::format(
+            "BufferLog with {} records of {} bytes does not fit into {} bytes",
+            h.nRecords, h.recordSize, bufferSize
+        ));
+    }
+
+    // Start with the oldest record that is still available
+    const uint64_t head = h.head.load(std::memory_order_acquire);
+    _next = head - std::min(head, h.nRecords);
+}
+
+BufferLogReader::BufferLogReader(const SharedMemory& memory)
+    : BufferLogReader(memory.memory(), memory.size())
+{}
+
+std::optional<BufferLogReader::Record> BufferLogReader::next() {
+    const Header& h = header(_header);
+    while (true) {
+        const uint64_t head = h.head.load(std::memory_order_acquire);
+        if (_next >= head) {
+            return std::nullopt;
+        }
+
+        if (head - _next > h.nRecords) {
+            // The writers have lapped us, so the records in between are gone
+            const uint64_t oldest = head - h.nRecords;
+            _nLost += oldest - _next;
+            _next = oldest;
+        }
+
+        const std::byte* rec = record(_header, _next);
+        const RecordHeader& r = recordHeader(rec);
+        const uint64_t state = r.state.load(std::memory_order_acquire);
+        if (state % 2 == 1 && state < writingState(_next)) {
+            // An older message is still being written into the record, so the message
+            // with our sequence number is discarded by its producer
+            _nLost++;
+            _next++;
+            continue;
+        }
+        if (state < writtenState(_next)) {
+            // The record has been claimed but not finished yet
+            return std::nullopt;
+        }
+        if (state > writtenState(_next)) {
+            // The record was overwritten or its message was discarded
+            _nLost++;
+            _next++;
+            continue;
+        }
+
+        // The length might be a torn value if the record is overwritten right now, so
+        // it has to be clamped to stay inside the record
+        const size_t capacity = h.recordSize - RecordHeaderSize - 1;
+        const size_t length = std::min<size_t>(
+            r.length.load(std::memory_order_relaxed),
+            capacity
+        );
+        Record result = {
+            .sequence = _next,
+            .timestamp = r.timestamp.load(std::memory_order_relaxed),
+            .message = std::string_view(
+                reinterpret_cast<const char*>(rec + RecordHeaderSize),
+                length
+            )
+        };
+        _next++;
+        return result;
+    }
+}
+
+bool BufferLogReader::isValid(const Record& record) const {
+    // Make sure that all reads of the record content happen before the state is checked
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const RecordHeader& r = recordHeader(::record(_header, record.sequence));
+    return r.state.load(std::memory_order_relaxed) == writtenState(record.sequence);
+}
+
+size_t BufferLogReader::drain(const std::function<void(const Record&)>& callback) {
+    ZoneScoped;
+
+    size_t nRecords = 0;
+    while (std::optional<Record> rec = next()) {
+        _message = rec->message;
+        if (!isValid(*rec)) {
+            _nLost++;
+            continue;
+        }
+
+        rec->message = _message;
+        callback(*rec);
+        nRecords++;
+    }
+    return nRecords;
+}
+
+uint64_t BufferLogReader::lostRecords() const {
+    return _nLost;
 }
 
 } // namespace ghoul::logging
@@ -26,17 +26,77 @@
 #include <ghoul/logging/log.h>
 
 #include <ghoul/format.h>
+#include <ghoul/misc/defer.h>
 #include <ghoul/misc/profiling.h>
+#include <array>
 #include <chrono>
+#include <ctime>
+#include <optional>
+
+namespace {
+    struct Timestamp {
+        /// The date in the format "YYYY-MM-DD"
+        std::array<char, 10> date;
+        /// The time in the format "HH:MM:SS.mmm"
+        std::array<char, 12> time;
+    };
+
+    void writeDigits(char* destination, int value, int nDigits) {
+        for (int i = nDigits - 1; i >= 0; i--) {
+            destination[i] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+    }
 
+    // The time of the message that is currently passed to a Log through Log::logAt on
+    // this thread
+    thread_local std::optional<std::chrono::system_clock::time_point> MessageTime;
+
+    // Converting the time into calendar fields is expensive, so the date and the time
+    // without the milliseconds are only recomputed when the second has changed since
+    // the last call on the same thread
+    Timestamp toTimestamp(std::chrono::system_clock::time_point timePoint) {
+        thread_local std::time_t cachedSecond = -1;
+        thread_local Timestamp cached = {};
+
+        using namespace std::chrono;
+        const system_clock::duration sinceEpoch = timePoint.time_since_epoch();
+        const seconds secs = floor<seconds>(sinceEpoch);
+        const milliseconds ms = duration_cast<milliseconds>(sinceEpoch - secs);
+        const std::time_t second = static_cast<std::time_t>(secs.count());
+
+        if (second != cachedSecond) {
+            std::tm date = {};
+            std::tm time = {};
 #ifdef WIN32
-#include <Windows.h>
+            localtime_s(&date, &second);
+            time = date;
 #else // ^^^^ WIN32 // !WIN32 vvvv
-#include <iomanip>
-#include <sstream>
-#include <sys/time.h>
+            localtime_r(&second, &date);
+            gmtime_r(&second, &time);
 #endif // WIN32
 
+            writeDigits(cached.date.data(), date.tm_year + 1900, 4);
+            cached.date[4] = '-';
+            writeDigits(cached.date.data() + 5, date.tm_mon + 1, 2);
+            cached.date[7] = '-';
+            writeDigits(cached.date.data() + 8, date.tm_mday, 2);
+
+            writeDigits(cached.time.data(), time.tm_hour, 2);
+            cached.time[2] = ':';
+            writeDigits(cached.time.data() + 3, time.tm_min, 2);
+            cached.time[5] = ':';
+            writeDigits(cached.time.data() + 6, time.tm_sec, 2);
+            cached.time[8] = '.';
+            cachedSecond = second;
+        }
+
+        Timestamp res = cached;
+        writeDigits(res.time.data() + 9, static_cast<int>(ms.count()), 3);
+        return res;
+    }
+} // namespace
+
 namespace ghoul::logging {
 
 Log::Log(TimeStamping timeStamping, DateStamping dateStamping,
@@ -85,40 +145,18 @@ LogLevel Log::logLevel() const {
     return _logLevel;
 }
 
-std::string Log::timeString() {
-#ifdef WIN32
-    SYSTEMTIME t = {};
-    GetLocalTime(&t);
-
-    return std::format(
-        "{:0>2}:{:0>2}:{:0>2}.{:0<3}", t.wHour, t.wMinute, t.wSecond, t.wMilliseconds
-    );
-#else // ^^^^ WIN32 // !WIN32 vvvv
-    struct timeval t;
-    gettimeofday(&t, nullptr);
-    tm* m = gmtime(&t.tv_sec);
+std::chrono::system_clock::time_point Log::messageTime() {
+    return MessageTime.value_or(std::chrono::system_clock::now());
+}
 
-    return std::format(
-        "{:0>2}:{:0>2}:{:0>2}.{:0<3}", m->tm_hour, m->tm_min, m->tm_sec, t.tv_usec / 1000
-    );
-#endif // WIN32
+std::string Log::timeString() {
+    const Timestamp t = toTimestamp(messageTime());
+    return std::string(t.time.data(), t.time.size());
 }
 
 std::string Log::dateString() {
-#ifdef WIN32
-    SYSTEMTIME t = {};
-    GetLocalTime(&t);
-
-    return std::format("{}-{:0>2}-{:0>2}", t.wYear, t.wMonth, t.wDay);
-#else // ^^^^ WIN32 // !WIN32 vvvv
-    auto now = std::chrono::system_clock::now();
-    const time_t time = std::chrono::system_clock::to_time_t(now);
-
-    std::stringstream ss;
-
-    ss << std::put_time(std::localtime(&time), "%F");
-    return ss.str();
-#endif // WIN32
+    const Timestamp t = toTimestamp(messageTime());
+    return std::string(t.date.data(), t.date.size());
 }
 
 std::string Log::createFullMessageString(LogLevel level, std::string_view category,
@@ -126,15 +164,29 @@ std::string Log::createFullMessageString(LogLevel level, std::string_view catego
 {
     ZoneScoped;
 
+    const std::string_view levelString = to_string(level);
+
+    // Reserving the maximum size upfront so that the message is built with a single
+    // allocation
     std::string output;
-    if (_dateStamping && !_timeStamping) {
-        output += std::format("[{}] ", dateString());
-    }
-    else if (!_dateStamping && _timeStamping) {
-        output += std::format("[{}] ", timeString());
-    }
-    else if (_dateStamping && _timeStamping) {
-        output += std::format("[{} | {}] ", dateString(), timeString());
+    output.reserve(
+        sizeof("[YYYY-MM-DD | HH:MM:SS.mmm] ") + category.size() + levelString.size() +
+        message.size() + 4
+    );
+
+    if (_dateStamping || _timeStamping) {
+        const Timestamp t = toTimestamp(messageTime());
+        output += '[';
+        if (_dateStamping) {
+            output.append(t.date.data(), t.date.size());
+        }
+        if (_dateStamping && _timeStamping) {
+            output += " | ";
+        }
+        if (_timeStamping) {
+            output.append(t.time.data(), t.time.size());
+        }
+        output += "] ";
     }
 
     if (isCategoryStamping() && (!category.empty())) {
@@ -142,7 +194,9 @@ std::string Log::createFullMessageString(LogLevel level, std::string_view catego
         output += ' ';
     }
     if (isLogLevelStamping()) {
-        output += std::format("({})", to_string(level));
+        output += '(';
+        output += levelString;
+        output += ')';
     }
     if (!output.empty()) {
         output += '\t';
@@ -152,6 +206,30 @@ std::string Log::createFullMessageString(LogLevel level, std::string_view catego
     return output;
 }
 
+void Log::logDeferred(LogLevel level, std::string_view category,
+                      std::string_view message, const DeferredMessage&)
+{
+    log(level, category, message);
+}
+
+void Log::logAt(std::chrono::system_clock::time_point timestamp, LogLevel level,
+                std::string_view category, std::string_view message,
+                const DeferredMessage* deferred)
+{
+    // A Log might log another message while it is logging, so the previous time has to
+    // be restored afterwards
+    const std::optional<std::chrono::system_clock::time_point> previous = MessageTime;
+    MessageTime = timestamp;
+    defer { MessageTime = previous; };
+
+    if (deferred) {
+        logDeferred(level, category, message, *deferred);
+    }
+    else {
+        log(level, category, message);
+    }
+}
+
 void Log::flush() {}
 
 } // namespace ghoul::logging
@@ -0,0 +1,155 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2026                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <ghoul/logging/logcategory.h>
+
+#include <ghoul/format.h>
+#include <ghoul/misc/exception.h>
+#include <ghoul/misc/map.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace {
+    struct Registry {
+        std::shared_mutex mutex;
+        std::unordered_map<std::string, int, transparent_string_hash, std::equal_to<>>
+            ids;
+        // A deque does not move its elements when it grows, so the names can be handed
+        // out as views
+        std::deque<std::string> names;
+        // The number of interned names, which can be read without taking the lock
+        std::atomic<int> nNames = 0;
+    };
+
+    // The result of a previous lookup of a category name on the current thread. As
+    // categories are almost always passed as views of the same string literal, the cache
+    // is indexed by the address of the name, which is cheaper than hashing the name
+    struct CacheEntry {
+        // The address and a copy of the name that was looked up. The copy is compared as
+        // well as a different name might have been placed at the same address
+        const char* data = nullptr;
+        std::string name;
+        // The identifier of the category or `std::nullopt` if it was not interned
+        std::optional<int> id;
+        // The number of interned names at the time of the lookup. A name that was not
+        // interned might have been interned since if this number has changed
+        int nNames = 0;
+    };
+    constexpr size_t CacheSize = 64;
+
+    // Categories are usually created during static initialization, so the registry has
+    // to be created on first use
+    Registry& registry() {
+        static Registry r;
+        return r;
+    }
+} // namespace
+
+namespace ghoul::logging {
+
+LogCategory::LogCategory(std::string_view name) {
+    Registry& r = registry();
+    {
+        const std::shared_lock lock(r.mutex);
+        const auto it = r.ids.find(name);
+        if (it != r.ids.end()) {
+            _name = r.names[it->second];
+            _id = it->second;
+            return;
+        }
+    }
+
+    const std::unique_lock lock(r.mutex);
+    // Another thread might have interned the same name while we didn't hold the lock
+    const auto it = r.ids.find(name);
+    if (it != r.ids.end()) {
+        _name = r.names[it->second];
+        _id = it->second;
+        return;
+    }
+
+    if (r.names.size() >= MaxCategories) {
+        throw RuntimeError(
+            std::format("Cannot intern category '{}', too many categories", name),
+            "LogCategory"
+        );
+    }
+
+    _id = static_cast<int>(r.names.size());
+    _name = r.names.emplace_back(name);
+    r.ids.emplace(std::string(name), _id);
+    r.nNames.store(_id + 1, std::memory_order_release);
+}
+
+std::string_view LogCategory::name() const {
+    return _name;
+}
+
+int LogCategory::id() const {
+    return _id;
+}
+
+LogCategory::operator std::string_view() const {
+    return _name;
+}
+
+std::optional<int> LogCategory::find(std::string_view name) {
+    Registry& r = registry();
+
+    // The registry only ever grows, so a cached identifier stays valid forever, whereas
+    // a name that was not interned is only valid as long as no other name was interned
+    thread_local std::array<CacheEntry, CacheSize> cache;
+    const uintptr_t address = reinterpret_cast<uintptr_t>(name.data());
+    CacheEntry& entry = cache[(address ^ (address >> 6)) % CacheSize];
+    const int nNames = r.nNames.load(std::memory_order_acquire);
+    if (entry.data == name.data() && entry.name == name &&
+        (entry.id.has_value() || entry.nNames == nNames))
+    {
+        return entry.id;
+    }
+
+    std::optional<int> res;
+    {
+        const std::shared_lock lock(r.mutex);
+        const auto it = r.ids.find(name);
+        if (it != r.ids.end()) {
+            res = it->second;
+        }
+    }
+
+    entry.data = name.data();
+    entry.name = name;
+    entry.id = res;
+    entry.nNames = nNames;
+    return res;
+}
+
+} // namespace ghoul::logging
@@ -28,8 +28,15 @@
 #include <ghoul/logging/consolelog.h>
 #include <ghoul/logging/log.h>
 #include <ghoul/misc/assert.h>
+#include <ghoul/misc/defer.h>
 #include <ghoul/misc/profiling.h>
 #include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <thread>
 #include <type_traits>
 #include <utility>
 
@@ -40,17 +47,186 @@ namespace {
     // include the ConsoleLog in every file that wants to use the LogManager. Its fine to
     // do this as the ConsoleLog has a trivial-enough destructor
     ConsoleLog consoleLog;
+
+    // Avoids false sharing between the members that are written by the logging threads
+    // and the members that are written by the sink thread
+    constexpr size_t CacheLineSize = 64;
 } // namespace
 
 namespace ghoul::logging {
 
+// The queue of the asynchronous mode is a bounded multi-producer single-consumer ring
+// buffer. Each slot carries a sequence number that encodes whether it is free to be
+// written by the producer claiming position `p` (sequence == p) or ready to be read by
+// the consumer (sequence == p + 1). Producers claim a position with a single CAS on the
+// enqueue position and the consumer is the sink thread, which is the only one advancing
+// the dequeue position. The strings in each slot keep their capacity after they have been
+// consumed, so after a warm-up phase queueing a message does not allocate memory. For
+// deferred messages, the slot stores the format string in place of the message together
+// with the encoded arguments and the function that formats them
+struct LogManager::AsyncState {
+    struct Slot {
+        std::atomic<uint64_t> sequence = 0;
+        std::chrono::system_clock::time_point timestamp;
+        LogLevel level = LogLevel::NoLogging;
+        std::string category;
+        std::string message;
+        FormatFunction formatter = nullptr;
+        std::string arguments;
+    };
+
+    explicit AsyncState(AsyncOptions options_);
+
+    bool tryPush(std::chrono::system_clock::time_point timestamp, LogLevel level,
+        std::string_view category, std::string_view message, FormatFunction formatter,
+        std::string_view arguments);
+    Slot* front();
+    void pop();
+    void wakeSink();
+    bool isSinkThread() const;
+
+    const AsyncOptions options;
+    const uint64_t mask;
+    std::unique_ptr<Slot[]> slots;
+
+    alignas(CacheLineSize) std::atomic<uint64_t> enqueuePosition = 0;
+
+    // Only accessed by the sink thread
+    alignas(CacheLineSize) uint64_t dequeuePosition = 0;
+
+    // The number of messages that have been written by the sink thread. Threads that wait
+    // for room in the queue or for the queue to be written wait on this value
+    alignas(CacheLineSize) std::atomic<uint64_t> nWritten = 0;
+    std::atomic<int> nWaiting = 0;
+
+    // Set by the sink thread before it waits for new messages
+    std::atomic<bool> isSleeping = false;
+    std::atomic<bool> shouldStop = false;
+
+    std::thread sink;
+
+    // Set by the sink thread when it starts so that calls coming from a Log that is
+    // being written to by the sink thread can be recognized
+    std::atomic<std::thread::id> sinkId;
+
+    // Only accessed by the sink thread to format deferred messages
+    std::string formatted;
+};
+
+LogManager::AsyncState::AsyncState(AsyncOptions options_)
+    : options(options_)
+    , mask(std::bit_ceil(static_cast<uint64_t>(options_.queueSize)) - 1)
+    , slots(std::make_unique<Slot[]>(mask + 1))
+{
+    for (uint64_t i = 0; i <= mask; i++) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool LogManager::AsyncState::tryPush(std::chrono::system_clock::time_point timestamp,
+                                     LogLevel level, std::string_view category,
+                                     std::string_view message, FormatFunction formatter,
+                                     std::string_view arguments)
+{
+    uint64_t pos = enqueuePosition.load(std::memory_order_relaxed);
+    while (true) {
+        Slot& slot = slots[pos & mask];
+        const uint64_t seq = slot.sequence.load(std::memory_order_acquire);
+        const int64_t diff = static_cast<int64_t>(seq - pos);
+        if (diff == 0) {
+            // The slot is free, try to claim it. On failure, `pos` is updated to the
+            // current enqueue position and we try again
+            if (enqueuePosition.compare_exchange_weak(
+                    pos, pos + 1, std::memory_order_relaxed
+                ))
+            {
+                slot.timestamp = timestamp;
+                slot.level = level;
+                slot.category.assign(category);
+                slot.message.assign(message);
+                slot.formatter = formatter;
+                slot.arguments.assign(arguments);
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0) {
+            // The slot still holds a message from the previous round, the queue is full
+            return false;
+        }
+        else {
+            // Another producer claimed this position in the meantime
+            pos = enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+LogManager::AsyncState::Slot* LogManager::AsyncState::front() {
+    Slot& slot = slots[dequeuePosition & mask];
+    const uint64_t seq = slot.sequence.load(std::memory_order_acquire);
+    return seq == dequeuePosition + 1 ? &slot : nullptr;
+}
+
+void LogManager::AsyncState::pop() {
+    Slot& slot = slots[dequeuePosition & mask];
+    slot.sequence.store(dequeuePosition + mask + 1, std::memory_order_release);
+    dequeuePosition++;
+}
+
+void LogManager::AsyncState::wakeSink() {
+    // Pairs with the fence in the sink thread between setting the `isSleeping` flag and
+    // checking the queue one last time, so either the sink sees the new message or we see
+    // the flag
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (isSleeping.load(std::memory_order_relaxed) && isSleeping.exchange(false)) {
+        isSleeping.notify_one();
+    }
+}
+
+bool LogManager::AsyncState::isSinkThread() const {
+    return sinkId.load(std::memory_order_relaxed) == std::this_thread::get_id();
+}
+
+// The LogLevels of the categories are stored in chunks that are only allocated once a
+// LogLevel is set for a category in that chunk, so that the table does not need to grow
+// and a lookup never needs to take a lock
+struct LogManager::CategoryLevels {
+    static constexpr int ChunkSize = 256;
+    static constexpr int NChunks = LogCategory::MaxCategories / ChunkSize;
+
+    // Marks a category for which no LogLevel has been set
+    static constexpr int NotSet = -1;
+
+    struct Chunk {
+        Chunk();
+        std::array<std::atomic<int>, ChunkSize> levels;
+    };
+
+    std::array<std::atomic<Chunk*>, NChunks> chunks = {};
+    std::array<std::unique_ptr<Chunk>, NChunks> storage;
+
+    // Protects the allocation of new chunks and the number of set levels
+    std::mutex mutex;
+};
+
+LogManager::CategoryLevels::Chunk::Chunk() {
+    for (std::atomic<int>& level : levels) {
+        level.store(NotSet, std::memory_order_relaxed);
+    }
+}
+
 LogManager* LogManager::_instance = nullptr;
 
 LogManager::LogManager(LogLevel level, ImmediateFlush immediateFlush)
     : _level(level)
     , _immediateFlush(immediateFlush)
+    , _categoryLevels(std::make_unique<CategoryLevels>())
 {}
 
+LogManager::~LogManager() {
+    stopAsync();
+}
+
 void LogManager::initialize(LogLevel level, ImmediateFlush immediateFlush) {
     if (_instance) {
         _instance->_level = level;
@@ -62,6 +238,7 @@ void LogManager::initialize(LogLevel level, ImmediateFlush immediateFlush) {
 void LogManager::deinitialize() {
     ghoul_assert(isInitialized(), "LogManager is not initialized");
 
+    _instance->stopAsync();
     _instance->_logs.clear();
 }
 
@@ -75,23 +252,45 @@ LogManager& LogManager::ref() {
 }
 
 void LogManager::addLog(std::unique_ptr<Log> log) {
+    const std::lock_guard lock(_logsMutex);
     _logs.push_back(std::move(log));
 }
 
 void LogManager::removeLog(Log* log) {
+    const std::lock_guard lock(_logsMutex);
     const auto it = std::find_if(
-        _logs.cbegin(),
-        _logs.cend(),
+        _logs.begin(),
+        _logs.end(),
         [log](const std::unique_ptr<Log>& l) { return l.get() == log; }
     );
-    if (it != _logs.end()) {
+    if (it == _logs.end()) {
+        return;
+    }
+
+    if (_nDispatching > 0) {
+        // We are called from a Log while a message is written, possibly from the Log
+        // that is removed. So it must stay alive and the list must not change its size
+        // until the message has been written to all Logs
+        _removedLogs.push_back(std::move(*it));
+    }
+    else {
         _logs.erase(it);
     }
 }
 
 void LogManager::flushLogs() {
+    // The sink thread would wait for itself, but it has already written all messages up
+    // to the one that caused this call
+    if (_async && !_async->isSinkThread()) {
+        waitForQueue();
+    }
+
+    const std::lock_guard lock(_logsMutex);
     for (const std::unique_ptr<Log>& log : _logs) {
-        log->flush();
+        // Logs that were removed while a message was written are still in the list
+        if (log) {
+            log->flush();
+        }
     }
 }
 
@@ -105,43 +304,352 @@ void LogManager::logMessage(LogLevel level, std::string_view category,
     }
 
     if (!LogManager::isInitialized()) {
-        consoleLog.log(level, category, message);
+        logUninitialized(level, category, message);
         return;
     }
 
-    if (level >= _level) {
-        consoleLog.log(level, category, message);
-        if (_immediateFlush) {
-            consoleLog.flush();
+    if (isEnabled(level, category)) {
+        logEnabledMessage(level, category, message);
+    }
+}
+
+void LogManager::logEnabledMessage(LogLevel level, std::string_view category,
+                                   std::string_view message)
+{
+    ZoneScoped;
+    ghoul_assert(level != LogLevel::NoLogging, "Level must not be NoLogging");
+
+    if (_async && !_async->isSinkThread()) {
+        const bool wasQueued = queueMessage(level, category, message);
+        if (!wasQueued) {
+            return;
+        }
+        if (level == LogLevel::Fatal) {
+            // A fatal message is likely followed by the termination of the application,
+            // so we don't return before it has been written
+            flushLogs();
+        }
+    }
+    else {
+        // A message from a Log that is written to by the sink thread is written right
+        // away, as the sink thread can't wait for room in the queue or for the queue to
+        // be written
+        writeMessage(std::chrono::system_clock::now(), level, category, message);
+    }
+
+    const int l = std::underlying_type_t<LogLevel>(level);
+    _logCounters[l].fetch_add(1, std::memory_order_relaxed);
+}
+
+void LogManager::logUninitialized(LogLevel level, std::string_view category,
+                                  std::string_view message)
+{
+    consoleLog.log(level, category, message);
+}
+
+void LogManager::logMessage(LogLevel level, std::string_view message) {
+    logMessage(level, "", message);
+}
+
+void LogManager::logRecord(LogLevel level, std::string_view category,
+                           std::string_view format, FormatFunction formatter,
+                           std::string_view arguments)
+{
+    ZoneScoped;
+
+    if (_async && !_async->isSinkThread()) {
+        const bool wasQueued =
+            queueMessage(level, category, format, formatter, arguments);
+        if (!wasQueued) {
+            return;
+        }
+        if (level == LogLevel::Fatal) {
+            flushLogs();
+        }
+    }
+    else {
+        // The thread-local buffer avoids an allocation for each message. If a Log logs
+        // another message while this one is written, the nested message must not
+        // overwrite the buffer and uses its own string instead
+        thread_local std::string buffer;
+        std::string tmp;
+        std::string& message = buffer.empty() ? buffer : tmp;
+        message.clear();
+        defer { message.clear(); };
+        formatter(message, format, arguments);
+        const DeferredMessage deferred = { .format = format, .arguments = arguments };
+        const std::chrono::system_clock::time_point now =
+            std::chrono::system_clock::now();
+        writeMessage(now, level, category, message, &deferred);
+    }
+
+    const int l = std::underlying_type_t<LogLevel>(level);
+    _logCounters[l].fetch_add(1, std::memory_order_relaxed);
+}
+
+void LogManager::writeMessage(std::chrono::system_clock::time_point timestamp,
+                              LogLevel level, std::string_view category,
+                              std::string_view message, const DeferredMessage* deferred)
+{
+    consoleLog.logAt(timestamp, level, category, message);
+    if (_immediateFlush) {
+        consoleLog.flush();
+    }
+    const std::lock_guard lock(_logsMutex);
+    _nDispatching++;
+    defer {
+        _nDispatching--;
+        if (_nDispatching == 0 && !_removedLogs.empty()) {
+            std::erase(_logs, nullptr);
+            // The Logs are destroyed at the end of this scope, after the list is valid
+            // again, as they might log another message in their destructor
+            std::vector<std::unique_ptr<Log>> removed = std::move(_removedLogs);
+            _removedLogs.clear();
+        }
+    };
+
+    // A Log might add another Log while it is logging, which would invalidate iterators.
+    // Logs that are added this way only receive the following messages. Logs that are
+    // removed this way are replaced with `nullptr` until all Logs have been written to
+    const size_t nLogs = _logs.size();
+    for (size_t i = 0; i < nLogs; i++) {
+        Log* log = _logs[i].get();
+        if (log && level >= log->logLevel()) {
+            log->logAt(timestamp, level, category, message, deferred);
+            if (_immediateFlush) {
+                log->flush();
+            }
+        }
+    }
+}
+
+bool LogManager::queueMessage(LogLevel level, std::string_view category,
+                              std::string_view message, FormatFunction formatter,
+                              std::string_view arguments)
+{
+    ZoneScoped;
+
+    AsyncState& async = *_async;
+    const bool canDrop =
+        async.options.overflowPolicy == OverflowPolicy::Drop ||
+        (async.options.overflowPolicy == OverflowPolicy::DropBelowLevel &&
+         level < async.options.dropBelowLevel);
+
+    // The time is taken before waiting for room in the queue, as this is when the message
+    // was logged
+    const std::chrono::system_clock::time_point timestamp =
+        std::chrono::system_clock::now();
+    while (true) {
+        // Read the counter before trying to push so that a message written by the sink
+        // thread between the failed push and the wait wakes us up right away
+        const uint64_t nWritten = async.nWritten.load();
+        const bool wasPushed =
+            async.tryPush(timestamp, level, category, message, formatter, arguments);
+        if (wasPushed) {
+            async.wakeSink();
+            return true;
+        }
+
+        if (canDrop) {
+            _nDroppedMessages.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        async.wakeSink();
+        async.nWaiting++;
+        async.nWritten.wait(nWritten);
+        async.nWaiting--;
+    }
+}
+
+void LogManager::waitForQueue() {
+    AsyncState& async = *_async;
+    const uint64_t target = async.enqueuePosition.load();
+    while (true) {
+        const uint64_t nWritten = async.nWritten.load();
+        if (nWritten >= target) {
+            return;
         }
-        for (const std::unique_ptr<Log>& log : _logs) {
-            if (level >= log->logLevel()) {
-                log->log(level, category, message);
-                if (_immediateFlush) {
-                    log->flush();
+        async.nWaiting++;
+        async.nWritten.wait(nWritten);
+        async.nWaiting--;
+    }
+}
+
+void LogManager::startAsync(AsyncOptions options) {
+    ghoul_assert(!_async, "LogManager is already in asynchronous mode");
+    ghoul_assert(options.queueSize > 0, "Queue size must be bigger than 0");
+
+    _async = std::make_unique<AsyncState>(options);
+    _async->sink = std::thread([this, &async = *_async]() {
+        async.sinkId = std::this_thread::get_id();
+        while (true) {
+            AsyncState::Slot* slot = async.front();
+            if (!slot) {
+                if (async.shouldStop.load()) {
+                    return;
                 }
+
+                // Announce that we are going to sleep and then check once more, as a
+                // message might have been pushed before the flag was visible
+                async.isSleeping.store(true);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (async.front() || async.shouldStop.load()) {
+                    async.isSleeping.store(false);
+                    continue;
+                }
+                async.isSleeping.wait(true);
+                continue;
+            }
+
+            {
+                try {
+                    if (slot->formatter) {
+                        async.formatted.clear();
+                        slot->formatter(async.formatted, slot->message, slot->arguments);
+                        const DeferredMessage deferred = {
+                            .format = slot->message,
+                            .arguments = slot->arguments
+                        };
+                        writeMessage(
+                            slot->timestamp,
+                            slot->level,
+                            slot->category,
+                            async.formatted,
+                            &deferred
+                        );
+                    }
+                    else {
+                        writeMessage(
+                            slot->timestamp,
+                            slot->level,
+                            slot->category,
+                            slot->message
+                        );
+                    }
+                }
+                catch (...) {
+                    // There is no one to report the error to and we must not lose the
+                    // rest of the messages because a single Log failed
+                }
+            }
+            async.pop();
+
+            async.nWritten++;
+            if (async.nWaiting.load() > 0) {
+                async.nWritten.notify_all();
             }
         }
+    });
+}
 
-        const int l = std::underlying_type_t<LogLevel>(level);
-        (_logCounters[l])++;
+void LogManager::stopAsync() {
+    if (!_async) {
+        return;
     }
+
+    // The sink thread writes all remaining messages before it checks the stop flag again
+    _async->shouldStop = true;
+    _async->isSleeping = false;
+    _async->isSleeping.notify_one();
+    _async->sink.join();
+    _async = nullptr;
 }
 
-void LogManager::logMessage(LogLevel level, std::string_view message) {
-    logMessage(level, "", message);
+bool LogManager::isAsync() const {
+    return _async != nullptr;
+}
+
+int LogManager::droppedMessages() const {
+    return _nDroppedMessages.load(std::memory_order_relaxed);
 }
 
 LogLevel LogManager::logLevel() const {
     return _level;
 }
 
+void LogManager::setCategoryLevel(std::string_view category, LogLevel level) {
+    const LogCategory cat = LogCategory(category);
+    const int chunkIndex = cat.id() / CategoryLevels::ChunkSize;
+
+    CategoryLevels& levels = *_categoryLevels;
+    const std::lock_guard lock(levels.mutex);
+    std::unique_ptr<CategoryLevels::Chunk>& chunk = levels.storage[chunkIndex];
+    if (!chunk) {
+        chunk = std::make_unique<CategoryLevels::Chunk>();
+        levels.chunks[chunkIndex].store(chunk.get(), std::memory_order_release);
+    }
+
+    const int previous = chunk->levels[cat.id() % CategoryLevels::ChunkSize].exchange(
+        std::underlying_type_t<LogLevel>(level)
+    );
+    if (previous == CategoryLevels::NotSet) {
+        _nCategoryLevels++;
+    }
+}
+
+void LogManager::resetCategoryLevel(std::string_view category) {
+    const std::optional<int> id = LogCategory::find(category);
+    if (!id.has_value()) {
+        return;
+    }
+
+    CategoryLevels& levels = *_categoryLevels;
+    const std::lock_guard lock(levels.mutex);
+    CategoryLevels::Chunk* chunk = levels.storage[*id / CategoryLevels::ChunkSize].get();
+    if (!chunk) {
+        return;
+    }
+
+    const int previous = chunk->levels[*id % CategoryLevels::ChunkSize].exchange(
+        CategoryLevels::NotSet
+    );
+    if (previous != CategoryLevels::NotSet) {
+        _nCategoryLevels--;
+    }
+}
+
+bool LogManager::isEnabled(LogLevel level, std::string_view category) const {
+    if (_nCategoryLevels.load(std::memory_order_relaxed) == 0) {
+        return level >= _level;
+    }
+
+    const std::optional<int> id = LogCategory::find(category);
+    return level >= (id.has_value() ? thresholdForCategory(*id) : _level);
+}
+
+bool LogManager::isEnabled(LogLevel level, const LogCategory& category) const {
+    if (_nCategoryLevels.load(std::memory_order_relaxed) == 0) {
+        return level >= _level;
+    }
+
+    return level >= thresholdForCategory(category.id());
+}
+
+LogLevel LogManager::thresholdForCategory(int id) const {
+    const CategoryLevels::Chunk* chunk =
+        _categoryLevels->chunks[id / CategoryLevels::ChunkSize].load(
+            std::memory_order_acquire
+        );
+    if (!chunk) {
+        return _level;
+    }
+
+    const int level = chunk->levels[id % CategoryLevels::ChunkSize].load(
+        std::memory_order_relaxed
+    );
+    return level == CategoryLevels::NotSet ? _level : static_cast<LogLevel>(level);
+}
+
 int LogManager::messageCounter(LogLevel level) {
-    return _logCounters[std::underlying_type_t<LogLevel>(level)];
+    return _logCounters[std::underlying_type_t<LogLevel>(level)].load();
 }
 
 void LogManager::resetMessageCounters() {
-    std::fill(_logCounters.begin(), _logCounters.end(), 0);
+    for (std::atomic<int>& counter : _logCounters) {
+        counter = 0;
+    }
+    _nDroppedMessages = 0;
 }
 
 } // namespace ghoul::logging
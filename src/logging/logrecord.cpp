@@ -0,0 +1,192 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2026                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <ghoul/logging/logrecord.h>
+
+#include <array>
+#include <utility>
+#include <variant>
+
+namespace {
+    using namespace ghoul::logging;
+
+    // The maximum number of arguments that can be formatted by formatArguments
+    constexpr size_t MaxArguments = 32;
+
+    // A decoded argument whose type is only known at runtime. The formatter stores the
+    // format specification and applies it to the actual value when formatting
+    struct DynamicArgument {
+        std::variant<std::monostate, bool, char, int64_t, uint64_t, float, double,
+            std::string_view, const void*> value;
+    };
+
+    template <typename T>
+    T read(std::string_view arguments, size_t& offset) {
+        if (offset + sizeof(T) > arguments.size()) {
+            throw std::format_error("Encoded arguments are truncated");
+        }
+        T value;
+        std::memcpy(&value, arguments.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return value;
+    }
+
+    // Decodes the argument at the `offset` and advances the offset past it. Arguments of
+    // the ArgumentType::Raw are skipped and returned as an empty argument
+    DynamicArgument decodeArgument(std::string_view arguments, size_t& offset) {
+        const ArgumentType type =
+            static_cast<ArgumentType>(read<uint8_t>(arguments, offset));
+        switch (type) {
+            case ArgumentType::Bool:
+                return { read<bool>(arguments, offset) };
+            case ArgumentType::Char:
+                return { read<char>(arguments, offset) };
+            case ArgumentType::Int8:
+                return { static_cast<int64_t>(read<int8_t>(arguments, offset)) };
+            case ArgumentType::Int16:
+                return { static_cast<int64_t>(read<int16_t>(arguments, offset)) };
+            case ArgumentType::Int32:
+                return { static_cast<int64_t>(read<int32_t>(arguments, offset)) };
+            case ArgumentType::Int64:
+                return { read<int64_t>(arguments, offset) };
+            case ArgumentType::UInt8:
+                return { static_cast<uint64_t>(read<uint8_t>(arguments, offset)) };
+            case ArgumentType::UInt16:
+                return { static_cast<uint64_t>(read<uint16_t>(arguments, offset)) };
+            case ArgumentType::UInt32:
+                return { static_cast<uint64_t>(read<uint32_t>(arguments, offset)) };
+            case ArgumentType::UInt64:
+                return { read<uint64_t>(arguments, offset) };
+            case ArgumentType::Float:
+                return { read<float>(arguments, offset) };
+            case ArgumentType::Double:
+                return { read<double>(arguments, offset) };
+            case ArgumentType::String:
+            {
+                const uint64_t size = read<uint64_t>(arguments, offset);
+                if (size > arguments.size() - offset) {
+                    throw std::format_error("Encoded arguments are truncated");
+                }
+                const std::string_view v = arguments.substr(offset, size);
+                offset += size;
+                return { v };
+            }
+            case ArgumentType::Pointer:
+            {
+                const uint64_t address = read<uint64_t>(arguments, offset);
+                return {
+                    reinterpret_cast<const void*>(static_cast<uintptr_t>(address))
+                };
+            }
+            case ArgumentType::Raw:
+            {
+                const uint32_t size = read<uint32_t>(arguments, offset);
+                if (size > arguments.size() - offset) {
+                    throw std::format_error("Encoded arguments are truncated");
+                }
+                offset += size;
+                return {};
+            }
+            default:
+                throw std::format_error("Unknown argument type");
+        }
+    }
+
+    template <size_t... Is>
+    std::string vformat(std::string_view format,
+                        std::array<DynamicArgument, MaxArguments>& arguments,
+                        std::index_sequence<Is...>)
+    {
+        // Unused trailing arguments are permitted by std::format, so we can always pass
+        // the maximum number of arguments
+        return std::vformat(format, std::make_format_args(arguments[Is]...));
+    }
+} // namespace
+
+template <>
+struct std::formatter<DynamicArgument> {
+    constexpr auto parse(std::format_parse_context& ctx) {
+        auto it = ctx.begin();
+        while (it != ctx.end() && *it != '}') {
+            if (*it == '{') {
+                throw std::format_error("Nested replacement fields are not supported");
+            }
+            it++;
+        }
+        spec = std::string_view(ctx.begin(), it);
+        return it;
+    }
+
+    auto format(const DynamicArgument& argument, std::format_context& ctx) const {
+        return std::visit(
+            [this, &ctx](const auto& value) {
+                using T = std::decay_t<decltype(value)>;
+                if constexpr (std::is_same_v<T, std::monostate>) {
+                    throw std::format_error("Argument cannot be formatted");
+                    return ctx.out();
+                }
+                else {
+                    std::string f = "{:";
+                    f += spec;
+                    f += '}';
+                    return std::vformat_to(ctx.out(), f, std::make_format_args(value));
+                }
+            },
+            argument.value
+        );
+    }
+
+    std::string_view spec;
+};
+
+namespace ghoul::logging {
+
+bool hasPortableArguments(std::string_view arguments) {
+    size_t offset = 0;
+    while (offset < arguments.size()) {
+        const ArgumentType type = static_cast<ArgumentType>(arguments[offset]);
+        if (type == ArgumentType::Raw) {
+            return false;
+        }
+        decodeArgument(arguments, offset);
+    }
+    return true;
+}
+
+std::string formatArguments(std::string_view format, std::string_view arguments) {
+    std::array<DynamicArgument, MaxArguments> values;
+    size_t offset = 0;
+    size_t nArguments = 0;
+    while (offset < arguments.size()) {
+        if (nArguments == MaxArguments) {
+            throw std::format_error("Too many arguments");
+        }
+        values[nArguments] = decodeArgument(arguments, offset);
+        nArguments++;
+    }
+    return vformat(format, values, std::make_index_sequence<MaxArguments>());
+}
+
+} // namespace ghoul::logging
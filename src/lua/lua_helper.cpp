@@ -26,9 +26,12 @@
 #include <ghoul/lua/lua_helper.h>
 
 #include <ghoul/format.h>
+#include <ghoul/filesystem/cachemanager.h>
+#include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/lua/ghoul_lua.h>
 #include <ghoul/misc/dictionary.h>
+#include <ghoul/misc/dictionarybinaryformat.h>
 #include <ghoul/misc/stringhelper.h>
 #include <cstring>
 #include <stdexcept>
@@ -294,6 +297,50 @@ Dictionary loadDictionaryFromFile(const std::filesystem::path& filename, lua_Sta
     return result;
 }
 
+Dictionary loadDictionaryFromFileCached(const std::filesystem::path& filename,
+                                        lua_State* state)
+{
+    ghoul_assert(!filename.empty(), "filename must not be empty");
+    ghoul_assert(
+        std::filesystem::is_regular_file(filename),
+        "filename must be an existing file"
+    );
+
+    filesystem::CacheManager* cache = FileSys.cacheManager();
+    if (!cache) {
+        return loadDictionaryFromFile(filename, state);
+    }
+
+    // Without additional information, the cached file is keyed on the file's path and
+    // its last modification date, so a modified script invalidates the cache
+    const std::filesystem::path cached = cache->cachedFilename(
+        filename,
+        std::nullopt,
+        "dictionaries"
+    );
+    if (std::filesystem::is_regular_file(cached)) {
+        try {
+            return loadBinaryFile(cached);
+        }
+        catch (const RuntimeError& e) {
+            LWARNINGC(
+                "Lua",
+                std::format("Ignoring cache for '{}': {}", filename, e.message)
+            );
+        }
+    }
+
+    Dictionary result = loadDictionaryFromFile(filename, state);
+    try {
+        saveBinaryFile(result, cached);
+    }
+    catch (const RuntimeError& e) {
+        LWARNINGC("Lua", std::format("Error caching '{}': {}", filename, e.message));
+        std::filesystem::remove(cached);
+    }
+    return result;
+}
+
 void loadDictionaryFromString(const std::string& script, Dictionary& dictionary,
                               lua_State* state)
 {
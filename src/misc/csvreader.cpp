@@ -137,10 +137,11 @@ namespace {
             // If indices have been specified, we use those to reorganize and filter the
             // line values
             if (!indices.empty()) {
-                std::vector<std::string> copy = lineValues;
-                lineValues.clear();
+                const std::vector<std::string> values = std::move(lineValues);
+                lineValues = std::vector<std::string>();
+                lineValues.reserve(indices.size());
                 for (const int idx : indices) {
-                    lineValues.push_back(copy[idx]);
+                    lineValues.push_back(values[idx]);
                 }
             }
             result.push_back(std::move(lineValues));
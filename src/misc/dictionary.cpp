@@ -28,7 +28,11 @@
 #include <ghoul/format.h>
 #include <ghoul/misc/assert.h>
 #include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <optional>
+#include <span>
 #include <utility>
 
 namespace {
@@ -52,6 +56,59 @@ namespace {
         glm::dmat3x3, glm::dmat3x4, glm::dmat4x2, glm::dmat4x3, glm::dmat4x4>;
     template <typename T> using isGLMType = is_one_of<T, GLMTypes>;
 
+    // Returns the values of the vector, matrix, or std::vector with the value type V that
+    // is stored in the variant, or std::nullopt if the variant stores a different type
+    template <typename V, typename Variant>
+    std::optional<std::span<const V>> components(const Variant& v) {
+        return std::visit(
+            [](const auto& value) -> std::optional<std::span<const V>> {
+                using U = std::decay_t<decltype(value)>;
+                if constexpr (std::is_same_v<U, std::vector<V>>) {
+                    return std::span<const V>(value);
+                }
+                else if constexpr (isGLMType<U>::value) {
+                    if constexpr (std::is_same_v<typename U::value_type, V>) {
+                        return std::span<const V>(
+                            glm::value_ptr(value),
+                            glm_components<U>::value
+                        );
+                    }
+                }
+                return std::nullopt;
+            },
+            v
+        );
+    }
+
+    // Compares two values of the variant. Vector and matrix types are equal to a
+    // std::vector that contains the same values, as they were stored as such in the past
+    template <typename Variant>
+    bool isEqual(const Variant& lhs, const Variant& rhs) {
+        if (lhs.index() == rhs.index()) {
+            return lhs == rhs;
+        }
+
+        const auto ld = components<double>(lhs);
+        const auto rd = components<double>(rhs);
+        if (ld.has_value() && rd.has_value()) {
+            return std::ranges::equal(*ld, *rd);
+        }
+        const auto li = components<int>(lhs);
+        const auto ri = components<int>(rhs);
+        if (li.has_value() && ri.has_value()) {
+            return std::ranges::equal(*li, *ri);
+        }
+        return false;
+    }
+
+    // Compares the key of an entry in the Dictionary's storage with a lookup key
+    struct KeyLess {
+        template <typename Entry>
+        bool operator()(const Entry& entry, std::string_view key) const {
+            return entry.first < key;
+        }
+    };
+
 
     /**
      * Exception that is thrown if the Dictionary does not contain a provided key.
@@ -80,23 +137,33 @@ namespace {
 namespace ghoul {
 
 bool Dictionary::operator==(const Dictionary& rhs) const noexcept {
-    return _storage == rhs._storage;
+    if (_storage == rhs._storage) {
+        return true;
+    }
+
+    const std::vector<Entry>& lhsEntries = entries();
+    const std::vector<Entry>& rhsEntries = rhs.entries();
+    return std::ranges::equal(
+        lhsEntries,
+        rhsEntries,
+        [](const Entry& l, const Entry& r) {
+            return l.first == r.first && isEqual(l.second, r.second);
+        }
+    );
 }
 
 bool Dictionary::operator!=(const Dictionary& rhs) const noexcept {
-    return _storage != rhs._storage;
+    return !(*this == rhs);
 }
 
 template <SupportedByDictionary T>
 void Dictionary::setValue(std::string key, T value) {
     ghoul_assert(!key.empty(), "Key must not be empty");
     if constexpr (isDirectType<T>::value) {
-        _storage.insert_or_assign(std::move(key), std::move(value));
+        insertOrAssign(std::move(key), std::move(value));
     }
     else if constexpr (isGLMType<T>::value) {
-        typename T::value_type* p = glm::value_ptr(value);
-        std::vector<typename T::value_type> vec(p, p + glm_components<T>::value);
-        _storage.insert_or_assign(std::move(key), std::move(vec));
+        insertOrAssign(std::move(key), value);
     }
     else if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, const char[]>)
     {
@@ -122,49 +189,62 @@ template <SupportedByDictionary T>
 T Dictionary::value(std::string_view key) const {
     ghoul_assert(!key.empty(), "Key must not be empty");
 
-    auto it = _storage.find(key);
-    if (it == _storage.end()) {
+    const StorageTypes* v = find(key);
+    if (!v) {
         throw KeyError(std::format("Could not find key '{}'", key));
     }
 
     if constexpr (isDirectType<T>::value) {
-        if (std::holds_alternative<T>(it->second)) {
-            return std::get<T>(it->second);
+        if (std::holds_alternative<T>(*v)) {
+            return std::get<T>(*v);
         }
-        else {
-            throw ValueError(
-                std::string(key),
-                std::format(
-                    "Error accessing value, wanted type '{}' has '{}'",
-                    typeid(T).name(), it->second.index()
-                )
-            );
+
+        if constexpr (IsAnyOf<T, std::vector<int>, std::vector<double>>) {
+            // Vector and matrix types can also be accessed as a list of their values
+            const auto values = components<typename T::value_type>(*v);
+            if (values.has_value()) {
+                return T(values->begin(), values->end());
+            }
         }
+
+        throw ValueError(
+            std::string(key),
+            std::format(
+                "Error accessing value, wanted type '{}' has '{}'",
+                typeid(T).name(), v->index()
+            )
+        );
     }
     else if constexpr (isGLMType<T>::value) {
+        if (std::holds_alternative<T>(*v)) {
+            return std::get<T>(*v);
+        }
+
+        // Other vector and matrix types and lists with the right number of values are
+        // converted, as are Dictionaries with the keys 1..n as they are created by Lua
         using VT = std::vector<typename T::value_type>;
         VT vec;
-        if (std::holds_alternative<VT>(it->second)) {
-            vec = std::get<VT>(it->second);
-        }
-        else if (std::holds_alternative<Dictionary>(it->second)) {
-            const Dictionary d = std::get<Dictionary>(it->second);
-            vec.resize(d._storage.size());
-            for (const auto& kv : d._storage) {
+        std::optional<std::span<const typename T::value_type>> values =
+            components<typename T::value_type>(*v);
+        if (!values.has_value() && std::holds_alternative<Dictionary>(*v)) {
+            const Dictionary& d = std::get<Dictionary>(*v);
+            vec.resize(d.size());
+            for (const auto& kv : d.entries()) {
                 // Lua is 1-based index, the rest of the world is 0-based
                 int k = std::stoi(kv.first) - 1;
-                if (k < 0 || k >= static_cast<int>(d._storage.size())) {
+                if (k < 0 || k >= static_cast<int>(d.size())) {
                     throw ValueError(
                         std::string(key),
                         std::format(
-                            "Invalid key '{}' outside range [0,{}]", k, d._storage.size()
+                            "Invalid key '{}' outside range [0,{}]", k, d.size()
                         )
                     );
                 }
                 vec[k] = std::get<typename T::value_type>(kv.second);
             }
+            values = vec;
         }
-        else {
+        else if (!values.has_value()) {
             throw ValueError(
                 std::string(key),
                 std::format(
@@ -175,18 +255,18 @@ T Dictionary::value(std::string_view key) const {
             );
         }
 
-        if (vec.size() != glm_components<T>::value) {
+        if (values->size() != glm_components<T>::value) {
             throw ValueError(
                 std::string(key),
                 std::format(
                     "Contained wrong number of values. Expected {} got {}",
-                    glm_components<T>::value, vec.size()
+                    glm_components<T>::value, values->size()
                 )
             );
         }
 
         T res;
-        std::memcpy(glm::value_ptr(res), vec.data(), sizeof(T));
+        std::memcpy(glm::value_ptr(res), values->data(), sizeof(T));
         return res;
     }
     else if constexpr (std::is_same_v<T, const char*> ||
@@ -213,16 +293,22 @@ template <SupportedByDictionary T>
 bool Dictionary::hasValue(std::string_view key) const {
     ghoul_assert(!key.empty(), "Key must not be empty");
 
-    auto it = _storage.find(key);
-    if (it == _storage.end()) {
+    const StorageTypes* v = find(key);
+    if (!v) {
         return false;
     }
-    if constexpr (isDirectType<T>::value) {
-        return std::holds_alternative<T>(it->second);
+    if constexpr (IsAnyOf<T, std::vector<int>, std::vector<double>>) {
+        return components<typename T::value_type>(*v).has_value();
+    }
+    else if constexpr (isDirectType<T>::value) {
+        return std::holds_alternative<T>(*v);
     }
     else if constexpr (isGLMType<T>::value) {
-        if (std::holds_alternative<Dictionary>(it->second)) {
-            const Dictionary d = std::get<Dictionary>(it->second);
+        if (std::holds_alternative<T>(*v)) {
+            return true;
+        }
+        else if (std::holds_alternative<Dictionary>(*v)) {
+            const Dictionary& d = std::get<Dictionary>(*v);
 
             if (d.size() != glm_components<T>::value) {
                 return false;
@@ -239,9 +325,8 @@ bool Dictionary::hasValue(std::string_view key) const {
             return true;
         }
         else {
-            using VT = std::vector<typename T::value_type>;
-            return std::holds_alternative<VT>(it->second) &&
-                std::get<VT>(it->second).size() == glm_components<T>::value;
+            const auto values = components<typename T::value_type>(*v);
+            return values.has_value() && values->size() == glm_components<T>::value;
         }
     }
     else if constexpr (std::is_same_v<T, const char*> ||
@@ -258,40 +343,114 @@ bool Dictionary::hasValue(std::string_view key) const {
     }
 }
 
+const Dictionary& Dictionary::ref(std::string_view key) const {
+    ghoul_assert(!key.empty(), "Key must not be empty");
+
+    const StorageTypes* v = find(key);
+    if (!v) {
+        throw KeyError(std::format("Could not find key '{}'", key));
+    }
+    if (!std::holds_alternative<Dictionary>(*v)) {
+        throw ValueError(
+            std::string(key),
+            std::format("Error accessing value, wanted Dictionary has '{}'", v->index())
+        );
+    }
+    return std::get<Dictionary>(*v);
+}
+
+std::string_view Dictionary::stringView(std::string_view key) const {
+    ghoul_assert(!key.empty(), "Key must not be empty");
+
+    const StorageTypes* v = find(key);
+    if (!v) {
+        throw KeyError(std::format("Could not find key '{}'", key));
+    }
+    if (!std::holds_alternative<std::string>(*v)) {
+        throw ValueError(
+            std::string(key),
+            std::format("Error accessing value, wanted string has '{}'", v->index())
+        );
+    }
+    return std::get<std::string>(*v);
+}
+
+template <typename T>
+    requires IsAnyOf<T, int, double>
+std::span<const T> Dictionary::valueSpan(std::string_view key) const {
+    ghoul_assert(!key.empty(), "Key must not be empty");
+
+    const StorageTypes* v = find(key);
+    if (!v) {
+        throw KeyError(std::format("Could not find key '{}'", key));
+    }
+    const std::optional<std::span<const T>> values = components<T>(*v);
+    if (!values.has_value()) {
+        throw ValueError(
+            std::string(key),
+            std::format(
+                "Error accessing values, wanted '{}' has '{}'",
+                typeid(T).name(), v->index()
+            )
+        );
+    }
+    return *values;
+}
+
+std::pair<const Dictionary*, std::string_view> Dictionary::resolvePath(
+                                                             std::string_view path) const
+{
+    const Dictionary* d = this;
+    for (size_t dotPos = path.find('.'); dotPos != std::string_view::npos;
+         dotPos = path.find('.'))
+    {
+        const StorageTypes* v = d->find(path.substr(0, dotPos));
+        if (!v || !std::holds_alternative<Dictionary>(*v)) {
+            return { nullptr, path };
+        }
+        d = &std::get<Dictionary>(*v);
+        path = path.substr(dotPos + 1);
+    }
+    return { d, path };
+}
+
 bool Dictionary::hasKey(std::string_view key) const {
     ghoul_assert(!key.empty(), "Key must not be empty");
 
-    auto it = _storage.find(key);
-    return it != _storage.end();
+    return find(key) != nullptr;
 }
 
 std::vector<std::string_view> Dictionary::keys() const {
     std::vector<std::string_view> keys;
-    keys.reserve(_storage.size());
-    for (const std::pair<const std::string, StorageTypes>& kv : _storage) {
+    keys.reserve(size());
+    for (const Entry& kv : entries()) {
         keys.push_back(kv.first);
     }
     return keys;
 }
 
 void Dictionary::removeValue(std::string_view key) {
-    if (const auto it = _storage.find(key);  it != _storage.end()) {
-        _storage.erase(it);
+    if (!find(key)) {
+        return;
     }
+
+    std::vector<Entry>& storage = mutableEntries();
+    const auto it = std::lower_bound(storage.begin(), storage.end(), key, KeyLess());
+    storage.erase(it);
 }
 
 bool Dictionary::isEmpty() const {
-    return _storage.empty();
+    return entries().empty();
 }
 
 size_t Dictionary::size() const {
-    return _storage.size();
+    return entries().size();
 }
 
 bool Dictionary::isSubset(const Dictionary& dict) const {
-    for (const std::pair<const std::string, StorageTypes>& kv : dict._storage) {
-        auto it = _storage.find(kv.first);
-        if (it == _storage.end() || it->second != kv.second) {
+    for (const Entry& kv : dict.entries()) {
+        const StorageTypes* v = find(kv.first);
+        if (!v || !isEqual(*v, kv.second)) {
             return false;
         }
     }
@@ -300,6 +459,53 @@ bool Dictionary::isSubset(const Dictionary& dict) const {
     return true;
 }
 
+const Dictionary::StorageTypes* Dictionary::find(std::string_view key) const {
+    const std::vector<Entry>& storage = entries();
+    const auto it = std::lower_bound(storage.begin(), storage.end(), key, KeyLess());
+    return (it != storage.end() && it->first == key) ? &it->second : nullptr;
+}
+
+const std::vector<Dictionary::Entry>& Dictionary::entries() const {
+    static const std::vector<Entry> Empty;
+    return _storage ? *_storage : Empty;
+}
+
+std::vector<Dictionary::Entry>& Dictionary::mutableEntries() {
+    if (!_storage) {
+        _storage = std::make_shared<std::vector<Entry>>();
+    }
+    else if (_storage.use_count() > 1) {
+        // The entries are shared with other copies of this Dictionary, so we need our
+        // own copy. Nested Dictionaries are shared with the original entries, so this
+        // only copies a single level of the tree
+        _storage = std::make_shared<std::vector<Entry>>(*_storage);
+    }
+    else {
+        // We are the only owner, but the previous other owners might have read the
+        // entries on a different thread before releasing them
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    return *_storage;
+}
+
+void Dictionary::insertOrAssign(std::string key, StorageTypes value) {
+    // Dictionaries are frequently built with keys in ascending order, for example from
+    // sorted sources or when copying another Dictionary, so check the end first
+    std::vector<Entry>& storage = mutableEntries();
+    if (storage.empty() || storage.back().first < key) {
+        storage.emplace_back(std::move(key), std::move(value));
+        return;
+    }
+
+    const auto it = std::lower_bound(storage.begin(), storage.end(), key, KeyLess());
+    if (it != storage.end() && it->first == key) {
+        it->second = std::move(value);
+    }
+    else {
+        storage.emplace(it, std::move(key), std::move(value));
+    }
+}
+
 template void Dictionary::setValue(std::string, Dictionary value);
 template void Dictionary::setValue(std::string, bool value);
 template void Dictionary::setValue(std::string, double);
@@ -356,6 +562,10 @@ template glm::dmat4x3 Dictionary::value(std::string_view) const;
 template glm::dmat4x4 Dictionary::value(std::string_view) const;
 
 
+template std::span<const int> Dictionary::valueSpan(std::string_view) const;
+template std::span<const double> Dictionary::valueSpan(std::string_view) const;
+
+
 template bool Dictionary::hasValue<Dictionary>(std::string_view) const;
 template bool Dictionary::hasValue<bool>(std::string_view) const;
 template bool Dictionary::hasValue<double>(std::string_view) const;
@@ -0,0 +1,772 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2026                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <ghoul/misc/dictionarybinaryformat.h>
+
+#include <ghoul/format.h>
+#include <ghoul/glm.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#ifdef WIN32
+#include <Windows.h>
+#else // ^^^^ WIN32 // !WIN32 vvvv
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // WIN32
+
+namespace {
+    using namespace ghoul;
+
+    constexpr std::array<char, 4> Magic = { 'G', 'D', 'I', 'C' };
+    constexpr uint32_t Version = 1;
+    constexpr uint32_t ByteOrderMark = 0x01020304;
+
+    // Protects against stack overflows when decoding corrupted buffers
+    constexpr int MaxDepth = 512;
+
+    struct Header {
+        std::array<char, 4> magic;
+        uint32_t version;
+        uint32_t byteOrder;
+        uint32_t nKeys;
+        uint64_t keyTable;
+        uint64_t root;
+        uint64_t size;
+    };
+    static_assert(sizeof(Header) == 40);
+
+    // An entry in the key table that points to the characters of the key
+    struct KeyRecord {
+        uint64_t offset;
+        uint64_t length;
+    };
+    static_assert(sizeof(KeyRecord) == 16);
+
+    // A single value in a Dictionary
+    struct EntryRecord {
+        uint32_t key;
+        uint32_t type;
+        uint64_t payload;
+    };
+    static_assert(sizeof(EntryRecord) == 16);
+
+    // The type tags are part of the file format, so new types must only be added to the
+    // end and existing types must not be reordered
+    enum class Type : uint32_t {
+        Bool = 0,
+        Int,
+        Double,
+        String,
+        Dictionary,
+        IntVector,
+        DoubleVector,
+        StringVector,
+        // The glm types follow in the order of GLMTypes
+        FirstGLM
+    };
+
+    using GLMTypes = std::tuple<glm::ivec2, glm::ivec3, glm::ivec4, glm::dvec2,
+        glm::dvec3, glm::dvec4, glm::dmat2x2, glm::dmat2x3, glm::dmat2x4, glm::dmat3x2,
+        glm::dmat3x3, glm::dmat3x4, glm::dmat4x2, glm::dmat4x3, glm::dmat4x4>;
+
+    template <typename T, size_t... Is>
+    constexpr uint32_t glmTypeTag(std::index_sequence<Is...>) {
+        return static_cast<uint32_t>(Type::FirstGLM) +
+            ((std::is_same_v<T, std::tuple_element_t<Is, GLMTypes>> ? Is : 0) + ...);
+    }
+
+    template <typename T>
+    constexpr uint32_t glmTypeTag() {
+        return glmTypeTag<T>(std::make_index_sequence<std::tuple_size_v<GLMTypes>>());
+    }
+
+    // Calls the templated function with the glm type that belongs to the type tag and
+    // returns whether such a type exists
+    template <typename Function, size_t... Is>
+    bool visitGLMType(uint32_t type, Function&& function, std::index_sequence<Is...>) {
+        return (
+            (type == static_cast<uint32_t>(Type::FirstGLM) + Is ?
+                (function.template operator()<std::tuple_element_t<Is, GLMTypes>>(),
+                 true) :
+                false
+            ) || ...
+        );
+    }
+
+    template <typename Function>
+    bool visitGLMType(uint32_t type, Function&& function) {
+        return visitGLMType(
+            type,
+            std::forward<Function>(function),
+            std::make_index_sequence<std::tuple_size_v<GLMTypes>>()
+        );
+    }
+
+    constexpr uint64_t align(uint64_t offset) {
+        return (offset + 7) & ~uint64_t(7);
+    }
+
+    //
+    // Reading
+    //
+
+    // Throws if the \p buffer does not contain \p count objects of \p size bytes at the
+    // \p offset
+    void checkRange(std::span<const std::byte> buffer, uint64_t offset, uint64_t count,
+                    uint64_t size)
+    {
+        if (offset > buffer.size() || (buffer.size() - offset) / size < count) {
+            throw BinaryFormatError(std::format("Offset {} is out of bounds", offset));
+        }
+    }
+
+    template <typename T>
+    T read(std::span<const std::byte> buffer, uint64_t offset) {
+        checkRange(buffer, offset, 1, sizeof(T));
+        T value;
+        std::memcpy(&value, buffer.data() + offset, sizeof(T));
+        return value;
+    }
+
+    // Returns the \p count values of type T that are stored at the \p offset
+    template <typename T>
+    std::span<const T> readSpan(std::span<const std::byte> buffer, uint64_t offset,
+                                uint64_t count)
+    {
+        if (offset % alignof(T) != 0) {
+            throw BinaryFormatError(std::format("Offset {} is not aligned", offset));
+        }
+        checkRange(buffer, offset, count, sizeof(T));
+        return std::span<const T>(
+            reinterpret_cast<const T*>(buffer.data() + offset),
+            static_cast<size_t>(count)
+        );
+    }
+
+    // Returns a list that is stored as its size followed by its values
+    template <typename T>
+    std::span<const T> readList(std::span<const std::byte> buffer, uint64_t offset) {
+        const uint64_t count = read<uint64_t>(buffer, offset);
+        return readSpan<T>(buffer, offset + sizeof(uint64_t), count);
+    }
+
+    std::string_view readString(std::span<const std::byte> buffer, uint64_t offset) {
+        const std::span<const char> s = readList<char>(buffer, offset);
+        return std::string_view(s.data(), s.size());
+    }
+
+    class Reader {
+    public:
+        Reader(std::span<const std::byte> buffer, uint64_t keyTable, uint32_t nKeys);
+
+        std::span<const EntryRecord> entries(uint64_t node) const;
+        std::string_view key(uint32_t index) const;
+        const EntryRecord* find(uint64_t node, std::string_view key) const;
+
+        Dictionary decodeDictionary(uint64_t node, int depth) const;
+        void decodeEntry(Dictionary& dictionary, const EntryRecord& entry,
+            int depth) const;
+
+    private:
+        std::span<const std::byte> _buffer;
+        std::span<const KeyRecord> _keys;
+    };
+
+    Reader::Reader(std::span<const std::byte> buffer, uint64_t keyTable, uint32_t nKeys)
+        : _buffer(buffer)
+        , _keys(readSpan<KeyRecord>(buffer, keyTable, nKeys))
+    {}
+
+    std::span<const EntryRecord> Reader::entries(uint64_t node) const {
+        return readList<EntryRecord>(_buffer, node);
+    }
+
+    std::string_view Reader::key(uint32_t index) const {
+        if (index >= _keys.size()) {
+            throw BinaryFormatError(std::format("Key index {} is out of bounds", index));
+        }
+        const KeyRecord& record = _keys[index];
+        const std::span<const char> k = readSpan<char>(
+            _buffer,
+            record.offset,
+            record.length
+        );
+        return std::string_view(k.data(), k.size());
+    }
+
+    const EntryRecord* Reader::find(uint64_t node, std::string_view key) const {
+        ghoul_assert(!key.empty(), "Key must not be empty");
+
+        const std::span<const EntryRecord> es = entries(node);
+        const auto it = std::lower_bound(
+            es.begin(),
+            es.end(),
+            key,
+            [this](const EntryRecord& entry, std::string_view k) {
+                return this->key(entry.key) < k;
+            }
+        );
+        return (it != es.end() && this->key(it->key) == key) ? &*it : nullptr;
+    }
+
+    Dictionary Reader::decodeDictionary(uint64_t node, int depth) const {
+        if (depth > MaxDepth) {
+            throw BinaryFormatError("Maximum nesting depth exceeded");
+        }
+
+        Dictionary result;
+        for (const EntryRecord& entry : entries(node)) {
+            decodeEntry(result, entry, depth);
+        }
+        return result;
+    }
+
+    void Reader::decodeEntry(Dictionary& dictionary, const EntryRecord& entry,
+                             int depth) const
+    {
+        std::string k = std::string(key(entry.key));
+        if (k.empty()) {
+            throw BinaryFormatError("Empty key");
+        }
+
+        switch (static_cast<Type>(entry.type)) {
+            case Type::Bool:
+                dictionary.setValue(std::move(k), entry.payload != 0);
+                return;
+            case Type::Int:
+                dictionary.setValue(
+                    std::move(k),
+                    static_cast<int>(std::bit_cast<int64_t>(entry.payload))
+                );
+                return;
+            case Type::Double:
+                dictionary.setValue(std::move(k), std::bit_cast<double>(entry.payload));
+                return;
+            case Type::String:
+                dictionary.setValue(
+                    std::move(k),
+                    std::string(readString(_buffer, entry.payload))
+                );
+                return;
+            case Type::Dictionary:
+                dictionary.setValue(
+                    std::move(k),
+                    decodeDictionary(entry.payload, depth + 1)
+                );
+                return;
+            case Type::IntVector:
+            {
+                const std::span<const int> v = readList<int>(_buffer, entry.payload);
+                dictionary.setValue(std::move(k), std::vector<int>(v.begin(), v.end()));
+                return;
+            }
+            case Type::DoubleVector:
+            {
+                const std::span<const double> v =
+                    readList<double>(_buffer, entry.payload);
+                dictionary.setValue(
+                    std::move(k),
+                    std::vector<double>(v.begin(), v.end())
+                );
+                return;
+            }
+            case Type::StringVector:
+            {
+                const std::span<const uint64_t> offsets =
+                    readList<uint64_t>(_buffer, entry.payload);
+                std::vector<std::string> v;
+                v.reserve(offsets.size());
+                for (uint64_t offset : offsets) {
+                    v.emplace_back(readString(_buffer, offset));
+                }
+                dictionary.setValue(std::move(k), std::move(v));
+                return;
+            }
+            default:
+            {
+                const bool isGLM = visitGLMType(
+                    entry.type,
+                    [&]<typename T>() {
+                        using V = typename T::value_type;
+                        const std::span<const V> values = readSpan<V>(
+                            _buffer,
+                            entry.payload,
+                            glm_components<T>::value
+                        );
+                        T value;
+                        std::memcpy(glm::value_ptr(value), values.data(), sizeof(T));
+                        dictionary.setValue(std::move(k), value);
+                    }
+                );
+                if (!isGLM) {
+                    throw BinaryFormatError(std::format("Unknown type {}", entry.type));
+                }
+            }
+        }
+    }
+
+    //
+    // Writing
+    //
+
+    class Writer {
+    public:
+        std::vector<std::byte> write(const Dictionary& dictionary);
+
+    private:
+        // Reserves \p size bytes at the end of the buffer, aligned to 8 bytes, and
+        // returns the offset of the reserved memory
+        uint64_t allocate(uint64_t size);
+
+        template <typename T>
+        void store(uint64_t offset, const T& value);
+
+        uint32_t internKey(std::string_view key);
+
+        template <typename T>
+        uint64_t writeValues(std::span<const T> values);
+
+        template <typename T>
+        uint64_t writeList(std::span<const T> values);
+
+        uint64_t writeDictionary(const Dictionary& dictionary);
+
+        std::vector<std::byte> _buffer;
+        std::unordered_map<std::string_view, uint32_t> _keyIndices;
+        std::vector<std::string_view> _keys;
+    };
+
+    std::vector<std::byte> Writer::write(const Dictionary& dictionary) {
+        allocate(sizeof(Header));
+        const uint64_t root = writeDictionary(dictionary);
+
+        const uint64_t keyTable = allocate(_keys.size() * sizeof(KeyRecord));
+        for (size_t i = 0; i < _keys.size(); i++) {
+            const uint64_t offset = writeValues(std::span<const char>(_keys[i]));
+            store(keyTable + i * sizeof(KeyRecord), KeyRecord{ offset, _keys[i].size() });
+        }
+
+        const Header header = {
+            .magic = Magic,
+            .version = Version,
+            .byteOrder = ByteOrderMark,
+            .nKeys = static_cast<uint32_t>(_keys.size()),
+            .keyTable = keyTable,
+            .root = root,
+            .size = _buffer.size()
+        };
+        store(0, header);
+        return std::move(_buffer);
+    }
+
+    uint64_t Writer::allocate(uint64_t size) {
+        const uint64_t offset = align(_buffer.size());
+        _buffer.resize(offset + size);
+        return offset;
+    }
+
+    template <typename T>
+    void Writer::store(uint64_t offset, const T& value) {
+        std::memcpy(_buffer.data() + offset, &value, sizeof(T));
+    }
+
+    uint32_t Writer::internKey(std::string_view key) {
+        // The keys point into the Dictionary that is written, which outlives the Writer
+        const auto [it, inserted] = _keyIndices.try_emplace(
+            key,
+            static_cast<uint32_t>(_keys.size())
+        );
+        if (inserted) {
+            _keys.push_back(key);
+        }
+        return it->second;
+    }
+
+    template <typename T>
+    uint64_t Writer::writeValues(std::span<const T> values) {
+        const uint64_t offset = allocate(values.size_bytes());
+        if (!values.empty()) {
+            std::memcpy(_buffer.data() + offset, values.data(), values.size_bytes());
+        }
+        return offset;
+    }
+
+    template <typename T>
+    uint64_t Writer::writeList(std::span<const T> values) {
+        const uint64_t offset = allocate(sizeof(uint64_t) + values.size_bytes());
+        store(offset, static_cast<uint64_t>(values.size()));
+        if (!values.empty()) {
+            std::memcpy(
+                _buffer.data() + offset + sizeof(uint64_t),
+                values.data(),
+                values.size_bytes()
+            );
+        }
+        return offset;
+    }
+
+    uint64_t Writer::writeDictionary(const Dictionary& dictionary) {
+        const uint64_t node = allocate(
+            sizeof(uint64_t) + dictionary.size() * sizeof(EntryRecord)
+        );
+        store(node, static_cast<uint64_t>(dictionary.size()));
+
+        uint64_t offset = node + sizeof(uint64_t);
+        dictionary.forEach([this, &offset](std::string_view key, const auto& value) {
+            using T = std::decay_t<decltype(value)>;
+
+            EntryRecord entry = { .key = internKey(key), .type = 0, .payload = 0 };
+            if constexpr (std::is_same_v<T, bool>) {
+                entry.type = static_cast<uint32_t>(Type::Bool);
+                entry.payload = value ? 1 : 0;
+            }
+            else if constexpr (std::is_same_v<T, int>) {
+                entry.type = static_cast<uint32_t>(Type::Int);
+                entry.payload = std::bit_cast<uint64_t>(static_cast<int64_t>(value));
+            }
+            else if constexpr (std::is_same_v<T, double>) {
+                entry.type = static_cast<uint32_t>(Type::Double);
+                entry.payload = std::bit_cast<uint64_t>(value);
+            }
+            else if constexpr (std::is_same_v<T, std::string>) {
+                entry.type = static_cast<uint32_t>(Type::String);
+                entry.payload = writeList(std::span<const char>(value));
+            }
+            else if constexpr (std::is_same_v<T, Dictionary>) {
+                entry.type = static_cast<uint32_t>(Type::Dictionary);
+                entry.payload = writeDictionary(value);
+            }
+            else if constexpr (std::is_same_v<T, std::vector<int>>) {
+                entry.type = static_cast<uint32_t>(Type::IntVector);
+                entry.payload = writeList(std::span<const int>(value));
+            }
+            else if constexpr (std::is_same_v<T, std::vector<double>>) {
+                entry.type = static_cast<uint32_t>(Type::DoubleVector);
+                entry.payload = writeList(std::span<const double>(value));
+            }
+            else if constexpr (std::is_same_v<T, std::vector<std::string>>) {
+                std::vector<uint64_t> offsets;
+                offsets.reserve(value.size());
+                for (const std::string& v : value) {
+                    offsets.push_back(writeList(std::span<const char>(v)));
+                }
+                entry.type = static_cast<uint32_t>(Type::StringVector);
+                entry.payload = writeList(std::span<const uint64_t>(offsets));
+            }
+            else if constexpr (std::is_same_v<T, void*>) {
+                throw BinaryFormatError(std::format(
+                    "Key '{}' contains a pointer, which cannot be stored", key
+                ));
+            }
+            else {
+                using V = typename T::value_type;
+                entry.type = glmTypeTag<T>();
+                entry.payload = writeValues(
+                    std::span<const V>(glm::value_ptr(value), glm_components<T>::value)
+                );
+            }
+
+            store(offset, entry);
+            offset += sizeof(EntryRecord);
+        });
+        return node;
+    }
+} // namespace
+
+namespace ghoul {
+
+BinaryFormatError::BinaryFormatError(std::string msg)
+    : RuntimeError(std::move(msg), "Dictionary")
+{}
+
+BinaryDictionaryView::BinaryDictionaryView(std::span<const std::byte> buffer)
+    : _buffer(buffer)
+{
+    ghoul_assert(
+        reinterpret_cast<uintptr_t>(buffer.data()) % alignof(uint64_t) == 0,
+        "Buffer must be aligned to 8 bytes"
+    );
+
+    if (buffer.size() < sizeof(Header)) {
+        throw BinaryFormatError("Buffer is too small to contain a Dictionary");
+    }
+    const Header header = read<Header>(buffer, 0);
+    if (header.magic != Magic) {
+        throw BinaryFormatError("Buffer does not contain a Dictionary");
+    }
+    if (header.version != Version) {
+        throw BinaryFormatError(std::format(
+            "Unsupported version {}. Expected {}", header.version, Version
+        ));
+    }
+    if (header.byteOrder != ByteOrderMark) {
+        throw BinaryFormatError("Buffer was written with a different byte order");
+    }
+    if (header.size != buffer.size()) {
+        throw BinaryFormatError(std::format(
+            "Buffer has size {} but expected {}", buffer.size(), header.size
+        ));
+    }
+
+    _keyTable = header.keyTable;
+    _nKeys = header.nKeys;
+    _node = header.root;
+    checkRange(buffer, _keyTable, _nKeys, sizeof(KeyRecord));
+}
+
+BinaryDictionaryView::BinaryDictionaryView(std::span<const std::byte> buffer,
+                                           uint64_t keyTable, uint32_t nKeys,
+                                           uint64_t node)
+    : _buffer(buffer)
+    , _keyTable(keyTable)
+    , _nKeys(nKeys)
+    , _node(node)
+{}
+
+BinaryDictionaryView BinaryDictionaryView::view(std::string_view key) const {
+    const Reader reader = Reader(_buffer, _keyTable, _nKeys);
+    const EntryRecord* entry = reader.find(_node, key);
+    if (!entry || entry->type != static_cast<uint32_t>(Type::Dictionary)) {
+        throw BinaryFormatError(std::format("Key '{}' is not a Dictionary", key));
+    }
+    return BinaryDictionaryView(_buffer, _keyTable, _nKeys, entry->payload);
+}
+
+std::string_view BinaryDictionaryView::stringView(std::string_view key) const {
+    const Reader reader = Reader(_buffer, _keyTable, _nKeys);
+    const EntryRecord* entry = reader.find(_node, key);
+    if (!entry || entry->type != static_cast<uint32_t>(Type::String)) {
+        throw BinaryFormatError(std::format("Key '{}' is not a string", key));
+    }
+    return readString(_buffer, entry->payload);
+}
+
+template <typename T>
+    requires IsAnyOf<T, int, double>
+std::span<const T> BinaryDictionaryView::valueSpan(std::string_view key) const {
+    const Reader reader = Reader(_buffer, _keyTable, _nKeys);
+    const EntryRecord* entry = reader.find(_node, key);
+    if (!entry) {
+        throw BinaryFormatError(std::format("Key '{}' does not exist", key));
+    }
+
+    constexpr Type ListType =
+        std::is_same_v<T, int> ? Type::IntVector : Type::DoubleVector;
+    if (entry->type == static_cast<uint32_t>(ListType)) {
+        return readList<T>(_buffer, entry->payload);
+    }
+
+    std::span<const T> result;
+    const bool isGLM = visitGLMType(
+        entry->type,
+        [&]<typename U>() {
+            if constexpr (std::is_same_v<typename U::value_type, T>) {
+                result = readSpan<T>(_buffer, entry->payload, glm_components<U>::value);
+            }
+            else {
+                throw BinaryFormatError(std::format(
+                    "Key '{}' contains values of a different type", key
+                ));
+            }
+        }
+    );
+    if (!isGLM) {
+        throw BinaryFormatError(std::format("Key '{}' does not contain a list", key));
+    }
+    return result;
+}
+
+template std::span<const int> BinaryDictionaryView::valueSpan(std::string_view) const;
+template std::span<const double> BinaryDictionaryView::valueSpan(std::string_view) const;
+
+bool BinaryDictionaryView::hasKey(std::string_view key) const {
+    const Reader reader = Reader(_buffer, _keyTable, _nKeys);
+    return reader.find(_node, key) != nullptr;
+}
+
+std::vector<std::string_view> BinaryDictionaryView::keys() const {
+    const Reader reader = Reader(_buffer, _keyTable, _nKeys);
+    std::vector<std::string_view> result;
+    for (const EntryRecord& entry : reader.entries(_node)) {
+        result.push_back(reader.key(entry.key));
+    }
+    return result;
+}
+
+size_t BinaryDictionaryView::size() const {
+    return static_cast<size_t>(read<uint64_t>(_buffer, _node));
+}
+
+Dictionary BinaryDictionaryView::dictionary() const {
+    ZoneScoped;
+
+    const Reader reader = Reader(_buffer, _keyTable, _nKeys);
+    return reader.decodeDictionary(_node, 0);
+}
+
+Dictionary BinaryDictionaryView::decode(std::string_view key) const {
+    const Reader reader = Reader(_buffer, _keyTable, _nKeys);
+    Dictionary result;
+    const EntryRecord* entry = reader.find(_node, key);
+    if (entry) {
+        reader.decodeEntry(result, *entry, 0);
+    }
+    return result;
+}
+
+BinaryDictionaryFile::BinaryDictionaryFile(const std::filesystem::path& path) {
+    ZoneScoped;
+
+#ifdef WIN32
+    HANDLE file = CreateFileW(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE) {
+        throw RuntimeError(std::format("Error opening file '{}'", path), "Dictionary");
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        throw RuntimeError(std::format("Error reading file '{}'", path), "Dictionary");
+    }
+    _size = static_cast<size_t>(size.QuadPart);
+    if (_size < sizeof(Header)) {
+        CloseHandle(file);
+        throw BinaryFormatError(std::format("File '{}' is too small", path));
+    }
+
+    // The view keeps the mapping alive, so we don't need to keep the handles around
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) {
+        throw RuntimeError(std::format("Error mapping file '{}'", path), "Dictionary");
+    }
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!data) {
+        throw RuntimeError(std::format("Error mapping file '{}'", path), "Dictionary");
+    }
+#else // ^^^^ WIN32 // !WIN32 vvvv
+    const int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file == -1) {
+        throw RuntimeError(std::format("Error opening file '{}'", path), "Dictionary");
+    }
+    struct stat info;
+    if (fstat(file, &info) != 0) {
+        close(file);
+        throw RuntimeError(std::format("Error reading file '{}'", path), "Dictionary");
+    }
+    _size = static_cast<size_t>(info.st_size);
+    if (_size < sizeof(Header)) {
+        close(file);
+        throw BinaryFormatError(std::format("File '{}' is too small", path));
+    }
+
+    // The mapping stays valid after the file is closed
+    void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (data == MAP_FAILED) {
+        throw RuntimeError(std::format("Error mapping file '{}'", path), "Dictionary");
+    }
+#endif // WIN32
+    _data = static_cast<const std::byte*>(data);
+
+    try {
+        // Validate the header right away so that errors are reported on construction
+        root();
+    }
+    catch (...) {
+#ifdef WIN32
+        UnmapViewOfFile(_data);
+#else // ^^^^ WIN32 // !WIN32 vvvv
+        munmap(const_cast<std::byte*>(_data), _size);
+#endif // WIN32
+        throw;
+    }
+}
+
+BinaryDictionaryFile::~BinaryDictionaryFile() {
+#ifdef WIN32
+    UnmapViewOfFile(_data);
+#else // ^^^^ WIN32 // !WIN32 vvvv
+    munmap(const_cast<std::byte*>(_data), _size);
+#endif // WIN32
+}
+
+BinaryDictionaryView BinaryDictionaryFile::root() const {
+    return BinaryDictionaryView(std::span<const std::byte>(_data, _size));
+}
+
+std::vector<std::byte> formatBinary(const Dictionary& dictionary) {
+    ZoneScoped;
+
+    Writer writer;
+    return writer.write(dictionary);
+}
+
+Dictionary parseBinary(std::span<const std::byte> buffer) {
+    return BinaryDictionaryView(buffer).dictionary();
+}
+
+void saveBinaryFile(const Dictionary& dictionary, const std::filesystem::path& path) {
+    ZoneScoped;
+
+    const std::vector<std::byte> buffer = formatBinary(dictionary);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(
+        reinterpret_cast<const char*>(buffer.data()),
+        static_cast<std::streamsize>(buffer.size())
+    );
+    if (!file.good()) {
+        throw RuntimeError(std::format("Error writing file '{}'", path), "Dictionary");
+    }
+}
+
+Dictionary loadBinaryFile(const std::filesystem::path& path) {
+    const BinaryDictionaryFile file = BinaryDictionaryFile(path);
+    return file.root().dictionary();
+}
+
+} // namespace ghoul
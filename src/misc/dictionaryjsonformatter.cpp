@@ -25,148 +25,223 @@
 
 #include <ghoul/misc/dictionaryjsonformatter.h>
 
+#include <ghoul/format.h>
 #include <ghoul/glm.h>
 #include <ghoul/misc/dictionary.h>
-#include <algorithm>
+#include <array>
 #include <charconv>
 #include <cmath>
-#include <iterator>
-#include <numeric>
+#include <ostream>
+#include <span>
 #include <string>
-#include <sstream>
 #include <string_view>
 #include <system_error>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace {
     using namespace ghoul;
 
-    std::string formatNumber(double d) {
-        // std::format will represent infinite values with 'inf' and NaNs with 'nan'.
-        // These are not valid in JSON, so use 'null' instead
-        if (!std::isfinite(d)) {
-            return "null";
-        }
+    // When writing to a stream, the buffer is flushed whenever it grows beyond this size
+    constexpr size_t StreamChunkSize = 64 * 1024;
 
-        return std::format("{}", d);
+    // Returns whether the keys of the Dictionary are the numbers 1 to n, which is how
+    // arrays are stored when they are created from Lua
+    bool isSequence(const Dictionary& dictionary) {
+        const size_t n = dictionary.size();
+        bool result = true;
+        dictionary.forEach([&result, n](std::string_view key, const auto&) {
+            // The keys are unique, so if none of them has a leading zero and all of them
+            // are in the range [1, n], they have to be a permutation of 1 to n
+            const char* end = key.data() + key.size();
+            size_t value = 0;
+            const auto [p, ec] = std::from_chars(key.data(), end, value);
+            result &= ec == std::errc() && p == end && key[0] != '0' &&
+                      value >= 1 && value <= n;
+        });
+        return result;
     }
 
-    std::string formatString(const std::string& value) {
-        std::string jsonString;
-        for (const char& c : value) {
-            switch (c) {
-            case '"':
-                jsonString += "\\\"";
-                break;
-            case '\\':
-                jsonString += "\\\\";
-                break;
-            case '\b':
-                jsonString += "\\b";
-                break;
-            case '\f':
-                jsonString += "\\f";
-                break;
-            case '\n':
-                jsonString += "\\n";
-                break;
-            case '\r':
-                jsonString += "\\r";
-                break;
-            case '\t':
-                jsonString += "\\t";
-                break;
-            default:
-                jsonString += c;
-            }
-        }
+    class JsonWriter {
+    public:
+        JsonWriter(std::string& buffer, std::ostream* stream);
 
-        return std::format("\"{}\"", jsonString);
-    }
+        void writeDictionary(const Dictionary& dictionary);
+        void flush();
 
-    template <typename T>
-    std::string formatVector(const std::vector<T>& vec) {
-        static_assert(
-            std::is_same_v<T, double> || std::is_same_v<T, int> ||
-            std::is_same_v<T, std::string>,
-            "Only double, ints, or strings are allowed in vectors"
-        );
-        if (vec.empty()) {
-            return "[]";
-        }
+    private:
+        template <typename T>
+        void writeValue(std::string_view key, const T& value);
 
-        std::stringstream values;
-        for (size_t i = 0; i < vec.size() - 1; i++) {
-            if constexpr (std::is_arithmetic_v<T>) {
-                const double v = static_cast<double>(vec[i]);
-                values << formatNumber(v) << ",";
-            }
-            else {
-                values << formatString(vec[i]) << ",";
-            }
-        }
-        values << vec.back();
+        void writeNumber(double value);
+        void writeString(std::string_view value);
 
-        return std::format("[{}]", values.str());
-    }
+        template <typename T>
+        void writeList(std::span<const T> values);
+
+        void flushIfFull();
 
-    /**
-    * Converts a single value \p key out of the \p dictionary by manually iterating all
-    * the types and trying to access them.
-    *
-    * \param dictionary The Dictionary from which the \p key should be extracted and
-    *        converted
-    * \param key The key in the Dictionary that should be converted
-    * \return A JSON representation of the \p key's value
-    *
-    * \throw JsonFormattingError If the \p key points to a type that cannot be converted
-    */
-    std::string formatValue(const Dictionary& dictionary, const std::string& key) {
-        if (dictionary.hasValue<Dictionary>(key)) {
-            const Dictionary subDictionary = dictionary.value<Dictionary>(key);
-            return formatJson(subDictionary);
+        std::string& _buffer;
+        std::ostream* _stream = nullptr;
+    };
+
+    JsonWriter::JsonWriter(std::string& buffer, std::ostream* stream)
+        : _buffer(buffer)
+        , _stream(stream)
+    {}
+
+    void JsonWriter::writeDictionary(const Dictionary& dictionary) {
+        if (dictionary.isEmpty()) {
+            _buffer += "{}";
+            return;
         }
 
-        if (dictionary.hasValue<double>(key)) {
-            const double value = dictionary.value<double>(key);
-            return formatNumber(value);
+        if (!isSequence(dictionary)) {
+            _buffer += '{';
+            bool first = true;
+            dictionary.forEach([this, &first](std::string_view key, const auto& value) {
+                if (!first) {
+                    _buffer += ',';
+                }
+                first = false;
+                writeString(key);
+                _buffer += ':';
+                writeValue(key, value);
+                flushIfFull();
+            });
+            _buffer += '}';
+            return;
         }
 
-        if (dictionary.hasValue<int>(key)) {
-            const int value = dictionary.value<int>(key);
-            return formatNumber(static_cast<double>(value));
+        _buffer += '[';
+        // The keys are sorted as strings ("1", "10", "2", ...), so the values are looked
+        // up in the order of their numbers instead
+        const size_t n = dictionary.size();
+        std::array<char, 24> key;
+        for (size_t i = 1; i <= n; i++) {
+            if (i > 1) {
+                _buffer += ',';
+            }
+            const char* end = std::to_chars(key.data(), key.data() + key.size(), i).ptr;
+            dictionary.visit(
+                std::string_view(key.data(), end),
+                [this](std::string_view k, const auto& value) { writeValue(k, value); }
+            );
+            flushIfFull();
         }
+        _buffer += ']';
+    }
 
-        if (dictionary.hasValue<bool>(key)) {
-            const bool value = dictionary.value<bool>(key);
-            return value ? "true" : "false";
+    void JsonWriter::flush() {
+        if (_stream) {
+            _stream->write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+            _buffer.clear();
         }
+    }
 
-        if (dictionary.hasValue<std::vector<int>>(key)) {
-            const std::vector<int> vec = dictionary.value<std::vector<int>>(key);
-            return formatVector(vec);
+    template <typename T>
+    void JsonWriter::writeValue(std::string_view key, const T& value) {
+        if constexpr (std::is_same_v<T, bool>) {
+            _buffer += value ? "true" : "false";
+        }
+        else if constexpr (std::is_same_v<T, int> || std::is_same_v<T, double>) {
+            writeNumber(static_cast<double>(value));
+        }
+        else if constexpr (std::is_same_v<T, std::string>) {
+            writeString(value);
+        }
+        else if constexpr (std::is_same_v<T, Dictionary>) {
+            writeDictionary(value);
+        }
+        else if constexpr (std::is_same_v<T, void*>) {
+            throw JsonFormattingError(std::format(
+                "Key '{}' has invalid type for formatting dictionary as JSON", key
+            ));
+        }
+        else if constexpr (std::is_same_v<T, std::vector<int>> ||
+                           std::is_same_v<T, std::vector<double>> ||
+                           std::is_same_v<T, std::vector<std::string>>)
+        {
+            writeList(std::span<const typename T::value_type>(value));
+        }
+        else {
+            // Vector and matrix types are written as a list of their values
+            writeList(std::span<const typename T::value_type>(
+                glm::value_ptr(value),
+                glm_components<T>::value
+            ));
         }
+    }
 
-        if (dictionary.hasValue<std::vector<double>>(key)) {
-            const std::vector<double> vec = dictionary.value<std::vector<double>>(key);
-            return formatVector(vec);
+    void JsonWriter::writeNumber(double value) {
+        // Infinite values and NaNs are not valid in JSON, so use 'null' instead
+        if (!std::isfinite(value)) {
+            _buffer += "null";
+            return;
         }
 
-        if (dictionary.hasValue<std::vector<std::string>>(key)) {
-            const std::vector<std::string> vec =
-                dictionary.value<std::vector<std::string>>(key);
-            return formatVector(vec);
+        // std::to_chars produces the shortest representation that round-trips
+        std::array<char, 32> buf;
+        const auto [p, ec] = std::to_chars(buf.data(), buf.data() + buf.size(), value);
+        _buffer.append(buf.data(), p);
+    }
+
+    void JsonWriter::writeString(std::string_view value) {
+        _buffer += '"';
+        // Most strings don't contain any characters that need escaping, so we append
+        // runs of regular characters in one go
+        size_t runBegin = 0;
+        for (size_t i = 0; i < value.size(); i++) {
+            const char c = value[i];
+            if (c != '"' && c != '\\' && static_cast<unsigned char>(c) >= 0x20) {
+                continue;
+            }
+
+            _buffer.append(value.data() + runBegin, i - runBegin);
+            runBegin = i + 1;
+            switch (c) {
+                case '"':  _buffer += "\\\""; break;
+                case '\\': _buffer += "\\\\"; break;
+                case '\b': _buffer += "\\b";  break;
+                case '\f': _buffer += "\\f";  break;
+                case '\n': _buffer += "\\n";  break;
+                case '\r': _buffer += "\\r";  break;
+                case '\t': _buffer += "\\t";  break;
+                default:
+                {
+                    constexpr std::string_view Hex = "0123456789abcdef";
+                    _buffer += "\\u00";
+                    _buffer += Hex[(c >> 4) & 0xF];
+                    _buffer += Hex[c & 0xF];
+                }
+            }
         }
+        _buffer.append(value.data() + runBegin, value.size() - runBegin);
+        _buffer += '"';
+    }
 
-        if (dictionary.hasValue<std::string>(key)) {
-            const std::string value = dictionary.value<std::string>(key);
-            return formatString(value);
+    template <typename T>
+    void JsonWriter::writeList(std::span<const T> values) {
+        _buffer += '[';
+        for (size_t i = 0; i < values.size(); i++) {
+            if (i > 0) {
+                _buffer += ',';
+            }
+            if constexpr (std::is_same_v<T, std::string>) {
+                writeString(values[i]);
+            }
+            else {
+                writeNumber(static_cast<double>(values[i]));
+            }
         }
+        _buffer += ']';
+    }
 
-        throw JsonFormattingError(std::format(
-            "Key '{}' has invalid type for formatting dictionary as JSON", key
-        ));
+    void JsonWriter::flushIfFull() {
+        if (_stream && _buffer.size() >= StreamChunkSize) {
+            flush();
+        }
     }
 } // namespace
 
@@ -177,53 +252,22 @@ JsonFormattingError::JsonFormattingError(std::string msg)
 {}
 
 std::string formatJson(const Dictionary& dictionary) {
-    if (dictionary.isEmpty()) {
-        return "{}";
-    }
+    std::string result;
+    formatJson(dictionary, result);
+    return result;
+}
 
-    std::vector<std::string> keys;
-    std::vector<int> intKeys;
-    for (const std::string_view k : dictionary.keys()) {
-        keys.emplace_back(k);
-        int result;
-        auto [p, ec] = std::from_chars(k.data(), k.data() + k.size(), result);
-        if (ec == std::errc()) {
-            intKeys.emplace_back(result);
-        }
-    }
-    std::sort(intKeys.begin(), intKeys.end());
-
-    // Check whether the dictionary contains only numerical and sequential keys
-    std::vector<int> seqRef = std::vector<int>(keys.size());
-    std::iota(seqRef.begin(), seqRef.end(), 1);
-    if (intKeys == seqRef) {
-        auto convert = [](const std::string& key, const Dictionary& d) {
-            return formatValue(d, key);
-        };
-        const std::string json = std::accumulate(
-            std::next(keys.begin()),
-            keys.end(),
-            convert(*keys.begin(), dictionary),
-            [convert, dictionary](const std::string& a, const std::string& key) {
-                return std::format("{},{}", a, convert(key, dictionary));
-            }
-        );
-        return std::format("[{}]", json);
-    }
-    else {
-        auto convert = [](const std::string& key, const Dictionary& d) {
-            return "\"" + key + "\":" + formatValue(d, key);
-        };
-        const std::string json = std::accumulate(
-            std::next(keys.begin()),
-            keys.end(),
-            convert(*keys.begin(), dictionary),
-            [convert, dictionary](const std::string& a, const std::string& key) {
-                return std::format("{},{}", a, convert(key, dictionary));
-            }
-        );
-        return std::format("{{{}}}", json);
-    }
+void formatJson(const Dictionary& dictionary, std::string& buffer) {
+    JsonWriter writer = JsonWriter(buffer, nullptr);
+    writer.writeDictionary(dictionary);
+}
+
+void formatJson(const Dictionary& dictionary, std::ostream& stream) {
+    std::string buffer;
+    buffer.reserve(StreamChunkSize + StreamChunkSize / 4);
+    JsonWriter writer = JsonWriter(buffer, &stream);
+    writer.writeDictionary(dictionary);
+    writer.flush();
 }
 
 } // namespace ghoul
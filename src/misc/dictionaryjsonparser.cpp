@@ -0,0 +1,517 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2026                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <ghoul/misc/dictionaryjsonparser.h>
+
+#include <ghoul/format.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/dictionary.h>
+#include <ghoul/misc/profiling.h>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace {
+    using namespace ghoul;
+
+    // Protects against stack overflows caused by deeply nested (and malicious) documents
+    constexpr int MaxDepth = 512;
+
+    // The result of parsing a single JSON value. The empty state represents 'null'
+    using Value = std::variant<
+        std::monostate, bool, double, std::string, std::vector<double>,
+        std::vector<std::string>, Dictionary
+    >;
+
+    constexpr uint64_t broadcast(uint8_t byte) {
+        return 0x0101010101010101ull * byte;
+    }
+
+    // Returns a value that is non-zero if any of the bytes in v is smaller than n, which
+    // must be at most 128. Only the lowest flagged byte is guaranteed to be correct
+    constexpr uint64_t hasLess(uint64_t v, uint8_t n) {
+        return (v - broadcast(n)) & ~v & broadcast(0x80);
+    }
+
+    constexpr uint64_t hasByte(uint64_t v, uint8_t byte) {
+        return hasLess(v ^ broadcast(byte), 1);
+    }
+
+    constexpr bool isSpecial(char c) {
+        return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+    }
+
+    constexpr bool isDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    constexpr bool isWhitespace(char c) {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    // Returns the first character in [p, end) that terminates a run of unescaped string
+    // characters, which is a quote, a backslash, or a control character. The characters
+    // are tested eight at a time, which is where most of the time is spent for typical
+    // documents
+    const char* findSpecial(const char* p, const char* end) {
+        while (end - p >= 8) {
+            uint64_t v = 0;
+            std::memcpy(&v, p, sizeof(v));
+            if (hasByte(v, '"') | hasByte(v, '\\') | hasLess(v, 0x20)) {
+                break;
+            }
+            p += 8;
+        }
+        while (p < end && !isSpecial(*p)) {
+            p++;
+        }
+        return p;
+    }
+
+    void appendUtf8(std::string& result, uint32_t codepoint) {
+        if (codepoint < 0x80) {
+            result += static_cast<char>(codepoint);
+        }
+        else if (codepoint < 0x800) {
+            result += static_cast<char>(0xC0 | (codepoint >> 6));
+            result += static_cast<char>(0x80 | (codepoint & 0x3F));
+        }
+        else if (codepoint < 0x10000) {
+            result += static_cast<char>(0xE0 | (codepoint >> 12));
+            result += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+            result += static_cast<char>(0x80 | (codepoint & 0x3F));
+        }
+        else {
+            result += static_cast<char>(0xF0 | (codepoint >> 18));
+            result += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+            result += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+            result += static_cast<char>(0x80 | (codepoint & 0x3F));
+        }
+    }
+
+    void store(Dictionary& dictionary, std::string key, Value value) {
+        std::visit(
+            [&dictionary, &key](auto&& v) {
+                using T = std::decay_t<decltype(v)>;
+                if constexpr (!std::is_same_v<T, std::monostate>) {
+                    dictionary.setValue(std::move(key), std::move(v));
+                }
+            },
+            std::move(value)
+        );
+    }
+
+    class Parser {
+    public:
+        explicit Parser(std::string_view json);
+
+        Dictionary parse();
+
+    private:
+        [[noreturn]] void error(std::string_view message) const;
+
+        char peek() const;
+        bool consume(char c);
+        void expect(char c);
+        void skipWhitespace();
+
+        Value parseValue(int depth);
+        Dictionary parseObject(int depth);
+        Value parseArray(int depth);
+        std::string parseString();
+        void parseEscape(std::string& result);
+        uint32_t parseHex();
+        double parseNumber();
+        void parseLiteral(std::string_view literal);
+
+        template <typename T>
+        bool parseUniformArray(std::vector<T>& values);
+
+        const char* _begin = nullptr;
+        const char* _cur = nullptr;
+        const char* _end = nullptr;
+    };
+
+    Parser::Parser(std::string_view json)
+        : _begin(json.data())
+        , _cur(json.data())
+        , _end(json.data() + json.size())
+    {}
+
+    Dictionary Parser::parse() {
+        // Skip the UTF-8 byte order mark if it exists
+        if (std::string_view(_cur, _end).starts_with("\xEF\xBB\xBF")) {
+            _cur += 3;
+        }
+
+        skipWhitespace();
+        if (!consume('{')) {
+            error("Expected an object as the top-level value");
+        }
+        Dictionary result = parseObject(1);
+        skipWhitespace();
+        if (_cur != _end) {
+            error("Unexpected characters after the top-level object");
+        }
+        return result;
+    }
+
+    void Parser::error(std::string_view message) const {
+        int line = 1;
+        const char* lineBegin = _begin;
+        for (const char* p = _begin; p < _cur; p++) {
+            if (*p == '\n') {
+                line++;
+                lineBegin = p + 1;
+            }
+        }
+        const ptrdiff_t column = _cur - lineBegin + 1;
+        throw JsonParsingError(
+            std::format("{} at line {}, column {}", message, line, column)
+        );
+    }
+
+    char Parser::peek() const {
+        return _cur < _end ? *_cur : '\0';
+    }
+
+    bool Parser::consume(char c) {
+        if (_cur < _end && *_cur == c) {
+            _cur++;
+            return true;
+        }
+        return false;
+    }
+
+    void Parser::expect(char c) {
+        if (!consume(c)) {
+            error(std::format("Expected '{}'", c));
+        }
+    }
+
+    void Parser::skipWhitespace() {
+        while (_cur < _end && isWhitespace(*_cur)) {
+            _cur++;
+        }
+    }
+
+    Value Parser::parseValue(int depth) {
+        if (depth > MaxDepth) {
+            error("Maximum nesting depth exceeded");
+        }
+
+        const char c = peek();
+        switch (c) {
+            case '{':
+                _cur++;
+                return parseObject(depth + 1);
+            case '[':
+                _cur++;
+                return parseArray(depth + 1);
+            case '"':
+                return parseString();
+            case 't':
+                parseLiteral("true");
+                return true;
+            case 'f':
+                parseLiteral("false");
+                return false;
+            case 'n':
+                parseLiteral("null");
+                return std::monostate();
+            default:
+                if (c == '-' || isDigit(c)) {
+                    return parseNumber();
+                }
+                error("Unexpected character");
+        }
+    }
+
+    Dictionary Parser::parseObject(int depth) {
+        Dictionary result;
+        skipWhitespace();
+        if (consume('}')) {
+            return result;
+        }
+
+        while (true) {
+            if (peek() != '"') {
+                error("Expected a string as the key of an object member");
+            }
+            std::string key = parseString();
+            if (key.empty()) {
+                error("Empty keys are not supported");
+            }
+            skipWhitespace();
+            expect(':');
+            skipWhitespace();
+            store(result, std::move(key), parseValue(depth));
+            skipWhitespace();
+            if (consume('}')) {
+                return result;
+            }
+            expect(',');
+            skipWhitespace();
+        }
+    }
+
+    template <typename T>
+    bool Parser::parseUniformArray(std::vector<T>& values) {
+        while (true) {
+            if constexpr (std::is_same_v<T, double>) {
+                if (peek() != '-' && !isDigit(peek())) {
+                    return false;
+                }
+                values.push_back(parseNumber());
+            }
+            else {
+                if (peek() != '"') {
+                    return false;
+                }
+                values.push_back(parseString());
+            }
+
+            skipWhitespace();
+            if (consume(']')) {
+                return true;
+            }
+            expect(',');
+            skipWhitespace();
+        }
+    }
+
+    Value Parser::parseArray(int depth) {
+        skipWhitespace();
+        if (consume(']')) {
+            return Dictionary();
+        }
+
+        // Most arrays only contain numbers or strings, so we optimistically parse them
+        // directly into a vector. If we encounter a different type, the values that have
+        // been read so far are moved into a Dictionary and we continue from there
+        Dictionary result;
+        int index = 1;
+        const char c = peek();
+        if (c == '-' || isDigit(c)) {
+            std::vector<double> values;
+            if (parseUniformArray(values)) {
+                return values;
+            }
+            for (double v : values) {
+                result.setValue(std::to_string(index), v);
+                index++;
+            }
+        }
+        else if (c == '"') {
+            std::vector<std::string> values;
+            if (parseUniformArray(values)) {
+                return values;
+            }
+            for (std::string& v : values) {
+                result.setValue(std::to_string(index), std::move(v));
+                index++;
+            }
+        }
+
+        while (true) {
+            // Lua arrays start at index 1, so we do the same for compatibility
+            store(result, std::to_string(index), parseValue(depth));
+            index++;
+            skipWhitespace();
+            if (consume(']')) {
+                return result;
+            }
+            expect(',');
+            skipWhitespace();
+        }
+    }
+
+    std::string Parser::parseString() {
+        ghoul_assert(peek() == '"', "Must be at the beginning of a string");
+        _cur++;
+
+        std::string result;
+        while (true) {
+            const char* start = _cur;
+            _cur = findSpecial(_cur, _end);
+            result.append(start, _cur);
+
+            if (_cur == _end) {
+                error("Unterminated string");
+            }
+            else if (*_cur == '"') {
+                _cur++;
+                return result;
+            }
+            else if (*_cur == '\\') {
+                _cur++;
+                parseEscape(result);
+            }
+            else {
+                error("Unescaped control character in string");
+            }
+        }
+    }
+
+    void Parser::parseEscape(std::string& result) {
+        const char c = peek();
+        _cur++;
+        switch (c) {
+            case '"':  result += '"';  break;
+            case '\\': result += '\\'; break;
+            case '/':  result += '/';  break;
+            case 'b':  result += '\b'; break;
+            case 'f':  result += '\f'; break;
+            case 'n':  result += '\n'; break;
+            case 'r':  result += '\r'; break;
+            case 't':  result += '\t'; break;
+            case 'u':
+            {
+                uint32_t codepoint = parseHex();
+                if (codepoint >= 0xDC00 && codepoint <= 0xDFFF) {
+                    error("Unpaired low surrogate in string");
+                }
+                if (codepoint >= 0xD800 && codepoint <= 0xDBFF) {
+                    // Characters outside the basic multilingual plane are encoded as a
+                    // surrogate pair
+                    if (!consume('\\') || !consume('u')) {
+                        error("Unpaired high surrogate in string");
+                    }
+                    const uint32_t low = parseHex();
+                    if (low < 0xDC00 || low > 0xDFFF) {
+                        error("Invalid low surrogate in string");
+                    }
+                    codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                }
+                appendUtf8(result, codepoint);
+                break;
+            }
+            default:
+                _cur--;
+                error("Invalid escape sequence in string");
+        }
+    }
+
+    uint32_t Parser::parseHex() {
+        if (_end - _cur < 4) {
+            error("Incomplete unicode escape sequence");
+        }
+        uint32_t value = 0;
+        const auto [ptr, ec] = std::from_chars(_cur, _cur + 4, value, 16);
+        if (ec != std::errc() || ptr != _cur + 4) {
+            error("Invalid unicode escape sequence");
+        }
+        _cur += 4;
+        return value;
+    }
+
+    double Parser::parseNumber() {
+        // std::from_chars is more lenient than the JSON grammar (it accepts 'inf', 'nan',
+        // and leading zeros, for example), so we validate the grammar first
+        const char* start = _cur;
+        consume('-');
+        if (!isDigit(peek())) {
+            error("Invalid number");
+        }
+        if (!consume('0')) {
+            while (isDigit(peek())) {
+                _cur++;
+            }
+        }
+        if (consume('.')) {
+            if (!isDigit(peek())) {
+                error("Invalid number");
+            }
+            while (isDigit(peek())) {
+                _cur++;
+            }
+        }
+        if (consume('e') || consume('E')) {
+            if (!consume('+')) {
+                consume('-');
+            }
+            if (!isDigit(peek())) {
+                error("Invalid number");
+            }
+            while (isDigit(peek())) {
+                _cur++;
+            }
+        }
+
+        double value = 0.0;
+        const auto [ptr, ec] = std::from_chars(start, _cur, value);
+        if (ec != std::errc()) {
+            _cur = start;
+            error("Number out of range");
+        }
+        return value;
+    }
+
+    void Parser::parseLiteral(std::string_view literal) {
+        if (!std::string_view(_cur, _end).starts_with(literal)) {
+            error("Unexpected character");
+        }
+        _cur += literal.size();
+    }
+} // namespace
+
+namespace ghoul {
+
+JsonParsingError::JsonParsingError(std::string msg)
+    : RuntimeError(std::move(msg), "Dictionary")
+{}
+
+Dictionary parseJson(std::string_view json) {
+    ZoneScoped;
+
+    Parser parser(json);
+    return parser.parse();
+}
+
+Dictionary parseJsonFile(const std::filesystem::path& path) {
+    ZoneScoped;
+
+    ghoul_assert(std::filesystem::is_regular_file(path), "File must exist");
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.good()) {
+        throw RuntimeError(std::format("Error opening file '{}'", path), "Dictionary");
+    }
+
+    std::string contents(std::filesystem::file_size(path), '\0');
+    file.read(contents.data(), static_cast<std::streamsize>(contents.size()));
+    if (file.gcount() != static_cast<std::streamsize>(contents.size())) {
+        throw RuntimeError(std::format("Error reading file '{}'", path), "Dictionary");
+    }
+    return parseJson(contents);
+}
+
+} // namespace ghoul
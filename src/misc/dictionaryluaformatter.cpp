@@ -25,169 +25,184 @@
 
 #include <ghoul/misc/dictionaryluaformatter.h>
 
+#include <ghoul/format.h>
 #include <ghoul/glm.h>
 #include <ghoul/misc/dictionary.h>
-#include <iterator>
-#include <numeric>
+#include <array>
+#include <charconv>
+#include <span>
+#include <string_view>
 #include <type_traits>
 #include <vector>
 
 namespace {
     using namespace ghoul;
 
-    std::string formatValue(const Dictionary& dictionary, const std::string& key,
-                            PrettyPrint prettyPrint, const std::string& indentation,
-                            int indentationSteps);
+    class LuaWriter {
+    public:
+        LuaWriter(std::string& buffer, PrettyPrint prettyPrint,
+            std::string_view indentation);
 
-    std::string format(const Dictionary& d, PrettyPrint prettyPrint,
-                       const std::string& indentation, int indentationSteps)
-    {
-        if (d.isEmpty()) {
-            return "{}";
-        }
+        void writeDictionary(const Dictionary& dictionary, int indentationSteps);
 
-        std::string indent;
-        if (prettyPrint) {
-            for (int i = 0; i < indentationSteps; i++) {
-                indent += indentation;
-            }
-        }
+    private:
+        template <typename T>
+        void writeValue(std::string_view key, const T& value, int indentationSteps);
 
-        auto convert = [&](const std::string& key) {
-            if (prettyPrint) {
-                return std::format(
-                    "{}[\"{}\"] = {}",
-                    indentation,
-                    key,
-                    formatValue(d, key, prettyPrint, indentation, indentationSteps + 1)
-                );
-            }
-            else {
-                return std::format(
-                    "[\"{}\"]={}",
-                    key,
-                    formatValue(d, key, prettyPrint, indentation, indentationSteps + 1)
-                );
-            }
-        };
+        template <typename T>
+        void writeNumber(T value);
 
-        std::vector<std::string> keys;
-        keys.reserve(d.keys().size());
-        for (const std::string_view k : d.keys()) {
-            keys.emplace_back(k);
-        }
+        void writeString(std::string_view value);
 
-        const std::string lua = std::accumulate(
-            std::next(keys.begin()),
-            keys.end(),
-            convert(*keys.begin()),
-            [&](const std::string& a, const std::string& key) {
-                return std::format(
-                    "{},{}{}{}", a, prettyPrint ? "\n" : "", indent, convert(key)
-                );
-            }
-        );
+        template <typename T>
+        void writeList(std::span<const T> values);
 
-        return std::format(
-            "{{{0}{1}{2}{0}{1}}}",
-            prettyPrint ? "\n" : "",
-            indent,
-            lua
-        );
-    }
+        void writeIndentation(int indentationSteps);
 
-    template <typename T>
-    std::string formatVector(const std::vector<T>& vec) {
-        static_assert(
-            std::is_same_v<T, double> || std::is_same_v<T, int>,
-            "Only double or ints allowed"
-        );
+        std::string& _buffer;
+        const PrettyPrint _prettyPrint;
+        const std::string_view _indentation;
+    };
 
-        if (vec.empty()) {
-            return "{}";
-        }
+    LuaWriter::LuaWriter(std::string& buffer, PrettyPrint prettyPrint,
+                         std::string_view indentation)
+        : _buffer(buffer)
+        , _prettyPrint(prettyPrint)
+        , _indentation(indentation)
+    {}
 
-        std::string values;
-        for (size_t i = 0; i < vec.size() - 1; i++) {
-            values += std::format("{},", vec[i]);
+    void LuaWriter::writeDictionary(const Dictionary& dictionary, int indentationSteps) {
+        if (dictionary.isEmpty()) {
+            _buffer += "{}";
+            return;
         }
-        values += std::format("{}", vec.back());
 
-        return std::format("{{{}}}", values);
+        _buffer += '{';
+        bool first = true;
+        dictionary.forEach(
+            [this, &first, indentationSteps](std::string_view key, const auto& value) {
+                if (!first) {
+                    _buffer += ',';
+                }
+                first = false;
+
+                if (_prettyPrint) {
+                    _buffer += '\n';
+                    writeIndentation(indentationSteps + 1);
+                }
+                _buffer += '[';
+                writeString(key);
+                _buffer += _prettyPrint ? "] = " : "]=";
+                writeValue(key, value, indentationSteps + 1);
+            }
+        );
+        if (_prettyPrint) {
+            _buffer += '\n';
+            writeIndentation(indentationSteps);
+        }
+        _buffer += '}';
     }
 
-    std::string formatValue(const Dictionary& dictionary, const std::string& key,
-                            PrettyPrint prettyPrint, const std::string& indentation,
-                            int indentationSteps)
+    template <typename T>
+    void LuaWriter::writeValue(std::string_view key, const T& value,
+                               int indentationSteps)
     {
-        if (dictionary.hasValue<Dictionary>(key)) {
-            const Dictionary subDictionary = dictionary.value<Dictionary>(key);
-            return format(subDictionary, prettyPrint, indentation, indentationSteps);
+        if constexpr (std::is_same_v<T, bool>) {
+            _buffer += value ? "true" : "false";
         }
-
-        if (dictionary.hasValue<double>(key)) {
-            const double value = dictionary.value<double>(key);
-            return std::format("{}", value);
+        else if constexpr (std::is_same_v<T, int> || std::is_same_v<T, double>) {
+            writeNumber(value);
         }
-
-        if (dictionary.hasValue<int>(key)) {
-            const int value = dictionary.value<int>(key);
-            return std::to_string(value);
+        else if constexpr (std::is_same_v<T, std::string>) {
+            writeString(value);
         }
-
-        if (dictionary.hasValue<bool>(key)) {
-            const bool value = dictionary.value<bool>(key);
-            return value ? "true" : "false";
+        else if constexpr (std::is_same_v<T, Dictionary>) {
+            writeDictionary(value, indentationSteps);
         }
-
-        if (dictionary.hasValue<std::vector<int>>(key)) {
-            const std::vector<int> vec = dictionary.value<std::vector<int>>(key);
-            return formatVector(vec);
+        else if constexpr (std::is_same_v<T, void*>) {
+            throw LuaFormattingError(std::format(
+                "Key '{}' has invalid type for formatting dictionary as Lua", key
+            ));
         }
-
-        if (dictionary.hasValue<std::vector<double>>(key)) {
-            const std::vector<double> vec = dictionary.value<std::vector<double>>(key);
-            return formatVector(vec);
+        else if constexpr (std::is_same_v<T, std::vector<int>> ||
+                           std::is_same_v<T, std::vector<double>> ||
+                           std::is_same_v<T, std::vector<std::string>>)
+        {
+            writeList(std::span<const typename T::value_type>(value));
+        }
+        else {
+            // Vector and matrix types are written as a list of their values
+            writeList(std::span<const typename T::value_type>(
+                glm::value_ptr(value),
+                glm_components<T>::value
+            ));
         }
+    }
 
-        if (dictionary.hasValue<std::string>(key)) {
-            const std::string value = dictionary.value<std::string>(key);
-
-            std::string luaString;
-            for (const char c : value) {
-                switch (c) {
-                    case '"':
-                        luaString += "\\\"";
-                        break;
-                    case '\\':
-                        luaString += "\\\\";
-                        break;
-                    case '\b':
-                        luaString += "\\b";
-                        break;
-                    case '\f':
-                        luaString += "\\f";
-                        break;
-                    case '\n':
-                        luaString += "\\n";
-                        break;
-                    case '\r':
-                        luaString += "\\r";
-                        break;
-                    case '\t':
-                        luaString += "\\t";
-                        break;
-                    default:
-                        luaString += c;
-                }
+    template <typename T>
+    void LuaWriter::writeNumber(T value) {
+        // std::to_chars produces the shortest representation that round-trips and
+        // writes infinite values and NaNs as 'inf' and 'nan'
+        std::array<char, 32> buf;
+        const auto [p, ec] = std::to_chars(buf.data(), buf.data() + buf.size(), value);
+        _buffer.append(buf.data(), p);
+    }
+
+    void LuaWriter::writeString(std::string_view value) {
+        _buffer += '"';
+        // Most strings don't contain any characters that need escaping, so we append
+        // runs of regular characters in one go
+        size_t runBegin = 0;
+        for (size_t i = 0; i < value.size(); i++) {
+            const char c = value[i];
+            if (c != '"' && c != '\\' && static_cast<unsigned char>(c) >= 0x20) {
+                continue;
             }
 
-            return "\"" + luaString + "\"";
+            _buffer.append(value.data() + runBegin, i - runBegin);
+            runBegin = i + 1;
+            switch (c) {
+                case '"':  _buffer += "\\\""; break;
+                case '\\': _buffer += "\\\\"; break;
+                case '\b': _buffer += "\\b";  break;
+                case '\f': _buffer += "\\f";  break;
+                case '\n': _buffer += "\\n";  break;
+                case '\r': _buffer += "\\r";  break;
+                case '\t': _buffer += "\\t";  break;
+                default:
+                    // Lua's decimal escape sequence with exactly three digits, so that
+                    // it cannot be extended by a following digit
+                    _buffer += '\\';
+                    _buffer += static_cast<char>('0' + c / 100);
+                    _buffer += static_cast<char>('0' + (c / 10) % 10);
+                    _buffer += static_cast<char>('0' + c % 10);
+            }
         }
+        _buffer.append(value.data() + runBegin, value.size() - runBegin);
+        _buffer += '"';
+    }
 
-        throw LuaFormattingError(std::format(
-            "Key '{}' has invalid type for formatting dictionary as Lua", key
-        ));
+    template <typename T>
+    void LuaWriter::writeList(std::span<const T> values) {
+        _buffer += '{';
+        for (size_t i = 0; i < values.size(); i++) {
+            if (i > 0) {
+                _buffer += ',';
+            }
+            if constexpr (std::is_same_v<T, std::string>) {
+                writeString(values[i]);
+            }
+            else {
+                writeNumber(values[i]);
+            }
+        }
+        _buffer += '}';
+    }
+
+    void LuaWriter::writeIndentation(int indentationSteps) {
+        for (int i = 0; i < indentationSteps; i++) {
+            _buffer += _indentation;
+        }
     }
 } // namespace
 
@@ -200,7 +215,10 @@ LuaFormattingError::LuaFormattingError(const std::string& msg)
 std::string formatLua(const Dictionary& dictionary, PrettyPrint prettyPrint,
                       const std::string& indentation)
 {
-    return format(dictionary, prettyPrint, indentation, 0);
+    std::string result;
+    LuaWriter writer = LuaWriter(result, prettyPrint, indentation);
+    writer.writeDictionary(dictionary, 0);
+    return result;
 }
 
 } // namespace ghoul
@@ -0,0 +1,143 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2026                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <ghoul/misc/framearena.h>
+
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
+#include <cstdint>
+
+namespace ghoul {
+
+FrameArena::Scope::Scope(FrameArena& arena)
+    : _arena(arena)
+    , _marker(arena.mark())
+{}
+
+FrameArena::Scope::~Scope() {
+    _arena.rewind(_marker);
+}
+
+FrameArena::FrameArena(size_t chunkSize)
+    : _chunkSize(chunkSize)
+{
+    ghoul_assert(chunkSize > 0, "chunkSize must be positive");
+}
+
+FrameArena::Marker FrameArena::mark() const {
+    return _position;
+}
+
+void FrameArena::rewind(Marker marker) {
+    ghoul_assert(
+        marker.chunk < _position.chunk ||
+        (marker.chunk == _position.chunk && marker.offset <= _position.offset),
+        "Cannot rewind to a position after the current position"
+    );
+    _position = marker;
+}
+
+void FrameArena::reset() {
+    _position = Marker();
+}
+
+size_t FrameArena::usage() const {
+    size_t res = _position.offset;
+    for (size_t i = 0; i < std::min(_position.chunk, _chunks.size()); i++) {
+        res += _chunks[i].size;
+    }
+    return res;
+}
+
+size_t FrameArena::capacity() const {
+    size_t res = 0;
+    for (const Chunk& c : _chunks) {
+        res += c.size;
+    }
+    return res;
+}
+
+FrameArena& FrameArena::threadLocal() {
+    thread_local FrameArena arena;
+    return arena;
+}
+
+void* FrameArena::do_allocate(size_t bytes, size_t alignment) {
+    // Try the current chunk first and then all following chunks that have been kept
+    // from earlier uses
+    while (_position.chunk < _chunks.size()) {
+        const Chunk& chunk = _chunks[_position.chunk];
+        const uintptr_t base = reinterpret_cast<uintptr_t>(chunk.data.get());
+        const uintptr_t begin =
+            (base + _position.offset + alignment - 1) & ~(alignment - 1);
+        if (begin + bytes <= base + chunk.size) {
+            _position.offset = begin + bytes - base;
+            return reinterpret_cast<void*>(begin);
+        }
+
+        if (bytes + alignment > _chunkSize) {
+            // Regular chunks are too small for this allocation, so we look for a big
+            // enough chunk that was kept from an earlier use. The chunks after the
+            // current one are unused, so they can be reordered without invalidating
+            // any markers
+            auto next = _chunks.begin() + _position.chunk + 1;
+            auto it = std::find_if(
+                next,
+                _chunks.end(),
+                [size = bytes + alignment](const Chunk& c) { return c.size >= size; }
+            );
+            if (it == _chunks.end()) {
+                break;
+            }
+            std::rotate(next, it, it + 1);
+        }
+        _position.chunk++;
+        _position.offset = 0;
+    }
+
+    ZoneScoped;
+
+    // None of the chunks have enough space left, so we need a new one. It is placed
+    // after the current chunk so that all existing markers remain valid
+    const size_t size = std::max(_chunkSize, bytes + alignment);
+    const size_t index = std::min(_position.chunk + 1, _chunks.size());
+    _chunks.insert(
+        _chunks.begin() + index,
+        Chunk{ .data = std::make_unique_for_overwrite<std::byte[]>(size), .size = size }
+    );
+    _position = { .chunk = index, .offset = 0 };
+    return do_allocate(bytes, alignment);
+}
+
+void FrameArena::do_deallocate(void*, size_t, size_t) {
+    // Memory is only released by rewinding the FrameArena
+}
+
+bool FrameArena::do_is_equal(const pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+} // namespace ghoul
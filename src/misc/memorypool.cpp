@@ -0,0 +1,170 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2026                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <ghoul/misc/memorypool.h>
+
+#include <ghoul/misc/assert.h>
+#include <new>
+
+#ifdef WIN32
+#include <Windows.h>
+#else // ^^^^ WIN32 // !WIN32 vvvv
+#include <sys/mman.h>
+#include <unistd.h>
+#endif // WIN32
+
+namespace {
+    // The size of a huge page on the platforms we care about. Transparent huge pages are
+    // only used by the kernel for regions that are aligned to this size
+    constexpr size_t HugePageSize = 2 * 1024 * 1024;
+
+    size_t roundUp(size_t value, size_t multiple) {
+        return (value + multiple - 1) / multiple * multiple;
+    }
+
+#ifdef WIN32
+    std::byte* mapPages(size_t size, DWORD flags) {
+        void* ptr = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | flags,
+            PAGE_READWRITE);
+        return static_cast<std::byte*>(ptr);
+    }
+#else // ^^^^ WIN32 // !WIN32 vvvv
+    std::byte* mapPages(size_t size, int flags) {
+        void* ptr = mmap(
+            nullptr,
+            size,
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | flags,
+            -1,
+            0
+        );
+        return ptr != MAP_FAILED ? static_cast<std::byte*>(ptr) : nullptr;
+    }
+
+    // Maps a region of normal pages that is aligned to the huge page size and asks the
+    // kernel to back it with transparent huge pages
+    std::byte* mapTransparentHugePages(size_t size) {
+#ifdef MADV_HUGEPAGE
+        // Over-allocate so that an aligned region can be cut out of the mapping
+        std::byte* ptr = mapPages(size + HugePageSize, 0);
+        if (!ptr) {
+            return nullptr;
+        }
+        const uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+        std::byte* aligned = ptr + (roundUp(address, HugePageSize) - address);
+        if (aligned > ptr) {
+            munmap(ptr, aligned - ptr);
+        }
+        std::byte* end = ptr + size + HugePageSize;
+        if (aligned + size < end) {
+            munmap(aligned + size, end - (aligned + size));
+        }
+
+        if (madvise(aligned, size, MADV_HUGEPAGE) != 0) {
+            munmap(aligned, size);
+            return nullptr;
+        }
+        return aligned;
+#else // ^^^^ MADV_HUGEPAGE // !MADV_HUGEPAGE vvvv
+        (void)size;
+        return nullptr;
+#endif // MADV_HUGEPAGE
+    }
+#endif // WIN32
+} // namespace
+
+namespace ghoul::detail {
+
+BucketMemory::BucketMemory(size_t size_, BucketBacking backing_)
+    : size(size_)
+    , backing(backing_)
+{
+    ghoul_assert(size > 0, "size must be positive");
+
+    if (backing == BucketBacking::HugePages) {
+        const size_t hugeSize = roundUp(size, HugePageSize);
+#ifdef WIN32
+        // Large pages require the SeLockMemoryPrivilege, which most processes don't have
+        const size_t largePage = GetLargePageMinimum();
+        if (largePage > 0) {
+            const size_t s = roundUp(size, largePage);
+            data = mapPages(s, MEM_LARGE_PAGES);
+            if (data) {
+                size = s;
+                return;
+            }
+        }
+#else // ^^^^ WIN32 // !WIN32 vvvv
+#ifdef MAP_HUGETLB
+        // Explicit huge pages are only available if the administrator reserved them
+        data = mapPages(hugeSize, MAP_HUGETLB);
+        if (data) {
+            size = hugeSize;
+            return;
+        }
+#endif // MAP_HUGETLB
+        data = mapTransparentHugePages(hugeSize);
+        if (data) {
+            size = hugeSize;
+            return;
+        }
+#endif // WIN32
+        (void)hugeSize;
+        backing = BucketBacking::Pages;
+    }
+
+    if (backing == BucketBacking::Pages) {
+#ifdef WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        size = roundUp(size, info.dwAllocationGranularity);
+        data = mapPages(size, 0);
+#else // ^^^^ WIN32 // !WIN32 vvvv
+        size = roundUp(size, static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+        data = mapPages(size, 0);
+#endif // WIN32
+        if (!data) {
+            throw std::bad_alloc();
+        }
+        return;
+    }
+
+    data = static_cast<std::byte*>(::operator new(size));
+}
+
+BucketMemory::~BucketMemory() {
+    if (backing == BucketBacking::Heap) {
+        ::operator delete(data);
+        return;
+    }
+
+#ifdef WIN32
+    VirtualFree(data, 0, MEM_RELEASE);
+#else // ^^^^ WIN32 // !WIN32 vvvv
+    munmap(data, size);
+#endif // WIN32
+}
+
+} // namespace ghoul::detail
@@ -26,11 +26,19 @@
 #include <ghoul/misc/thread.h>
 
 #include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <cerrno>
+#include <string>
 
 #ifdef WIN32
 #include <Windows.h>
 #else // ^^^^ WIN32 // !WIN32 vvvv
 #include <pthread.h>
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif // __linux__
 #endif // WIN32
 
 namespace {
@@ -138,4 +146,65 @@ void setThreadBackground(std::thread& t, Background background) {
 void setThreadBackground(std::thread&, Background) {}
 #endif // WIN32
 
+void setAffinity([[maybe_unused]] std::thread& t,
+                 [[maybe_unused]] const std::vector<int>& cpus)
+{
+    ghoul_assert(!cpus.empty(), "cpus must not be empty");
+
+#if defined WIN32
+    DWORD_PTR mask = 0;
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < 64) {
+            mask |= DWORD_PTR(1) << cpu;
+        }
+    }
+    if (mask == 0 || SetThreadAffinityMask(t.native_handle(), mask) == 0) {
+        throw RuntimeError(
+            "Error setting thread affinity with error " + std::to_string(GetLastError()),
+            "Thread"
+        );
+    }
+#elif defined __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    const int res = pthread_setaffinity_np(t.native_handle(), sizeof(set), &set);
+    if (res != 0) {
+        throw RuntimeError(
+            "Error setting thread affinity with error " + std::to_string(res),
+            "Thread"
+        );
+    }
+#endif // WIN32
+}
+
+void setPreferredMemoryNode([[maybe_unused]] int node) {
+    ghoul_assert(node >= 0, "node must not be negative");
+
+#ifdef __linux__
+    // We are calling the system call directly to not add a dependency on libnuma. The
+    // value of MPOL_PREFERRED is part of the kernel's ABI
+    constexpr int MpolPreferred = 1;
+    constexpr int BitsPerWord = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> mask(node / BitsPerWord + 1, 0);
+    mask[node / BitsPerWord] = 1UL << (node % BitsPerWord);
+    const long res = syscall(
+        SYS_set_mempolicy,
+        MpolPreferred,
+        mask.data(),
+        mask.size() * BitsPerWord + 1
+    );
+    if (res != 0) {
+        throw RuntimeError(
+            "Error setting memory policy with error " + std::to_string(errno),
+            "Thread"
+        );
+    }
+#endif // __linux__
+}
+
 } // namespace ghoul::thread
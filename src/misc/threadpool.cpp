@@ -28,23 +28,164 @@
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/assert.h>
 #include <ghoul/misc/defer.h>
-#include <chrono>
+#include <ghoul/misc/exception.h>
+#include <ghoul/misc/memorypool.h>
+#include <ghoul/misc/profiling.h>
+#include <algorithm>
+#include <bit>
+#include <cmath>
 #include <exception>
+#include <functional>
+#include <latch>
+#include <limits>
+#include <random>
 #include <utility>
 
 namespace {
-    // The time-out time for the condition_variable inside the worker threads
-    constexpr std::chrono::seconds WaitTime(1);
+    // The maximum number of tasks a worker moves from the shared queue into its own
+    // queue at once when work stealing is enabled
+    constexpr int MaxBatchSize = 32;
+
+    // The number of Task slots that are moved between the thread-local caches and the
+    // shared pool at once
+    constexpr int TaskCacheBatchSize = 64;
 } // namespace
 
 namespace ghoul {
 
+thread_local ThreadPool::WorkStealingQueue* ThreadPool::_localQueue = nullptr;
+thread_local const ThreadPool::WorkerQueues* ThreadPool::_localQueueOwner = nullptr;
+thread_local ThreadPool::WorkerCounters* ThreadPool::_localCounters = nullptr;
+
+ThreadPool::CancellationToken::CancellationToken()
+    : _isCancelled(std::make_shared<std::atomic_bool>(false))
+{}
+
+void ThreadPool::CancellationToken::cancel() {
+    *_isCancelled = true;
+}
+
+bool ThreadPool::CancellationToken::isCancelled() const {
+    return *_isCancelled;
+}
+
+int ThreadPool::Histogram::bucket(std::chrono::nanoseconds duration) {
+    if (duration.count() <= 0) {
+        return 0;
+    }
+    const int b = std::bit_width(static_cast<uint64_t>(duration.count())) - 1;
+    return std::min(b, NBuckets - 1);
+}
+
+uint64_t ThreadPool::Histogram::count() const {
+    uint64_t res = 0;
+    for (uint64_t b : buckets) {
+        res += b;
+    }
+    return res;
+}
+
+std::chrono::nanoseconds ThreadPool::Histogram::percentile(double p) const {
+    ghoul_assert(p >= 0.0 && p <= 1.0, "p must be in the range [0, 1]");
+
+    const uint64_t total = count();
+    if (total == 0) {
+        return std::chrono::nanoseconds(0);
+    }
+
+    const uint64_t target = std::max(
+        static_cast<uint64_t>(std::ceil(p * static_cast<double>(total))),
+        uint64_t(1)
+    );
+    uint64_t sum = 0;
+    for (int i = 0; i < NBuckets; i++) {
+        sum += buckets[i];
+        if (sum >= target) {
+            return std::chrono::nanoseconds(int64_t(1) << (i + 1));
+        }
+    }
+    return std::chrono::nanoseconds(int64_t(1) << NBuckets);
+}
+
+ThreadPool::WorkerCounters::WorkerCounters(const MetricsRegistry* owner_)
+    : owner(owner_)
+    , startTime(std::chrono::steady_clock::now())
+{}
+
+void ThreadPool::WorkerCounters::record(std::chrono::nanoseconds queueWaitTime,
+                                        std::chrono::nanoseconds executionTime)
+{
+    constexpr std::memory_order Relaxed = std::memory_order_relaxed;
+    const auto qw = static_cast<uint64_t>(std::max<int64_t>(queueWaitTime.count(), 0));
+    const auto ex = static_cast<uint64_t>(std::max<int64_t>(executionTime.count(), 0));
+
+    nTasks.fetch_add(1, Relaxed);
+    queueWait.fetch_add(qw, Relaxed);
+    execution.fetch_add(ex, Relaxed);
+    queueWaitHistogram[Histogram::bucket(queueWaitTime)].fetch_add(1, Relaxed);
+    executionHistogram[Histogram::bucket(executionTime)].fetch_add(1, Relaxed);
+}
+
+void ThreadPool::WorkerCounters::addTo(Metrics& metrics) const {
+    constexpr std::memory_order Relaxed = std::memory_order_relaxed;
+
+    metrics.nTasksExecuted += nTasks.load(Relaxed);
+    metrics.nTasksCancelled += nCancelled.load(Relaxed);
+    metrics.totalQueueWaitTime += std::chrono::nanoseconds(queueWait.load(Relaxed));
+    metrics.totalExecutionTime += std::chrono::nanoseconds(execution.load(Relaxed));
+    for (int i = 0; i < Histogram::NBuckets; i++) {
+        metrics.queueWaitTime.buckets[i] += queueWaitHistogram[i].load(Relaxed);
+        metrics.executionTime.buckets[i] += executionHistogram[i].load(Relaxed);
+    }
+}
+
+ThreadPool::MetricsRegistry::MetricsRegistry()
+    : external(this)
+{}
+
+struct ThreadPool::TaskCache {
+    /// The pool from which all Task slots are taken, shared between all threads
+    struct SharedPool {
+        std::mutex mutex;
+        ReusableTypedMemoryPool<Task, 1024> pool;
+    };
+
+    /// The shared pool is intentionally never destroyed as detached Workers and other
+    /// threads might still return their slots during the static deinitialization
+    static SharedPool& sharedPool() {
+        static SharedPool* pool = new SharedPool;
+        return *pool;
+    }
+
+    /// Returns the cache of the calling thread
+    static TaskCache& local() {
+        thread_local TaskCache cache;
+        return cache;
+    }
+
+    TaskCache() {
+        slots.reserve(2 * TaskCacheBatchSize);
+    }
+
+    ~TaskCache() {
+        SharedPool& shared = sharedPool();
+        const std::lock_guard lock(shared.mutex);
+        shared.pool.free(slots);
+    }
+
+    /// The free slots that are available to the calling thread without locking
+    std::vector<Task*> slots;
+};
+
 ThreadPool::ThreadPool(int nThreads, std::function<void()> workerInit,
                        std::function<void()> workerDeinit,
                        thread::ThreadPriorityClass tpc, thread::ThreadPriorityLevel tpl,
-                       thread::Background bg)
+                       thread::Background bg, WorkStealing workStealing,
+                       thread::Placement placement)
     : _workers(nThreads)
     , _taskQueue(std::make_shared<TaskQueue>())
+    , _workerQueues(workStealing ? std::make_shared<WorkerQueues>() : nullptr)
+    , _metrics(std::make_shared<MetricsRegistry>())
     , _isRunning(std::make_shared<std::atomic_bool>(true))
     , _nWaiting(std::make_shared<std::atomic_int>(0))
     , _mutex(std::make_shared<std::mutex>())
@@ -54,16 +195,31 @@ ThreadPool::ThreadPool(int nThreads, std::function<void()> workerInit,
     , _threadPriorityClass(tpc)
     , _threadPriorityLevel(tpl)
     , _threadBackground(bg)
+    , _placement(std::move(placement))
 {
     ghoul_assert(nThreads > 0, "nThreads must be bigger than 0");
     ghoul_assert(_workerInitialization, "workerInit must not be empty");
     ghoul_assert(_workerDeinitialization, "workerDeinit must not be empty");
 
-    // Activate the workers
-    for (Worker& w : _workers) {
-        activateWorker(w);
+    // Nodes without processors cannot host any workers. If nothing is left, we treat
+    // the system as a single node that contains all processors
+    std::erase_if(
+        _placement.topology,
+        [](const thread::NumaNode& node) { return node.cpus.empty(); }
+    );
+    if (_placement.topology.empty()) {
+        thread::NumaNode node;
+        const unsigned int hc = std::thread::hardware_concurrency();
+        const int nCpus = std::max(static_cast<int>(hc), 1);
+        for (int cpu = 0; cpu < nCpus; cpu++) {
+            node.cpus.push_back(cpu);
+        }
+        _placement.topology.push_back(std::move(node));
     }
 
+    // Activate the workers
+    activateWorkers(0, nThreads);
+
     ghoul_assert(isRunning(), "ThreadPool is not running");
 }
 
@@ -89,9 +245,7 @@ void ThreadPool::start() {
 
     *_isRunning = true;
 
-    for (Worker& w : _workers) {
-        activateWorker(w);
-    }
+    activateWorkers(0, size());
 
     ghoul_assert(isRunning(), "ThreadPool is not running");
 }
@@ -114,8 +268,8 @@ void ThreadPool::stop(RunRemainingTasks runTasks, DetachThreads detachThreads) {
 
     // Wake up all of the threads, all of the threads that cannot find tasks will
     // terminate
+    wakeWorkers(WakeAll::Yes);
     for (Worker& w : _workers) {
-        _cv->notify_all();
         if (detachThreads) {
             // Detaching the thread to let it finish it's work independently
             w.thread->detach();
@@ -129,7 +283,7 @@ void ThreadPool::stop(RunRemainingTasks runTasks, DetachThreads detachThreads) {
     // Delete all the workers. We don't want to actually delete them as we would otherwise
     // lose information about their sizes
     for (Worker& w : _workers) {
-        w = { .thread = nullptr, .shouldTerminate = nullptr };
+        w = { .thread = nullptr, .shouldTerminate = nullptr, .localQueue = nullptr };
     }
 
     ghoul_assert(!isRunning(), "The ThreadPool is still running");
@@ -147,11 +301,9 @@ void ThreadPool::resize(int nThreads) {
         // If the number of threads has increased
         _workers.resize(nThreads);
 
-        // We only want to activate the new workers if we are not currently running
+        // We only want to activate the new workers if we are currently running
         if (*_isRunning) {
-            for (int i = oldNThreads; i < nThreads; i++) {
-                activateWorker(_workers[i]);
-            }
+            activateWorkers(oldNThreads, nThreads);
         }
     }
     else {
@@ -165,7 +317,7 @@ void ThreadPool::resize(int nThreads) {
         }
         // The notification will do nothing for the first 'nThreads' threads, but it will
         // cause the remaining 'nThreads - oldNThreads' to return
-        _cv->notify_all();
+        wakeWorkers(WakeAll::Yes);
 
         // Safe to delete because the threads are detached
         _workers.resize(nThreads);
@@ -182,18 +334,269 @@ int ThreadPool::idleThreads() const {
 }
 
 int ThreadPool::remainingTasks() const {
-    return _taskQueue->size();
+    int res = _taskQueue->size();
+    if (_workerQueues) {
+        const std::lock_guard lock(_workerQueues->mutex);
+        for (const std::shared_ptr<WorkStealingQueue>& q : _workerQueues->queues) {
+            res += q->size();
+        }
+    }
+    return res;
+}
+
+int ThreadPool::remainingTasks(TaskPriority priority) const {
+    int res = _taskQueue->size(priority);
+
+    // Only tasks with a normal priority are ever moved into the queues of the workers
+    if (priority == TaskPriority::Normal && _workerQueues) {
+        const std::lock_guard lock(_workerQueues->mutex);
+        for (const std::shared_ptr<WorkStealingQueue>& q : _workerQueues->queues) {
+            res += q->size();
+        }
+    }
+    return res;
+}
+
+ThreadPool::Metrics ThreadPool::metrics() const {
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    const std::lock_guard lock(_metrics->mutex);
+    Metrics res = _metrics->retired;
+    res.time = now;
+    _metrics->external.addTo(res);
+    res.workers.reserve(_metrics->workers.size());
+    for (const std::shared_ptr<WorkerCounters>& w : _metrics->workers) {
+        w->addTo(res);
+
+        WorkerMetrics m = {
+            .nTasks = w->nTasks.load(std::memory_order_relaxed),
+            .busyTime = std::chrono::nanoseconds(
+                w->execution.load(std::memory_order_relaxed)
+            ),
+            .lifetime = now - w->startTime
+        };
+        if (m.lifetime.count() > 0) {
+            m.utilization = std::min(
+                static_cast<double>(m.busyTime.count()) / m.lifetime.count(),
+                1.0
+            );
+        }
+        res.workers.push_back(m);
+    }
+    return res;
+}
+
+double ThreadPool::throughput(const Metrics& before, const Metrics& after) {
+    const std::chrono::duration<double> dt = after.time - before.time;
+    if (dt.count() <= 0.0) {
+        return 0.0;
+    }
+    return static_cast<double>(after.nTasksExecuted - before.nTasksExecuted) / dt.count();
 }
 
 void ThreadPool::clearRemainingTasks() {
-    while (!_taskQueue->isEmpty()) {
-        _taskQueue->pop();
+    while (Task* t = _taskQueue->pop()) {
+        discardTask(t);
+    }
+
+    if (_workerQueues) {
+        const std::lock_guard lock(_workerQueues->mutex);
+        for (const std::shared_ptr<WorkStealingQueue>& q : _workerQueues->queues) {
+            // A steal only fails if the queue is empty or if a worker took the task at
+            // the same time, in which case that worker is responsible for it
+            while (Task* t = q->steal()) {
+                discardTask(t);
+            }
+        }
     }
 
     ghoul_assert(_taskQueue->isEmpty(), "Task queue is not empty");
 }
 
-void ThreadPool::activateWorker(Worker& worker) {
+void ThreadPool::wait(TaskGroup& group) {
+    int nRemaining = group.nRemaining;
+    while (nRemaining > 0) {
+        // Instead of blocking, we help out with the remaining work, which most likely
+        // contains tasks of our own group. Only once there is nothing left to help with,
+        // we sleep until the last task of the group has finished. If the counter has
+        // changed since we read it, the wait returns immediately
+        if (!runPendingTask()) {
+            group.nRemaining.wait(nRemaining);
+        }
+        nRemaining = group.nRemaining;
+    }
+
+    if (group.hasException) {
+        std::rethrow_exception(group.exception);
+    }
+}
+
+bool ThreadPool::runPendingTask() {
+    Task* task = nullptr;
+
+    // If we are one of our own workers, the most recently spawned tasks are at the
+    // bottom of our own queue
+    if (_localQueue && _localQueueOwner == _workerQueues.get()) {
+        task = _localQueue->pop();
+    }
+
+    if (!task) {
+        // Background tasks are not picked up here as the calling thread would then be
+        // blocked for the whole duration of a task that is not related to what it waits
+        // for
+        task = _taskQueue->pop(TaskPriority::Normal);
+    }
+
+    if (!task && _workerQueues) {
+        const std::lock_guard lock(_workerQueues->mutex);
+        for (const std::shared_ptr<WorkStealingQueue>& q : _workerQueues->queues) {
+            task = q->steal();
+            if (task) {
+                break;
+            }
+        }
+    }
+
+    if (task) {
+        // Our own workers keep their own counters, all other threads share one set
+        const bool isWorker = _localCounters && _localCounters->owner == _metrics.get();
+        runTask(task, isWorker ? *_localCounters : _metrics->external);
+    }
+    return task != nullptr;
+}
+
+void ThreadPool::runTask(Task* task, WorkerCounters& counters) {
+    ZoneScoped;
+    ghoul_assert(task, "No task provided");
+
+    if (task->isCancelled && *task->isCancelled) {
+        counters.nCancelled.fetch_add(1, std::memory_order_relaxed);
+        discardTask(task);
+        return;
+    }
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const std::chrono::nanoseconds queueWait = start - task->queueTime;
+
+    // The function object is destroyed by 'run' even if it throws, but the slot has to
+    // be returned by us
+    defer { freeTask(task); };
+    try {
+        task->run(*task);
+    }
+    catch (const std::exception& e) {
+        LERRORC("ThreadPool", std::format("Uncaught exception in task: {}", e.what()));
+    }
+    catch (...) {
+        LERRORC("ThreadPool", "Uncaught unknown exception in task");
+    }
+
+    counters.record(queueWait, std::chrono::steady_clock::now() - start);
+}
+
+void ThreadPool::discardTask(Task* task) {
+    ghoul_assert(task, "No task provided");
+
+    task->discard(*task);
+    freeTask(task);
+}
+
+ThreadPool::Task* ThreadPool::allocateTask() {
+    TaskCache& cache = TaskCache::local();
+    if (cache.slots.empty()) {
+        TaskCache::SharedPool& shared = TaskCache::sharedPool();
+        cache.slots.resize(TaskCacheBatchSize);
+        const std::lock_guard lock(shared.mutex);
+        shared.pool.allocate(cache.slots);
+    }
+
+    Task* task = cache.slots.back();
+    cache.slots.pop_back();
+    return new (task) Task;
+}
+
+void ThreadPool::freeTask(Task* task) {
+    task->~Task();
+
+    TaskCache& cache = TaskCache::local();
+    cache.slots.push_back(task);
+
+    if (cache.slots.size() >= 2 * TaskCacheBatchSize) {
+        // This thread frees more tasks than it allocates (for example a Worker that
+        // executes tasks queued from a different thread), so we return a batch of slots
+        // to the shared pool where other threads can pick them up
+        TaskCache::SharedPool& shared = TaskCache::sharedPool();
+        const std::lock_guard lock(shared.mutex);
+        shared.pool.free(std::span(cache.slots).last(TaskCacheBatchSize));
+        cache.slots.resize(cache.slots.size() - TaskCacheBatchSize);
+    }
+}
+
+void ThreadPool::enqueue(Task* task, const TaskOptions& options) {
+    task->queueTime = std::chrono::steady_clock::now();
+    if (options.cancellationToken) {
+        task->isCancelled = options.cancellationToken->_isCancelled;
+    }
+
+    if (options.priority == TaskPriority::Normal && _localQueue &&
+        _localQueueOwner == _workerQueues.get())
+    {
+        // We are called from one of our own workers, so we can push the task onto its
+        // own queue without taking any lock. Only if there are idle workers, we have to
+        // wake one of them up so that it can steal the task. Tasks with other priorities
+        // always go through the shared queue so that their priority is respected
+        _localQueue->push(task);
+        wakeWorkers(WakeAll::No);
+        return;
+    }
+
+    {
+        const std::unique_lock lock(_queueMutex);
+        _taskQueue->push(task, options.priority);
+    }
+
+    // Notify a potentially waiting thread that a new task is available
+    wakeWorkers(WakeAll::No);
+}
+
+void ThreadPool::wakeWorkers(WakeAll all) {
+    // A Worker first registers itself in '_nWaiting' and then checks for work while
+    // holding the '_mutex', whereas we first publish the work and then check
+    // '_nWaiting'. With the fences in between, at least one of the two sides is
+    // guaranteed to see the other's change, so either the Worker finds the work or we
+    // find the Worker. As nobody is waiting most of the time when the ThreadPool is
+    // busy, we can skip the notification and the lock in that case
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (*_nWaiting == 0 && !all) {
+        return;
+    }
+
+    // Acquiring the mutex guarantees that the Worker that has just checked for work is
+    // already waiting on the condition variable and cannot miss the notification
+    { const std::lock_guard lock(*_mutex); }
+    if (all) {
+        _cv->notify_all();
+    }
+    else {
+        _cv->notify_one();
+    }
+}
+
+void ThreadPool::activateWorkers(int begin, int end) {
+    ghoul_assert(begin <= end, "begin must not be bigger than end");
+
+    // All workers are started at the same time and we only wait once for all of them to
+    // be initialized instead of waiting for each worker in turn
+    auto initialized = std::make_shared<std::latch>(end - begin);
+    for (int i = begin; i < end; i++) {
+        activateWorker(_workers[i], initialized);
+    }
+    initialized->wait();
+}
+
+void ThreadPool::activateWorker(Worker& worker,
+                                std::shared_ptr<std::latch> initialized)
+{
     // A copy of the shared ptr to the flag
     auto shouldTerminate = std::make_shared<std::atomic_bool>(false);
 
@@ -204,40 +607,205 @@ void ThreadPool::activateWorker(Worker& worker) {
     const std::shared_ptr<std::atomic_bool>& threadPoolIsRunning = _isRunning;
     const std::shared_ptr<std::atomic_int>& nWaiting = _nWaiting;
     const std::shared_ptr<TaskQueue>& taskQueue = _taskQueue;
+    const std::shared_ptr<WorkerQueues>& workerQueues = _workerQueues;
+    const std::shared_ptr<MetricsRegistry>& metrics = _metrics;
     const std::shared_ptr<std::mutex>& mutex = _mutex;
     const std::shared_ptr<std::condition_variable>& cv = _cv;
 
     const std::function<void()>& workerInitialization = _workerInitialization;
     std::function<void()> workerDeinitialization = _workerDeinitialization;
 
+    // Determine the processors this worker is pinned to based on its index. Consecutive
+    // workers are placed on different NUMA nodes so that all nodes are used even if
+    // there are only few workers
+    std::vector<int> cpus;
+    int memoryNode = -1;
+    if (_placement.affinity != thread::Affinity::None) {
+        const std::vector<thread::NumaNode>& topology = _placement.topology;
+        const size_t index = &worker - _workers.data();
+        const thread::NumaNode& node = topology[index % topology.size()];
+        if (_placement.affinity == thread::Affinity::Core) {
+            cpus = { node.cpus[(index / topology.size()) % node.cpus.size()] };
+        }
+        else {
+            cpus = node.cpus;
+        }
 
-    volatile bool finishedInitializing = false;
+        if (_placement.numaLocalMemory) {
+            memoryNode = node.id;
+        }
+    }
+
+    // If work stealing is enabled, each worker gets its own queue that has to be known
+    // to all other workers before the worker starts
+    std::shared_ptr<WorkStealingQueue> localQueue;
+    if (workerQueues) {
+        localQueue = std::make_shared<WorkStealingQueue>();
+        const std::lock_guard lock(workerQueues->mutex);
+        workerQueues->queues.push_back(localQueue);
+        workerQueues->generation++;
+    }
+
+    // Each worker has its own metrics counters that are only combined when they are read
+    auto counters = std::make_shared<WorkerCounters>(metrics.get());
+    {
+        const std::lock_guard lock(metrics->mutex);
+        metrics->workers.push_back(counters);
+    }
 
     // Capturing the shared_ptrs by value to maintain a copy
     auto workerLoop = [
-        shouldTerminate, threadPoolIsRunning, &finishedInitializing, nWaiting, taskQueue,
-        mutex, cv, workerInitialization, workerDeinitialization
+        shouldTerminate, threadPoolIsRunning, initialized = std::move(initialized),
+        nWaiting, taskQueue, workerQueues, localQueue, metrics, counters, mutex, cv,
+        workerInitialization, workerDeinitialization, memoryNode
     ]() {
+        // The memory policy only applies to the calling thread, so it has to be set from
+        // within the worker. It is set first so that all allocations of the worker are
+        // affected by it
+        if (memoryNode >= 0) {
+            try {
+                thread::setPreferredMemoryNode(memoryNode);
+            }
+            catch (const RuntimeError& e) {
+                LWARNINGC("ThreadPool", e.message);
+            }
+        }
+
         // Invoke the user-defined initialization function
         workerInitialization();
         // And invoke the user-defined deinitialization function when the scope is exited
         defer { workerDeinitialization(); };
 
-        std::function<void()> task;
-        bool hasTask = false;
-        std::tie(task, hasTask) = taskQueue->pop();
+        _localCounters = counters.get();
+        defer {
+            // Our counters are kept in the totals of the ThreadPool after we are gone
+            const std::lock_guard lock(metrics->mutex);
+            counters->addTo(metrics->retired);
+            std::erase(metrics->workers, counters);
+            _localCounters = nullptr;
+        };
+
+        if (localQueue) {
+            _localQueue = localQueue.get();
+            _localQueueOwner = workerQueues.get();
+        }
+        defer {
+            if (!localQueue) {
+                return;
+            }
+
+            // Remove our queue from the list of potential victims and hand back all of
+            // the tasks that are still remaining in our queue so that they are picked up
+            // by the other workers
+            {
+                const std::lock_guard lock(workerQueues->mutex);
+                std::erase(workerQueues->queues, localQueue);
+                workerQueues->generation++;
+            }
+            bool hasReturnedTasks = false;
+            while (Task* t = localQueue->pop()) {
+                taskQueue->push(t, TaskPriority::Normal);
+                hasReturnedTasks = true;
+            }
+            if (hasReturnedTasks) {
+                { const std::lock_guard lock(*mutex); }
+                cv->notify_all();
+            }
+            _localQueue = nullptr;
+            _localQueueOwner = nullptr;
+        };
+
+        // We are ready to work, which releases the thread that has started us
+        initialized->count_down();
+
+        // Our cached copy of the list of all worker queues that we can steal from
+        std::vector<std::shared_ptr<WorkStealingQueue>> victims;
+        uint64_t victimsGeneration = std::numeric_limits<uint64_t>::max();
+        std::minstd_rand random(static_cast<std::minstd_rand::result_type>(
+            std::hash<std::thread::id>()(std::this_thread::get_id())
+        ));
+
+        auto updateVictims = [&]() {
+            if (workerQueues->generation != victimsGeneration) {
+                const std::lock_guard lock(workerQueues->mutex);
+                victims = workerQueues->queues;
+                victimsGeneration = workerQueues->generation;
+            }
+        };
+
+        // Returns the next task this worker should work on. Without work stealing, this
+        // is the top of the highest priority lane of the shared queue. With work
+        // stealing, the order is: high priority tasks from the shared queue, our own
+        // queue, a batch of normal priority tasks from the shared queue, stealing from a
+        // random victim, and finally background tasks from the shared queue
+        auto nextTask = [&]() -> Task* {
+            if (!localQueue) {
+                return taskQueue->pop();
+            }
+
+            if (taskQueue->size(TaskPriority::High) > 0) {
+                if (Task* t = taskQueue->pop(TaskPriority::High)) {
+                    return t;
+                }
+            }
+
+            if (Task* t = localQueue->pop()) {
+                return t;
+            }
+
+            updateVictims();
+
+            const int nShares = std::max(static_cast<int>(victims.size()), 1);
+            if (taskQueue->popInto(*localQueue, nShares) > 0) {
+                if (Task* t = localQueue->pop()) {
+                    return t;
+                }
+            }
+
+            if (!victims.empty()) {
+                const size_t start = random() % victims.size();
+                for (size_t i = 0; i < victims.size(); i++) {
+                    WorkStealingQueue* v = victims[(start + i) % victims.size()].get();
+                    if (v == localQueue.get()) {
+                        continue;
+                    }
+                    if (Task* t = v->steal()) {
+                        return t;
+                    }
+                }
+            }
+
+            return taskQueue->pop();
+        };
+
+        // Returns whether there is any task that this worker could work on. This is
+        // checked while holding the mutex before going to sleep
+        auto hasWork = [&]() {
+            if (!taskQueue->isEmpty()) {
+                return true;
+            }
+            if (localQueue) {
+                updateVictims();
+                for (const std::shared_ptr<WorkStealingQueue>& v : victims) {
+                    if (v->size() > 0) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        };
+
+        Task* task = nextTask();
 
         // Infinite look that only gets broken if this thread should terminate or if it
         // gets woken up without there being a task
         while (true) {
             // If there is something in the queue
-            while (hasTask) {
-                finishedInitializing = true;
-
+            while (task) {
                 // Do the task
-                task();
+                runTask(task, *counters);
 
-                // We cannot check for shouldTerminate earlier as if hasTask is true, we
+                // We cannot check for shouldTerminate earlier as if we have a task, we
                 // have already retrieved that value from the stack and if we don't work
                 // on it, it would disappear
                 if (*shouldTerminate) {
@@ -246,46 +814,40 @@ void ThreadPool::activateWorker(Worker& worker) {
 
                 // If we shouldn't terminate, we can check if there is more work if there
                 // is, we stay in this inner loop until there is no more work to be done
-                std::tie(task, hasTask) = taskQueue->pop();
+                task = nextTask();
             }
 
             // If the ThreadPool has stopped running and there are no more tasks, we don't
             // need to sleep first, but can return immediately
             if (!*threadPoolIsRunning) {
-                finishedInitializing = true;
                 return;
             }
 
             // If we get here, there is no more work to be done and the ThreadPool is
-            // still running, so we can sleep until there is more work
-            (*nWaiting)++;
-            while (true) {
-                finishedInitializing = true;
-
-                // We are doing this in an infinite loop, as we want to check regularly if
-                // there is more work. This shouldn't be necessary in normal cases, but is
-                // more of a last resort protection
+            // still running, so we can sleep until there is more work. We register
+            // ourselves as waiting before checking for work one last time; see
+            // ThreadPool::wakeWorkers for the other half of this handshake. There is no
+            // timeout, so an idle worker does not wake up until it is notified
+            {
                 std::unique_lock lock(*mutex);
-                cv->wait_for(lock, WaitTime);
-
-                // We woke up, so either there is work to be done
-                std::tie(task, hasTask) = taskQueue->pop();
-                if (hasTask) {
-                    (*nWaiting)--;
-                    // We have a task now, so if we break we start over with loop #1 and
-                    // do the work as we enter loop #2
-                    break;
-                }
+                (*nWaiting)++;
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                cv->wait(lock, [&]() {
+                    return *shouldTerminate || !*threadPoolIsRunning || hasWork();
+                });
+                (*nWaiting)--;
+            }
 
-                // Or we were asked to terminate or the ThreadPool is finished
-                if (*shouldTerminate || !*threadPoolIsRunning) {
-                    (*nWaiting)--;
-                    return;
-                }
+            // We woke up, so either there is work to be done
+            task = nextTask();
 
-                // If we reach this place, we just woke up spuriously or due to the timer
-                // so we stay in loop #3 and go to sleep again
+            // Or we were asked to terminate or the ThreadPool is finished
+            if (!task && (*shouldTerminate || !*threadPoolIsRunning)) {
+                return;
             }
+
+            // If there is no task, another worker was faster, so we start over and go to
+            // sleep again
         }
     };
 
@@ -301,44 +863,210 @@ void ThreadPool::activateWorker(Worker& worker) {
         thread::setThreadBackground(*thread, thread::Background::Yes);
     }
 
+    // Pin the thread to its processors. Failing to do so is not fatal, for example if
+    // the process is restricted to a subset of the processors of the topology
+    if (!cpus.empty()) {
+        try {
+            thread::setAffinity(*thread, cpus);
+        }
+        catch (const RuntimeError& e) {
+            LWARNINGC("ThreadPool", e.message);
+        }
+    }
+
     // Overwrite the worker and we are done
     worker = {
         .thread = std::move(thread),
-        .shouldTerminate = std::move(shouldTerminate)
+        .shouldTerminate = std::move(shouldTerminate),
+        .localQueue = std::move(localQueue)
     };
+}
 
-    while (!finishedInitializing) {}
+ThreadPool::TaskQueue::~TaskQueue() {
+    for (std::queue<Task*>& queue : _queues) {
+        while (!queue.empty()) {
+            discardTask(queue.front());
+            queue.pop();
+        }
+    }
 }
 
-std::tuple<ThreadPool::Task, bool> ThreadPool::TaskQueue::pop() {
+ThreadPool::Task* ThreadPool::TaskQueue::pop(TaskPriority lowest) {
     const std::unique_lock lock(_queueMutex);
-    if (_queue.empty()) {
-        // No work to be done, the default constructed Task is never read
-        return std::make_tuple(Task(), false);
-    }
-    else {
-        // We have a task, so we move it out of the queue
-        Task t = std::move(_queue.front());
-        // And remove the item
-        _queue.pop();
-        // And return the task together with a positive reply
-        return std::make_tuple(std::move(t), true);
+    for (int i = 0; i <= static_cast<int>(lowest); i++) {
+        if (!_queues[i].empty()) {
+            // We have a task, so we take it out of the queue
+            Task* t = _queues[i].front();
+            // And remove the item
+            _queues[i].pop();
+            _sizes[i]--;
+            return t;
+        }
     }
+
+    // No work to be done
+    return nullptr;
 }
 
-void ThreadPool::TaskQueue::push(const ThreadPool::Task& task) {
+void ThreadPool::TaskQueue::push(ThreadPool::Task* task, TaskPriority priority) {
+    const int i = static_cast<int>(priority);
     const std::unique_lock lock(_queueMutex);
-    _queue.push(task);
+    _queues[i].push(task);
+    _sizes[i]++;
 }
 
-bool ThreadPool::TaskQueue::isEmpty() const {
+int ThreadPool::TaskQueue::popInto(WorkStealingQueue& target, int nShares) {
+    ghoul_assert(nShares > 0, "nShares must be bigger than 0");
+
+    constexpr int Normal = static_cast<int>(TaskPriority::Normal);
     const std::unique_lock lock(_queueMutex);
-    return _queue.empty();
+    std::queue<Task*>& queue = _queues[Normal];
+    const int size = static_cast<int>(queue.size());
+    const int n = std::min(std::max(size / nShares, 1), std::min(size, MaxBatchSize));
+    for (int i = 0; i < n; i++) {
+        target.push(queue.front());
+        queue.pop();
+    }
+    _sizes[Normal] -= n;
+    return n;
+}
+
+bool ThreadPool::TaskQueue::isEmpty() const {
+    for (const std::atomic_int& size : _sizes) {
+        if (size > 0) {
+            return false;
+        }
+    }
+    return true;
 }
 
 int ThreadPool::TaskQueue::size() const {
     const std::unique_lock lock(_queueMutex);
-    return static_cast<int>(_queue.size());
+    int res = 0;
+    for (const std::queue<Task*>& queue : _queues) {
+        res += static_cast<int>(queue.size());
+    }
+    return res;
+}
+
+int ThreadPool::TaskQueue::size(TaskPriority priority) const {
+    return _sizes[static_cast<int>(priority)];
+}
+
+ThreadPool::WorkStealingQueue::Storage::Storage(int64_t cap)
+    : capacity(cap)
+    , data(std::make_unique<std::atomic<Task*>[]>(cap))
+{}
+
+ThreadPool::Task* ThreadPool::WorkStealingQueue::Storage::get(int64_t i) const {
+    return data[i & (capacity - 1)].load(std::memory_order_relaxed);
+}
+
+void ThreadPool::WorkStealingQueue::Storage::put(int64_t i, Task* task) {
+    data[i & (capacity - 1)].store(task, std::memory_order_relaxed);
+}
+
+ThreadPool::WorkStealingQueue::WorkStealingQueue(int64_t capacity) {
+    ghoul_assert(capacity > 0, "capacity must be bigger than 0");
+    ghoul_assert((capacity & (capacity - 1)) == 0, "capacity must be a power of two");
+
+    _storages.push_back(std::make_unique<Storage>(capacity));
+    _storage = _storages.front().get();
+}
+
+ThreadPool::WorkStealingQueue::~WorkStealingQueue() {
+    const Storage* s = _storage.load(std::memory_order_relaxed);
+    const int64_t b = _bottom.load(std::memory_order_relaxed);
+    for (int64_t i = _top.load(std::memory_order_relaxed); i < b; i++) {
+        discardTask(s->get(i));
+    }
+}
+
+void ThreadPool::WorkStealingQueue::push(Task* task) {
+    const int64_t b = _bottom.load(std::memory_order_relaxed);
+    const int64_t t = _top.load(std::memory_order_acquire);
+    Storage* s = _storage.load(std::memory_order_relaxed);
+
+    if (b - t > s->capacity - 1) {
+        // The queue is full, so we have to move everything into a bigger storage. The old
+        // storage has to remain alive as a thief might currently be reading from it
+        auto storage = std::make_unique<Storage>(s->capacity * 2);
+        for (int64_t i = t; i < b; i++) {
+            storage->put(i, s->get(i));
+        }
+        s = storage.get();
+        _storages.insert(_storages.begin(), std::move(storage));
+        _storage.store(s, std::memory_order_seq_cst);
+    }
+
+    // If no thief is active, none of them can hold a pointer to a replaced storage. Any
+    // thief that arrives after this check is guaranteed to see the current storage, as
+    // both the counter and the storage are accessed sequentially consistent
+    if (_storages.size() > 1 && _nThieves.load(std::memory_order_seq_cst) == 0) {
+        _storages.resize(1);
+    }
+
+    s->put(b, task);
+    std::atomic_thread_fence(std::memory_order_release);
+    _bottom.store(b + 1, std::memory_order_relaxed);
+}
+
+ThreadPool::Task* ThreadPool::WorkStealingQueue::pop() {
+    const int64_t b = _bottom.load(std::memory_order_relaxed) - 1;
+    Storage* s = _storage.load(std::memory_order_relaxed);
+    _bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = _top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+        // The queue was already empty
+        _bottom.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Task* task = s->get(b);
+    if (t == b) {
+        // This is the last task in the queue, so we are racing against the thieves
+        if (!_top.compare_exchange_strong(
+                t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed
+            ))
+        {
+            // A thief was faster
+            task = nullptr;
+        }
+        _bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return task;
+}
+
+ThreadPool::Task* ThreadPool::WorkStealingQueue::steal() {
+    _nThieves.fetch_add(1, std::memory_order_seq_cst);
+    defer { _nThieves.fetch_sub(1, std::memory_order_release); };
+
+    int64_t t = _top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t b = _bottom.load(std::memory_order_acquire);
+
+    if (t >= b) {
+        return nullptr;
+    }
+
+    Storage* s = _storage.load(std::memory_order_seq_cst);
+    Task* task = s->get(t);
+    if (!_top.compare_exchange_strong(
+            t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed
+        ))
+    {
+        // Either the owner or a different thief was faster
+        return nullptr;
+    }
+    return task;
+}
+
+int ThreadPool::WorkStealingQueue::size() const {
+    const int64_t b = _bottom.load(std::memory_order_relaxed);
+    const int64_t t = _top.load(std::memory_order_relaxed);
+    return static_cast<int>(std::max<int64_t>(b - t, 0));
 }
 
 } // namespace ghoul
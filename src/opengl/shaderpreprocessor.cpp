@@ -38,7 +38,6 @@
 #include <iterator>
 #include <limits>
 #include <ranges>
-#include <sstream>
 #include <tuple>
 #include <utility>
 
@@ -61,50 +60,23 @@ namespace {
     };
 
     bool hasKeyRecursive(const Dictionary& dictionary, std::string_view key) {
-        const size_t dotPos = key.find('.');
-        if (dotPos == std::string_view::npos) {
-            return dictionary.hasKey(key);
-        }
-
-        const std::string_view before = key.substr(0, dotPos);
-        if (!dictionary.hasKey(before)) {
-            return false;
-        }
-
-
-        const Dictionary d = dictionary.value<Dictionary>(before);
-        const std::string_view after = key.substr(dotPos + 1);
-        return hasKeyRecursive(d, after);
+        const auto [d, k] = dictionary.resolvePath(key);
+        return d && d->hasKey(k);
     }
 
     template <typename T>
     bool hasValueRecursive(const Dictionary& dictionary, std::string_view key) {
-        const size_t dotPos = key.find('.');
-        if (dotPos == std::string_view::npos) {
-            return dictionary.hasValue<T>(key);
-        }
-
-        const std::string_view before = key.substr(0, dotPos);
-        if (!dictionary.hasValue<Dictionary>(before)) {
-            return false;
-        }
-
-        const Dictionary d = dictionary.value<Dictionary>(before);
-        const std::string_view after = key.substr(dotPos + 1);
-        return hasValueRecursive<T>(d, after);
+        const auto [d, k] = dictionary.resolvePath(key);
+        return d && d->hasValue<T>(k);
     }
 
     template <typename T>
     T valueRecursive(const Dictionary& dictionary, std::string_view key) {
-        const size_t dotPos = key.find('.');
-        if (dotPos == std::string_view::npos) {
-            return dictionary.value<T>(key);
+        const auto [d, k] = dictionary.resolvePath(key);
+        if (!d) {
+            throw ShaderPreprocessorError(std::format("Could not resolve '{}'", key));
         }
-
-        const std::string_view before = key.substr(0, dotPos);
-        const std::string_view after = key.substr(dotPos + 1);
-        const Dictionary d = dictionary.value<Dictionary>(before);
-        return valueRecursive<T>(d, after);
+        return d->value<T>(k);
     }
 
     class Env {
@@ -147,7 +119,7 @@ namespace {
         void addLineNumber();
         std::string fileInfo() const;
 
-        std::stringstream _output;
+        std::string _output;
         std::vector<InputFile> _inputFiles;
         std::vector<ForStatement> _forStatements;
 
@@ -234,7 +206,8 @@ namespace {
             isLineProcessed |= parseFor(line);
 
             if (!isLineProcessed) {
-                _output << std::format("{}\n", line);
+                _output += line;
+                _output += '\n';
             }
         }
 
@@ -279,7 +252,7 @@ namespace {
     }
 
     std::string Env::output() {
-        return _output.str();
+        return std::move(_output);
     }
 
     bool Env::parseFor(std::string_view line) {
@@ -329,13 +302,14 @@ namespace {
 
         // Fetch the dictionary to iterate over
         std::string dict = resolveAlias(dictionary);
-        const Dictionary innerDict = _dictionary.value<Dictionary>(dict);
+        const Dictionary& innerDict = _dictionary.ref(dict);
 
         size_t currentIteration = 0;
         std::vector<std::string_view> keys = innerDict.keys();
         if (!keys.empty()) {
             currentIteration = 0;
-            _output << std::format(
+            std::format_to(
+                std::back_inserter(_output),
                 "//# For loop over {0}\n"
                 "//# Key {1} in {0}\n",
                 dict, keys[0]
@@ -343,7 +317,7 @@ namespace {
         }
         else {
             currentIteration = ForStatement::EmptyLoop;
-            _output << "//# Empty for loop\n";
+            _output += "//# Empty for loop\n";
         }
         addLineNumber();
 
@@ -383,13 +357,16 @@ namespace {
         forStmnt.currentIteration++;
 
         // Fetch the dictionary to iterate over
-        const Dictionary innerDict = _dictionary.value<Dictionary>(forStmnt.dictionary);
+        const Dictionary& innerDict = _dictionary.ref(forStmnt.dictionary);
         std::vector<std::string_view> keys = innerDict.keys();
         // This part of the code effectively behaves like the check in a for loop, except
         // that the for loop is extracting all of the lines of the file
         if (forStmnt.currentIteration < keys.size()) {
             std::string_view key = keys[forStmnt.currentIteration];
-            _output << std::format("//# Key {} in {}\n", key, forStmnt.dictionary);
+            std::format_to(
+                std::back_inserter(_output),
+                "//# Key {} in {}\n", key, forStmnt.dictionary
+            );
             addLineNumber();
 
             // Restore input to its state from when #for was found
@@ -399,7 +376,10 @@ namespace {
         }
         else {
             // This was the last iteration or there were zero iterations
-            _output << std::format("//# Terminated loop over {}\n", forStmnt.dictionary);
+            std::format_to(
+                std::back_inserter(_output),
+                "//# Terminated loop over {}\n", forStmnt.dictionary
+            );
             addLineNumber();
             _forStatements.pop_back();
         }
@@ -509,7 +489,10 @@ namespace {
         );
 
         std::string_view t = isCore ? "core" : (isCompatibility ? "compatibility" : "");
-        _output << std::format("#version {}{}0 {}\n", major, minor, t);
+        std::format_to(
+            std::back_inserter(_output),
+            "#version {}{}0 {}\n", major, minor, t
+        );
         return true;
     }
 
@@ -527,7 +510,8 @@ namespace {
 #else  // ^^^^ WIN32 // !WIN32 vvvv
         constexpr std::string_view os = "linux";
 #endif // WIN32
-        _output << std::format(
+        std::format_to(
+            std::back_inserter(_output),
             "#ifndef __OS__\n"
             "#define __OS__ {0}\n"
             "#define {0}\n"
@@ -601,7 +585,7 @@ namespace {
 
         // Resolve only part before dot
         for (const Env::ForStatement& fs : std::ranges::reverse_view(_forStatements)) {
-            const Dictionary innerDict = _dictionary.value<Dictionary>(fs.dictionary);
+            const Dictionary& innerDict = _dictionary.ref(fs.dictionary);
             std::vector<std::string_view> keys = innerDict.keys();
             std::string_view key = keys[fs.currentIteration];
             if (beforeDot == fs.keyName) {
@@ -636,7 +620,8 @@ namespace {
         }
 
         ptrdiff_t number = std::distance(_includedFiles.begin(), it);
-        _output << std::format(
+        std::format_to(
+            std::back_inserter(_output),
             "{}\n#line {} {} // {}\n",
             includeSep, _inputFiles.back().lineNumber, number, filename
         );
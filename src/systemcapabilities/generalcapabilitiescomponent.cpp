@@ -27,9 +27,12 @@
 
 #include <ghoul/format.h>
 #include <ghoul/logging/logmanager.h>
+#include <algorithm>
 #include <array>
 #include <cstring>
 #include <exception>
+#include <filesystem>
+#include <fstream>
 #include <sstream>
 #include <utility>
 
@@ -112,6 +115,7 @@ void GeneralCapabilitiesComponent::detectCapabilities() {
     detectOS();
     detectMemory();
     detectCPU();
+    detectNumaTopology();
 }
 
 void GeneralCapabilitiesComponent::clearCapabilities() {
@@ -125,6 +129,7 @@ void GeneralCapabilitiesComponent::clearCapabilities() {
     _L2Associativity = 0;
     _cacheSize = 0;
     _extensions.clear();
+    _numaNodes.clear();
 }
 
 void GeneralCapabilitiesComponent::detectOS() {
@@ -519,6 +524,85 @@ void GeneralCapabilitiesComponent::detectCPU() {
 #endif // WIN32
 }
 
+void GeneralCapabilitiesComponent::detectNumaTopology() {
+#ifdef WIN32
+    ULONG highestNode = 0;
+    if (GetNumaHighestNodeNumber(&highestNode)) {
+        for (USHORT node = 0; node <= highestNode; node++) {
+            GROUP_AFFINITY affinity;
+            if (!GetNumaNodeProcessorMaskEx(node, &affinity) || affinity.Mask == 0) {
+                continue;
+            }
+
+            thread::NumaNode n = { .id = static_cast<int>(node) };
+            for (int bit = 0; bit < 64; bit++) {
+                if (affinity.Mask & (KAFFINITY(1) << bit)) {
+                    n.cpus.push_back(affinity.Group * 64 + bit);
+                }
+            }
+            _numaNodes.push_back(std::move(n));
+        }
+    }
+#elif defined __linux__
+    // Each NUMA node has a folder 'nodeX' that contains the list of its processors in a
+    // format like '0-7,16-23'
+    std::error_code ec;
+    const std::filesystem::path root = "/sys/devices/system/node";
+    for (const std::filesystem::directory_entry& e :
+         std::filesystem::directory_iterator(root, ec))
+    {
+        const std::string name = e.path().filename().string();
+        if (!name.starts_with("node") || name.size() == 4 ||
+            name.find_first_not_of("0123456789", 4) != std::string::npos)
+        {
+            continue;
+        }
+
+        std::ifstream file(e.path() / "cpulist");
+        std::string list;
+        if (!std::getline(file, list)) {
+            continue;
+        }
+
+        thread::NumaNode n = { .id = std::stoi(name.substr(4)) };
+        std::stringstream ss(list);
+        std::string range;
+        while (std::getline(ss, range, ',')) {
+            if (range.empty()) {
+                continue;
+            }
+            const size_t dash = range.find('-');
+            const int first = std::stoi(range.substr(0, dash));
+            const int last =
+                dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; cpu++) {
+                n.cpus.push_back(cpu);
+            }
+        }
+        if (!n.cpus.empty()) {
+            _numaNodes.push_back(std::move(n));
+        }
+    }
+    std::sort(
+        _numaNodes.begin(),
+        _numaNodes.end(),
+        [](const thread::NumaNode& lhs, const thread::NumaNode& rhs) {
+            return lhs.id < rhs.id;
+        }
+    );
+#endif // WIN32
+
+    if (_numaNodes.empty()) {
+        // Either there is only a single node or we were not able to detect the topology
+        thread::NumaNode n;
+        const int nCores = std::max(static_cast<int>(_cores), 1);
+        for (int cpu = 0; cpu < nCores; cpu++) {
+            n.cpus.push_back(cpu);
+        }
+        _numaNodes.push_back(std::move(n));
+    }
+}
+
 std::vector<SystemCapabilitiesComponent::CapabilityInformation>
 GeneralCapabilitiesComponent::capabilities() const
 {
@@ -530,6 +614,7 @@ GeneralCapabilitiesComponent::capabilities() const
         { "L2 Associativity", std::to_string(_L2Associativity), Verbosity::Full },
         { "Cache size", std::to_string(_cacheSize) + " KB", Verbosity::Full },
         { "Extensions", _extensions,Verbosity::Full },
+        { "NUMA nodes", std::to_string(_numaNodes.size()), Verbosity::Full },
         {
             "Main Memory",
             std::to_string(_installedMainMemory) + " MB",
@@ -572,6 +657,10 @@ unsigned int GeneralCapabilitiesComponent::cacheSize() const {
     return _cacheSize;
 }
 
+const std::vector<thread::NumaNode>& GeneralCapabilitiesComponent::numaNodes() const {
+    return _numaNodes;
+}
+
 const std::string& GeneralCapabilitiesComponent::extensions() const {
     return _extensions;
 }
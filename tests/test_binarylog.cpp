@@ -0,0 +1,213 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2026                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/logging/binarylog.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/logging/logrecord.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace ghoul::logging;
+
+namespace {
+    std::vector<BinaryLogReader::Entry> readAll(const std::filesystem::path& path) {
+        BinaryLogReader reader = BinaryLogReader(path);
+        std::vector<BinaryLogReader::Entry> entries;
+        while (std::optional<BinaryLogReader::Entry> entry = reader.next()) {
+            entries.push_back(std::move(*entry));
+        }
+        return entries;
+    }
+
+    template <typename... Args>
+    std::string encode(const Args&... args) {
+        std::string buffer;
+        (detail::encodeArgument(buffer, args), ...);
+        return buffer;
+    }
+
+    struct Opaque {
+        int value;
+    };
+} // namespace
+
+TEST_CASE("BinaryLog: Argument Encoding", "[binarylog]") {
+    const std::string text = "text";
+    const std::string arguments = encode(
+        true, 'c', -5, 7u, int64_t(-1), uint8_t(200), 1.5f, 2.25, text, "literal"
+    );
+    CHECK(hasPortableArguments(arguments));
+    CHECK(
+        formatArguments("{} {} {} {} {} {} {} {} {} {}", arguments) ==
+        "true c -5 7 -1 200 1.5 2.25 text literal"
+    );
+    CHECK(
+        formatArguments("{:>4}|{:x}|{:.1f}", encode(42, 255, 3.14159)) == "  42|ff|3.1"
+    );
+    CHECK(formatArguments("no arguments", std::string()) == "no arguments");
+
+    const std::string raw = encode(1, Opaque{ 2 });
+    CHECK_FALSE(hasPortableArguments(raw));
+    CHECK_THROWS_AS(formatArguments("{} {}", raw), std::format_error);
+}
+
+TEST_CASE("BinaryLog: Write and Read", "[binarylog]") {
+    const std::filesystem::path path = absPath("${TEMPORARY}/binarylog.glog");
+    {
+        BinaryLog log(path);
+        log.log(LogLevel::Info, "cat1", "first message");
+        log.log(LogLevel::Warning, "cat2", "second\nmessage");
+        log.log(LogLevel::Error, "cat1", "");
+
+        const std::string arguments = encode(42, std::string("abc"));
+        const DeferredMessage deferred = { .format = "{} {}", .arguments = arguments };
+        log.logDeferred(LogLevel::Debug, "cat2", "42 abc", deferred);
+
+        // Arguments that can't be formatted by the reader are stored as text
+        const std::string raw = encode(Opaque{ 1 });
+        const DeferredMessage opaque = { .format = "{}", .arguments = raw };
+        log.logDeferred(LogLevel::Info, "cat3", "opaque", opaque);
+
+        // The file can be read while it is still being written
+        CHECK(readAll(path).size() == 5);
+    }
+
+    const std::vector<BinaryLogReader::Entry> entries = readAll(path);
+    REQUIRE(entries.size() == 5);
+    CHECK(entries[0].level == LogLevel::Info);
+    CHECK(entries[0].category == "cat1");
+    CHECK(entries[0].message == "first message");
+    CHECK(entries[1].level == LogLevel::Warning);
+    CHECK(entries[1].category == "cat2");
+    CHECK(entries[1].message == "second\nmessage");
+    CHECK(entries[2].category == "cat1");
+    CHECK(entries[2].message.empty());
+    CHECK(entries[3].level == LogLevel::Debug);
+    CHECK(entries[3].message == "42 abc");
+    CHECK(entries[4].category == "cat3");
+    CHECK(entries[4].message == "opaque");
+
+    const auto now = std::chrono::system_clock::now();
+    for (size_t i = 0; i < entries.size(); i++) {
+        CHECK(entries[i].time <= now);
+        CHECK(now - entries[i].time < std::chrono::minutes(1));
+        if (i > 0) {
+            CHECK(entries[i].time >= entries[i - 1].time);
+        }
+    }
+}
+
+TEST_CASE("BinaryLog: Message Time", "[binarylog]") {
+    const std::filesystem::path path = absPath("${TEMPORARY}/binarylogtime.glog");
+
+    // Messages that are written by the sink thread of the LogManager keep the time at
+    // which they were logged, which can be before previous messages or the file itself
+    const std::chrono::system_clock::time_point time =
+        std::chrono::floor<std::chrono::microseconds>(
+            std::chrono::system_clock::now() - std::chrono::hours(1)
+        );
+    {
+        BinaryLog log(path);
+        log.log(LogLevel::Info, "cat", "now");
+        log.logAt(time, LogLevel::Info, "cat", "earlier");
+    }
+
+    const std::vector<BinaryLogReader::Entry> entries = readAll(path);
+    REQUIRE(entries.size() == 2);
+    CHECK(entries[0].time > time);
+    CHECK(entries[1].message == "earlier");
+    CHECK(entries[1].time == time);
+}
+
+TEST_CASE("BinaryLog: Rotation", "[binarylog]") {
+    const std::filesystem::path path = absPath("${TEMPORARY}/binarylogrotation.glog");
+    const std::filesystem::path path1 = absPath("${TEMPORARY}/binarylogrotation-1.glog");
+    const std::filesystem::path path2 = absPath("${TEMPORARY}/binarylogrotation-2.glog");
+    std::filesystem::remove(path1);
+    std::filesystem::remove(path2);
+
+    const std::string message(100, 'x');
+    {
+        BinaryLog log(path, 4096, std::chrono::seconds(0), 2);
+        for (int i = 0; i < 100; i++) {
+            log.log(LogLevel::Info, "cat", std::to_string(i) + message);
+        }
+
+        // A message that is bigger than the maximum size gets a file of its own
+        log.log(LogLevel::Info, "cat", std::string(10000, 'y'));
+    }
+
+    CHECK(std::filesystem::file_size(path1) <= 4096);
+    CHECK(std::filesystem::file_size(path2) <= 4096);
+    const std::vector<BinaryLogReader::Entry> last = readAll(path);
+    REQUIRE(last.size() == 1);
+    CHECK(last[0].message == std::string(10000, 'y'));
+
+    // The previous file contains the last messages and each file defines its categories
+    const std::vector<BinaryLogReader::Entry> previous = readAll(path1);
+    REQUIRE_FALSE(previous.empty());
+    CHECK(previous.back().category == "cat");
+    CHECK(previous.back().message == "99" + message);
+    const std::vector<BinaryLogReader::Entry> older = readAll(path2);
+    REQUIRE_FALSE(older.empty());
+    CHECK(
+        std::stoi(older.back().message) + 1 == std::stoi(previous.front().message)
+    );
+}
+
+TEST_CASE("BinaryLog: Invalid File", "[binarylog]") {
+    const std::filesystem::path path = absPath("${TEMPORARY}/binarylog-invalid.glog");
+    {
+        std::ofstream file(path);
+        file << "This is not a binary log file, but it is long enough for a header";
+    }
+    CHECK_THROWS_AS(BinaryLogReader(path), BinaryLogError);
+}
+
+TEST_CASE("BinaryLog: LogManager", "[binarylog]") {
+    const std::filesystem::path path = absPath("${TEMPORARY}/binarylogmanager.glog");
+    {
+        LogManager manager(LogLevel::Info);
+        manager.addLog(std::make_unique<BinaryLog>(path));
+        manager.logFormatted(LogLevel::Info, "cat", "{} + {} = {}", 1, 2, 3);
+        manager.startAsync();
+        manager.logFormatted(LogLevel::Warning, "cat", "{:.2f}", 0.5);
+        manager.logMessage(LogLevel::Error, "cat", "text");
+    }
+
+    const std::vector<BinaryLogReader::Entry> entries = readAll(path);
+    REQUIRE(entries.size() == 3);
+    CHECK(entries[0].message == "1 + 2 = 3");
+    CHECK(entries[1].message == "0.50");
+    CHECK(entries[2].message == "text");
+}
@@ -0,0 +1,226 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2026                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <ghoul/logging/bufferlog.h>
+#include <ghoul/misc/sharedmemory.h>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ghoul::logging;
+
+TEST_CASE("BufferLog: Write and Read", "[bufferlog]") {
+    std::vector<std::byte> buffer(4096);
+    BufferLog log(buffer.data(), buffer.size(), 64);
+    CHECK(log.nRecords() > 2);
+    CHECK(log.usedSize() < log.totalSize());
+
+    BufferLogReader reader(buffer.data(), buffer.size());
+    CHECK_FALSE(reader.next().has_value());
+
+    CHECK(log.log(10, "first") == 0);
+    CHECK(log.log(20, "second") == 1);
+    const std::string longMessage(100, 'x');
+    CHECK(log.log(30, longMessage) == 2);
+    CHECK(log.nextSequence() == 3);
+
+    std::optional<BufferLogReader::Record> record = reader.next();
+    REQUIRE(record.has_value());
+    CHECK(record->sequence == 0);
+    CHECK(record->timestamp == 10);
+    CHECK(record->message == "first");
+    CHECK(reader.isValid(*record));
+
+    std::vector<BufferLogReader::Record> records;
+    std::vector<std::string> messages;
+    const size_t nRead = reader.drain([&](const BufferLogReader::Record& r) {
+        records.push_back(r);
+        messages.emplace_back(r.message);
+    });
+    REQUIRE(nRead == 2);
+    CHECK(records[0].sequence == 1);
+    CHECK(records[0].timestamp == 20);
+    CHECK(messages[0] == "second");
+    // Messages that don't fit into a record are truncated
+    CHECK(records[1].sequence == 2);
+    CHECK(messages[1] == std::string(64 - 25, 'x'));
+    CHECK_FALSE(reader.next().has_value());
+    CHECK(reader.lostRecords() == 0);
+}
+
+TEST_CASE("BufferLog: Overwrite Oldest", "[bufferlog]") {
+    std::vector<std::byte> buffer(4096);
+    BufferLog log(buffer.data(), buffer.size(), 64);
+    const size_t nRecords = log.nRecords();
+
+    BufferLogReader earlyReader(buffer.data(), buffer.size());
+    for (size_t i = 0; i < 3 * nRecords; i++) {
+        log.log(i, std::to_string(i));
+    }
+    CHECK(log.usedSize() <= log.totalSize());
+
+    // A reader that started before the buffer wrapped around has lost the old records
+    std::optional<BufferLogReader::Record> record = earlyReader.next();
+    REQUIRE(record.has_value());
+    CHECK(record->sequence == 2 * nRecords);
+    CHECK(record->message == std::to_string(2 * nRecords));
+    CHECK(earlyReader.lostRecords() == 2 * nRecords);
+
+    // A new reader starts at the oldest record that is still available
+    BufferLogReader lateReader(buffer.data(), buffer.size());
+    uint64_t expected = 2 * nRecords;
+    lateReader.drain([&expected](const BufferLogReader::Record& r) {
+        CHECK(r.sequence == expected);
+        CHECK(r.timestamp == expected);
+        CHECK(r.message == std::to_string(expected));
+        expected++;
+    });
+    CHECK(expected == 3 * nRecords);
+    CHECK(lateReader.lostRecords() == 0);
+
+    // Records returned without a copy can be detected as overwritten
+    BufferLogReader reader(buffer.data(), buffer.size());
+    record = reader.next();
+    REQUIRE(record.has_value());
+    for (size_t i = 0; i < nRecords; i++) {
+        log.log(0, "overwrite");
+    }
+    CHECK_FALSE(reader.isValid(*record));
+}
+
+TEST_CASE("BufferLog: Concurrent Producers", "[bufferlog]") {
+    constexpr int NThreads = 4;
+    constexpr int NMessages = 20000;
+
+    std::vector<std::byte> buffer(64 * 1024);
+    BufferLog log(buffer.data(), buffer.size());
+    BufferLogReader reader(buffer.data(), buffer.size());
+
+    // The records are only collected by the consumer thread and verified after it has
+    // finished, as the assertions must not be used from multiple threads
+    struct Observation {
+        uint64_t sequence;
+        unsigned long long timestamp;
+        std::string message;
+    };
+    std::vector<Observation> records;
+    auto consume = [&records](const BufferLogReader::Record& r) {
+        records.emplace_back(r.sequence, r.timestamp, std::string(r.message));
+    };
+
+    std::atomic_bool isDone = false;
+    std::thread consumer([&]() {
+        while (!isDone) {
+            reader.drain(consume);
+        }
+    });
+
+    std::vector<std::thread> producers;
+    for (int i = 0; i < NThreads; i++) {
+        producers.emplace_back([&log, i]() {
+            for (int j = 0; j < NMessages; j++) {
+                log.log(j, std::to_string(i) + ":" + std::to_string(j));
+            }
+        });
+    }
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+    isDone = true;
+    consumer.join();
+    reader.drain(consume);
+
+    std::map<int, int> lastMessage;
+    for (size_t i = 0; i < records.size(); i++) {
+        const Observation& r = records[i];
+        if (i > 0) {
+            CHECK(r.sequence > records[i - 1].sequence);
+        }
+
+        // Messages of each producer have to arrive in the order they were logged
+        const size_t separator = r.message.find(':');
+        REQUIRE(separator != std::string::npos);
+        const int thread = std::stoi(r.message.substr(0, separator));
+        const int message = std::stoi(r.message.substr(separator + 1));
+        CHECK(r.timestamp == static_cast<unsigned long long>(message));
+        auto it = lastMessage.find(thread);
+        if (it != lastMessage.end()) {
+            CHECK(message > it->second);
+        }
+        lastMessage[thread] = message;
+    }
+
+    const size_t nRead = records.size();
+    CHECK(log.nextSequence() == NThreads * NMessages);
+    CHECK(nRead + reader.lostRecords() == NThreads * NMessages);
+    CHECK(nRead >= log.nRecords());
+}
+
+TEST_CASE("BufferLog: SharedMemory", "[bufferlog]") {
+    const std::string name = "ghoul_test_bufferlog";
+    if (ghoul::SharedMemory::exists(name)) {
+        ghoul::SharedMemory::remove(name);
+    }
+    ghoul::SharedMemory::create(name, 8192);
+
+    {
+        ghoul::SharedMemory writerMemory(name);
+        BufferLog log(writerMemory);
+        log.log(1, "shared");
+
+        // A separate attachment simulates an external process that tails the log
+        ghoul::SharedMemory readerMemory(name);
+        BufferLogReader reader(readerMemory);
+        std::optional<BufferLogReader::Record> record = reader.next();
+        REQUIRE(record.has_value());
+        CHECK(record->timestamp == 1);
+        CHECK(record->message == "shared");
+        CHECK(reader.isValid(*record));
+
+        log.log(2, "tail");
+        record = reader.next();
+        REQUIRE(record.has_value());
+        CHECK(record->message == "tail");
+    }
+
+    ghoul::SharedMemory::remove(name);
+}
+
+TEST_CASE("BufferLog: Invalid Buffer", "[bufferlog]") {
+    std::vector<std::byte> buffer(4096);
+    CHECK_THROWS_AS(BufferLogReader(buffer.data(), buffer.size()), BufferLogError);
+
+    // The records of a valid BufferLog have to fit into the buffer given to the reader
+    BufferLog log(buffer.data(), buffer.size());
+    CHECK_NOTHROW(BufferLogReader(buffer.data(), buffer.size()));
+    CHECK_THROWS_AS(BufferLogReader(buffer.data(), buffer.size() / 2), BufferLogError);
+    CHECK_THROWS_AS(BufferLogReader(buffer.data(), 16), BufferLogError);
+}
@@ -24,9 +24,15 @@
  ****************************************************************************************/
 
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 
 #include <ghoul/misc/dictionary.h>
+#include <ghoul/format.h>
 #include <ghoul/glm.h>
+#include <map>
+#include <span>
+#include <string>
+#include <vector>
 
 TEST_CASE("Dictionary: bool", "[dictionary]") {
     ghoul::Dictionary d;
@@ -699,3 +705,264 @@ TEST_CASE("Dictionary: glm::dmat4x4", "[dictionary]") {
         )
     );
 }
+
+TEST_CASE("Dictionary: Unordered Insertion", "[dictionary]") {
+    ghoul::Dictionary d;
+    d.setValue("d", 4);
+    d.setValue("b", 2);
+    d.setValue("e", 5);
+    d.setValue("a", 1);
+    d.setValue("c", 3);
+    d.setValue("b", std::string("two"));
+
+    CHECK(d.size() == 5);
+    CHECK(d.keys() == std::vector<std::string_view>{ "a", "b", "c", "d", "e" });
+    CHECK(d.value<int>("a") == 1);
+    CHECK(d.value<std::string>("b") == "two");
+    CHECK(d.value<int>("e") == 5);
+
+    d.removeValue("c");
+    d.removeValue("f");
+    CHECK(d.size() == 4);
+    CHECK_FALSE(d.hasKey("c"));
+    CHECK(d.keys() == std::vector<std::string_view>{ "a", "b", "d", "e" });
+
+    ghoul::Dictionary e;
+    e.setValue("e", 5);
+    e.setValue("a", 1);
+    CHECK(d.isSubset(e));
+    e.setValue("c", 3);
+    CHECK_FALSE(d.isSubset(e));
+}
+
+TEST_CASE("Dictionary: Benchmark Storage", "[.][dictionary][benchmark]") {
+    // Many small dictionaries with a handful of typical keys, as they are created when
+    // loading scene descriptions
+    constexpr int NDictionaries = 100000;
+    const std::vector<std::string> keys = {
+        "Identifier", "Parent", "Renderable", "Type", "Enabled", "Opacity", "Color",
+        "Position", "Tag", "Gui", "Name", "Path"
+    };
+
+    BENCHMARK("Build Dictionary") {
+        std::vector<ghoul::Dictionary> dicts(NDictionaries);
+        for (ghoul::Dictionary& d : dicts) {
+            for (size_t i = 0; i < keys.size(); i++) {
+                d.setValue(keys[i], static_cast<int>(i));
+            }
+        }
+        return dicts;
+    };
+
+    BENCHMARK("Build std::map") {
+        using Map = std::map<std::string, ghoul::Dictionary::Types, std::less<>>;
+        std::vector<Map> maps(NDictionaries);
+        for (Map& m : maps) {
+            for (size_t i = 0; i < keys.size(); i++) {
+                m.insert_or_assign(keys[i], static_cast<int>(i));
+            }
+        }
+        return maps;
+    };
+
+    std::vector<ghoul::Dictionary> dicts(NDictionaries);
+    using Map = std::map<std::string, ghoul::Dictionary::Types, std::less<>>;
+    std::vector<Map> maps(NDictionaries);
+    for (int i = 0; i < NDictionaries; i++) {
+        for (size_t j = 0; j < keys.size(); j++) {
+            dicts[i].setValue(keys[j], static_cast<int>(j));
+            maps[i].insert_or_assign(keys[j], static_cast<int>(j));
+        }
+    }
+
+    BENCHMARK("Lookup Dictionary") {
+        int sum = 0;
+        for (const ghoul::Dictionary& d : dicts) {
+            for (const std::string& key : keys) {
+                sum += d.value<int>(key);
+            }
+        }
+        return sum;
+    };
+
+    BENCHMARK("Lookup std::map") {
+        int sum = 0;
+        for (const Map& m : maps) {
+            for (const std::string& key : keys) {
+                sum += std::get<int>(m.find(key)->second);
+            }
+        }
+        return sum;
+    };
+}
+
+TEST_CASE("Dictionary: glm Interoperability", "[dictionary]") {
+    ghoul::Dictionary d;
+    d.setValue("a", glm::dvec3(1.0, 2.0, 3.0));
+    d.setValue("b", std::vector<double>{ 4.0, 5.0, 6.0, 7.0 });
+    d.setValue("c", glm::ivec2(8, 9));
+
+    // The values of vector types can be accessed as a std::vector
+    REQUIRE(d.hasValue<std::vector<double>>("a"));
+    CHECK(d.value<std::vector<double>>("a") == std::vector<double>{ 1.0, 2.0, 3.0 });
+    CHECK_FALSE(d.hasValue<std::vector<int>>("a"));
+    REQUIRE(d.hasValue<std::vector<int>>("c"));
+    CHECK(d.value<std::vector<int>>("c") == std::vector<int>{ 8, 9 });
+
+    // std::vectors and other glm types with the same number of values are converted
+    REQUIRE(d.hasValue<glm::dvec4>("b"));
+    CHECK(d.value<glm::dvec4>("b") == glm::dvec4(4.0, 5.0, 6.0, 7.0));
+    REQUIRE(d.hasValue<glm::dmat2x2>("b"));
+    CHECK(d.value<glm::dmat2x2>("b") == glm::dmat2x2(4.0, 5.0, 6.0, 7.0));
+    CHECK_FALSE(d.hasValue<glm::dvec2>("a"));
+    CHECK_THROWS(d.value<glm::dvec2>("a"));
+    CHECK_FALSE(d.hasValue<glm::dvec3>("c"));
+
+    d.setValue("d", glm::dmat2x2(1.0, 2.0, 3.0, 4.0));
+    REQUIRE(d.hasValue<glm::dvec4>("d"));
+    CHECK(d.value<glm::dvec4>("d") == glm::dvec4(1.0, 2.0, 3.0, 4.0));
+}
+
+TEST_CASE("Dictionary: glm Equality", "[dictionary]") {
+    ghoul::Dictionary glmValues;
+    glmValues.setValue("a", glm::dvec3(1.0, 2.0, 3.0));
+    glmValues.setValue("b", glm::ivec2(4, 5));
+
+    ghoul::Dictionary vectorValues;
+    vectorValues.setValue("a", std::vector<double>{ 1.0, 2.0, 3.0 });
+    vectorValues.setValue("b", std::vector<int>{ 4, 5 });
+
+    // Vector types are equal to std::vectors with the same values
+    CHECK(glmValues == vectorValues);
+    CHECK(vectorValues == glmValues);
+    CHECK(glmValues.isSubset(vectorValues));
+    CHECK(vectorValues.isSubset(glmValues));
+
+    ghoul::Dictionary outer;
+    outer.setValue("inner", glmValues);
+    ghoul::Dictionary outerVector;
+    outerVector.setValue("inner", vectorValues);
+    CHECK(outer == outerVector);
+
+    ghoul::Dictionary other;
+    other.setValue("a", std::vector<double>{ 1.0, 2.0, 4.0 });
+    other.setValue("b", std::vector<int>{ 4, 5 });
+    CHECK(glmValues != other);
+    CHECK_FALSE(glmValues.isSubset(other));
+
+    // The value types have to match
+    ghoul::Dictionary mixed;
+    mixed.setValue("a", std::vector<int>{ 1, 2, 3 });
+    mixed.setValue("b", std::vector<double>{ 4.0, 5.0 });
+    CHECK(glmValues != mixed);
+}
+
+TEST_CASE("Dictionary: References", "[dictionary]") {
+    ghoul::Dictionary inner;
+    inner.setValue("s", std::string("abc"));
+    inner.setValue("v", std::vector<int>{ 1, 2, 3 });
+    inner.setValue("m", glm::dvec2(4.0, 5.0));
+    ghoul::Dictionary middle;
+    middle.setValue("inner", inner);
+    ghoul::Dictionary d;
+    d.setValue("middle", middle);
+    d.setValue("i", 1);
+
+    const ghoul::Dictionary& m = d.ref("middle");
+    CHECK(&m.ref("inner") == &d.ref("middle").ref("inner"));
+    CHECK(m.ref("inner") == inner);
+    CHECK_THROWS(d.ref("i"));
+    CHECK_THROWS(d.ref("x"));
+
+    const ghoul::Dictionary& i = m.ref("inner");
+    CHECK(i.stringView("s") == "abc");
+    CHECK_THROWS(i.stringView("v"));
+    std::span<const int> v = i.valueSpan<int>("v");
+    CHECK(std::vector<int>(v.begin(), v.end()) == std::vector<int>{ 1, 2, 3 });
+    std::span<const double> mv = i.valueSpan<double>("m");
+    CHECK(std::vector<double>(mv.begin(), mv.end()) == std::vector<double>{ 4.0, 5.0 });
+    CHECK_THROWS(i.valueSpan<double>("v"));
+
+    auto [parent, key] = d.resolvePath("middle.inner.s");
+    CHECK(parent == &i);
+    CHECK(key == "s");
+    CHECK(parent->value<std::string>(key) == "abc");
+
+    auto [self, selfKey] = d.resolvePath("i");
+    CHECK(self == &d);
+    CHECK(selfKey == "i");
+
+    CHECK(d.resolvePath("middle.missing.s").first == nullptr);
+    CHECK(d.resolvePath("i.s").first == nullptr);
+}
+
+TEST_CASE("Dictionary: Copy on Write", "[dictionary]") {
+    ghoul::Dictionary inner;
+    inner.setValue("a", 1);
+    inner.setValue("s", std::string("abc"));
+    ghoul::Dictionary d;
+    d.setValue("inner", inner);
+    d.setValue("b", 2);
+
+    ghoul::Dictionary copy = d;
+    CHECK(copy == d);
+    // Both copies share the nested Dictionary
+    CHECK(&copy.ref("inner") == &d.ref("inner"));
+
+    // Modifying the copy does not change the original, but the unmodified nested
+    // Dictionary is still shared
+    copy.setValue("b", 3);
+    CHECK(d.value<int>("b") == 2);
+    CHECK(copy.value<int>("b") == 3);
+    CHECK(copy != d);
+    const std::string_view copyString = copy.ref("inner").stringView("s");
+    CHECK(copyString.data() == d.ref("inner").stringView("s").data());
+
+    ghoul::Dictionary modifiedInner = copy.value<ghoul::Dictionary>("inner");
+    modifiedInner.setValue("a", 4);
+    copy.setValue("inner", modifiedInner);
+    CHECK(d.ref("inner").value<int>("a") == 1);
+    CHECK(copy.ref("inner").value<int>("a") == 4);
+
+    ghoul::Dictionary removed = d;
+    removed.removeValue("b");
+    CHECK(d.hasKey("b"));
+    CHECK_FALSE(removed.hasKey("b"));
+
+    // Storing a Dictionary inside of itself stores the previous state
+    d.setValue("self", d);
+    CHECK(d.ref("self").size() == 2);
+    CHECK(d.size() == 3);
+}
+
+TEST_CASE("Dictionary: Benchmark Copy", "[.][dictionary][benchmark]") {
+    // 100 nested Dictionaries with 100 entries each
+    ghoul::Dictionary d;
+    for (int i = 0; i < 100; i++) {
+        ghoul::Dictionary inner;
+        for (int j = 0; j < 100; j++) {
+            inner.setValue(std::format("Key{}", j), static_cast<double>(j));
+        }
+        d.setValue(std::format("Dictionary{}", i), inner);
+    }
+
+    BENCHMARK("Copy 10k entries 1000 times") {
+        std::vector<ghoul::Dictionary> copies;
+        copies.reserve(1000);
+        for (int i = 0; i < 1000; i++) {
+            copies.push_back(d);
+        }
+        return copies;
+    };
+
+    BENCHMARK("Copy and modify 10k entries 1000 times") {
+        std::vector<ghoul::Dictionary> copies;
+        copies.reserve(1000);
+        for (int i = 0; i < 1000; i++) {
+            ghoul::Dictionary copy = d;
+            copy.setValue("Modified", i);
+            copies.push_back(std::move(copy));
+        }
+        return copies;
+    };
+}
@@ -0,0 +1,222 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2026                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/misc/dictionary.h>
+#include <ghoul/misc/dictionarybinaryformat.h>
+#include <ghoul/format.h>
+#include <ghoul/glm.h>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+    ghoul::Dictionary createDictionary() {
+        ghoul::Dictionary inner;
+        inner.setValue("Value", 1.5);
+        inner.setValue("Name", std::string("inner"));
+
+        ghoul::Dictionary d;
+        d.setValue("Bool", true);
+        d.setValue("Int", -5);
+        d.setValue("Double", 3.25);
+        d.setValue("String", std::string("abc"));
+        d.setValue("EmptyString", std::string());
+        d.setValue("Dictionary", inner);
+        d.setValue("EmptyDictionary", ghoul::Dictionary());
+        d.setValue("IntVector", std::vector<int>{ 1, -2, 3 });
+        d.setValue("DoubleVector", std::vector<double>{ 1.5, 2.5 });
+        d.setValue("EmptyVector", std::vector<double>());
+        d.setValue("StringVector", std::vector<std::string>{ "a", "", "ccc" });
+        d.setValue("IVec3", glm::ivec3(1, 2, 3));
+        d.setValue("DVec4", glm::dvec4(1.0, 2.0, 3.0, 4.0));
+        d.setValue("DMat3x2", glm::dmat3x2(1.0, 2.0, 3.0, 4.0, 5.0, 6.0));
+        return d;
+    }
+} // namespace
+
+TEST_CASE("DictionaryBinaryFormat: Empty Dictionary", "[dictionarybinaryformat]") {
+    const std::vector<std::byte> buffer = ghoul::formatBinary(ghoul::Dictionary());
+    const ghoul::Dictionary d = ghoul::parseBinary(buffer);
+    CHECK(d.isEmpty());
+}
+
+TEST_CASE("DictionaryBinaryFormat: Round Trip", "[dictionarybinaryformat]") {
+    const ghoul::Dictionary d = createDictionary();
+    const std::vector<std::byte> buffer = ghoul::formatBinary(d);
+    const ghoul::Dictionary e = ghoul::parseBinary(buffer);
+
+    CHECK(e == d);
+    // The values have to keep their types
+    CHECK(e.hasValue<int>("Int"));
+    CHECK(e.hasValue<std::vector<int>>("IntVector"));
+    CHECK(e.hasValue<glm::ivec3>("IVec3"));
+    CHECK(e.value<glm::dmat3x2>("DMat3x2") == glm::dmat3x2(1, 2, 3, 4, 5, 6));
+}
+
+TEST_CASE("DictionaryBinaryFormat: View", "[dictionarybinaryformat]") {
+    const ghoul::Dictionary d = createDictionary();
+    const std::vector<std::byte> buffer = ghoul::formatBinary(d);
+    const ghoul::BinaryDictionaryView view = ghoul::BinaryDictionaryView(buffer);
+
+    CHECK(view.size() == d.size());
+    CHECK(view.keys() == d.keys());
+    CHECK(view.hasKey("Bool"));
+    CHECK_FALSE(view.hasKey("Missing"));
+
+    CHECK(view.value<bool>("Bool") == true);
+    CHECK(view.value<int>("Int") == -5);
+    CHECK(view.value<std::string>("String") == "abc");
+    CHECK(view.value<glm::dvec4>("DVec4") == glm::dvec4(1.0, 2.0, 3.0, 4.0));
+    CHECK(view.value<std::vector<int>>("IVec3") == std::vector<int>{ 1, 2, 3 });
+    CHECK(view.hasValue<double>("Double"));
+    CHECK_FALSE(view.hasValue<int>("Double"));
+    CHECK_FALSE(view.hasValue<int>("Missing"));
+
+    // Accessing values in-place returns pointers into the buffer
+    const std::string_view s = view.stringView("String");
+    CHECK(s == "abc");
+    CHECK(reinterpret_cast<const std::byte*>(s.data()) >= buffer.data());
+    CHECK(reinterpret_cast<const std::byte*>(s.data()) < buffer.data() + buffer.size());
+
+    const std::span<const double> dv = view.valueSpan<double>("DoubleVector");
+    CHECK(std::vector<double>(dv.begin(), dv.end()) == std::vector<double>{ 1.5, 2.5 });
+    const std::span<const int> iv = view.valueSpan<int>("IVec3");
+    CHECK(std::vector<int>(iv.begin(), iv.end()) == std::vector<int>{ 1, 2, 3 });
+    CHECK(view.valueSpan<double>("DMat3x2").size() == 6);
+    CHECK(view.valueSpan<double>("EmptyVector").empty());
+
+    const ghoul::BinaryDictionaryView inner = view.view("Dictionary");
+    CHECK(inner.size() == 2);
+    CHECK(inner.stringView("Name") == "inner");
+    CHECK(inner.value<double>("Value") == 1.5);
+    CHECK(inner.dictionary() == d.value<ghoul::Dictionary>("Dictionary"));
+    CHECK(view.view("EmptyDictionary").size() == 0);
+}
+
+TEST_CASE("DictionaryBinaryFormat: Interned Keys", "[dictionarybinaryformat]") {
+    ghoul::Dictionary d;
+    for (int i = 0; i < 100; i++) {
+        ghoul::Dictionary e;
+        e.setValue("RepeatedKeyName", i);
+        d.setValue(std::to_string(i + 1), e);
+    }
+
+    const std::vector<std::byte> buffer = ghoul::formatBinary(d);
+    const std::string_view key = "RepeatedKeyName";
+    const auto it = std::search(
+        buffer.begin(),
+        buffer.end(),
+        reinterpret_cast<const std::byte*>(key.data()),
+        reinterpret_cast<const std::byte*>(key.data() + key.size())
+    );
+    REQUIRE(it != buffer.end());
+    const auto next = std::search(
+        it + 1,
+        buffer.end(),
+        reinterpret_cast<const std::byte*>(key.data()),
+        reinterpret_cast<const std::byte*>(key.data() + key.size())
+    );
+    CHECK(next == buffer.end());
+    CHECK(ghoul::parseBinary(buffer) == d);
+}
+
+TEST_CASE("DictionaryBinaryFormat: Invalid Buffers", "[dictionarybinaryformat]") {
+    ghoul::Dictionary p;
+    int i = 0;
+    p.setValue("Pointer", reinterpret_cast<void*>(&i));
+    CHECK_THROWS_AS(ghoul::formatBinary(p), ghoul::BinaryFormatError);
+
+    const std::vector<std::byte> buffer = ghoul::formatBinary(createDictionary());
+
+    CHECK_THROWS_AS(
+        ghoul::parseBinary(std::span<const std::byte>()),
+        ghoul::BinaryFormatError
+    );
+
+    // Truncated buffer
+    CHECK_THROWS_AS(
+        ghoul::parseBinary(std::span(buffer.data(), buffer.size() - 8)),
+        ghoul::BinaryFormatError
+    );
+
+    // Wrong magic number
+    std::vector<std::byte> wrongMagic = buffer;
+    wrongMagic[0] = std::byte(0);
+    CHECK_THROWS_AS(ghoul::parseBinary(wrongMagic), ghoul::BinaryFormatError);
+
+    // A root offset that points outside of the buffer
+    std::vector<std::byte> wrongRoot = buffer;
+    const uint64_t root = wrongRoot.size();
+    std::memcpy(wrongRoot.data() + 24, &root, sizeof(uint64_t));
+    CHECK_THROWS_AS(ghoul::parseBinary(wrongRoot), ghoul::BinaryFormatError);
+
+    // Accessing values with the wrong type
+    const ghoul::BinaryDictionaryView view = ghoul::BinaryDictionaryView(buffer);
+    CHECK_THROWS_AS(view.view("String"), ghoul::BinaryFormatError);
+    CHECK_THROWS_AS(view.stringView("Int"), ghoul::BinaryFormatError);
+    CHECK_THROWS_AS(view.valueSpan<int>("DVec4"), ghoul::BinaryFormatError);
+    CHECK_THROWS_AS(view.valueSpan<double>("Missing"), ghoul::BinaryFormatError);
+}
+
+TEST_CASE("DictionaryBinaryFormat: File", "[dictionarybinaryformat]") {
+    const ghoul::Dictionary d = createDictionary();
+    const std::filesystem::path path = absPath("${TEMPORARY}/dictionary.bin");
+    ghoul::saveBinaryFile(d, path);
+
+    CHECK(ghoul::loadBinaryFile(path) == d);
+    {
+        const ghoul::BinaryDictionaryFile file = ghoul::BinaryDictionaryFile(path);
+        CHECK(file.root().view("Dictionary").stringView("Name") == "inner");
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("DictionaryBinaryFormat: Benchmark", "[.][dictionarybinaryformat][benchmark]") {
+    // 1000 nested Dictionaries with all supported types
+    ghoul::Dictionary d;
+    for (int i = 0; i < 1000; i++) {
+        ghoul::Dictionary e = createDictionary();
+        d.setValue(std::format("Dictionary{}", i), e);
+    }
+    const std::vector<std::byte> buffer = ghoul::formatBinary(d);
+
+    BENCHMARK("formatBinary") {
+        return ghoul::formatBinary(d);
+    };
+
+    BENCHMARK("parseBinary") {
+        return ghoul::parseBinary(buffer);
+    };
+
+    BENCHMARK("View single value") {
+        const ghoul::BinaryDictionaryView view = ghoul::BinaryDictionaryView(buffer);
+        return view.view("Dictionary500").value<int>("Int");
+    };
+}
@@ -27,6 +27,7 @@
 
 #include <ghoul/misc/dictionaryjsonformatter.h>
 #include <ghoul/misc/dictionary.h>
+#include <sstream>
 #include <string>
 
 TEST_CASE("DictionaryJsonFormatter: Empty Dictionary", "[dictionaryjsonformatter]") {
@@ -210,3 +211,54 @@ TEST_CASE("DictionaryJsonFormatter: Nested Dictionary", "[dictionaryjsonformatte
         "\"vec4\":[0,0,0,0]}"
     );
 }
+
+TEST_CASE("DictionaryJsonFormatter: Strings", "[dictionaryjsonformatter]") {
+    ghoul::Dictionary d;
+    d.setValue("escaped", std::string("a\"b\\c\nd\te\x01"));
+    d.setValue("list", std::vector<std::string>{ "a", "b\"", "c" });
+    d.setValue("key\"", std::string("utf8 åäö"));
+
+    const std::string res = ghoul::formatJson(d);
+    CHECK(
+        res ==
+        "{\"escaped\":\"a\\\"b\\\\c\\nd\\te\\u0001\","
+        "\"key\\\"\":\"utf8 åäö\","
+        "\"list\":[\"a\",\"b\\\"\",\"c\"]}"
+    );
+}
+
+TEST_CASE("DictionaryJsonFormatter: Arrays", "[dictionaryjsonformatter]") {
+    // Dictionaries with the keys 1 to n are written as arrays in the numerical order of
+    // their keys, rather than the order of the keys as strings
+    ghoul::Dictionary d;
+    for (int i = 1; i <= 12; i++) {
+        d.setValue(std::to_string(i), i);
+    }
+    CHECK(ghoul::formatJson(d) == "[1,2,3,4,5,6,7,8,9,10,11,12]");
+
+    ghoul::Dictionary e;
+    e.setValue("1", 1);
+    e.setValue("3", 3);
+    CHECK(ghoul::formatJson(e) == "{\"1\":1,\"3\":3}");
+}
+
+TEST_CASE("DictionaryJsonFormatter: Output Buffer and Stream",
+          "[dictionaryjsonformatter]")
+{
+    ghoul::Dictionary d;
+    for (int i = 0; i < 1000; i++) {
+        ghoul::Dictionary e;
+        e.setValue("Name", std::string(100, 'a'));
+        e.setValue("Position", glm::dvec3(1.0, 2.0, 3.0));
+        d.setValue(std::to_string(i + 1), e);
+    }
+    const std::string expected = ghoul::formatJson(d);
+
+    std::string buffer = "prefix";
+    ghoul::formatJson(d, buffer);
+    CHECK(buffer == "prefix" + expected);
+
+    std::stringstream stream;
+    ghoul::formatJson(d, stream);
+    CHECK(stream.str() == expected);
+}
@@ -0,0 +1,243 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2026                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/lua/lua_helper.h>
+#include <ghoul/misc/dictionary.h>
+#include <ghoul/misc/dictionaryjsonparser.h>
+#include <ghoul/format.h>
+#include <ghoul/glm.h>
+#include <string>
+#include <vector>
+
+TEST_CASE("DictionaryJsonParser: Empty Object", "[dictionaryjsonparser]") {
+    CHECK(ghoul::parseJson("{}").isEmpty());
+    CHECK(ghoul::parseJson(" \n\t{ \r\n}\n ").isEmpty());
+    CHECK(ghoul::parseJson("\xEF\xBB\xBF{}").isEmpty());
+}
+
+TEST_CASE("DictionaryJsonParser: Simple Values", "[dictionaryjsonparser]") {
+    const ghoul::Dictionary d = ghoul::parseJson(R"({
+        "boolTrue": true,
+        "boolFalse": false,
+        "int": 12,
+        "negative": -3,
+        "double": 2.5,
+        "exponent": -1.5e3,
+        "string": "abc",
+        "null": null
+    })");
+
+    CHECK(d.size() == 7);
+    CHECK(d.value<bool>("boolTrue") == true);
+    CHECK(d.value<bool>("boolFalse") == false);
+    // Numbers are always stored as double, the same way they are when loaded from Lua
+    CHECK(d.value<double>("int") == 12.0);
+    CHECK(d.value<double>("negative") == -3.0);
+    CHECK(d.value<double>("double") == 2.5);
+    CHECK(d.value<double>("exponent") == -1500.0);
+    CHECK(d.value<std::string>("string") == "abc");
+    CHECK_FALSE(d.hasKey("null"));
+}
+
+TEST_CASE("DictionaryJsonParser: Strings", "[dictionaryjsonparser]") {
+    const ghoul::Dictionary d = ghoul::parseJson(R"({
+        "empty": "",
+        "escaped": "a\"b\\c\/d\be\ff\ng\rh\ti",
+        "unicode": "\u00e5\u20ac",
+        "surrogate": "\ud83d\ude00",
+        "utf8": "åäö",
+        "long": "This string is long enough to be scanned in multiple blocks \n !"
+    })");
+
+    CHECK(d.value<std::string>("empty").empty());
+    CHECK(d.value<std::string>("escaped") == "a\"b\\c/d\be\ff\ng\rh\ti");
+    CHECK(d.value<std::string>("unicode") == "\xC3\xA5\xE2\x82\xAC");
+    CHECK(d.value<std::string>("surrogate") == "\xF0\x9F\x98\x80");
+    CHECK(d.value<std::string>("utf8") == "åäö");
+    CHECK(
+        d.value<std::string>("long") ==
+        "This string is long enough to be scanned in multiple blocks \n !"
+    );
+}
+
+TEST_CASE("DictionaryJsonParser: Arrays", "[dictionaryjsonparser]") {
+    const ghoul::Dictionary d = ghoul::parseJson(R"({
+        "numbers": [1, 2.5, -3e2],
+        "strings": ["a", "b", "c"],
+        "vec3": [1, 2, 3],
+        "empty": [],
+        "mixed": [1, "a", true, null, {"b": 2}],
+        "nested": [[1, 2], ["a"]]
+    })");
+
+    REQUIRE(d.hasValue<std::vector<double>>("numbers"));
+    CHECK(d.value<std::vector<double>>("numbers") == std::vector<double>{ 1, 2.5, -300 });
+
+    REQUIRE(d.hasValue<std::vector<std::string>>("strings"));
+    CHECK(
+        d.value<std::vector<std::string>>("strings") ==
+        std::vector<std::string>{ "a", "b", "c" }
+    );
+
+    CHECK(d.value<glm::dvec3>("vec3") == glm::dvec3(1.0, 2.0, 3.0));
+
+    REQUIRE(d.hasValue<ghoul::Dictionary>("empty"));
+    CHECK(d.value<ghoul::Dictionary>("empty").isEmpty());
+
+    // Arrays that cannot be represented by a vector are converted the same way as Lua
+    // tables, skipping the null value
+    REQUIRE(d.hasValue<ghoul::Dictionary>("mixed"));
+    const ghoul::Dictionary mixed = d.value<ghoul::Dictionary>("mixed");
+    CHECK(mixed.size() == 4);
+    CHECK(mixed.value<double>("1") == 1.0);
+    CHECK(mixed.value<std::string>("2") == "a");
+    CHECK(mixed.value<bool>("3") == true);
+    CHECK_FALSE(mixed.hasKey("4"));
+    CHECK(mixed.value<ghoul::Dictionary>("5").value<double>("b") == 2.0);
+
+    REQUIRE(d.hasValue<ghoul::Dictionary>("nested"));
+    const ghoul::Dictionary nested = d.value<ghoul::Dictionary>("nested");
+    CHECK(nested.value<std::vector<double>>("1") == std::vector<double>{ 1.0, 2.0 });
+    CHECK(nested.value<std::vector<std::string>>("2") == std::vector<std::string>{ "a" });
+}
+
+TEST_CASE("DictionaryJsonParser: Nested Objects", "[dictionaryjsonparser]") {
+    const ghoul::Dictionary d = ghoul::parseJson(R"({
+        "a": { "b": { "c": 1 }, "d": "e" },
+        "a2": 2,
+        "a": { "f": 3 }
+    })");
+
+    CHECK(d.size() == 2);
+    // Duplicate keys are resolved by using the last value
+    CHECK(d.value<ghoul::Dictionary>("a").value<double>("f") == 3.0);
+    CHECK_FALSE(d.value<ghoul::Dictionary>("a").hasKey("b"));
+    CHECK(d.value<double>("a2") == 2.0);
+
+    const ghoul::Dictionary e = ghoul::parseJson(R"({"a":{"b":{"c":1},"d":"e"}})");
+    CHECK(e.value<ghoul::Dictionary>("a").value<std::string>("d") == "e");
+    const ghoul::Dictionary b = e.value<ghoul::Dictionary>("a").value<ghoul::Dictionary>(
+        "b"
+    );
+    CHECK(b.value<double>("c") == 1.0);
+}
+
+TEST_CASE("DictionaryJsonParser: Invalid Documents", "[dictionaryjsonparser]") {
+    const std::vector<std::string> documents = {
+        "",
+        "[]",
+        "1",
+        "{",
+        "{}}",
+        "{} 1",
+        "{\"a\"}",
+        "{\"a\":}",
+        "{\"a\":1,}",
+        "{\"a\":[1,]}",
+        "{\"a\":[1 2]}",
+        "{\"\":1}",
+        "{a:1}",
+        "{\"a\":01}",
+        "{\"a\":1.}",
+        "{\"a\":-}",
+        "{\"a\":1e}",
+        "{\"a\":1e999}",
+        "{\"a\":nan}",
+        "{\"a\":tru}",
+        "{\"a\":\"b}",
+        "{\"a\":\"\\x\"}",
+        "{\"a\":\"\\u12\"}",
+        "{\"a\":\"\\ud800\"}",
+        "{\"a\":\"\\udc00\"}",
+        "{\"a\":\"b\nc\"}",
+        std::string("{\"a\":1}\0", 8)
+    };
+
+    for (const std::string& doc : documents) {
+        INFO(doc);
+        CHECK_THROWS_AS(ghoul::parseJson(doc), ghoul::JsonParsingError);
+    }
+
+    const std::string deep = std::string(1000, '[') + std::string(1000, ']');
+    CHECK_THROWS_AS(
+        ghoul::parseJson(std::format("{{\"a\":{}}}", deep)),
+        ghoul::JsonParsingError
+    );
+}
+
+TEST_CASE("DictionaryJsonParser: File", "[dictionaryjsonparser]") {
+    const ghoul::Dictionary d = ghoul::parseJsonFile(
+        absPath("${UNIT_TEST}/jsonparser/test0.json")
+    );
+
+    CHECK(d.value<std::string>("Identifier") == "Earth");
+    CHECK(d.value<std::string>("Parent") == "SolarSystemBarycenter");
+    const ghoul::Dictionary r = d.value<ghoul::Dictionary>("Renderable");
+    CHECK(r.value<std::string>("Type") == "RenderableGlobe");
+    CHECK(
+        r.value<glm::dvec3>("Radii") == glm::dvec3(6378137.0, 6378137.0, 6356752.314245)
+    );
+    CHECK(
+        r.value<std::vector<std::string>>("Layers") ==
+        std::vector<std::string>{ "ColorLayers", "HeightLayers" }
+    );
+    CHECK(r.value<bool>("Enabled") == true);
+}
+
+TEST_CASE("DictionaryJsonParser: Benchmark", "[.][dictionaryjsonparser][benchmark]") {
+    // The same document as JSON and as a Lua table with 10000 scene-graph-like entries
+    constexpr int NEntries = 10000;
+    std::string json = "{";
+    std::string lua = "return {";
+    for (int i = 0; i < NEntries; i++) {
+        json += std::format(
+            R"({}"Node{}":{{"Identifier":"Node{}","Enabled":true,"Opacity":{}.5,)"
+            R"("Position":[{},2.5,-3.75],"Tags":["a","b"]}})",
+            i == 0 ? "" : ",", i, i, i, i
+        );
+        lua += std::format(
+            R"(Node{}={{Identifier="Node{}",Enabled=true,Opacity={}.5,)"
+            R"(Position={{{},2.5,-3.75}},Tags={{"a","b"}}}},)",
+            i, i, i, i
+        );
+    }
+    json += "}";
+    lua += "}";
+
+    REQUIRE(ghoul::parseJson(json).size() == NEntries);
+    REQUIRE(ghoul::lua::loadDictionaryFromString(lua).size() == NEntries);
+
+    BENCHMARK("parseJson") {
+        return ghoul::parseJson(json);
+    };
+
+    BENCHMARK("loadDictionaryFromString") {
+        return ghoul::lua::loadDictionaryFromString(lua);
+    };
+}
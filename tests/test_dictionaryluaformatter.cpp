@@ -212,3 +212,38 @@ TEST_CASE("DictionaryLuaFormatter: Nested Dictionary", "[dictionaryluaformatter]
         "[\"vec4\"]={0,0,0,0}}"
     );
 }
+
+TEST_CASE("DictionaryLuaFormatter: Strings", "[dictionaryluaformatter]") {
+    ghoul::Dictionary d;
+    d.setValue("escaped", std::string("a\"b\\c\nd\te\x01"));
+    d.setValue("list", std::vector<std::string>{ "a", "b\"", "c" });
+
+    const std::string res = ghoul::formatLua(d);
+    CHECK(
+        res ==
+        "{[\"escaped\"]=\"a\\\"b\\\\c\\nd\\te\\001\","
+        "[\"list\"]={\"a\",\"b\\\"\",\"c\"}}"
+    );
+}
+
+TEST_CASE("DictionaryLuaFormatter: Pretty Print", "[dictionaryluaformatter]") {
+    ghoul::Dictionary e;
+    e.setValue("c", 2);
+
+    ghoul::Dictionary d;
+    d.setValue("a", 1);
+    d.setValue("b", e);
+    d.setValue("v", std::vector<int>{ 1, 2 });
+
+    const std::string res = ghoul::formatLua(d, ghoul::PrettyPrint::Yes, "  ");
+    CHECK(
+        res ==
+        "{\n"
+        "  [\"a\"] = 1,\n"
+        "  [\"b\"] = {\n"
+        "    [\"c\"] = 2\n"
+        "  },\n"
+        "  [\"v\"] = {1,2}\n"
+        "}"
+    );
+}
@@ -0,0 +1,134 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2026                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <ghoul/misc/framearena.h>
+#include <cstdint>
+#include <thread>
+
+TEST_CASE("FrameArena: Allocation", "[framearena]") {
+    ghoul::FrameArena arena(1024);
+    CHECK(arena.usage() == 0);
+    CHECK(arena.capacity() == 0);
+
+    void* p1 = arena.allocate(100, 1);
+    void* p2 = arena.allocate(100, 1);
+    CHECK(static_cast<std::byte*>(p2) == static_cast<std::byte*>(p1) + 100);
+    CHECK(arena.usage() == 200);
+    CHECK(arena.capacity() == 1024);
+
+    void* p3 = arena.allocate(8, 64);
+    CHECK(reinterpret_cast<uintptr_t>(p3) % 64 == 0);
+
+    // Deallocation does not release anything
+    arena.deallocate(p1, 100, 1);
+    CHECK(arena.usage() >= 208);
+
+    // An allocation that does not fit into the current chunk starts a new one, and one
+    // that does not fit into any chunk receives a chunk of its own
+    arena.allocate(900, 1);
+    CHECK(arena.capacity() == 2048);
+    arena.allocate(4096, 16);
+    CHECK(arena.capacity() > 2048 + 4096);
+
+    arena.reset();
+    CHECK(arena.usage() == 0);
+    CHECK(arena.allocate(100, 1) == p1);
+}
+
+TEST_CASE("FrameArena: Mark And Rewind", "[framearena]") {
+    ghoul::FrameArena arena(1024);
+    arena.allocate(100, 1);
+
+    const ghoul::FrameArena::Marker marker = arena.mark();
+    void* p1 = arena.allocate(500, 1);
+    arena.allocate(800, 1);
+    arena.allocate(800, 1);
+    const size_t capacity = arena.capacity();
+
+    arena.rewind(marker);
+    CHECK(arena.usage() == 100);
+
+    // The same memory and chunks are reused after rewinding
+    CHECK(arena.allocate(500, 1) == p1);
+    arena.allocate(800, 1);
+    arena.allocate(800, 1);
+    CHECK(arena.capacity() == capacity);
+}
+
+TEST_CASE("FrameArena: Oversized Allocations", "[framearena]") {
+    ghoul::FrameArena arena(1024);
+    {
+        ghoul::FrameArena::Scope scope(arena);
+        arena.allocate(16);
+        arena.allocate(4096);
+    }
+    const size_t capacity = arena.capacity();
+
+    // Chunks that were created for oversized allocations are reused in later scopes
+    for (int i = 0; i < 10; i++) {
+        ghoul::FrameArena::Scope scope(arena);
+        arena.allocate(16);
+        arena.allocate(4096);
+        arena.allocate(2048);
+    }
+    const size_t grownCapacity = arena.capacity();
+    CHECK(grownCapacity > capacity);
+    for (int i = 0; i < 10; i++) {
+        ghoul::FrameArena::Scope scope(arena);
+        arena.allocate(16);
+        arena.allocate(4096);
+        arena.allocate(2048);
+        CHECK(arena.capacity() == grownCapacity);
+    }
+}
+
+TEST_CASE("FrameArena: Scope", "[framearena]") {
+    ghoul::FrameArena arena;
+    arena.allocate(16);
+    const size_t usage = arena.usage();
+    {
+        ghoul::FrameArena::Scope scope(arena);
+        ghoul::frame_vector<int> v(&arena);
+        for (int i = 0; i < 1000; i++) {
+            v.push_back(i);
+        }
+        ghoul::frame_string s("a string that does not fit into the object", &arena);
+        CHECK(v[999] == 999);
+        CHECK(s.starts_with("a string"));
+        CHECK(arena.usage() > usage);
+    }
+    CHECK(arena.usage() == usage);
+}
+
+TEST_CASE("FrameArena: Thread Local", "[framearena]") {
+    ghoul::FrameArena& arena = ghoul::FrameArena::threadLocal();
+    CHECK(&arena == &ghoul::FrameArena::threadLocal());
+
+    ghoul::FrameArena* other = nullptr;
+    std::thread([&other]() { other = &ghoul::FrameArena::threadLocal(); }).join();
+    CHECK(other != &arena);
+}
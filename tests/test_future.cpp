@@ -0,0 +1,197 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2026                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <ghoul/misc/future.h>
+#include <ghoul/misc/threadpool.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    ghoul::Future<int> addAsync(ghoul::ThreadPool& pool, int a, int b) {
+        co_await ghoul::resumeOn(pool);
+        co_return a + b;
+    }
+
+    ghoul::Future<std::string> pipeline(ghoul::ThreadPool& pool) {
+        const int first = co_await addAsync(pool, 1, 2);
+        const int second = co_await ghoul::runAsync(pool, [&]() { return first * 2; });
+        co_return std::to_string(first) + " " + std::to_string(second);
+    }
+
+    ghoul::Future<void> throwingCoroutine(ghoul::ThreadPool& pool) {
+        co_await ghoul::resumeOn(pool);
+        throw std::runtime_error("error");
+    }
+} // namespace
+
+TEST_CASE("Future: Run Async", "[future]") {
+    ghoul::ThreadPool pool(2);
+
+    auto add = [](int a, int b) { return a + b; };
+    ghoul::Future<int> f = ghoul::runAsync(pool, add, 1, 2);
+    CHECK(f.isValid());
+    CHECK(f.get() == 3);
+    CHECK_FALSE(f.isValid());
+
+    std::atomic_bool hasRun = false;
+    ghoul::Future<void> v = ghoul::runAsync(pool, [&hasRun]() { hasRun = true; });
+    v.wait();
+    CHECK(v.isReady());
+    v.get();
+    CHECK(hasRun);
+}
+
+TEST_CASE("Future: Promise", "[future]") {
+    ghoul::Promise<std::string> promise;
+    ghoul::Future<std::string> future = promise.future();
+    CHECK_FALSE(future.isReady());
+    promise.setValue("foobar");
+    CHECK(future.isReady());
+    CHECK(future.get() == "foobar");
+
+    ghoul::Future<int> broken;
+    {
+        ghoul::Promise<int> p;
+        broken = p.future();
+    }
+    CHECK_THROWS_AS(broken.get(), std::future_error);
+}
+
+TEST_CASE("Future: Then", "[future]") {
+    ghoul::ThreadPool pool(2);
+
+    ghoul::Future<std::string> f = ghoul::runAsync(pool, []() { return 2; })
+        .then([](int i) { return i * 21; })
+        .then([](int i) { return std::to_string(i); });
+    CHECK(f.get() == "42");
+
+    // Continuations that return a Future are flattened
+    ghoul::Future<int> nested = ghoul::runAsync(pool, []() {})
+        .then([&pool]() { return ghoul::runAsync(pool, []() { return 1337; }); });
+    CHECK(nested.get() == 1337);
+
+    // Continuations are only queued after the value is available
+    ghoul::Promise<int> promise;
+    std::atomic_int result = 0;
+    ghoul::Future<void> g = promise.future().then(pool, [&result](int i) { result = i; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    CHECK(result == 0);
+    promise.setValue(5);
+    g.get();
+    CHECK(result == 5);
+}
+
+TEST_CASE("Future: Then Exception", "[future]") {
+    ghoul::ThreadPool pool(2);
+
+    std::atomic_bool hasRun = false;
+    ghoul::Future<int> f = ghoul::runAsync(pool, []() -> int {
+            throw std::runtime_error("error");
+        })
+        .then([&hasRun](int i) { hasRun = true; return i; });
+    CHECK_THROWS_AS(f.get(), std::runtime_error);
+    CHECK_FALSE(hasRun);
+
+    ghoul::Future<void> g = ghoul::runAsync(pool, []() {})
+        .then([]() { throw std::logic_error("error"); });
+    CHECK_THROWS_AS(g.get(), std::logic_error);
+}
+
+TEST_CASE("Future: When All", "[future]") {
+    constexpr int NFutures = 100;
+    ghoul::ThreadPool pool(4);
+
+    std::vector<ghoul::Future<int>> futures;
+    for (int i = 0; i < NFutures; i++) {
+        futures.push_back(ghoul::runAsync(pool, [i]() { return i; }));
+    }
+    std::vector<int> values = ghoul::whenAll(std::move(futures)).get();
+    REQUIRE(values.size() == NFutures);
+    for (int i = 0; i < NFutures; i++) {
+        CHECK(values[i] == i);
+    }
+
+    std::atomic_int counter = 0;
+    std::vector<ghoul::Future<void>> voids;
+    for (int i = 0; i < NFutures; i++) {
+        voids.push_back(ghoul::runAsync(pool, [&counter]() { counter++; }));
+    }
+    ghoul::whenAll(std::move(voids)).then([]() {}).get();
+    CHECK(counter == NFutures);
+
+    CHECK(ghoul::whenAll(std::vector<ghoul::Future<int>>()).get().empty());
+
+    std::vector<ghoul::Future<int>> failing;
+    failing.push_back(ghoul::runAsync(pool, []() { return 1; }));
+    failing.push_back(ghoul::runAsync(pool, []() -> int {
+        throw std::runtime_error("error");
+    }));
+    CHECK_THROWS_AS(ghoul::whenAll(std::move(failing)).get(), std::runtime_error);
+}
+
+TEST_CASE("Future: When Any", "[future]") {
+    ghoul::ThreadPool pool(2);
+
+    ghoul::Promise<int> never;
+    std::vector<ghoul::Future<int>> futures;
+    futures.push_back(never.future());
+    futures.push_back(ghoul::runAsync(pool, []() { return 2; }));
+
+    ghoul::WhenAnyResult<int> result = ghoul::whenAny(std::move(futures)).get();
+    CHECK(result.index == 1);
+    REQUIRE(result.futures.size() == 2);
+    CHECK(result.futures[1].get() == 2);
+    CHECK_FALSE(result.futures[0].isReady());
+
+    never.setValue(1);
+    CHECK(result.futures[0].get() == 1);
+}
+
+TEST_CASE("Future: Coroutines", "[future]") {
+    ghoul::ThreadPool pool(2);
+
+    CHECK(addAsync(pool, 3, 4).get() == 7);
+    CHECK(pipeline(pool).get() == "3 6");
+    CHECK_THROWS_AS(throwingCoroutine(pool).get(), std::runtime_error);
+
+    // Awaiting a Promise without a ThreadPool resumes on the completing thread
+    ghoul::Promise<int> promise;
+    auto awaitPromise = [](ghoul::Future<int> f) -> ghoul::Future<int> {
+        co_return co_await std::move(f) + 1;
+    };
+    ghoul::Future<int> f = awaitPromise(promise.future());
+    CHECK_FALSE(f.isReady());
+    promise.setValue(41);
+    CHECK(f.isReady());
+    CHECK(f.get() == 42);
+}
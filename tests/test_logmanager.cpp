@@ -0,0 +1,634 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2026                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <ghoul/logging/callbacklog.h>
+#include <ghoul/logging/log.h>
+#include <ghoul/logging/logcategory.h>
+#include <ghoul/logging/logmanager.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <regex>
+#include <span>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace ghoul::logging;
+
+namespace {
+    struct Message {
+        LogLevel level;
+        std::string category;
+        std::string message;
+        std::chrono::system_clock::time_point time;
+    };
+
+    // Records all messages and can optionally hold the thread that is writing the
+    // messages until it is released to simulate a slow Log
+    class RecordingLog final : public Log {
+    public:
+        void log(LogLevel level, std::string_view category,
+                 std::string_view message) override
+        {
+            isWriting = true;
+            isWriting.notify_all();
+            isHeld.wait(true);
+
+            const std::lock_guard lock(mutex);
+            messages.emplace_back(
+                level,
+                std::string(category),
+                std::string(message),
+                messageTime()
+            );
+        }
+
+        std::vector<Message> recorded() {
+            const std::lock_guard lock(mutex);
+            return messages;
+        }
+
+        std::atomic<bool> isHeld = false;
+        std::atomic<bool> isWriting = false;
+
+    private:
+        std::mutex mutex;
+        std::vector<Message> messages;
+    };
+
+    // Removes itself from the LogManager when it receives the message "remove"
+    class SelfRemovingLog final : public Log {
+    public:
+        SelfRemovingLog(LogManager& manager, std::atomic<int>& nDestroyed)
+            : _manager(manager)
+            , _nDestroyed(nDestroyed)
+        {}
+
+        ~SelfRemovingLog() override {
+            _nDestroyed++;
+        }
+
+        void log(LogLevel, std::string_view, std::string_view message) override {
+            if (message == "remove") {
+                _manager.removeLog(this);
+            }
+        }
+
+    private:
+        LogManager& _manager;
+        std::atomic<int>& _nDestroyed;
+    };
+
+    struct Sample {
+        int value;
+    };
+} // namespace
+
+template <>
+struct std::formatter<std::span<const Sample>> {
+    constexpr auto parse(std::format_parse_context& ctx) {
+        return ctx.begin();
+    }
+
+    auto format(std::span<const Sample> samples, std::format_context& ctx) const {
+        auto out = ctx.out();
+        for (const Sample& sample : samples) {
+            out = std::format_to(out, "[{}]", sample.value);
+        }
+        return out;
+    }
+};
+
+TEST_CASE("LogManager: Synchronous", "[logmanager]") {
+    LogManager manager(LogLevel::Info);
+    auto log = std::make_unique<RecordingLog>();
+    RecordingLog* l = log.get();
+    manager.addLog(std::move(log));
+
+    manager.logMessage(LogLevel::Debug, "cat", "ignored");
+    manager.logMessage(LogLevel::Info, "cat", "first");
+    manager.logMessage(LogLevel::Warning, "cat", "second");
+
+    CHECK_FALSE(manager.isAsync());
+    const std::vector<Message> messages = l->recorded();
+    REQUIRE(messages.size() == 2);
+    CHECK(messages[0].message == "first");
+    CHECK(messages[1].message == "second");
+    CHECK(manager.messageCounter(LogLevel::Debug) == 0);
+    CHECK(manager.messageCounter(LogLevel::Info) == 1);
+    CHECK(manager.messageCounter(LogLevel::Warning) == 1);
+}
+
+TEST_CASE("LogManager: Asynchronous Multiple Producers", "[logmanager]") {
+    constexpr int NThreads = 4;
+    constexpr int NMessages = 100;
+
+    LogManager manager(LogLevel::Info);
+    auto log = std::make_unique<RecordingLog>();
+    RecordingLog* l = log.get();
+    manager.addLog(std::move(log));
+
+    AsyncOptions options;
+    options.queueSize = 16;
+    manager.startAsync(options);
+    CHECK(manager.isAsync());
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < NThreads; i++) {
+        threads.emplace_back([&manager, i]() {
+            const std::string category = std::to_string(i);
+            for (int j = 0; j < NMessages; j++) {
+                manager.logMessage(LogLevel::Info, category, std::to_string(j));
+            }
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    manager.flushLogs();
+
+    const std::vector<Message> messages = l->recorded();
+    REQUIRE(messages.size() == NThreads * NMessages);
+    CHECK(manager.messageCounter(LogLevel::Info) == NThreads * NMessages);
+    CHECK(manager.droppedMessages() == 0);
+
+    // The messages of each thread have to arrive in the order in which they were logged
+    std::vector<int> next(NThreads, 0);
+    for (const Message& m : messages) {
+        const int thread = std::stoi(m.category);
+        CHECK(std::stoi(m.message) == next[thread]);
+        next[thread]++;
+    }
+
+    manager.stopAsync();
+    CHECK_FALSE(manager.isAsync());
+}
+
+TEST_CASE("LogManager: Asynchronous Drop", "[logmanager]") {
+    LogManager manager(LogLevel::Info);
+    auto log = std::make_unique<RecordingLog>();
+    RecordingLog* l = log.get();
+    manager.addLog(std::move(log));
+
+    AsyncOptions options;
+    options.queueSize = 4;
+    options.overflowPolicy = OverflowPolicy::Drop;
+    manager.startAsync(options);
+
+    // Hold the sink thread in the first message so that the queue fills up. The slot of
+    // the message that is currently being written is only freed afterwards
+    l->isHeld = true;
+    manager.logMessage(LogLevel::Info, "cat", "0");
+    l->isWriting.wait(false);
+    for (int i = 1; i < 9; i++) {
+        manager.logMessage(LogLevel::Info, "cat", std::to_string(i));
+    }
+    CHECK(manager.droppedMessages() == 5);
+
+    l->isHeld = false;
+    l->isHeld.notify_all();
+    manager.flushLogs();
+
+    const std::vector<Message> messages = l->recorded();
+    REQUIRE(messages.size() == 4);
+    for (size_t i = 0; i < messages.size(); i++) {
+        CHECK(messages[i].message == std::to_string(i));
+    }
+    CHECK(manager.messageCounter(LogLevel::Info) == 4);
+
+    manager.resetMessageCounters();
+    CHECK(manager.droppedMessages() == 0);
+}
+
+TEST_CASE("LogManager: Asynchronous Drop Below Level", "[logmanager]") {
+    LogManager manager(LogLevel::Info);
+    auto log = std::make_unique<RecordingLog>();
+    RecordingLog* l = log.get();
+    manager.addLog(std::move(log));
+
+    AsyncOptions options;
+    options.queueSize = 2;
+    options.overflowPolicy = OverflowPolicy::DropBelowLevel;
+    options.dropBelowLevel = LogLevel::Warning;
+    manager.startAsync(options);
+
+    l->isHeld = true;
+    manager.logMessage(LogLevel::Info, "cat", "0");
+    l->isWriting.wait(false);
+    manager.logMessage(LogLevel::Info, "cat", "1");
+
+    // The queue is full, so this message is dropped
+    manager.logMessage(LogLevel::Info, "cat", "dropped");
+    CHECK(manager.droppedMessages() == 1);
+
+    // whereas this one has to wait until the sink thread has made room
+    std::thread release([l]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        l->isHeld = false;
+        l->isHeld.notify_all();
+    });
+    manager.logMessage(LogLevel::Warning, "cat", "2");
+    release.join();
+    manager.flushLogs();
+
+    const std::vector<Message> messages = l->recorded();
+    REQUIRE(messages.size() == 3);
+    CHECK(messages[0].message == "0");
+    CHECK(messages[1].message == "1");
+    CHECK(messages[2].message == "2");
+    CHECK(messages[2].level == LogLevel::Warning);
+    CHECK(manager.droppedMessages() == 1);
+}
+
+TEST_CASE("LogManager: Asynchronous Fatal", "[logmanager]") {
+    LogManager manager(LogLevel::Info);
+    auto log = std::make_unique<RecordingLog>();
+    RecordingLog* l = log.get();
+    manager.addLog(std::move(log));
+    manager.startAsync();
+
+    manager.logMessage(LogLevel::Info, "cat", "first");
+    manager.logMessage(LogLevel::Fatal, "cat", "fatal");
+
+    // A fatal message is written before logMessage returns
+    const std::vector<Message> messages = l->recorded();
+    REQUIRE(messages.size() == 2);
+    CHECK(messages[1].message == "fatal");
+}
+
+TEST_CASE("LogManager: Asynchronous Timestamp", "[logmanager]") {
+    LogManager manager(LogLevel::Info);
+    auto log = std::make_unique<RecordingLog>();
+    RecordingLog* l = log.get();
+    manager.addLog(std::move(log));
+    manager.startAsync();
+
+    l->isHeld = true;
+    manager.logMessage(LogLevel::Info, "cat", "first");
+    l->isWriting.wait(false);
+    const std::chrono::system_clock::time_point before = std::chrono::system_clock::now();
+    manager.logMessage(LogLevel::Info, "cat", "second");
+    const std::chrono::system_clock::time_point after = std::chrono::system_clock::now();
+
+    // The message is written long after it was logged, but has to keep its time
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    l->isHeld = false;
+    l->isHeld.notify_all();
+    manager.flushLogs();
+
+    const std::vector<Message> messages = l->recorded();
+    REQUIRE(messages.size() == 2);
+    CHECK(messages[1].time >= before);
+    CHECK(messages[1].time <= after);
+}
+
+TEST_CASE("LogManager: Asynchronous Logging From Log", "[logmanager]") {
+    LogManager manager(LogLevel::Info);
+    auto log = std::make_unique<RecordingLog>();
+    RecordingLog* l = log.get();
+    manager.addLog(std::move(log));
+
+    // While the sink thread writes the trigger message, the callback logs more messages
+    // than fit into the queue, logs a fatal message, adds a Log, and flushes the Logs.
+    // Each of these would wait for the sink thread if they were queued
+    constexpr int NMessages = 8;
+    RecordingLog* added = nullptr;
+    auto callback = [&manager, &added](std::string message) {
+        if (!message.ends_with("trigger")) {
+            return;
+        }
+        for (int i = 0; i < NMessages; i++) {
+            manager.logMessage(LogLevel::Info, "cat", std::to_string(i));
+        }
+        manager.logMessage(LogLevel::Fatal, "cat", "fatal");
+        auto a = std::make_unique<RecordingLog>();
+        added = a.get();
+        manager.addLog(std::move(a));
+        manager.flushLogs();
+    };
+    manager.addLog(std::make_unique<CallbackLog>(callback));
+
+    AsyncOptions options;
+    options.queueSize = 4;
+    options.overflowPolicy = OverflowPolicy::Block;
+    manager.startAsync(options);
+
+    manager.logMessage(LogLevel::Info, "cat", "trigger");
+    manager.logMessage(LogLevel::Info, "cat", "last");
+    manager.flushLogs();
+
+    const std::vector<Message> messages = l->recorded();
+    REQUIRE(messages.size() == NMessages + 3);
+    CHECK(messages[0].message == "trigger");
+    for (int i = 0; i < NMessages; i++) {
+        CHECK(messages[i + 1].message == std::to_string(i));
+    }
+    CHECK(messages[NMessages + 1].message == "fatal");
+    CHECK(messages[NMessages + 2].message == "last");
+
+    REQUIRE(added);
+    const std::vector<Message> addedMessages = added->recorded();
+    REQUIRE(addedMessages.size() == 1);
+    CHECK(addedMessages[0].message == "last");
+    CHECK(manager.messageCounter(LogLevel::Info) == NMessages + 2);
+    CHECK(manager.messageCounter(LogLevel::Fatal) == 1);
+}
+
+TEST_CASE("LogManager: Removing Log From Log", "[logmanager]") {
+    for (const bool isAsync : { false, true }) {
+        LogManager manager(LogLevel::Info);
+        std::atomic<int> nDestroyed = 0;
+        auto removing = std::make_unique<SelfRemovingLog>(manager, nDestroyed);
+        manager.addLog(std::move(removing));
+        auto log = std::make_unique<RecordingLog>();
+        RecordingLog* l = log.get();
+        manager.addLog(std::move(log));
+
+        if (isAsync) {
+            manager.startAsync();
+        }
+
+        manager.logMessage(LogLevel::Info, "cat", "first");
+        manager.logMessage(LogLevel::Info, "cat", "remove");
+        manager.flushLogs();
+
+        // The removed Log is destroyed once the message was written to all Logs, and
+        // the Log that follows it still receives the message
+        CHECK(nDestroyed == 1);
+        const std::vector<Message> messages = l->recorded();
+        REQUIRE(messages.size() == 2);
+        CHECK(messages[0].message == "first");
+        CHECK(messages[1].message == "remove");
+
+        manager.logMessage(LogLevel::Info, "cat", "last");
+        manager.flushLogs();
+        CHECK(l->recorded().size() == 3);
+    }
+}
+
+TEST_CASE("LogManager: Formatted", "[logmanager]") {
+    LogManager manager(LogLevel::Info);
+    auto log = std::make_unique<RecordingLog>();
+    RecordingLog* l = log.get();
+    manager.addLog(std::move(log));
+
+    int nEvaluated = 0;
+    auto evaluate = [&nEvaluated]() {
+        nEvaluated++;
+        return 1;
+    };
+
+    manager.logFormatted(LogLevel::Info, "cat", "{} {} {}", 1, 2.5, "abc");
+    if (LogLevel::Debug >= manager.logLevel()) {
+        manager.logFormatted(LogLevel::Debug, "cat", "{}", evaluate());
+    }
+
+    const std::vector<Message> messages = l->recorded();
+    REQUIRE(messages.size() == 1);
+    CHECK(messages[0].message == "1 2.5 abc");
+    CHECK(nEvaluated == 0);
+    CHECK(manager.messageCounter(LogLevel::Info) == 1);
+}
+
+TEST_CASE("LogManager: Formatted Asynchronous", "[logmanager]") {
+    LogManager manager(LogLevel::Info);
+    auto log = std::make_unique<RecordingLog>();
+    RecordingLog* l = log.get();
+    manager.addLog(std::move(log));
+    manager.startAsync();
+
+    // Hold the sink thread so that the arguments are formatted only after the original
+    // strings have been destroyed
+    l->isHeld = true;
+    manager.logMessage(LogLevel::Info, "cat", "first");
+    l->isWriting.wait(false);
+    {
+        std::string str = "temporary";
+        const char* cstr = str.c_str();
+        std::string_view sv = str;
+        manager.logFormatted(LogLevel::Info, "cat", "{} {} {}", str, cstr, sv);
+        str = "overwritten";
+    }
+    manager.logFormatted(LogLevel::Warning, "cat", "{:>4}|{:.2f}|{}", 42, 3.14159, true);
+    manager.logFormatted(LogLevel::Info, "cat", "no arguments");
+    manager.logFormatted(LogLevel::Info, "cat", "{}", std::vector<int>{ 1, 2 }.size());
+
+    l->isHeld = false;
+    l->isHeld.notify_all();
+    manager.flushLogs();
+
+    const std::vector<Message> messages = l->recorded();
+    REQUIRE(messages.size() == 5);
+    CHECK(messages[1].message == "temporary temporary temporary");
+    CHECK(messages[2].message == "  42|3.14|true");
+    CHECK(messages[2].level == LogLevel::Warning);
+    CHECK(messages[3].message == "no arguments");
+    CHECK(messages[4].message == "2");
+    CHECK(manager.messageCounter(LogLevel::Info) == 4);
+    CHECK(manager.messageCounter(LogLevel::Warning) == 1);
+}
+
+TEST_CASE("LogManager: Formatted Asynchronous Non-Owning", "[logmanager]") {
+    LogManager manager(LogLevel::Info);
+    auto log = std::make_unique<RecordingLog>();
+    RecordingLog* l = log.get();
+    manager.addLog(std::move(log));
+    manager.startAsync();
+
+    l->isHeld = true;
+    manager.logMessage(LogLevel::Info, "cat", "first");
+    l->isWriting.wait(false);
+
+    // A span does not own the values, so it has to be formatted before the buffer is
+    // overwritten
+    Sample buffer[] = { { 1 }, { 2 }, { 3 } };
+    manager.logFormatted(LogLevel::Info, "cat", "{}", std::span<const Sample>(buffer));
+    for (Sample& sample : buffer) {
+        sample.value = -1;
+    }
+
+    l->isHeld = false;
+    l->isHeld.notify_all();
+    manager.flushLogs();
+
+    const std::vector<Message> messages = l->recorded();
+    REQUIRE(messages.size() == 2);
+    CHECK(messages[1].message == "[1][2][3]");
+}
+
+TEST_CASE("LogManager: Formatted From Log", "[logmanager]") {
+    // Formats the arguments of the deferred messages it receives
+    class DeferredLog final : public Log {
+    public:
+        void log(LogLevel, std::string_view, std::string_view) override {}
+
+        void logDeferred(LogLevel, std::string_view, std::string_view,
+                         const DeferredMessage& deferred) override
+        {
+            messages.push_back(formatArguments(deferred.format, deferred.arguments));
+        }
+
+        std::vector<std::string> messages;
+    };
+
+    LogManager manager(LogLevel::Info);
+    auto callback = [&manager](std::string message) {
+        if (message.ends_with("outer 1")) {
+            manager.logFormatted(LogLevel::Info, "cat", "{} {}", "nested", 2);
+        }
+    };
+    manager.addLog(std::make_unique<CallbackLog>(callback));
+    auto log = std::make_unique<DeferredLog>();
+    DeferredLog* l = log.get();
+    manager.addLog(std::move(log));
+
+    // The nested message is logged while the arguments of the outer message are still
+    // passed to the second Log
+    manager.logFormatted(LogLevel::Info, "cat", "{} {}", "outer", 1);
+
+    REQUIRE(l->messages.size() == 2);
+    CHECK(l->messages[0] == "nested 2");
+    CHECK(l->messages[1] == "outer 1");
+}
+
+TEST_CASE("LogManager: Timestamp", "[logmanager]") {
+    std::string result;
+    CallbackLog log([&result](std::string message) { result = std::move(message); });
+    log.log(LogLevel::Info, "cat", "message");
+
+    // [YYYY-MM-DD | HH:MM:SS.mmm] cat (Info)\tmessage
+    const std::regex format(
+        R"(\[\d{4}-\d{2}-\d{2} \| \d{2}:\d{2}:\d{2}\.\d{3}\] cat \(Info\)\tmessage)"
+    );
+    CHECK(std::regex_match(result, format));
+}
+
+TEST_CASE("LogManager: Log Category", "[logmanager]") {
+    const LogCategory a("LogManagerTest.A");
+    const LogCategory b("LogManagerTest.B");
+    const LogCategory a2(std::string("LogManagerTest.") + "A");
+
+    CHECK(a.id() == a2.id());
+    CHECK(a.id() != b.id());
+    CHECK(a.name() == "LogManagerTest.A");
+    CHECK(std::string_view(b) == "LogManagerTest.B");
+    CHECK(LogCategory::find("LogManagerTest.A") == a.id());
+    CHECK_FALSE(LogCategory::find("LogManagerTest.NotInterned").has_value());
+}
+
+TEST_CASE("LogManager: Category Levels", "[logmanager]") {
+    LogManager manager(LogLevel::Info);
+    auto log = std::make_unique<RecordingLog>();
+    RecordingLog* l = log.get();
+    manager.addLog(std::move(log));
+
+    const LogCategory noisy("LogManagerTest.Noisy");
+    CHECK(manager.isEnabled(LogLevel::Info, noisy));
+    CHECK_FALSE(manager.isEnabled(LogLevel::Debug, "LogManagerTest.Verbose"));
+
+    manager.setCategoryLevel("LogManagerTest.Noisy", LogLevel::Error);
+    manager.setCategoryLevel("LogManagerTest.Verbose", LogLevel::Debug);
+
+    CHECK_FALSE(manager.isEnabled(LogLevel::Warning, noisy));
+    CHECK_FALSE(manager.isEnabled(LogLevel::Warning, "LogManagerTest.Noisy"));
+    CHECK(manager.isEnabled(LogLevel::Error, noisy));
+    CHECK(manager.isEnabled(LogLevel::Debug, "LogManagerTest.Verbose"));
+    CHECK_FALSE(manager.isEnabled(LogLevel::Trace, "LogManagerTest.Verbose"));
+    // Categories without their own level still use the level of the manager
+    CHECK(manager.isEnabled(LogLevel::Info, "LogManagerTest.Other"));
+    CHECK_FALSE(manager.isEnabled(LogLevel::Debug, "LogManagerTest.Other"));
+
+    manager.logMessage(LogLevel::Warning, noisy, "silenced");
+    manager.logMessage(LogLevel::Error, noisy, "error");
+    manager.logMessage(LogLevel::Debug, "LogManagerTest.Verbose", "debug");
+    manager.logFormatted(LogLevel::Info, "LogManagerTest.Noisy", "{}", "silenced");
+
+    std::vector<Message> messages = l->recorded();
+    REQUIRE(messages.size() == 2);
+    CHECK(messages[0].message == "error");
+    CHECK(messages[1].message == "debug");
+
+    manager.resetCategoryLevel("LogManagerTest.Noisy");
+    manager.resetCategoryLevel("LogManagerTest.NeverSet");
+    CHECK(manager.isEnabled(LogLevel::Warning, noisy));
+    CHECK(manager.isEnabled(LogLevel::Debug, "LogManagerTest.Verbose"));
+
+    manager.resetCategoryLevel("LogManagerTest.Verbose");
+    CHECK_FALSE(manager.isEnabled(LogLevel::Debug, "LogManagerTest.Verbose"));
+}
+
+TEST_CASE("LogManager: Category Level Lookup Cache", "[logmanager]") {
+    LogManager manager(LogLevel::Info);
+    manager.setCategoryLevel("LogManagerTest.CacheA", LogLevel::Error);
+
+    // Names are cached by their address, so a different name in the same buffer must not
+    // use the cached result of the previous name
+    std::string name = "LogManagerTest.CacheA";
+    const char* data = name.data();
+    CHECK_FALSE(manager.isEnabled(LogLevel::Warning, name));
+    name = "LogManagerTest.CacheB";
+    REQUIRE(name.data() == data);
+    CHECK(manager.isEnabled(LogLevel::Warning, name));
+
+    // A name that was not interned when it was looked up is found once it is interned
+    manager.setCategoryLevel("LogManagerTest.CacheB", LogLevel::Error);
+    CHECK_FALSE(manager.isEnabled(LogLevel::Warning, name));
+}
+
+TEST_CASE("LogManager: Macros", "[logmanager]") {
+    auto log = std::make_unique<RecordingLog>();
+    RecordingLog* l = log.get();
+    LogMgr.addLog(std::move(log));
+    LogMgr.setCategoryLevel("LogManagerTest.Macros", LogLevel::Info);
+
+    // The category is used to check whether the message is enabled and to log it, but
+    // must only be evaluated once
+    int nEvaluated = 0;
+    auto category = [&nEvaluated]() {
+        nEvaluated++;
+        return std::string("LogManagerTest.Macros");
+    };
+    LINFOC(category(), "message");
+    LINFOFC(category(), "{} {}", "formatted", 1);
+    CHECK(nEvaluated == 2);
+
+    const LogCategory interned("LogManagerTest.Macros");
+    LINFOC(interned, "interned");
+
+    const std::vector<Message> messages = l->recorded();
+    LogMgr.resetCategoryLevel("LogManagerTest.Macros");
+    LogMgr.removeLog(l);
+
+    REQUIRE(messages.size() == 3);
+    CHECK(messages[0].message == "message");
+    CHECK(messages[0].category == "LogManagerTest.Macros");
+    CHECK(messages[1].message == "formatted 1");
+    CHECK(messages[2].message == "interned");
+}
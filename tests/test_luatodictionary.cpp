@@ -25,10 +25,13 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/lua/lua_helper.h>
 #include <ghoul/lua/luastate.h>
 #include <ghoul/misc/dictionary.h>
+#include <ghoul/misc/defer.h>
+#include <ghoul/misc/dictionarybinaryformat.h>
 #include <ghoul/glm.h>
 #include <fstream>
 #include <sstream>
@@ -106,3 +109,36 @@ TEST_CASE("LuaToDictionary: Nested Tables 2", "[luatodictionary]") {
     const ghoul::Dictionary d = ghoul::lua::value<ghoul::Dictionary>(state);
     CHECK(d.hasValue<ghoul::Dictionary>("Server"));
 }
+
+TEST_CASE("LuaToDictionary: Cached File", "[luatodictionary]") {
+    const std::filesystem::path cache = absPath("${TEMPORARY}/luatodictionarycache");
+    std::filesystem::create_directories(cache);
+
+    // The CacheManager must not outlive this test even if one of the checks fails
+    REQUIRE_FALSE(FileSys.cacheManager());
+    FileSys.createCacheManager(cache);
+    defer {
+        FileSys.destroyCacheManager();
+        std::filesystem::remove_all(cache);
+    };
+
+    const std::filesystem::path file = absPath("${UNIT_TEST}/luatodictionary/test3.cfg");
+    const ghoul::Dictionary d = ghoul::lua::loadDictionaryFromFileCached(file);
+    CHECK(d == ghoul::lua::loadDictionaryFromFile(file));
+
+    const std::filesystem::path cached = FileSys.cacheManager()->cachedFilename(
+        file,
+        std::nullopt,
+        "dictionaries"
+    );
+    REQUIRE(std::filesystem::is_regular_file(cached));
+    CHECK(ghoul::loadBinaryFile(cached) == d);
+
+    // Replace the cached file to detect whether the second call is served from the
+    // cache rather than from executing the script again
+    ghoul::Dictionary marker;
+    marker.setValue("Cached", true);
+    ghoul::saveBinaryFile(marker, cached);
+    const ghoul::Dictionary e = ghoul::lua::loadDictionaryFromFileCached(file);
+    CHECK(e == marker);
+}
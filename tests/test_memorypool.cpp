@@ -24,8 +24,20 @@
  ****************************************************************************************/
 
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 
+#include <ghoul/format.h>
 #include <ghoul/misc/memorypool.h>
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <memory_resource>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
 
 TEST_CASE("MemoryPool: MemoryPool Default", "[memorypool]") {
     ghoul::MemoryPool<> pool;
@@ -159,46 +171,66 @@ TEST_CASE("MemoryPool: MemoryPool 2048 Bucket Pre-Alloc", "[memorypool]") {
 TEST_CASE("MemoryPool: MemoryPool 2048 Reusing pointers", "[memorypool]") {
     ghoul::MemoryPool<2048> pool;
 
-    const unsigned long long alignment = alignof(max_align_t);
-    // For the rest:  X used memory; O memory allocated due to alignment; F free memory
-
+    // For the rest:  X used memory; F free memory
     CHECK(pool.totalOccupancy() == 0);
-    void* p1 = pool.allocate(16);
-    //   8 byte alignment:   XXXXXXXX|XXXXXXXX                                      -> 16
-    //  16 byte alignment:   XXXXXXXX XXXXXXXX                                      -> 16
+    void* p1 = pool.allocate(16, 8);
+    //  XXXXXXXX|XXXXXXXX                                                           -> 16
     CHECK(pool.totalOccupancy() == 16);
-    
-    void* p2 = pool.allocate(8);
-    //   8 byte alignment:   XXXXXXXX|XXXXXXXX|XXXXXXXX                             -> 24
-    //  16 byte alignment:   OOOOOOOO XXXXXXXX|XXXXXXXX XXXXXXXX                    -> 32
-    CHECK(pool.totalOccupancy() == (alignment == 8 ? 24 : 32));
-
-    pool.deallocate(p1, 16);
-    //   8 byte alignment:   FFFFFFFF|FFFFFFFF|XXXXXXXX                             -> 24
-    //  16 byte alignment:   FFFFFFFF FFFFFFFF|FFFFFFFF XXXXXXXX                    -> 32
-    CHECK(pool.totalOccupancy() == (alignment == 8 ? 24 : 32));
-
-    void* p3 = pool.allocate(8);
-    //   8 byte alignment:   FFFFFFFF|XXXXXXXX|XXXXXXXX                             -> 24
-    //  16 byte alignment:   FFFFFFFF FFFFFFFF|XXXXXXXX XXXXXXXX                    -> 32
-    CHECK(pool.totalOccupancy() == (alignment == 8 ? 24 : 32));
-
-    void* p4 = pool.allocate(8);
-    //   8 byte alignment:   XXXXXXXX|XXXXXXXX|XXXXXXXX                             -> 24
-    //  16 byte alignment:   OOOOOOOO XXXXXXXX|XXXXXXXX XXXXXXXX                    -> 32
-    CHECK(pool.totalOccupancy() == (alignment == 8 ? 24 : 32));
-
-    void* p5 = pool.allocate(8);
-    //   8 byte alignment:   XXXXXXXX|XXXXXXXX|XXXXXXXX|XXXXXXXX                    -> 24
-    //  16 byte alignment:   OOOOOOOO XXXXXXXX|OOOOOOOO XXXXXXXX|XXXXXXXX XXXXXXXX  -> 48
-    CHECK(pool.totalOccupancy() == (alignment == 8 ? 32 : 48));
-    
+
+    void* p2 = pool.allocate(8, 8);
+    //  XXXXXXXX|XXXXXXXX|XXXXXXXX                                                  -> 24
+    CHECK(pool.totalOccupancy() == 24);
+
+    pool.deallocate(p1, 16, 8);
+    //  FFFFFFFF|FFFFFFFF|XXXXXXXX                                                  -> 24
+    CHECK(pool.totalOccupancy() == 24);
+
+    void* p3 = pool.allocate(8, 8);
+    //  XXXXXXXX|FFFFFFFF|XXXXXXXX                                                  -> 24
+    CHECK(pool.totalOccupancy() == 24);
+
+    void* p4 = pool.allocate(8, 8);
+    //  XXXXXXXX|XXXXXXXX|XXXXXXXX                                                  -> 24
+    CHECK(pool.totalOccupancy() == 24);
+
+    void* p5 = pool.allocate(8, 8);
+    //  XXXXXXXX|XXXXXXXX|XXXXXXXX|XXXXXXXX                                         -> 32
+    CHECK(pool.totalOccupancy() == 32);
+
     CHECK(reinterpret_cast<intptr_t>(p1) == reinterpret_cast<intptr_t>(p3));
     CHECK(reinterpret_cast<intptr_t>(p4) == reinterpret_cast<intptr_t>(p3) + 8);
     CHECK(reinterpret_cast<intptr_t>(p2) > reinterpret_cast<intptr_t>(p4));
     CHECK(reinterpret_cast<intptr_t>(p5) > reinterpret_cast<intptr_t>(p2));
 }
 
+TEST_CASE("MemoryPool: MemoryPool Alignment", "[memorypool]") {
+    ghoul::MemoryPool<4096> pool;
+    std::vector<std::pair<void*, size_t>> blocks;
+    for (size_t alignment : { 8, 64, 16, 256, 8, 32 }) {
+        void* p = pool.allocate(24, alignment);
+        CHECK(reinterpret_cast<uintptr_t>(p) % alignment == 0);
+        blocks.emplace_back(p, alignment);
+    }
+
+    // Once everything is returned, the padding has been merged with the blocks into a
+    // single free block that covers all used memory
+    for (const auto& [p, alignment] : blocks) {
+        pool.deallocate(p, 24, alignment);
+    }
+    using Statistics = ghoul::MemoryPool<4096>::FragmentationStatistics;
+    const Statistics stats = pool.fragmentationStatistics();
+    CHECK(stats.nFreeBlocks == 1);
+    CHECK(stats.freeBytes == pool.totalOccupancy());
+
+    // Reusing the free memory respects the alignment and doesn't need new memory
+    const int occupancy = pool.totalOccupancy();
+    for (size_t alignment : { 8, 128, 32, 64 }) {
+        void* p = pool.allocate(40, alignment);
+        CHECK(reinterpret_cast<uintptr_t>(p) % alignment == 0);
+    }
+    CHECK(pool.totalOccupancy() == occupancy);
+}
+
 TEST_CASE("MemoryPool: MemoryPool Reusing pointers w/o fragmentation", "[memorypool]") {
     constexpr unsigned long long alignment = alignof(max_align_t);
     if constexpr (alignment == 8) {
@@ -214,8 +246,8 @@ TEST_CASE("MemoryPool: MemoryPool Reusing pointers w/o fragmentation", "[memoryp
         pool.deallocate(p1, 8);
         pool.deallocate(p2, 8);
 
-        // The call to housekeeping will merge those two deallocated and make it possible
-        // to allocate a 16 byte block in the place of the 2 8-byte blocks
+        // The two deallocated blocks are merged, which makes it possible to allocate a
+        // 16 byte block in the place of the 2 8-byte blocks
         pool.housekeeping();
 
         void* p5 = pool.allocate(16);
@@ -238,8 +270,8 @@ TEST_CASE("MemoryPool: MemoryPool Reusing pointers w/o fragmentation", "[memoryp
         pool.deallocate(p1, 16);
         pool.deallocate(p2, 16);
 
-        // The call to housekeeping will merge those two deallocated and make it possible
-        // to allocate a 32 byte block in the place of the 2 16-byte blocks
+        // The two deallocated blocks are merged, which makes it possible to allocate a
+        // 32 byte block in the place of the 2 16-byte blocks
         pool.housekeeping();
 
         void* p5 = pool.allocate(32);
@@ -252,6 +284,141 @@ TEST_CASE("MemoryPool: MemoryPool Reusing pointers w/o fragmentation", "[memoryp
     }
 }
 
+TEST_CASE("MemoryPool: MemoryPool Fragmentation Statistics", "[memorypool]") {
+    ghoul::MemoryPool<1024> pool;
+    std::vector<void*> blocks;
+    for (int i = 0; i < 8; i++) {
+        blocks.push_back(pool.allocate(64));
+    }
+    CHECK(pool.fragmentationStatistics().nFreeBlocks == 0);
+    CHECK(pool.fragmentationStatistics().fragmentation == 0.0);
+
+    // Every other block is returned, so none of them can be merged
+    for (int i = 0; i < 8; i += 2) {
+        pool.deallocate(blocks[i], 64);
+    }
+    using Statistics = ghoul::MemoryPool<1024>::FragmentationStatistics;
+    Statistics stats = pool.fragmentationStatistics();
+    CHECK(stats.nFreeBlocks == 4);
+    CHECK(stats.freeBytes == 256);
+    CHECK(stats.largestFreeBlock == 64);
+    CHECK(stats.fragmentation == 0.75);
+
+    // Returning the blocks in between merges all of them into a single block
+    for (int i = 1; i < 8; i += 2) {
+        pool.deallocate(blocks[i], 64);
+    }
+    stats = pool.fragmentationStatistics();
+    CHECK(stats.nFreeBlocks == 1);
+    CHECK(stats.freeBytes == 512);
+    CHECK(stats.largestFreeBlock == 512);
+    CHECK(stats.fragmentation == 0.0);
+    CHECK(pool.totalOccupancy() == 512);
+
+    void* p = pool.allocate(512);
+    CHECK(p == blocks[0]);
+    CHECK(pool.fragmentationStatistics().nFreeBlocks == 0);
+
+    CHECK_THROWS(pool.deallocate(&stats, 8));
+}
+
+TEST_CASE("MemoryPool: MemoryPool Runtime Bucket Size", "[memorypool]") {
+    ghoul::MemoryPool<> pool(2, 8192);
+    CHECK(pool.bucketSize() == 8192);
+    CHECK(pool.nBuckets() == 2);
+
+    void* p1 = pool.allocate(8192);
+    std::memset(p1, 0xB0, 8192);
+    void* p2 = pool.allocate(6144);
+    std::memset(p2, 0xB1, 6144);
+    CHECK(pool.nBuckets() == 2);
+    REQUIRE(pool.occupancies().size() == 2);
+    CHECK(pool.occupancies()[0] == 8192);
+    CHECK(pool.occupancies()[1] == 6144);
+
+    // The rest of the second bucket is returned to the free lists when the block does
+    // not fit anymore, so it counts as occupied and smaller blocks can still use it
+    void* p3 = pool.allocate(4096);
+    std::memset(p3, 0xB2, 4096);
+    CHECK(pool.nBuckets() == 3);
+    CHECK(pool.totalOccupancy() == 20480);
+    CHECK(pool.allocate(2048) == static_cast<std::byte*>(p2) + 6144);
+
+    pool.deallocate(p3, 4096);
+    CHECK(pool.allocate(4096) == p3);
+    CHECK_THROWS(pool.deallocate(static_cast<std::byte*>(p1) + 8192, 16));
+
+    pool.reset();
+    CHECK(pool.nBuckets() == 2);
+    CHECK(pool.totalOccupancy() == 0);
+}
+
+TEST_CASE("MemoryPool: MemoryPool Page Backing", "[memorypool]") {
+    constexpr size_t BucketSize = 2 * 1024 * 1024;
+
+    for (ghoul::BucketBacking backing :
+         { ghoul::BucketBacking::Heap, ghoul::BucketBacking::Pages,
+           ghoul::BucketBacking::HugePages })
+    {
+        ghoul::MemoryPool<> pool(1, BucketSize, backing);
+        CHECK(pool.backing() == backing);
+        if (backing != ghoul::BucketBacking::HugePages) {
+            CHECK(pool.nHugePageBuckets() == 0);
+        }
+
+        std::vector<void*> blocks;
+        for (int i = 0; i < 3; i++) {
+            void* p = pool.allocate(BucketSize / 2);
+            std::memset(p, i, BucketSize / 2);
+            blocks.push_back(p);
+        }
+        CHECK(pool.nBuckets() == 2);
+        CHECK(pool.totalOccupancy() == static_cast<int>(3 * BucketSize / 2));
+        if (backing != ghoul::BucketBacking::Heap) {
+            // Mapped buckets always start at a page boundary
+            CHECK(reinterpret_cast<uintptr_t>(blocks[0]) % 4096 == 0);
+            CHECK(reinterpret_cast<uintptr_t>(blocks[2]) % 4096 == 0);
+        }
+
+        pool.deallocate(blocks[1], BucketSize / 2);
+        CHECK(pool.allocate(BucketSize / 2) == blocks[1]);
+    }
+}
+
+TEST_CASE("MemoryPool: Benchmark Random Access", "[.][memorypool][benchmark]") {
+    constexpr size_t BucketSize = 2 * 1024 * 1024;
+    constexpr size_t BlockSize = 64;
+    constexpr size_t TotalSize = 256 * 1024 * 1024;
+
+    // The blocks are spread over many buckets and accessed in a random order, so nearly
+    // every access touches a different page, which stresses the TLB
+    std::vector<size_t> order(TotalSize / BlockSize);
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::shuffle(order.begin(), order.end(), std::mt19937(1337));
+
+    for (auto [backing, name] : {
+            std::pair(ghoul::BucketBacking::Heap, "heap"),
+            std::pair(ghoul::BucketBacking::Pages, "pages"),
+            std::pair(ghoul::BucketBacking::HugePages, "huge pages")
+        })
+    {
+        ghoul::MemoryPool<> pool(0, BucketSize, backing);
+        std::vector<std::byte*> blocks(order.size());
+        for (std::byte*& b : blocks) {
+            b = static_cast<std::byte*>(pool.allocate(BlockSize));
+            std::memset(b, 1, BlockSize);
+        }
+
+        BENCHMARK(std::format("Random access {}", name)) {
+            size_t sum = 0;
+            for (size_t i : order) {
+                sum += static_cast<size_t>(*blocks[i]);
+            }
+            return sum;
+        };
+    }
+}
+
 TEST_CASE("MemoryPool: Reusable Typed MemoryPool", "[memorypool]") {
     ghoul::ReusableTypedMemoryPool<int> pool;
     std::vector<void*> p1 = pool.allocate(2);
@@ -301,3 +468,294 @@ TEST_CASE("MemoryPool: Reusable Typed MemoryPool Reuse", "[memorypool]") {
     CHECK(p4[0] == p1[0]);
     CHECK(p4[1] == p1[1]);
 }
+
+TEST_CASE("MemoryPool: Reusable Typed MemoryPool Objects", "[memorypool]") {
+    struct Object {
+        Object(int v, int* c) : value(v), counter(c) { (*counter)++; }
+        ~Object() { (*counter)--; }
+
+        int value;
+        int* counter;
+    };
+
+    int nAlive = 0;
+    ghoul::ReusableTypedMemoryPool<Object, 4> pool;
+    Object* o1 = pool.create(1, &nAlive);
+    Object* o2 = pool.create(2, &nAlive);
+    CHECK(nAlive == 2);
+    CHECK(o1->value == 1);
+    CHECK(o2->value == 2);
+
+    pool.destroy(o1);
+    CHECK(nAlive == 1);
+    Object* o3 = pool.create(3, &nAlive);
+    CHECK(o3 == o1);
+    CHECK(o3->value == 3);
+
+    // Creating more objects than fit into a bucket spreads them over multiple buckets
+    std::array<Object*, 10> objects;
+    pool.createN(objects, 4, &nAlive);
+    CHECK(nAlive == 12);
+    for (Object* o : objects) {
+        CHECK(o->value == 4);
+        CHECK(o != o2);
+        CHECK(o != o3);
+    }
+
+    pool.destroyN(objects);
+    CHECK(nAlive == 2);
+    pool.destroy(o2);
+    pool.destroy(o3);
+    CHECK(nAlive == 0);
+}
+
+TEST_CASE("MemoryPool: Reusable Typed MemoryPool Slots", "[memorypool]") {
+    ghoul::ReusableTypedMemoryPool<int> pool;
+    std::array<int*, 3> slots;
+    pool.allocate(slots);
+    CHECK(slots[0] != slots[1]);
+    CHECK(slots[1] != slots[2]);
+
+    pool.free(slots);
+    std::array<int*, 3> reused;
+    pool.allocate(reused);
+    CHECK(reused == slots);
+}
+
+TEST_CASE("MemoryPool: Reusable Typed MemoryPool Handles", "[memorypool]") {
+    ghoul::ReusableTypedMemoryPool<std::string> pool;
+    using Handle = ghoul::ReusableTypedMemoryPool<std::string>::Handle;
+
+    Handle h1 = pool.createHandle("abc");
+    CHECK(pool.isValid(h1));
+    CHECK(*pool.get(h1) == "abc");
+    CHECK_FALSE(pool.isValid(Handle()));
+
+    pool.destroy(h1);
+    CHECK_FALSE(pool.isValid(h1));
+
+    // The slot is reused, but the old handle stays invalid
+    Handle h2 = pool.createHandle("def");
+    CHECK(h2.ptr == h1.ptr);
+    CHECK(pool.isValid(h2));
+    CHECK_FALSE(pool.isValid(h1));
+
+    pool.destroy(pool.get(h2));
+    CHECK_FALSE(pool.isValid(h2));
+}
+
+TEST_CASE("MemoryPool: Reusable Typed MemoryPool Handles Reset", "[memorypool]") {
+    ghoul::ReusableTypedMemoryPool<int> pool;
+    using Handle = ghoul::ReusableTypedMemoryPool<int>::Handle;
+
+    Handle h1 = pool.createHandle(1);
+    CHECK(pool.isValid(h1));
+
+    // Handles that were created before a reset stay invalid even if the slot is reused
+    pool.reset();
+    CHECK_FALSE(pool.isValid(h1));
+    Handle h2 = pool.createHandle(2);
+    CHECK(h2.ptr == h1.ptr);
+    CHECK(pool.isValid(h2));
+    CHECK_FALSE(pool.isValid(h1));
+}
+
+TEST_CASE("MemoryPool: Reusable Typed MemoryPool Handles Reset Buckets", "[memorypool]") {
+    ghoul::ReusableTypedMemoryPool<int, 4> pool;
+    using Handle = ghoul::ReusableTypedMemoryPool<int, 4>::Handle;
+
+    // The handles are spread over three buckets, two of which are freed by the reset
+    std::vector<Handle> handles;
+    for (int i = 0; i < 10; i++) {
+        handles.push_back(pool.createHandle(i));
+    }
+    for (const Handle& h : handles) {
+        CHECK(pool.isValid(h));
+    }
+
+    pool.reset();
+    for (const Handle& h : handles) {
+        CHECK_FALSE(pool.isValid(h));
+    }
+
+    Handle h = pool.createHandle(10);
+    CHECK(pool.isValid(h));
+    CHECK(*pool.get(h) == 10);
+}
+
+TEST_CASE("MemoryPool: Concurrent MemoryPool", "[memorypool]") {
+    ghoul::ConcurrentMemoryPool<> pool;
+    CHECK(pool.nBuckets() == 0);
+
+    void* p1 = pool.allocate(24);
+    void* p2 = pool.allocate(24);
+    CHECK(p1 != p2);
+    CHECK(pool.nBuckets() == 1);
+    CHECK(pool.nThreadCaches() == 1);
+    std::memset(p1, 0xB0, 24);
+    std::memset(p2, 0xB1, 24);
+
+    // Memory that was returned on the same thread is reused right away
+    pool.deallocate(p1, 24);
+    void* p3 = pool.allocate(32);
+    CHECK(p3 == p1);
+
+    void* aligned = pool.allocate(64, 64);
+    CHECK(reinterpret_cast<uintptr_t>(aligned) % 64 == 0);
+    CHECK(pool.nBuckets() == 2);
+
+    // Allocations that are bigger than a block are passed on to operator new
+    constexpr size_t Large = ghoul::ConcurrentMemoryPool<>::MaxBlockSize + 1;
+    void* large = pool.allocate(Large);
+    std::memset(large, 0xB2, Large);
+    CHECK(pool.nBuckets() == 2);
+    pool.deallocate(large, Large);
+
+    std::pmr::vector<int> vector(&pool);
+    for (int i = 0; i < 1000; i++) {
+        vector.push_back(i);
+    }
+    CHECK(vector[999] == 999);
+
+    pool.deallocate(p2, 24);
+    pool.deallocate(p3, 32);
+    pool.deallocate(aligned, 64, 64);
+}
+
+TEST_CASE("MemoryPool: Concurrent MemoryPool Multithreaded", "[memorypool]") {
+    constexpr int NThreads = 8;
+    constexpr int NAllocations = 10000;
+
+    ghoul::ConcurrentMemoryPool<4096> pool;
+
+    // Each thread allocates blocks and passes them on to the next thread, which
+    // deallocates them, so that every block is returned by a thread that does not own it
+    std::vector<std::vector<int*>> blocks(NThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NThreads; t++) {
+        threads.emplace_back([&pool, &blocks, t]() {
+            for (int i = 0; i < NAllocations; i++) {
+                int* p = static_cast<int*>(pool.allocate(sizeof(int) * (1 + i % 8)));
+                *p = t * NAllocations + i;
+                blocks[t].push_back(p);
+            }
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    threads.clear();
+
+    for (int t = 0; t < NThreads; t++) {
+        threads.emplace_back([&pool, &blocks, t]() {
+            const std::vector<int*>& b = blocks[(t + 1) % NThreads];
+            for (int i = 0; i < NAllocations; i++) {
+                CHECK(*b[i] == ((t + 1) % NThreads) * NAllocations + i);
+                pool.deallocate(b[i], sizeof(int) * (1 + i % 8));
+            }
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    CHECK(pool.nThreadCaches() <= NThreads);
+}
+
+TEST_CASE("MemoryPool: Concurrent MemoryPool Reuse", "[memorypool]") {
+    constexpr int NAllocations = 10000;
+
+    ghoul::ConcurrentMemoryPool<4096> pool;
+    std::vector<void*> blocks;
+    std::thread([&pool, &blocks]() {
+        for (int i = 0; i < NAllocations; i++) {
+            blocks.push_back(pool.allocate(16));
+        }
+    }).join();
+    const int nBuckets = pool.nBuckets();
+    CHECK(pool.nThreadCaches() == 1);
+
+    // Deallocating on a thread that never allocated does not create a new cache
+    for (void* p : blocks) {
+        pool.deallocate(p, 16);
+    }
+    CHECK(pool.nThreadCaches() == 1);
+
+    // The cache of the terminated thread is adopted by a new thread, which reuses the
+    // blocks that were returned on the main thread
+    std::thread([&pool]() {
+        for (int i = 0; i < NAllocations; i++) {
+            pool.allocate(16);
+        }
+    }).join();
+    CHECK(pool.nThreadCaches() == 1);
+    CHECK(pool.nBuckets() == nBuckets);
+}
+
+TEST_CASE("MemoryPool: Benchmark Concurrent Allocation", "[.][memorypool][benchmark]") {
+    constexpr int NAllocations = 100000;
+
+    // Each thread allocates a number of blocks of different sizes and frees half of them
+    // on the same thread and the other half on a different thread
+    auto run = [](int nThreads, auto allocate, auto deallocate) {
+        std::vector<std::vector<void*>> blocks(nThreads);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < nThreads; t++) {
+            threads.emplace_back([&, t]() {
+                blocks[t].reserve(NAllocations / 2);
+                for (int i = 0; i < NAllocations; i++) {
+                    const size_t size = 16 + 8 * (i % 16);
+                    void* p = allocate(size);
+                    if (i % 2 == 0) {
+                        deallocate(p, size);
+                    }
+                    else {
+                        blocks[t].push_back(p);
+                    }
+                }
+            });
+        }
+        for (std::thread& t : threads) {
+            t.join();
+        }
+        threads.clear();
+        for (int t = 0; t < nThreads; t++) {
+            threads.emplace_back([&, t]() {
+                const std::vector<void*>& b = blocks[(t + 1) % nThreads];
+                for (size_t i = 0; i < b.size(); i++) {
+                    deallocate(b[i], 16 + 8 * ((2 * i + 1) % 16));
+                }
+            });
+        }
+        for (std::thread& t : threads) {
+            t.join();
+        }
+    };
+
+    for (int nThreads : { 1, 2, 4, 8, 16 }) {
+        ghoul::ConcurrentMemoryPool<> concurrent;
+        BENCHMARK(std::format("ConcurrentMemoryPool {} threads", nThreads)) {
+            run(
+                nThreads,
+                [&](size_t size) { return concurrent.allocate(size); },
+                [&](void* p, size_t size) { concurrent.deallocate(p, size); }
+            );
+        };
+
+        std::pmr::synchronized_pool_resource synchronized;
+        BENCHMARK(std::format("synchronized_pool_resource {} threads", nThreads)) {
+            run(
+                nThreads,
+                [&](size_t size) { return synchronized.allocate(size); },
+                [&](void* p, size_t size) { synchronized.deallocate(p, size); }
+            );
+        };
+
+        BENCHMARK(std::format("malloc {} threads", nThreads)) {
+            run(
+                nThreads,
+                [](size_t size) { return std::malloc(size); },
+                [](void* p, size_t) { std::free(p); }
+            );
+        };
+    }
+}
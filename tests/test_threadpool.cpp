@@ -0,0 +1,599 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * GHOUL                                                                                 *
+ * General Helpful Open Utility Library                                                  *
+ *                                                                                       *
+ * Copyright (c) 2012-2026                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <ghoul/format.h>
+#include <ghoul/misc/exception.h>
+#include <ghoul/misc/threadpool.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef WIN32
+#include <Windows.h>
+#else // ^^^^ WIN32 // !WIN32 vvvv
+#include <sys/resource.h>
+#endif // WIN32
+
+namespace {
+    using WorkStealing = ghoul::ThreadPool::WorkStealing;
+
+    ghoul::ThreadPool createPool(int nThreads, WorkStealing workStealing) {
+        return ghoul::ThreadPool(
+            nThreads,
+            []() {},
+            []() {},
+            ghoul::thread::ThreadPriorityClass::Normal,
+            ghoul::thread::ThreadPriorityLevel::Normal,
+            ghoul::thread::Background::No,
+            workStealing
+        );
+    }
+
+    void waitFor(const std::atomic_int& counter, int value) {
+        while (counter < value) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Returns the CPU time that was consumed by all threads of this process so far
+    std::chrono::microseconds processCpuTime() {
+#ifdef WIN32
+        FILETIME creation;
+        FILETIME exit;
+        FILETIME kernel;
+        FILETIME user;
+        GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+        auto toMicroseconds = [](const FILETIME& t) {
+            const uint64_t v = (uint64_t(t.dwHighDateTime) << 32) | t.dwLowDateTime;
+            // FILETIME is measured in 100 ns intervals
+            return std::chrono::microseconds(v / 10);
+        };
+        return toMicroseconds(kernel) + toMicroseconds(user);
+#else // ^^^^ WIN32 // !WIN32 vvvv
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        auto toMicroseconds = [](const timeval& t) {
+            return std::chrono::seconds(t.tv_sec) + std::chrono::microseconds(t.tv_usec);
+        };
+        return toMicroseconds(usage.ru_utime) + toMicroseconds(usage.ru_stime);
+#endif // WIN32
+    }
+} // namespace
+
+TEST_CASE("ThreadPool: Return Values", "[threadpool]") {
+    for (WorkStealing ws : { WorkStealing::No, WorkStealing::Yes }) {
+        ghoul::ThreadPool pool = createPool(2, ws);
+
+        std::future<int> ret = pool.queue([]() { return 1337; });
+        std::future<std::string> urn = pool.queue([]() { return std::string("foobar"); });
+        std::future<int> sum = pool.queue([](int a, int b) { return a + b; }, 1, 2);
+        CHECK(ret.get() == 1337);
+        CHECK(urn.get() == "foobar");
+        CHECK(sum.get() == 3);
+    }
+}
+
+TEST_CASE("ThreadPool: All Tasks Finish", "[threadpool]") {
+    constexpr int NTasks = 10000;
+
+    for (WorkStealing ws : { WorkStealing::No, WorkStealing::Yes }) {
+        std::atomic_int counter = 0;
+        {
+            ghoul::ThreadPool pool = createPool(4, ws);
+            for (int i = 0; i < NTasks; i++) {
+                pool.queue([&counter]() { counter++; });
+            }
+            // The destructor waits for all remaining tasks
+        }
+        CHECK(counter == NTasks);
+    }
+}
+
+TEST_CASE("ThreadPool: Nested Tasks", "[threadpool]") {
+    constexpr int NOuter = 64;
+    constexpr int NInner = 64;
+
+    for (WorkStealing ws : { WorkStealing::No, WorkStealing::Yes }) {
+        ghoul::ThreadPool pool = createPool(4, ws);
+        std::atomic_int counter = 0;
+        for (int i = 0; i < NOuter; i++) {
+            pool.queue([&pool, &counter]() {
+                for (int j = 0; j < NInner; j++) {
+                    pool.queue([&counter]() { counter++; });
+                }
+            });
+        }
+        waitFor(counter, NOuter * NInner);
+        CHECK(counter == NOuter * NInner);
+        CHECK(pool.remainingTasks() == 0);
+    }
+}
+
+TEST_CASE("ThreadPool: Resize Keeps Tasks", "[threadpool]") {
+    constexpr int NTasks = 1000;
+
+    for (WorkStealing ws : { WorkStealing::No, WorkStealing::Yes }) {
+        ghoul::ThreadPool pool = createPool(8, ws);
+        std::atomic_int counter = 0;
+        for (int i = 0; i < NTasks; i++) {
+            pool.queue([&pool, &counter]() {
+                pool.queue([&counter]() { counter++; });
+            });
+        }
+        pool.resize(2);
+        CHECK(pool.size() == 2);
+        waitFor(counter, NTasks);
+        CHECK(counter == NTasks);
+    }
+}
+
+TEST_CASE("ThreadPool: Clear Remaining Tasks", "[threadpool]") {
+    for (WorkStealing ws : { WorkStealing::No, WorkStealing::Yes }) {
+        ghoul::ThreadPool pool = createPool(1, ws);
+        std::promise<void> blocker;
+        std::shared_future<void> block = blocker.get_future().share();
+        pool.queue([block]() { block.wait(); });
+
+        std::atomic_int counter = 0;
+        for (int i = 0; i < 10; i++) {
+            pool.queue([&counter]() { counter++; });
+        }
+        CHECK(pool.remainingTasks() >= 10);
+        pool.clearRemainingTasks();
+        CHECK(pool.remainingTasks() == 0);
+        blocker.set_value();
+        pool.stop();
+        CHECK(counter == 0);
+    }
+}
+
+TEST_CASE("ThreadPool: Idle Workers Do Not Use CPU", "[threadpool]") {
+    using namespace std::chrono_literals;
+
+    for (WorkStealing ws : { WorkStealing::No, WorkStealing::Yes }) {
+        ghoul::ThreadPool pool = createPool(32, ws);
+
+        // Make sure that all workers have gone to sleep after finishing some work
+        std::atomic_int counter = 0;
+        for (int i = 0; i < 1000; i++) {
+            pool.submit([&counter]() { counter++; });
+        }
+        waitFor(counter, 1000);
+        std::this_thread::sleep_for(50ms);
+
+        // The workers used to wake up every second, so we wait for longer than that
+        const std::chrono::microseconds before = processCpuTime();
+        std::this_thread::sleep_for(1200ms);
+        const std::chrono::microseconds after = processCpuTime();
+        CHECK(after - before < 50ms);
+
+        // And the sleeping workers still pick up new work
+        std::future<int> f = pool.queue([]() { return 1; });
+        CHECK(f.get() == 1);
+    }
+}
+
+TEST_CASE("ThreadPool: Submit", "[threadpool]") {
+    constexpr int NTasks = 10000;
+
+    for (WorkStealing ws : { WorkStealing::No, WorkStealing::Yes }) {
+        ghoul::ThreadPool pool = createPool(4, ws);
+        std::atomic_int counter = 0;
+        for (int i = 0; i < NTasks; i++) {
+            pool.submit([&counter]() { counter++; });
+        }
+        for (int i = 0; i < NTasks; i++) {
+            pool.submit([&counter](int v) { counter += v; }, 2);
+        }
+        waitFor(counter, 3 * NTasks);
+        CHECK(counter == 3 * NTasks);
+    }
+}
+
+TEST_CASE("ThreadPool: Submit Move-Only And Large Functions", "[threadpool]") {
+    ghoul::ThreadPool pool = createPool(2, WorkStealing::No);
+    std::atomic_int counter = 0;
+
+    // Move-only captures are supported as tasks are never copied
+    auto value = std::make_unique<int>(5);
+    pool.submit([&counter, v = std::move(value)]() { counter += *v; });
+
+    // A function that does not fit into the inline storage of a task
+    std::array<int, 256> data;
+    data.fill(1);
+    pool.submit([&counter, data]() {
+        int sum = 0;
+        for (int v : data) {
+            sum += v;
+        }
+        counter += sum;
+    });
+
+    std::future<int> f = pool.queue([data]() { return data[0]; });
+    CHECK(f.get() == 1);
+    waitFor(counter, 5 + 256);
+    CHECK(counter == 5 + 256);
+}
+
+TEST_CASE("ThreadPool: Submit Exception", "[threadpool]") {
+    ghoul::ThreadPool pool = createPool(1, WorkStealing::No);
+
+    // The exception is logged and must not bring down the worker
+    pool.submit([]() { throw std::runtime_error("Error"); });
+    std::future<int> f = pool.queue([]() { return 1; });
+    CHECK(f.get() == 1);
+
+    // Exceptions in queued tasks end up in the future
+    std::future<void> g = pool.queue([]() { throw std::runtime_error("Error"); });
+    CHECK_THROWS_AS(g.get(), std::runtime_error);
+}
+
+TEST_CASE("ThreadPool: Priorities", "[threadpool]") {
+    using TaskPriority = ghoul::ThreadPool::TaskPriority;
+
+    for (WorkStealing ws : { WorkStealing::No, WorkStealing::Yes }) {
+        ghoul::ThreadPool pool = createPool(1, ws);
+        std::promise<void> blocker;
+        std::shared_future<void> block = blocker.get_future().share();
+        std::atomic_int started = 0;
+        pool.submit([block, &started]() {
+            started++;
+            block.wait();
+        });
+        waitFor(started, 1);
+
+        std::mutex orderMutex;
+        std::vector<TaskPriority> order;
+        auto record = [&orderMutex, &order](TaskPriority p) {
+            const std::lock_guard lock(orderMutex);
+            order.push_back(p);
+        };
+        for (TaskPriority p : { TaskPriority::Background, TaskPriority::Normal,
+                                TaskPriority::High, TaskPriority::Normal,
+                                TaskPriority::Background, TaskPriority::High })
+        {
+            pool.submit({ .priority = p, .cancellationToken = std::nullopt }, record, p);
+        }
+        CHECK(pool.remainingTasks(TaskPriority::High) == 2);
+        CHECK(pool.remainingTasks(TaskPriority::Normal) == 2);
+        CHECK(pool.remainingTasks(TaskPriority::Background) == 2);
+        CHECK(pool.remainingTasks() == 6);
+
+        blocker.set_value();
+        pool.stop();
+        const std::vector<TaskPriority> expected = {
+            TaskPriority::High, TaskPriority::High, TaskPriority::Normal,
+            TaskPriority::Normal, TaskPriority::Background, TaskPriority::Background
+        };
+        CHECK(order == expected);
+    }
+}
+
+TEST_CASE("ThreadPool: Cancellation", "[threadpool]") {
+    using TaskPriority = ghoul::ThreadPool::TaskPriority;
+
+    for (WorkStealing ws : { WorkStealing::No, WorkStealing::Yes }) {
+        ghoul::ThreadPool pool = createPool(1, ws);
+        std::promise<void> blocker;
+        std::shared_future<void> block = blocker.get_future().share();
+        pool.queue([block]() { block.wait(); });
+
+        ghoul::ThreadPool::CancellationToken token;
+        std::atomic_int cancelledCounter = 0;
+        std::atomic_int counter = 0;
+        for (int i = 0; i < 10; i++) {
+            pool.submit(
+                { .priority = TaskPriority::Background, .cancellationToken = token },
+                [&cancelledCounter]() { cancelledCounter++; }
+            );
+            pool.submit([&counter]() { counter++; });
+        }
+        std::future<int> f = pool.queue(
+            { .cancellationToken = token },
+            []() { return 1; }
+        );
+
+        CHECK_FALSE(token.isCancelled());
+        ghoul::ThreadPool::CancellationToken copy = token;
+        copy.cancel();
+        CHECK(token.isCancelled());
+
+        blocker.set_value();
+        pool.stop();
+        CHECK(cancelledCounter == 0);
+        CHECK(counter == 10);
+        CHECK_THROWS_AS(f.get(), std::future_error);
+    }
+}
+
+TEST_CASE("ThreadPool: Placement", "[threadpool]") {
+    using namespace ghoul::thread;
+    constexpr int NTasks = 1000;
+
+    // An empty topology is treated as a single node that contains all processors
+    const std::vector<NumaNode> topology = { NumaNode{ .id = 0, .cpus = { 0 } } };
+    for (const std::vector<NumaNode>& t : { std::vector<NumaNode>(), topology }) {
+        for (Affinity affinity : { Affinity::None, Affinity::Core, Affinity::NumaNode }) {
+            ghoul::ThreadPool pool(
+                3,
+                []() {},
+                []() {},
+                ThreadPriorityClass::Normal,
+                ThreadPriorityLevel::Normal,
+                Background::No,
+                WorkStealing::Yes,
+                {
+                    .affinity = affinity,
+                    .topology = t,
+                    .numaLocalMemory = NumaLocalMemory::Yes
+                }
+            );
+            std::atomic_int counter = 0;
+            for (int i = 0; i < NTasks; i++) {
+                pool.submit([&counter]() { counter++; });
+            }
+            waitFor(counter, NTasks);
+            CHECK(counter == NTasks);
+        }
+    }
+}
+
+TEST_CASE("ThreadPool: Metrics", "[threadpool]") {
+    using Metrics = ghoul::ThreadPool::Metrics;
+    constexpr int NTasks = 100;
+
+    for (WorkStealing ws : { WorkStealing::No, WorkStealing::Yes }) {
+        ghoul::ThreadPool pool = createPool(4, ws);
+        const Metrics before = pool.metrics();
+        CHECK(before.nTasksExecuted == 0);
+        CHECK(before.workers.size() == 4);
+
+        ghoul::ThreadPool::CancellationToken token;
+        token.cancel();
+        pool.submit({ .cancellationToken = token }, []() {});
+        for (int i = 0; i < NTasks; i++) {
+            pool.submit([]() {
+                std::this_thread::sleep_for(std::chrono::microseconds(10));
+            });
+        }
+        pool.stop();
+
+        // The counters of the stopped Workers are still part of the totals
+        const Metrics after = pool.metrics();
+        CHECK(after.workers.empty());
+        CHECK(after.nTasksExecuted == NTasks);
+        CHECK(after.nTasksCancelled == 1);
+        CHECK(after.queueWaitTime.count() == NTasks);
+        CHECK(after.executionTime.count() == NTasks);
+        CHECK(after.totalExecutionTime >= std::chrono::microseconds(10 * NTasks));
+        CHECK(after.executionTime.percentile(0.5) >= std::chrono::microseconds(10));
+        CHECK(
+            after.executionTime.percentile(0.5) <= after.executionTime.percentile(1.0)
+        );
+        CHECK(ghoul::ThreadPool::throughput(before, after) > 0.0);
+    }
+
+    ghoul::ThreadPool pool = createPool(2, WorkStealing::Yes);
+    pool.queue([]() { std::this_thread::sleep_for(std::chrono::milliseconds(5)); }).get();
+    for (const ghoul::ThreadPool::WorkerMetrics& worker : pool.metrics().workers) {
+        CHECK(worker.utilization >= 0.0);
+        CHECK(worker.utilization <= 1.0);
+    }
+}
+
+TEST_CASE("ThreadPool: Parallel For", "[threadpool]") {
+    constexpr int N = 100000;
+
+    for (WorkStealing ws : { WorkStealing::No, WorkStealing::Yes }) {
+        ghoul::ThreadPool pool = createPool(4, ws);
+        std::vector<int> values(N, 0);
+        pool.parallelFor(0, N, 64, [&values](int i) { values[i] += i; });
+
+        bool isCorrect = true;
+        for (int i = 0; i < N; i++) {
+            isCorrect &= (values[i] == i);
+        }
+        CHECK(isCorrect);
+
+        // Empty ranges and ranges smaller than the grain size
+        pool.parallelFor(10, 10, 1, [&values](int) { values[0] = -1; });
+        CHECK(values[0] == 0);
+        pool.parallelFor(size_t(0), size_t(3), size_t(64), [&values](size_t i) {
+            values[i] = -1;
+        });
+        CHECK(values[2] == -1);
+    }
+}
+
+TEST_CASE("ThreadPool: Parallel Reduce", "[threadpool]") {
+    constexpr int64_t N = 100000;
+
+    for (WorkStealing ws : { WorkStealing::No, WorkStealing::Yes }) {
+        ghoul::ThreadPool pool = createPool(4, ws);
+        const int64_t sum = pool.parallelReduce(
+            int64_t(0), N, int64_t(16), int64_t(0),
+            [](int64_t i) { return i; },
+            [](int64_t a, int64_t b) { return a + b; }
+        );
+        CHECK(sum == N * (N - 1) / 2);
+
+        const int empty = pool.parallelReduce(
+            0, 0, 1, 42,
+            [](int i) { return i; },
+            [](int a, int b) { return a + b; }
+        );
+        CHECK(empty == 42);
+    }
+}
+
+TEST_CASE("ThreadPool: Parallel Invoke", "[threadpool]") {
+    for (WorkStealing ws : { WorkStealing::No, WorkStealing::Yes }) {
+        ghoul::ThreadPool pool = createPool(2, ws);
+        int a = 0;
+        int b = 0;
+        int c = 0;
+        pool.parallelInvoke([&a]() { a = 1; }, [&b]() { b = 2; }, [&c]() { c = 3; });
+        CHECK(a == 1);
+        CHECK(b == 2);
+        CHECK(c == 3);
+    }
+}
+
+TEST_CASE("ThreadPool: Nested Parallel For", "[threadpool]") {
+    constexpr int N = 256;
+
+    for (WorkStealing ws : { WorkStealing::No, WorkStealing::Yes }) {
+        ghoul::ThreadPool pool = createPool(4, ws);
+        std::atomic_int counter = 0;
+        pool.parallelFor(0, N, 1, [&pool, &counter](int) {
+            pool.parallelFor(0, N, 8, [&counter](int) { counter++; });
+        });
+        CHECK(counter == N * N);
+    }
+}
+
+TEST_CASE("ThreadPool: Parallel For Exception", "[threadpool]") {
+    for (WorkStealing ws : { WorkStealing::No, WorkStealing::Yes }) {
+        ghoul::ThreadPool pool = createPool(4, ws);
+        std::atomic_int counter = 0;
+        CHECK_THROWS_AS(
+            pool.parallelFor(0, 1000, 1, [&counter](int i) {
+                counter++;
+                if (i == 500) {
+                    throw std::runtime_error("Error");
+                }
+            }),
+            std::runtime_error
+        );
+        // All other indices must have been processed before the exception is rethrown
+        CHECK(counter == 1000);
+    }
+}
+
+TEST_CASE("ThreadPool: Parallel Invoke Discarded Tasks", "[threadpool]") {
+    for (WorkStealing ws : { WorkStealing::No, WorkStealing::Yes }) {
+        ghoul::ThreadPool pool = createPool(1, ws);
+        std::promise<void> blocker;
+        std::shared_future<void> block = blocker.get_future().share();
+        pool.queue([block]() { block.wait(); });
+
+        // The only Worker is blocked, so the queued functions are still pending when
+        // the first function, which runs on the calling thread, discards them
+        std::atomic_int counter = 0;
+        CHECK_THROWS_AS(
+            pool.parallelInvoke(
+                [&pool]() { pool.clearRemainingTasks(); },
+                [&counter]() { counter++; },
+                [&counter]() { counter++; }
+            ),
+            ghoul::RuntimeError
+        );
+        blocker.set_value();
+        pool.stop();
+        CHECK(counter == 0);
+    }
+}
+
+TEST_CASE("ThreadPool: Parallel For Stopped Pool", "[threadpool]") {
+    ghoul::ThreadPool pool = createPool(2, WorkStealing::Yes);
+    pool.stop();
+
+    // The calling thread has to do all the work by itself
+    std::atomic_int counter = 0;
+    pool.parallelFor(0, 1000, 10, [&counter](int) { counter++; });
+    CHECK(counter == 1000);
+}
+
+// Measures the throughput of tiny tasks for a single shared queue compared to work
+// stealing. The reported time is for NTasks tasks, so the tasks per second are NTasks
+// divided by the mean time. Run these with:  GhoulTest "[benchmark]"
+TEST_CASE("ThreadPool: Benchmark Throughput", "[.][threadpool][benchmark]") {
+    constexpr int NTasks = 10000;
+
+    for (int nThreads : { 1, 2, 4, 8, 16, 32, 64 }) {
+        for (WorkStealing ws : { WorkStealing::No, WorkStealing::Yes }) {
+            ghoul::ThreadPool pool = createPool(nThreads, ws);
+            const std::string mode = ws ? "work stealing" : "single queue";
+
+            BENCHMARK(std::format("External {} threads {}", nThreads, mode)) {
+                std::atomic_int counter = 0;
+                for (int i = 0; i < NTasks; i++) {
+                    pool.queue([&counter]() { counter++; });
+                }
+                waitFor(counter, NTasks);
+            };
+
+            BENCHMARK(std::format("Submit {} threads {}", nThreads, mode)) {
+                std::atomic_int counter = 0;
+                for (int i = 0; i < NTasks; i++) {
+                    pool.submit([&counter]() { counter++; });
+                }
+                waitFor(counter, NTasks);
+            };
+
+            BENCHMARK(std::format("Nested {} threads {}", nThreads, mode)) {
+                std::atomic_int counter = 0;
+                for (int i = 0; i < nThreads; i++) {
+                    pool.queue([&pool, &counter, nThreads]() {
+                        for (int j = 0; j < NTasks / nThreads; j++) {
+                            pool.submit([&counter]() { counter++; });
+                        }
+                    });
+                }
+                waitFor(counter, (NTasks / nThreads) * nThreads);
+            };
+        }
+    }
+}
+
+TEST_CASE("ThreadPool: Benchmark Startup And Resize", "[.][threadpool][benchmark]") {
+    constexpr int NThreads = 128;
+
+    for (WorkStealing ws : { WorkStealing::No, WorkStealing::Yes }) {
+        const std::string mode = ws ? "work stealing" : "single queue";
+
+        BENCHMARK(std::format("Start and stop {} threads {}", NThreads, mode)) {
+            ghoul::ThreadPool pool = createPool(NThreads, ws);
+            pool.stop();
+        };
+
+        ghoul::ThreadPool pool = createPool(1, ws);
+        BENCHMARK(std::format("Resize 1 to {} to 1 threads {}", NThreads, mode)) {
+            pool.resize(NThreads);
+            pool.resize(1);
+        };
+    }
+}